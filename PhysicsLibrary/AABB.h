@@ -0,0 +1,79 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cfloat>
+
+// World space bounding sphere
+struct BoundingSphere
+{
+    DirectX::XMFLOAT3 Center{ 0.0f, 0.0f, 0.0f };
+    float Radius{ 0.0f };
+
+    bool Overlaps(const BoundingSphere& other) const
+    {
+        const float dx = Center.x - other.Center.x;
+        const float dy = Center.y - other.Center.y;
+        const float dz = Center.z - other.Center.z;
+        const float r = Radius + other.Radius;
+        return dx * dx + dy * dy + dz * dz <= r * r;
+    }
+};
+
+// World space axis aligned bounding box
+struct AABB
+{
+    DirectX::XMFLOAT3 Min{ FLT_MAX, FLT_MAX, FLT_MAX };
+    DirectX::XMFLOAT3 Max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    static AABB FromCenterExtents(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents)
+    {
+        AABB box;
+        box.Min = { center.x - extents.x, center.y - extents.y, center.z - extents.z };
+        box.Max = { center.x + extents.x, center.y + extents.y, center.z + extents.z };
+        return box;
+    }
+
+    bool Overlaps(const AABB& other) const
+    {
+        return Min.x <= other.Max.x && Max.x >= other.Min.x &&
+            Min.y <= other.Max.y && Max.y >= other.Min.y &&
+            Min.z <= other.Max.z && Max.z >= other.Min.z;
+    }
+
+    bool Contains(const AABB& other) const
+    {
+        return Min.x <= other.Min.x && Min.y <= other.Min.y && Min.z <= other.Min.z &&
+            Max.x >= other.Max.x && Max.y >= other.Max.y && Max.z >= other.Max.z;
+    }
+
+    void Merge(const AABB& other)
+    {
+        Min = { std::min(Min.x, other.Min.x), std::min(Min.y, other.Min.y), std::min(Min.z, other.Min.z) };
+        Max = { std::max(Max.x, other.Max.x), std::max(Max.y, other.Max.y), std::max(Max.z, other.Max.z) };
+    }
+
+    void Expand(float margin)
+    {
+        Min = { Min.x - margin, Min.y - margin, Min.z - margin };
+        Max = { Max.x + margin, Max.y + margin, Max.z + margin };
+    }
+
+    DirectX::XMFLOAT3 GetCenter() const
+    {
+        return { 0.5f * (Min.x + Max.x), 0.5f * (Min.y + Max.y), 0.5f * (Min.z + Max.z) };
+    }
+
+    DirectX::XMFLOAT3 GetExtents() const
+    {
+        return { 0.5f * (Max.x - Min.x), 0.5f * (Max.y - Min.y), 0.5f * (Max.z - Min.z) };
+    }
+
+    float SurfaceArea() const
+    {
+        const float dx = Max.x - Min.x;
+        const float dy = Max.y - Min.y;
+        const float dz = Max.z - Min.z;
+        return 2.0f * (dx * dy + dy * dz + dz * dx);
+    }
+};
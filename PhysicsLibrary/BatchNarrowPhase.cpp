@@ -0,0 +1,465 @@
+#include "pch.h"
+#include "BatchNarrowPhase.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CapsuleCollider.h"
+#include "SphereCollider.h"
+#include "WorkerPool.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define BATCH_NARROW_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    //~ Below this centre distance a contact takes the fallback normal, as in the scalar tests
+    constexpr float DEGENERATE_DISTANCE = 1e-6f;
+
+    // Same thin wrappers as the batched integration in BodyStore, plus a one lane build where
+    // Float is a plain float and masks are 1 / 0, so the tests below are written only once.
+    namespace batch
+    {
+#if defined(BATCH_NARROW_SIMD) && defined(__AVX__)
+        using Float = __m256;
+        constexpr uint32_t WIDTH = 8;
+
+        inline Float Load(const float* p) { return _mm256_loadu_ps(p); }
+        inline void Store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+        inline Float Set(float v) { return _mm256_set1_ps(v); }
+        inline Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+        inline Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+        inline Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+        inline Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+        inline Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+        inline Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+        inline Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+        inline Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        inline Float LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+        inline Float Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        inline Float Select(Float a, Float b, Float mask) { return _mm256_blendv_ps(a, b, mask); }
+        inline int Bits(Float mask) { return _mm256_movemask_ps(mask); }
+#elif defined(BATCH_NARROW_SIMD)
+        using Float = __m128;
+        constexpr uint32_t WIDTH = 4;
+
+        inline Float Load(const float* p) { return _mm_loadu_ps(p); }
+        inline void Store(float* p, Float v) { _mm_storeu_ps(p, v); }
+        inline Float Set(float v) { return _mm_set1_ps(v); }
+        inline Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+        inline Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+        inline Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+        inline Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+        inline Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+        inline Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+        inline Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+        inline Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+        inline Float LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+        inline Float Greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+        inline Float Select(Float a, Float b, Float mask)
+        {
+            return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+        }
+        inline int Bits(Float mask) { return _mm_movemask_ps(mask); }
+#else
+        using Float = float;
+        constexpr uint32_t WIDTH = 1;
+
+        inline Float Load(const float* p) { return *p; }
+        inline void Store(float* p, Float v) { *p = v; }
+        inline Float Set(float v) { return v; }
+        inline Float Add(Float a, Float b) { return a + b; }
+        inline Float Sub(Float a, Float b) { return a - b; }
+        inline Float Mul(Float a, Float b) { return a * b; }
+        inline Float Div(Float a, Float b) { return a / b; }
+        inline Float Sqrt(Float a) { return std::sqrt(a); }
+        inline Float Min(Float a, Float b) { return a < b ? a : b; }
+        inline Float Max(Float a, Float b) { return a > b ? a : b; }
+        inline Float Less(Float a, Float b) { return a < b ? 1.0f : 0.0f; }
+        inline Float LessEqual(Float a, Float b) { return a <= b ? 1.0f : 0.0f; }
+        inline Float Greater(Float a, Float b) { return a > b ? 1.0f : 0.0f; }
+        inline Float Select(Float a, Float b, Float mask) { return mask != 0.0f ? b : a; }
+        inline int Bits(Float mask) { return mask != 0.0f ? 1 : 0; }
+#endif
+        inline Float LengthSq(Float x, Float y, Float z)
+        {
+            return Add(Add(Mul(x, x), Mul(y, y)), Mul(z, z));
+        }
+
+        //~ Lanes of a register that hold a pair, the padding after the last one is masked off
+        inline int ValidBits(size_t begin, size_t end)
+        {
+            const size_t remaining = end - begin;
+            return remaining >= WIDTH ? (1 << WIDTH) - 1 : (1 << remaining) - 1;
+        }
+    }
+
+    //~ Material of a contact between the two bodies, averaged like the scalar sphere tests
+    void SetMaterial(Contact& contact, const RigidBody* a, const RigidBody* b)
+    {
+        contact.Restitution = 0.5f * (a->GetRestitution() + b->GetRestitution());
+        contact.Friction = 0.5f * (a->GetFriction() + b->GetFriction());
+        contact.Elasticity = 0.5f * (a->GetElasticity() + b->GetElasticity());
+    }
+
+    static_assert(BatchNarrowPhase::PAIRS_PER_TASK % batch::WIDTH == 0, "tasks have to start on a register");
+
+    size_t TaskCount(size_t pairs)
+    {
+        return (pairs + BatchNarrowPhase::PAIRS_PER_TASK - 1) / BatchNarrowPhase::PAIRS_PER_TASK;
+    }
+
+    //~ Lowest set bit, the lane of the next touching pair in a mask
+    int NextLane(int& bits)
+    {
+        int lane = 0;
+        while (!(bits & (1 << lane))) ++lane;
+        bits &= bits - 1;
+        return lane;
+    }
+}
+
+void BatchNarrowPhase::PairBatch::Clear()
+{
+    Pairs.clear();
+}
+
+void BatchNarrowPhase::PairBatch::Resize(size_t lanes)
+{
+    // Padding lanes only need to hold finite values, the valid mask drops them
+    const size_t padded = (Pairs.size() + lanes - 1) / lanes * lanes;
+    for (std::vector<float>* array : { &AX, &AY, &AZ, &BX, &BY, &BZ, &SegmentX, &SegmentY, &SegmentZ, &RadiusA, &RadiusB })
+    {
+        array->assign(padded, 0.0f);
+    }
+}
+
+void BatchNarrowPhase::Begin()
+{
+    m_SphereSpheres.Clear();
+    m_SphereCapsules.Clear();
+    m_OtherPairs.clear();
+}
+
+void BatchNarrowPhase::AddPair(ICollider* a, ICollider* b)
+{
+    const ColliderType typeA = a->GetColliderType();
+    const ColliderType typeB = b->GetColliderType();
+
+    if (typeA == ColliderType::Sphere && typeB == ColliderType::Sphere)
+    {
+        m_SphereSpheres.Pairs.push_back({ a, b });
+    }
+    else if (typeA == ColliderType::Sphere && typeB == ColliderType::Capsule)
+    {
+        m_SphereCapsules.Pairs.push_back({ a, b });
+    }
+    else if (typeA == ColliderType::Capsule && typeB == ColliderType::Sphere)
+    {
+        // CollisionDispatch puts the sphere first as well
+        m_SphereCapsules.Pairs.push_back({ b, a });
+    }
+    else
+    {
+        m_OtherPairs.push_back({ a, b });
+    }
+}
+
+void BatchNarrowPhase::Run(std::vector<Contact>& outContacts, WorkerPool* pool)
+{
+    m_SphereSpheres.Resize(batch::WIDTH);
+    m_SphereCapsules.Resize(batch::WIDTH);
+
+    // Task t always covers the same pairs: the sphere-sphere chunks, then sphere-capsule, then the rest
+    const size_t sphereTasks = TaskCount(m_SphereSpheres.Pairs.size());
+    const size_t capsuleTasks = TaskCount(m_SphereCapsules.Pairs.size());
+    const size_t tasks = sphereTasks + capsuleTasks + TaskCount(m_OtherPairs.size());
+    while (m_TaskOutputs.size() < tasks)
+    {
+        m_TaskOutputs.emplace_back().Contacts.reserve(PAIRS_PER_TASK);
+    }
+
+    auto task = [&](size_t index)
+        {
+            TaskOutput& output = m_TaskOutputs[index];
+            output.Contacts.clear();
+            output.TouchingPairs.clear();
+
+            if (index < sphereTasks)
+            {
+                const size_t first = index * PAIRS_PER_TASK;
+                const size_t last = (std::min)(first + PAIRS_PER_TASK, m_SphereSpheres.Pairs.size());
+                GatherSpheres(first, last);
+                CollideSpheres(first, last, output);
+                return;
+            }
+            index -= sphereTasks;
+
+            if (index < capsuleTasks)
+            {
+                const size_t first = index * PAIRS_PER_TASK;
+                const size_t last = (std::min)(first + PAIRS_PER_TASK, m_SphereCapsules.Pairs.size());
+                GatherSphereCapsules(first, last);
+                CollideSphereCapsules(first, last, output);
+                return;
+            }
+            index -= capsuleTasks;
+
+            const size_t first = index * PAIRS_PER_TASK;
+            CollideOthers(first, (std::min)(first + PAIRS_PER_TASK, m_OtherPairs.size()), output);
+        };
+
+    if (pool && tasks > 1)
+    {
+        pool->ParallelFor(tasks, task);
+    }
+    else
+    {
+        for (size_t index = 0; index < tasks; ++index) task(index);
+    }
+
+    // === Merge, one copy per chunk in task order ===
+    size_t contactCount = 0;
+    size_t touchingCount = 0;
+    for (size_t index = 0; index < tasks; ++index)
+    {
+        contactCount += m_TaskOutputs[index].Contacts.size();
+        touchingCount += m_TaskOutputs[index].TouchingPairs.size();
+    }
+    outContacts.reserve(outContacts.size() + contactCount);
+    m_TouchingPairs.clear();
+    m_TouchingPairs.reserve(touchingCount);
+
+    for (size_t index = 0; index < tasks; ++index)
+    {
+        const TaskOutput& output = m_TaskOutputs[index];
+        outContacts.insert(outContacts.end(), output.Contacts.begin(), output.Contacts.end());
+        m_TouchingPairs.insert(m_TouchingPairs.end(), output.TouchingPairs.begin(), output.TouchingPairs.end());
+    }
+}
+
+uint32_t BatchNarrowPhase::GetLaneCount()
+{
+    return batch::WIDTH;
+}
+
+void BatchNarrowPhase::GatherSpheres(size_t first, size_t last)
+{
+    PairBatch& group = m_SphereSpheres;
+    for (size_t i = first; i < last; ++i)
+    {
+        const SphereCollider* a = static_cast<const SphereCollider*>(group.Pairs[i].A);
+        const SphereCollider* b = static_cast<const SphereCollider*>(group.Pairs[i].B);
+
+        DirectX::XMFLOAT3 centerA;
+        DirectX::XMFLOAT3 centerB;
+        DirectX::XMStoreFloat3(&centerA, a->GetRigidBody()->GetPosition());
+        DirectX::XMStoreFloat3(&centerB, b->GetRigidBody()->GetPosition());
+
+        group.AX[i] = centerA.x;
+        group.AY[i] = centerA.y;
+        group.AZ[i] = centerA.z;
+        group.BX[i] = centerB.x;
+        group.BY[i] = centerB.y;
+        group.BZ[i] = centerB.z;
+        group.RadiusA[i] = a->GetRadius();
+        group.RadiusB[i] = b->GetRadius();
+    }
+}
+
+void BatchNarrowPhase::GatherSphereCapsules(size_t first, size_t last)
+{
+    using namespace DirectX;
+
+    PairBatch& group = m_SphereCapsules;
+
+    // Broadphases list the pairs of one body together, so the segment is usually the previous one
+    const CapsuleCollider* previous = nullptr;
+    XMFLOAT3 segmentStart{};
+    XMFLOAT3 segment{};
+
+    for (size_t i = first; i < last; ++i)
+    {
+        const SphereCollider* sphere = static_cast<const SphereCollider*>(group.Pairs[i].A);
+        const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(group.Pairs[i].B);
+
+        if (capsule != previous)
+        {
+            // Segment exactly as SphereCollider::CheckCollisionWith builds it
+            const RigidBody* capsuleBody = capsule->GetRigidBody();
+            const XMVECTOR up = capsuleBody->GetOrientation().RotateVector(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            const XMVECTOR halfHeight = up * (capsule->GetHeight() * 0.5f);
+            const XMVECTOR start = capsuleBody->GetPosition() - halfHeight;
+
+            XMStoreFloat3(&segmentStart, start);
+            XMStoreFloat3(&segment, (capsuleBody->GetPosition() + halfHeight) - start);
+            previous = capsule;
+        }
+
+        XMFLOAT3 center;
+        XMStoreFloat3(&center, sphere->GetRigidBody()->GetPosition());
+
+        group.AX[i] = center.x;
+        group.AY[i] = center.y;
+        group.AZ[i] = center.z;
+        group.BX[i] = segmentStart.x;
+        group.BY[i] = segmentStart.y;
+        group.BZ[i] = segmentStart.z;
+        group.SegmentX[i] = segment.x;
+        group.SegmentY[i] = segment.y;
+        group.SegmentZ[i] = segment.z;
+        group.RadiusA[i] = sphere->GetRadius();
+        group.RadiusB[i] = capsule->GetRadius();
+    }
+}
+
+void BatchNarrowPhase::CollideSpheres(size_t first, size_t last, TaskOutput& output) const
+{
+    using namespace batch;
+
+    const PairBatch& group = m_SphereSpheres;
+    const Float degenerate = Set(DEGENERATE_DISTANCE);
+    const Float one = Set(1.0f);
+    const Float zero = Set(0.0f);
+
+    float normalX[WIDTH];
+    float normalY[WIDTH];
+    float normalZ[WIDTH];
+    float depth[WIDTH];
+
+    for (size_t begin = first; begin < last; begin += WIDTH)
+    {
+        const Float dx = Sub(Load(&group.BX[begin]), Load(&group.AX[begin]));
+        const Float dy = Sub(Load(&group.BY[begin]), Load(&group.AY[begin]));
+        const Float dz = Sub(Load(&group.BZ[begin]), Load(&group.AZ[begin]));
+        const Float radius = Add(Load(&group.RadiusA[begin]), Load(&group.RadiusB[begin]));
+        const Float distanceSq = LengthSq(dx, dy, dz);
+
+        int touching = Bits(Less(distanceSq, Mul(radius, radius))) & ValidBits(begin, last);
+        if (!touching) continue;
+
+        // Coincident centres push apart along +x
+        const Float distance = Sqrt(distanceSq);
+        const Float apart = Greater(distance, degenerate);
+        const Float inverse = Select(zero, Div(one, Select(one, distance, apart)), apart);
+        Store(normalX, Select(one, Mul(dx, inverse), apart));
+        Store(normalY, Mul(dy, inverse));
+        Store(normalZ, Mul(dz, inverse));
+        Store(depth, Sub(radius, distance));
+
+        while (touching)
+        {
+            const int lane = NextLane(touching);
+            const size_t i = begin + lane;
+            const ColliderPair& pair = group.Pairs[i];
+
+            Contact& contact = output.Contacts.emplace_back();
+            contact.Colliders[0] = pair.A;
+            contact.Colliders[1] = pair.B;
+            contact.ContactNormal = { normalX[lane], normalY[lane], normalZ[lane] };
+            contact.ContactPoint = {
+                group.AX[i] + normalX[lane] * group.RadiusA[i],
+                group.AY[i] + normalY[lane] * group.RadiusA[i],
+                group.AZ[i] + normalZ[lane] * group.RadiusA[i] };
+            contact.PenetrationDepth = depth[lane];
+            SetMaterial(contact, pair.A->GetRigidBody(), pair.B->GetRigidBody());
+            output.TouchingPairs.push_back(pair);
+        }
+    }
+}
+
+void BatchNarrowPhase::CollideSphereCapsules(size_t first, size_t last, TaskOutput& output) const
+{
+    using namespace batch;
+
+    const PairBatch& group = m_SphereCapsules;
+    const Float degenerate = Set(DEGENERATE_DISTANCE);
+    const Float one = Set(1.0f);
+    const Float zero = Set(0.0f);
+
+    float closestX[WIDTH];
+    float closestY[WIDTH];
+    float closestZ[WIDTH];
+    float towardX[WIDTH];
+    float towardY[WIDTH];
+    float towardZ[WIDTH];
+    float depth[WIDTH];
+
+    for (size_t begin = first; begin < last; begin += WIDTH)
+    {
+        const Float cx = Load(&group.AX[begin]);
+        const Float cy = Load(&group.AY[begin]);
+        const Float cz = Load(&group.AZ[begin]);
+        const Float sx = Load(&group.BX[begin]);
+        const Float sy = Load(&group.BY[begin]);
+        const Float sz = Load(&group.BZ[begin]);
+        const Float ux = Load(&group.SegmentX[begin]);
+        const Float uy = Load(&group.SegmentY[begin]);
+        const Float uz = Load(&group.SegmentZ[begin]);
+
+        // Closest point of the segment to the sphere centre, a zero length capsule is a sphere
+        const Float lengthSq = LengthSq(ux, uy, uz);
+        const Float along = Add(Add(Mul(Sub(cx, sx), ux), Mul(Sub(cy, sy), uy)), Mul(Sub(cz, sz), uz));
+        const Float hasLength = Greater(lengthSq, zero);
+        const Float t = Select(zero, Min(Max(Div(along, Select(one, lengthSq, hasLength)), zero), one), hasLength);
+        const Float px = Add(sx, Mul(ux, t));
+        const Float py = Add(sy, Mul(uy, t));
+        const Float pz = Add(sz, Mul(uz, t));
+
+        const Float dx = Sub(cx, px);
+        const Float dy = Sub(cy, py);
+        const Float dz = Sub(cz, pz);
+        const Float radius = Add(Load(&group.RadiusA[begin]), Load(&group.RadiusB[begin]));
+        const Float distanceSq = LengthSq(dx, dy, dz);
+
+        int touching = Bits(LessEqual(distanceSq, Mul(radius, radius))) & ValidBits(begin, last);
+        if (!touching) continue;
+
+        const Float distance = Sqrt(distanceSq);
+        const Float apart = Greater(distance, degenerate);
+        const Float inverse = Select(zero, Div(one, Select(one, distance, apart)), apart);
+        Store(closestX, px);
+        Store(closestY, py);
+        Store(closestZ, pz);
+        Store(towardX, Select(one, Mul(dx, inverse), apart));
+        Store(towardY, Mul(dy, inverse));
+        Store(towardZ, Mul(dz, inverse));
+        Store(depth, Sub(radius, distance));
+
+        while (touching)
+        {
+            const int lane = NextLane(touching);
+            const size_t i = begin + lane;
+            const ColliderPair& pair = group.Pairs[i];
+
+            // Normal from the sphere to the capsule, the point on the capsule surface
+            Contact& contact = output.Contacts.emplace_back();
+            contact.Colliders[0] = pair.A;
+            contact.Colliders[1] = pair.B;
+            contact.ContactNormal = { -towardX[lane], -towardY[lane], -towardZ[lane] };
+            contact.ContactPoint = {
+                closestX[lane] + towardX[lane] * group.RadiusB[i],
+                closestY[lane] + towardY[lane] * group.RadiusB[i],
+                closestZ[lane] + towardZ[lane] * group.RadiusB[i] };
+            contact.PenetrationDepth = depth[lane];
+            SetMaterial(contact, pair.A->GetRigidBody(), pair.B->GetRigidBody());
+            output.TouchingPairs.push_back(pair);
+        }
+    }
+}
+
+void BatchNarrowPhase::CollideOthers(size_t first, size_t last, TaskOutput& output) const
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        const ColliderPair& pair = m_OtherPairs[i];
+        ContactManifold manifold;
+        if (pair.A->GenerateManifold(pair.B, manifold))
+        {
+            output.TouchingPairs.push_back(pair);
+            output.Contacts.insert(output.Contacts.end(), manifold.Points, manifold.Points + manifold.PointCount);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Contact.h"
+#include "IBroadPhase.h"
+
+class WorkerPool;
+
+// Narrowphase over all candidate pairs of a step. Sphere-sphere and sphere-capsule pairs, the
+// bulk of particle heavy scenes, are grouped by type, gathered into structure of arrays and
+// tested a register at a time (8 lanes with AVX, 4 with SSE); only the lanes that touch are
+// turned into contacts. Every other pair runs through ICollider::GenerateManifold one by one.
+// The batched tests give the contacts of SphereCollider::CheckCollisionWith, up to rounding.
+// Each group is cut into tasks of PAIRS_PER_TASK pairs that can run on a WorkerPool. A task
+// writes only to its own output chunk, kept with its capacity from step to step, and the
+// chunks are appended in task order, so the contacts come out in the same order whichever
+// thread ran which task, and on any number of threads.
+class BatchNarrowPhase
+{
+public:
+    BatchNarrowPhase() = default;
+    BatchNarrowPhase(const BatchNarrowPhase&) = delete;
+    BatchNarrowPhase& operator=(const BatchNarrowPhase&) = delete;
+
+    //~ Forgets the pairs of the previous step
+    void Begin();
+    //~ Queues a pair, sorted into its group
+    void AddPair(ICollider* a, ICollider* b);
+    //~ Tests every queued pair, appends the contacts of those that touch to outContacts.
+    //~ Tasks are spread over the pool when one is given, the calling thread works along.
+    void Run(std::vector<Contact>& outContacts, WorkerPool* pool = nullptr);
+
+    //~ One entry per pair that touched in the last Run, in the order their contacts were written
+    const std::vector<ColliderPair>& GetTouchingPairs() const { return m_TouchingPairs; }
+    //~ Pairs of the last Run that went through the batched tests
+    size_t GetBatchedPairCount() const { return m_SphereSpheres.Pairs.size() + m_SphereCapsules.Pairs.size(); }
+
+    //~ Pairs per SIMD register, 1 without SIMD support
+    static uint32_t GetLaneCount();
+
+    //~ Pairs handed to a worker at a time, a whole number of registers
+    static constexpr size_t PAIRS_PER_TASK = 256;
+
+private:
+    //~ One component per array, lane i of every array belongs to Pairs[i]. Sphere-sphere pairs
+    //~ use A / B as the two centres, sphere-capsule pairs A as the sphere centre, B as the start
+    //~ of the capsule segment and Segment as its length and direction.
+    struct PairBatch
+    {
+        std::vector<ColliderPair> Pairs;
+        std::vector<float> AX, AY, AZ;
+        std::vector<float> BX, BY, BZ;
+        std::vector<float> SegmentX, SegmentY, SegmentZ;
+        std::vector<float> RadiusA, RadiusB;
+
+        void Clear();
+        //~ Sizes the arrays for Pairs, padded to a whole register
+        void Resize(size_t lanes);
+    };
+
+    //~ What one task found, merged into the step's contacts after all tasks are done
+    struct TaskOutput
+    {
+        std::vector<Contact> Contacts;
+        std::vector<ColliderPair> TouchingPairs;
+    };
+
+    //~ Pairs [first, last) of a group, first on a register boundary
+    void GatherSpheres(size_t first, size_t last);
+    void GatherSphereCapsules(size_t first, size_t last);
+    void CollideSpheres(size_t first, size_t last, TaskOutput& output) const;
+    void CollideSphereCapsules(size_t first, size_t last, TaskOutput& output) const;
+    void CollideOthers(size_t first, size_t last, TaskOutput& output) const;
+
+private:
+    PairBatch m_SphereSpheres;
+    PairBatch m_SphereCapsules; // A is always the sphere
+    std::vector<ColliderPair> m_OtherPairs;
+    std::vector<TaskOutput> m_TaskOutputs;
+    std::vector<ColliderPair> m_TouchingPairs;
+};
@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "BodyEdit.h"
+
+#include "CapsuleCollider.h"
+#include "RigidBody.h"
+#include "SphereCollider.h"
+
+BodyEdit BodyEdit::Vector(BodyField field, const DirectX::XMFLOAT3& value)
+{
+    return { field, { value.x, value.y, value.z, 0.0f } };
+}
+
+BodyEdit BodyEdit::Scalar(BodyField field, float value)
+{
+    return { field, { value, 0.0f, 0.0f, 0.0f } };
+}
+
+BodyEdit BodyEdit::Flag(BodyField field, bool value)
+{
+    return Scalar(field, value ? 1.0f : 0.0f);
+}
+
+BodyEdit BodyEdit::Rotation(const Quaternion& orientation)
+{
+    return { BodyField::Orientation, { orientation.GetI(), orientation.GetJ(), orientation.GetK(), orientation.GetR() } };
+}
+
+BodyEdit BodyEdit::State(ColliderState state)
+{
+    return Scalar(BodyField::State, static_cast<float>(state));
+}
+
+void BodyEdit::Apply(ICollider* collider) const
+{
+    using namespace DirectX;
+
+    RigidBody* body = collider->GetRigidBody();
+    const XMVECTOR vector = XMVectorSet(Value.x, Value.y, Value.z, 0.0f);
+
+    switch (Field)
+    {
+    case BodyField::Position:        body->SetPosition(vector); break;
+    case BodyField::Velocity:        body->SetVelocity(vector); break;
+    case BodyField::Acceleration:    body->SetAcceleration(vector); break;
+    case BodyField::AngularVelocity: body->SetAngularVelocity(vector); break;
+    case BodyField::Orientation:     body->SetOrientation(Quaternion(Value.w, Value.x, Value.y, Value.z)); break;
+    case BodyField::Mass:            body->SetMass(Value.x); break;
+    case BodyField::LinearDamping:   body->SetDamping(Value.x); break;
+    case BodyField::AngularDamping:  body->SetAngularDamping(Value.x); break;
+    case BodyField::Elasticity:      body->SetElasticity(Value.x); break;
+    case BodyField::Restitution:     body->SetRestitution(Value.x); break;
+    case BodyField::Friction:        body->SetFriction(Value.x); break;
+    case BodyField::Platform:        body->SetAsPlatform(Value.x != 0.0f); break;
+    case BodyField::Scale:           collider->SetScale(vector); break;
+    case BodyField::Radius:
+        if (SphereCollider* sphere = collider->As<SphereCollider>()) sphere->SetRadius(Value.x);
+        else if (CapsuleCollider* capsule = collider->As<CapsuleCollider>()) capsule->SetRadius(Value.x);
+        break;
+    case BodyField::Height:
+        if (CapsuleCollider* capsule = collider->As<CapsuleCollider>()) capsule->SetHeight(Value.x);
+        break;
+    case BodyField::State:           collider->SetColliderState(static_cast<ColliderState>(Value.x)); break;
+    }
+}
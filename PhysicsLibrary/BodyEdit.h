@@ -0,0 +1,49 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+
+#include "ICollider.h"
+#include "Quaternion.h"
+
+//~ What a BodyEdit sets
+enum class BodyField : uint8_t
+{
+    Position,
+    Velocity,
+    Acceleration,
+    AngularVelocity,
+    Orientation,
+    Mass,
+    LinearDamping,
+    AngularDamping,
+    Elasticity,
+    Restitution,
+    Friction,
+    Platform,
+    Scale,
+    Radius,  // spheres and capsules
+    Height,  // capsules
+    State,
+};
+
+// One change to a body or its collider made from outside the step (the editor's widgets),
+// kept as plain data so it can wait in a command queue until the step boundary and be
+// recorded in a replay log. Vectors sit in xyz, the orientation as (i, j, k, r), scalars,
+// flags and the collider state in x.
+struct BodyEdit
+{
+    BodyField Field{ BodyField::Position };
+    DirectX::XMFLOAT4 Value{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+    static BodyEdit Vector(BodyField field, const DirectX::XMFLOAT3& value);
+    static BodyEdit Scalar(BodyField field, float value);
+    static BodyEdit Flag(BodyField field, bool value);
+    static BodyEdit Rotation(const Quaternion& orientation);
+    static BodyEdit State(ColliderState state);
+
+    //~ Caller owns the body for now (between steps). Fields the collider's shape does not
+    //~ have are ignored.
+    void Apply(ICollider* collider) const;
+};
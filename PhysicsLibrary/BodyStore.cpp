@@ -0,0 +1,718 @@
+#include "pch.h"
+#include "BodyStore.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define BODY_STORE_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    //~ Verlet clamps the acceleration so a single huge force cannot launch a body
+    constexpr float VERLET_MAX_ACCELERATION = 100.0f;
+    //~ Squared speeds below this are snapped to zero
+    constexpr float REST_SPEED_SQ = 1e-5f;
+
+    DirectX::XMVECTOR ClampVectorLength(DirectX::XMVECTOR vec, float maxLength)
+    {
+        using namespace DirectX;
+
+        XMVECTOR lenSq = XMVector3LengthSq(vec);
+        float lengthSquared = XMVectorGetX(lenSq);
+
+        if (lengthSquared > maxLength * maxLength)
+        {
+            XMVECTOR len = XMVectorSqrt(lenSq);
+            vec = XMVectorDivide(XMVectorScale(vec, maxLength), len); // vec * (max / length)
+        }
+
+        return vec;
+    }
+
+    void NormalizeOrientation(BodyStreamQuaternion& q, uint32_t lane)
+    {
+        const float r = q.R[lane];
+        const float i = q.I[lane];
+        const float j = q.J[lane];
+        const float k = q.K[lane];
+
+        const float d = r * r + i * i + j * j + k * k;
+        if (d == 0.f)
+        {
+            q.R[lane] = 1.0f;
+            q.I[lane] = 0.0f;
+            q.J[lane] = 0.0f;
+            q.K[lane] = 0.0f;
+            return;
+        }
+
+        const float inv = 1.0f / std::sqrt(d);
+        q.R[lane] = r * inv;
+        q.I[lane] = i * inv;
+        q.J[lane] = j * inv;
+        q.K[lane] = k * inv;
+    }
+
+    void ApplyLinearDamping(const BodyChunk& chunk, uint32_t lane, DirectX::XMVECTOR& vel, float dt)
+    {
+        vel = DirectX::XMVectorScale(vel, std::pow(chunk.LinearDamping[lane], dt));
+
+        if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(vel)) < REST_SPEED_SQ)
+            vel = DirectX::XMVectorZero();
+    }
+
+    void IntegrateAngular(BodyChunk& chunk, uint32_t lane, float dt)
+    {
+        using namespace DirectX;
+
+        XMVECTOR angVel = chunk.AngularVelocity.Load(lane);
+        const XMVECTOR torque = chunk.Torque.Load(lane);
+
+        const XMMATRIX inverseInertia = chunk.InverseInertiaLocal.Load(lane);
+        const XMVECTOR angularAcc = XMVector3Transform(torque, inverseInertia);
+        angVel = XMVectorAdd(angVel, XMVectorScale(angularAcc, dt));
+        angVel = XMVectorScale(angVel, std::pow(chunk.AngularDamping[lane], dt));
+
+        // q += 0.5 * (0, w * dt) * q
+        BodyStreamQuaternion& q = chunk.Orientation;
+        const float r = q.R[lane];
+        const float i = q.I[lane];
+        const float j = q.J[lane];
+        const float k = q.K[lane];
+
+        const XMVECTOR scaled = XMVectorScale(angVel, dt);
+        const float x = XMVectorGetX(scaled);
+        const float y = XMVectorGetY(scaled);
+        const float z = XMVectorGetZ(scaled);
+
+        q.R[lane] = r + 0.5f * -(i * x + j * y + k * z);
+        q.I[lane] = i + 0.5f * (r * x + j * z - k * y);
+        q.J[lane] = j + 0.5f * (r * y + k * x - i * z);
+        q.K[lane] = k + 0.5f * (r * z + i * y - j * x);
+        NormalizeOrientation(q, lane);
+
+        if (XMVectorGetX(XMVector3LengthSq(angVel)) < REST_SPEED_SQ)
+            angVel = XMVectorZero();
+        chunk.AngularVelocity.Store(lane, angVel);
+    }
+
+    void ClearAccumulators(BodyChunk& chunk, uint32_t lane)
+    {
+        chunk.Force.Store(lane, DirectX::XMVectorZero());
+        chunk.Torque.Store(lane, DirectX::XMVectorZero());
+    }
+
+    template<IntegrationType Type>
+    void IntegrateLinear(BodyChunk& chunk, uint32_t lane, float dt)
+    {
+        using namespace DirectX;
+
+        const float inverseMass = chunk.InverseMass[lane];
+        XMVECTOR pos = chunk.Position.Load(lane);
+
+        if constexpr (Type == IntegrationType::Verlet)
+        {
+            if (chunk.VerletNeedsReset[lane])
+            {
+                chunk.LastPosition.Store(lane, XMVectorSubtract(pos, XMVectorScale(chunk.Velocity.Load(lane), dt)));
+                chunk.VerletNeedsReset[lane] = 0;
+            }
+
+            const XMVECTOR lastPos = chunk.LastPosition.Load(lane);
+            XMVECTOR acceleration = XMVectorAdd(chunk.Acceleration.Load(lane),
+                XMVectorScale(chunk.Force.Load(lane), inverseMass));
+            acceleration = ClampVectorLength(acceleration, VERLET_MAX_ACCELERATION);
+
+            const XMVECTOR posDelta = XMVectorSubtract(pos, lastPos);
+            const XMVECTOR accelTerm = XMVectorScale(acceleration, dt * dt);
+            const XMVECTOR newPos = XMVectorAdd(pos, XMVectorAdd(posDelta, accelTerm));
+
+            XMVECTOR vel = XMVectorScale(posDelta, 1.0f / dt);
+            ApplyLinearDamping(chunk, lane, vel, dt);
+
+            chunk.LastPosition.Store(lane, pos);
+            chunk.Position.Store(lane, newPos);
+            chunk.Velocity.Store(lane, vel);
+        }
+        else
+        {
+            XMVECTOR vel = chunk.Velocity.Load(lane);
+            const XMVECTOR acceleration = XMVectorAdd(chunk.Acceleration.Load(lane),
+                XMVectorScale(chunk.Force.Load(lane), inverseMass));
+
+            if constexpr (Type == IntegrationType::Euler)
+            {
+                pos = XMVectorAdd(pos, XMVectorScale(vel, dt));
+                vel = XMVectorAdd(vel, XMVectorScale(acceleration, dt));
+            }
+            else
+            {
+                vel = XMVectorAdd(vel, XMVectorScale(acceleration, dt));
+                pos = XMVectorAdd(pos, XMVectorScale(vel, dt));
+            }
+            ApplyLinearDamping(chunk, lane, vel, dt);
+
+            chunk.Position.Store(lane, pos);
+            chunk.Velocity.Store(lane, vel);
+        }
+    }
+
+    template<IntegrationType Type>
+    void IntegrateBody(BodyChunk& chunk, uint32_t lane, float dt)
+    {
+        BodyStore::CalculateDerivedData(chunk, lane);
+
+        if (chunk.InverseMass[lane] <= 0.0f) return;
+
+        IntegrateLinear<Type>(chunk, lane, dt);
+        IntegrateAngular(chunk, lane, dt);
+        ClearAccumulators(chunk, lane);
+    }
+
+    template<IntegrationType Type>
+    void IntegrateChunk(BodyChunk& chunk, float dt)
+    {
+        const uint32_t used = chunk.Used.load(std::memory_order_acquire);
+        for (uint32_t lane = 0; lane < used; ++lane)
+        {
+            if (!chunk.Simulated[lane].load(std::memory_order_relaxed) ||
+                !chunk.Awake[lane].load(std::memory_order_relaxed))
+            {
+                continue;
+            }
+            IntegrateBody<Type>(chunk, lane, dt);
+        }
+    }
+
+#if defined(BODY_STORE_SIMD)
+    // Thin wrappers so the batch code below is written once for both register widths.
+    // Select(a, b, mask) picks b where mask is set, like XMVectorSelect.
+    namespace batch
+    {
+#if defined(__AVX__)
+        using Float = __m256;
+        constexpr uint32_t WIDTH = 8;
+
+        inline Float Load(const float* p) { return _mm256_load_ps(p); }
+        inline void Store(float* p, Float v) { _mm256_store_ps(p, v); }
+        inline Float Set(float v) { return _mm256_set1_ps(v); }
+        inline Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+        inline Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+        inline Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+        inline Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+        inline Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+        inline Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        inline Float Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        inline Float Equal(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        inline Float And(Float a, Float b) { return _mm256_and_ps(a, b); }
+        inline Float Select(Float a, Float b, Float mask) { return _mm256_blendv_ps(a, b, mask); }
+        inline int Bits(Float mask) { return _mm256_movemask_ps(mask); }
+        inline Float LoadMask(const int32_t* p)
+        {
+            return _mm256_castsi256_ps(_mm256_load_si256(reinterpret_cast<const __m256i*>(p)));
+        }
+#else
+        using Float = __m128;
+        constexpr uint32_t WIDTH = 4;
+
+        inline Float Load(const float* p) { return _mm_load_ps(p); }
+        inline void Store(float* p, Float v) { _mm_store_ps(p, v); }
+        inline Float Set(float v) { return _mm_set1_ps(v); }
+        inline Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+        inline Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+        inline Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+        inline Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+        inline Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+        inline Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+        inline Float Greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+        inline Float Equal(Float a, Float b) { return _mm_cmpeq_ps(a, b); }
+        inline Float And(Float a, Float b) { return _mm_and_ps(a, b); }
+        inline Float Select(Float a, Float b, Float mask)
+        {
+            return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+        }
+        inline int Bits(Float mask) { return _mm_movemask_ps(mask); }
+        inline Float LoadMask(const int32_t* p)
+        {
+            return _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(p)));
+        }
+#endif
+        //~ Writes only the lanes set in mask, the others keep what is in memory
+        inline void StoreMasked(float* p, Float value, Float mask)
+        {
+            Store(p, Select(Load(p), value, mask));
+        }
+
+        inline Float LengthSq(Float x, Float y, Float z)
+        {
+            return Add(Add(Mul(x, x), Mul(y, y)), Mul(z, z));
+        }
+
+        //~ Same operations as NormalizeOrientation, a zero quaternion becomes the identity
+        inline void Normalize(Float& r, Float& i, Float& j, Float& k)
+        {
+            const Float zero = Set(0.0f);
+            const Float one = Set(1.0f);
+
+            const Float d = Add(Add(Add(Mul(r, r), Mul(i, i)), Mul(j, j)), Mul(k, k));
+            const Float degenerate = Equal(d, zero);
+            const Float inv = Div(one, Sqrt(d));
+
+            r = Select(Mul(r, inv), one, degenerate);
+            i = Select(Mul(i, inv), zero, degenerate);
+            j = Select(Mul(j, inv), zero, degenerate);
+            k = Select(Mul(k, inv), zero, degenerate);
+        }
+    }
+
+    //~ pow(damping, dt) per lane, recomputed only when a damping value or dt changed
+    void RefreshDampingFactors(BodyChunk& chunk, uint32_t used, float dt)
+    {
+        const bool dirty = chunk.DampingDirty.exchange(false, std::memory_order_acq_rel);
+        if (!dirty && chunk.DampingDt == dt) return;
+
+        for (uint32_t lane = 0; lane < used; ++lane)
+        {
+            chunk.LinearDampingFactor[lane] = std::pow(chunk.LinearDamping[lane], dt);
+            chunk.AngularDampingFactor[lane] = std::pow(chunk.AngularDamping[lane], dt);
+        }
+        chunk.DampingDt = dt;
+    }
+
+    // IntegrateBody for batch::WIDTH lanes starting at base. Every lane is computed, the
+    // results are written back only for the active ones (and, past the derived data, only
+    // for bodies with finite mass).
+    template<IntegrationType Type>
+    void IntegrateBatch(BodyChunk& chunk, uint32_t base, uint32_t used, float dt)
+    {
+        using namespace batch;
+
+        alignas(32) int32_t activeBits[WIDTH];
+        alignas(32) int32_t resetBits[WIDTH];
+        for (uint32_t i = 0; i < WIDTH; ++i)
+        {
+            const uint32_t lane = base + i;
+            const bool active = lane < used &&
+                chunk.Simulated[lane].load(std::memory_order_relaxed) &&
+                chunk.Awake[lane].load(std::memory_order_relaxed);
+
+            activeBits[i] = active ? -1 : 0;
+            resetBits[i] = active && chunk.VerletNeedsReset[lane] ? -1 : 0;
+        }
+
+        const Float active = LoadMask(activeBits);
+        if (!Bits(active)) return;
+
+        const Float zero = Set(0.0f);
+        const Float one = Set(1.0f);
+        const Float two = Set(2.0f);
+        const Float half = Set(0.5f);
+        const Float restSpeedSq = Set(REST_SPEED_SQ);
+        const Float step = Set(dt);
+
+        // === Derived data ===
+        Float qr = Load(chunk.Orientation.R + base);
+        Float qi = Load(chunk.Orientation.I + base);
+        Float qj = Load(chunk.Orientation.J + base);
+        Float qk = Load(chunk.Orientation.K + base);
+        Normalize(qr, qi, qj, qk);
+
+        // XMMatrixRotationQuaternion of (x, y, z, w) = (i, j, k, r)
+        Float rot[9];
+        {
+            const Float xx = Mul(qi, qi), yy = Mul(qj, qj), zz = Mul(qk, qk);
+            const Float xy = Mul(qi, qj), xz = Mul(qi, qk), yz = Mul(qj, qk);
+            const Float xw = Mul(qi, qr), yw = Mul(qj, qr), zw = Mul(qk, qr);
+
+            rot[0] = Sub(one, Mul(two, Add(yy, zz)));
+            rot[1] = Mul(two, Add(xy, zw));
+            rot[2] = Mul(two, Sub(xz, yw));
+            rot[3] = Mul(two, Sub(xy, zw));
+            rot[4] = Sub(one, Mul(two, Add(xx, zz)));
+            rot[5] = Mul(two, Add(yz, xw));
+            rot[6] = Mul(two, Add(xz, yw));
+            rot[7] = Mul(two, Sub(yz, xw));
+            rot[8] = Sub(one, Mul(two, Add(xx, yy)));
+        }
+
+        Float local[9];
+        for (int n = 0; n < 9; ++n) local[n] = Load(chunk.InverseInertiaLocal.M[n] + base);
+
+        // world = rot * local * rot^T
+        Float rotLocal[9];
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int col = 0; col < 3; ++col)
+            {
+                rotLocal[row * 3 + col] = Add(Add(
+                    Mul(rot[row * 3 + 0], local[0 * 3 + col]),
+                    Mul(rot[row * 3 + 1], local[1 * 3 + col])),
+                    Mul(rot[row * 3 + 2], local[2 * 3 + col]));
+            }
+        }
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int col = 0; col < 3; ++col)
+            {
+                const Float world = Add(Add(
+                    Mul(rotLocal[row * 3 + 0], rot[col * 3 + 0]),
+                    Mul(rotLocal[row * 3 + 1], rot[col * 3 + 1])),
+                    Mul(rotLocal[row * 3 + 2], rot[col * 3 + 2]));
+                StoreMasked(chunk.InverseInertiaWorld.M[row * 3 + col] + base, world, active);
+            }
+        }
+
+        const Float inverseMass = Load(chunk.InverseMass + base);
+        const Float moving = And(active, Greater(inverseMass, zero));
+        if (!Bits(moving))
+        {
+            StoreMasked(chunk.Orientation.R + base, qr, active);
+            StoreMasked(chunk.Orientation.I + base, qi, active);
+            StoreMasked(chunk.Orientation.J + base, qj, active);
+            StoreMasked(chunk.Orientation.K + base, qk, active);
+            return;
+        }
+
+        // === Linear ===
+        Float px = Load(chunk.Position.X + base);
+        Float py = Load(chunk.Position.Y + base);
+        Float pz = Load(chunk.Position.Z + base);
+        Float vx = Load(chunk.Velocity.X + base);
+        Float vy = Load(chunk.Velocity.Y + base);
+        Float vz = Load(chunk.Velocity.Z + base);
+
+        Float ax = Add(Load(chunk.Acceleration.X + base), Mul(Load(chunk.Force.X + base), inverseMass));
+        Float ay = Add(Load(chunk.Acceleration.Y + base), Mul(Load(chunk.Force.Y + base), inverseMass));
+        Float az = Add(Load(chunk.Acceleration.Z + base), Mul(Load(chunk.Force.Z + base), inverseMass));
+
+        if constexpr (Type == IntegrationType::Verlet)
+        {
+            const Float reset = And(LoadMask(resetBits), moving);
+            const Float lx = Select(Load(chunk.LastPosition.X + base), Sub(px, Mul(vx, step)), reset);
+            const Float ly = Select(Load(chunk.LastPosition.Y + base), Sub(py, Mul(vy, step)), reset);
+            const Float lz = Select(Load(chunk.LastPosition.Z + base), Sub(pz, Mul(vz, step)), reset);
+
+            if (Bits(reset))
+            {
+                for (uint32_t i = 0; i < WIDTH; ++i)
+                {
+                    if (Bits(reset) & (1 << i)) chunk.VerletNeedsReset[base + i] = 0;
+                }
+            }
+
+            // ClampVectorLength
+            const Float maxAcc = Set(VERLET_MAX_ACCELERATION);
+            const Float accLenSq = LengthSq(ax, ay, az);
+            const Float clamp = Greater(accLenSq, Set(VERLET_MAX_ACCELERATION * VERLET_MAX_ACCELERATION));
+            const Float accLen = Sqrt(accLenSq);
+            ax = Select(ax, Div(Mul(ax, maxAcc), accLen), clamp);
+            ay = Select(ay, Div(Mul(ay, maxAcc), accLen), clamp);
+            az = Select(az, Div(Mul(az, maxAcc), accLen), clamp);
+
+            const Float dx = Sub(px, lx);
+            const Float dy = Sub(py, ly);
+            const Float dz = Sub(pz, lz);
+            const Float stepSq = Set(dt * dt);
+            const Float inverseStep = Set(1.0f / dt);
+
+            StoreMasked(chunk.LastPosition.X + base, px, moving);
+            StoreMasked(chunk.LastPosition.Y + base, py, moving);
+            StoreMasked(chunk.LastPosition.Z + base, pz, moving);
+
+            px = Add(px, Add(dx, Mul(ax, stepSq)));
+            py = Add(py, Add(dy, Mul(ay, stepSq)));
+            pz = Add(pz, Add(dz, Mul(az, stepSq)));
+            vx = Mul(dx, inverseStep);
+            vy = Mul(dy, inverseStep);
+            vz = Mul(dz, inverseStep);
+        }
+        else if constexpr (Type == IntegrationType::Euler)
+        {
+            px = Add(px, Mul(vx, step));
+            py = Add(py, Mul(vy, step));
+            pz = Add(pz, Mul(vz, step));
+            vx = Add(vx, Mul(ax, step));
+            vy = Add(vy, Mul(ay, step));
+            vz = Add(vz, Mul(az, step));
+        }
+        else
+        {
+            vx = Add(vx, Mul(ax, step));
+            vy = Add(vy, Mul(ay, step));
+            vz = Add(vz, Mul(az, step));
+            px = Add(px, Mul(vx, step));
+            py = Add(py, Mul(vy, step));
+            pz = Add(pz, Mul(vz, step));
+        }
+
+        const Float linearFactor = Load(chunk.LinearDampingFactor + base);
+        vx = Mul(vx, linearFactor);
+        vy = Mul(vy, linearFactor);
+        vz = Mul(vz, linearFactor);
+
+        const Float linearRest = Less(LengthSq(vx, vy, vz), restSpeedSq);
+        vx = Select(vx, zero, linearRest);
+        vy = Select(vy, zero, linearRest);
+        vz = Select(vz, zero, linearRest);
+
+        StoreMasked(chunk.Position.X + base, px, moving);
+        StoreMasked(chunk.Position.Y + base, py, moving);
+        StoreMasked(chunk.Position.Z + base, pz, moving);
+        StoreMasked(chunk.Velocity.X + base, vx, moving);
+        StoreMasked(chunk.Velocity.Y + base, vy, moving);
+        StoreMasked(chunk.Velocity.Z + base, vz, moving);
+
+        // === Angular ===
+        const Float tx = Load(chunk.Torque.X + base);
+        const Float ty = Load(chunk.Torque.Y + base);
+        const Float tz = Load(chunk.Torque.Z + base);
+
+        // torque * local inverse inertia, as XMVector3Transform
+        Float wx = Load(chunk.AngularVelocity.X + base);
+        Float wy = Load(chunk.AngularVelocity.Y + base);
+        Float wz = Load(chunk.AngularVelocity.Z + base);
+        wx = Add(wx, Mul(Add(Add(Mul(tx, local[0]), Mul(ty, local[3])), Mul(tz, local[6])), step));
+        wy = Add(wy, Mul(Add(Add(Mul(tx, local[1]), Mul(ty, local[4])), Mul(tz, local[7])), step));
+        wz = Add(wz, Mul(Add(Add(Mul(tx, local[2]), Mul(ty, local[5])), Mul(tz, local[8])), step));
+
+        const Float angularFactor = Load(chunk.AngularDampingFactor + base);
+        wx = Mul(wx, angularFactor);
+        wy = Mul(wy, angularFactor);
+        wz = Mul(wz, angularFactor);
+
+        // q += 0.5 * (0, w * dt) * q
+        const Float sx = Mul(wx, step);
+        const Float sy = Mul(wy, step);
+        const Float sz = Mul(wz, step);
+
+        Float nr = Sub(qr, Mul(half, Add(Add(Mul(qi, sx), Mul(qj, sy)), Mul(qk, sz))));
+        Float ni = Add(qi, Mul(half, Sub(Add(Mul(qr, sx), Mul(qj, sz)), Mul(qk, sy))));
+        Float nj = Add(qj, Mul(half, Sub(Add(Mul(qr, sy), Mul(qk, sx)), Mul(qi, sz))));
+        Float nk = Add(qk, Mul(half, Sub(Add(Mul(qr, sz), Mul(qi, sy)), Mul(qj, sx))));
+        Normalize(nr, ni, nj, nk);
+
+        // Infinite mass bodies keep the orientation normalized above
+        StoreMasked(chunk.Orientation.R + base, Select(qr, nr, moving), active);
+        StoreMasked(chunk.Orientation.I + base, Select(qi, ni, moving), active);
+        StoreMasked(chunk.Orientation.J + base, Select(qj, nj, moving), active);
+        StoreMasked(chunk.Orientation.K + base, Select(qk, nk, moving), active);
+
+        const Float angularRest = Less(LengthSq(wx, wy, wz), restSpeedSq);
+        StoreMasked(chunk.AngularVelocity.X + base, Select(wx, zero, angularRest), moving);
+        StoreMasked(chunk.AngularVelocity.Y + base, Select(wy, zero, angularRest), moving);
+        StoreMasked(chunk.AngularVelocity.Z + base, Select(wz, zero, angularRest), moving);
+
+        // === Clear accumulators ===
+        StoreMasked(chunk.Force.X + base, zero, moving);
+        StoreMasked(chunk.Force.Y + base, zero, moving);
+        StoreMasked(chunk.Force.Z + base, zero, moving);
+        StoreMasked(chunk.Torque.X + base, zero, moving);
+        StoreMasked(chunk.Torque.Y + base, zero, moving);
+        StoreMasked(chunk.Torque.Z + base, zero, moving);
+    }
+
+    template<IntegrationType Type>
+    void IntegrateChunkBatched(BodyChunk& chunk, float dt)
+    {
+        const uint32_t used = chunk.Used.load(std::memory_order_acquire);
+        RefreshDampingFactors(chunk, used, dt);
+
+        for (uint32_t base = 0; base < used; base += batch::WIDTH)
+        {
+            IntegrateBatch<Type>(chunk, base, used, dt);
+        }
+    }
+#endif
+}
+
+BodyStore::~BodyStore()
+{
+    for (std::atomic<BodyChunk*>& chunk : m_Chunks)
+    {
+        delete chunk.load(std::memory_order_relaxed);
+    }
+}
+
+BodyStore& BodyStore::Get()
+{
+    // Never destroyed, bodies owned by other statics may be released after main returns
+    static BodyStore* store = new BodyStore();
+    return *store;
+}
+
+bool BodyStore::AttachWorld(const PhysicsWorld* world)
+{
+    const PhysicsWorld* expected = nullptr;
+    return m_World.compare_exchange_strong(expected, world, std::memory_order_acq_rel);
+}
+
+void BodyStore::DetachWorld(const PhysicsWorld* world)
+{
+    const PhysicsWorld* expected = world;
+    m_World.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+}
+
+BodyHandle BodyStore::Allocate()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    BodyHandle handle = INVALID_HANDLE;
+    if (!m_FreeHandles.empty())
+    {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+        ResetLane(*GetChunk(handle), GetLane(handle));
+    }
+    else
+    {
+        uint32_t chunkCount = m_ChunkCount.load(std::memory_order_relaxed);
+        BodyChunk* chunk = chunkCount > 0 ? m_Chunks[chunkCount - 1].load(std::memory_order_relaxed) : nullptr;
+
+        if (!chunk || chunk->Used.load(std::memory_order_relaxed) == BODY_CHUNK_SIZE)
+        {
+            if (chunkCount == MAX_CHUNKS)
+            {
+                throw std::length_error("BodyStore is full: " + std::to_string(MAX_CHUNKS * BODY_CHUNK_SIZE) + " bodies");
+            }
+
+            chunk = new BodyChunk();
+            m_Chunks[chunkCount].store(chunk, std::memory_order_release);
+            m_ChunkCount.store(++chunkCount, std::memory_order_release);
+        }
+
+        const uint32_t lane = chunk->Used.load(std::memory_order_relaxed);
+        ResetLane(*chunk, lane);
+        // Published after the reset so the integrator never sees a half written lane
+        chunk->Used.store(lane + 1, std::memory_order_release);
+        handle = ((chunkCount - 1) << BODY_CHUNK_SHIFT) | lane;
+    }
+
+    ++m_LiveCount;
+    return handle;
+}
+
+void BodyStore::Release(BodyHandle handle)
+{
+    if (handle == INVALID_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    BodyChunk* chunk = GetChunk(handle);
+    chunk->Simulated[GetLane(handle)].store(0, std::memory_order_release);
+    chunk->Generation[GetLane(handle)].fetch_add(1, std::memory_order_relaxed);
+    m_FreeHandles.push_back(handle);
+    --m_LiveCount;
+}
+
+size_t BodyStore::GetLiveCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_LiveCount;
+}
+
+void BodyStore::Integrate(float dt, IntegrationType type)
+{
+    const uint32_t chunkCount = m_ChunkCount.load(std::memory_order_acquire);
+    for (uint32_t c = 0; c < chunkCount; ++c)
+    {
+        BodyChunk& chunk = *m_Chunks[c].load(std::memory_order_acquire);
+
+        // One switch per chunk, not per body
+#if defined(BODY_STORE_SIMD)
+        switch (type)
+        {
+        case IntegrationType::Euler:
+            IntegrateChunkBatched<IntegrationType::Euler>(chunk, dt);
+            break;
+        case IntegrationType::SemiImplicitEuler:
+            IntegrateChunkBatched<IntegrationType::SemiImplicitEuler>(chunk, dt);
+            break;
+        case IntegrationType::Verlet:
+            IntegrateChunkBatched<IntegrationType::Verlet>(chunk, dt);
+            break;
+        }
+#else
+        switch (type)
+        {
+        case IntegrationType::Euler:
+            IntegrateChunk<IntegrationType::Euler>(chunk, dt);
+            break;
+        case IntegrationType::SemiImplicitEuler:
+            IntegrateChunk<IntegrationType::SemiImplicitEuler>(chunk, dt);
+            break;
+        case IntegrationType::Verlet:
+            IntegrateChunk<IntegrationType::Verlet>(chunk, dt);
+            break;
+        }
+#endif
+    }
+}
+
+uint32_t BodyStore::GetBatchWidth()
+{
+#if defined(BODY_STORE_SIMD)
+    return batch::WIDTH;
+#else
+    return 1;
+#endif
+}
+
+void BodyStore::IntegrateLane(BodyChunk& chunk, uint32_t lane, float dt, IntegrationType type)
+{
+    switch (type)
+    {
+    case IntegrationType::Euler:
+        IntegrateBody<IntegrationType::Euler>(chunk, lane, dt);
+        break;
+    case IntegrationType::SemiImplicitEuler:
+        IntegrateBody<IntegrationType::SemiImplicitEuler>(chunk, lane, dt);
+        break;
+    case IntegrationType::Verlet:
+        IntegrateBody<IntegrationType::Verlet>(chunk, lane, dt);
+        break;
+    }
+}
+
+void BodyStore::CalculateDerivedData(BodyChunk& chunk, uint32_t lane)
+{
+    using namespace DirectX;
+
+    NormalizeOrientation(chunk.Orientation, lane); // Prevent drift
+
+    const XMMATRIX rotMatrix = XMMatrixRotationQuaternion(chunk.Orientation.Load(lane));
+    const XMMATRIX rotTranspose = XMMatrixTranspose(rotMatrix);
+    const XMMATRIX local = chunk.InverseInertiaLocal.Load(lane);
+
+    chunk.InverseInertiaWorld.Store(lane, XMMatrixMultiply(XMMatrixMultiply(rotMatrix, local), rotTranspose));
+}
+
+void BodyStore::ResetLane(BodyChunk& chunk, uint32_t lane)
+{
+    using namespace DirectX;
+
+    const XMVECTOR zero = XMVectorZero();
+    chunk.Position.Store(lane, zero);
+    chunk.LastPosition.Store(lane, zero);
+    chunk.Velocity.Store(lane, zero);
+    chunk.Acceleration.Store(lane, zero);
+    chunk.Force.Store(lane, zero);
+    chunk.AngularVelocity.Store(lane, zero);
+    chunk.Torque.Store(lane, zero);
+    chunk.Orientation.Store(lane, XMQuaternionIdentity());
+
+    chunk.InverseMass[lane] = 1.0f;
+    chunk.LinearDamping[lane] = 0.75f;
+    chunk.AngularDamping[lane] = 0.39f;
+    chunk.DampingDirty.store(true, std::memory_order_release);
+
+    chunk.InverseInertiaLocal.Store(lane, XMMatrixIdentity());
+    chunk.InverseInertiaWorld.Store(lane, XMMatrixIdentity());
+
+    chunk.VerletNeedsReset[lane] = 0;
+    chunk.Awake[lane].store(1, std::memory_order_relaxed);
+    chunk.Simulated[lane].store(0, std::memory_order_relaxed);
+}
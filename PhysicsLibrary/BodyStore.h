@@ -0,0 +1,198 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "IntegrationType.h"
+
+class PhysicsWorld;
+
+//~ Stable index of a body in the store: chunk in the high bits, lane in the low ones
+using BodyHandle = uint32_t;
+
+constexpr uint32_t BODY_CHUNK_SHIFT = 10;
+constexpr uint32_t BODY_CHUNK_SIZE = 1u << BODY_CHUNK_SHIFT;
+
+// One float array per component, so a loop over the bodies walks each component contiguously
+struct BodyStream3
+{
+    alignas(64) float X[BODY_CHUNK_SIZE];
+    alignas(64) float Y[BODY_CHUNK_SIZE];
+    alignas(64) float Z[BODY_CHUNK_SIZE];
+
+    DirectX::XMVECTOR Load(uint32_t lane) const
+    {
+        return DirectX::XMVectorSet(X[lane], Y[lane], Z[lane], 0.0f);
+    }
+
+    void Store(uint32_t lane, DirectX::FXMVECTOR value)
+    {
+        X[lane] = DirectX::XMVectorGetX(value);
+        Y[lane] = DirectX::XMVectorGetY(value);
+        Z[lane] = DirectX::XMVectorGetZ(value);
+    }
+};
+
+// Quaternion components, same naming as Quaternion (R is the scalar part)
+struct BodyStreamQuaternion
+{
+    alignas(64) float R[BODY_CHUNK_SIZE];
+    alignas(64) float I[BODY_CHUNK_SIZE];
+    alignas(64) float J[BODY_CHUNK_SIZE];
+    alignas(64) float K[BODY_CHUNK_SIZE];
+
+    //~ (i, j, k, r), the layout of Quaternion::ToXmVector
+    DirectX::XMVECTOR Load(uint32_t lane) const
+    {
+        return DirectX::XMVectorSet(I[lane], J[lane], K[lane], R[lane]);
+    }
+
+    void Store(uint32_t lane, DirectX::FXMVECTOR value)
+    {
+        I[lane] = DirectX::XMVectorGetX(value);
+        J[lane] = DirectX::XMVectorGetY(value);
+        K[lane] = DirectX::XMVectorGetZ(value);
+        R[lane] = DirectX::XMVectorGetW(value);
+    }
+};
+
+// 3x3 matrix as nine arrays, M[row * 3 + column]
+struct BodyStreamMatrix3
+{
+    alignas(64) float M[9][BODY_CHUNK_SIZE];
+
+    //~ Same layout as XMLoadFloat3x3, the fourth row is (0, 0, 0, 1)
+    DirectX::XMMATRIX Load(uint32_t lane) const
+    {
+        return DirectX::XMMATRIX{
+            DirectX::XMVectorSet(M[0][lane], M[1][lane], M[2][lane], 0.0f),
+            DirectX::XMVectorSet(M[3][lane], M[4][lane], M[5][lane], 0.0f),
+            DirectX::XMVectorSet(M[6][lane], M[7][lane], M[8][lane], 0.0f),
+            DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f) };
+    }
+
+    void Store(uint32_t lane, DirectX::FXMMATRIX value)
+    {
+        for (int row = 0; row < 3; ++row)
+        {
+            M[row * 3 + 0][lane] = DirectX::XMVectorGetX(value.r[row]);
+            M[row * 3 + 1][lane] = DirectX::XMVectorGetY(value.r[row]);
+            M[row * 3 + 2][lane] = DirectX::XMVectorGetZ(value.r[row]);
+        }
+    }
+};
+
+// A fixed block of bodies. Chunks are never moved or freed while the store lives, so a
+// pointer into one stays valid while other threads allocate new bodies.
+struct alignas(64) BodyChunk
+{
+    BodyStream3 Position;
+    BodyStream3 LastPosition;
+    BodyStream3 Velocity;
+    BodyStream3 Acceleration;
+    BodyStream3 Force;
+    BodyStream3 AngularVelocity;
+    BodyStream3 Torque;
+    BodyStreamQuaternion Orientation;
+
+    alignas(64) float InverseMass[BODY_CHUNK_SIZE];
+    alignas(64) float LinearDamping[BODY_CHUNK_SIZE];
+    alignas(64) float AngularDamping[BODY_CHUNK_SIZE];
+
+    // pow(damping, DampingDt), refreshed by Integrate when dt or a damping value changes
+    alignas(64) float LinearDampingFactor[BODY_CHUNK_SIZE];
+    alignas(64) float AngularDampingFactor[BODY_CHUNK_SIZE];
+    float DampingDt{ 0.0f };
+    std::atomic<bool> DampingDirty{ true };
+
+    BodyStreamMatrix3 InverseInertiaLocal;
+    BodyStreamMatrix3 InverseInertiaWorld;
+
+    uint8_t VerletNeedsReset[BODY_CHUNK_SIZE];
+    //~ Bumped whenever a lane is released, tells a reused handle from the body that held it before
+    std::atomic<uint32_t> Generation[BODY_CHUNK_SIZE];
+    // Written from other threads (waking, registering) while the physics thread reads them
+    std::atomic<uint8_t> Awake[BODY_CHUNK_SIZE];
+    std::atomic<uint8_t> Simulated[BODY_CHUNK_SIZE];
+
+    //~ Lanes [0, Used) have been handed out at least once
+    std::atomic<uint32_t> Used{ 0 };
+};
+
+//~ A body's lane resolved to its chunk, for loops that gather from bodies of any store and
+//~ scatter back
+struct BodyLane
+{
+    BodyChunk* Chunk{ nullptr };
+    uint32_t Lane{ 0 };
+};
+
+// Structure of arrays storage for every RigidBody. RigidBody is a view holding its handle,
+// the hot state (pose, velocities, accumulators, mass and inertia) lives here so the
+// integrator runs as one loop over contiguous arrays instead of one call per body.
+// On x86 Integrate advances GetBatchWidth() bodies per instruction (4 with SSE2, 8 when
+// built for AVX); inactive lanes of a batch are computed and then masked out.
+// Allocate and Release may be called from any thread; Integrate only visits lanes marked
+// Simulated, which the physics thread owns. A store is stepped by one PhysicsWorld at a
+// time, a world meant to run beside another (ReplayPlayer) gets a store of its own.
+class BodyStore
+{
+public:
+    static constexpr uint32_t MAX_CHUNKS = 1024;
+    static constexpr BodyHandle INVALID_HANDLE = 0xFFFFFFFFu;
+
+    BodyStore() = default;
+    ~BodyStore();
+
+    BodyStore(const BodyStore&) = delete;
+    BodyStore& operator=(const BodyStore&) = delete;
+
+    //~ The store RigidBody and PhysicsWorld use unless they are given another one
+    static BodyStore& Get();
+
+    //~ False while another world is attached, its steps would integrate this world's bodies
+    bool AttachWorld(const PhysicsWorld* world);
+    void DetachWorld(const PhysicsWorld* world);
+
+    //~ Returns a lane reset to the RigidBody defaults. Throws std::length_error once MAX_CHUNKS
+    //~ are full, so no body is ever built on a handle without storage.
+    BodyHandle Allocate();
+    void Release(BodyHandle handle);
+
+    BodyChunk* GetChunk(BodyHandle handle) const
+    {
+        return m_Chunks[handle >> BODY_CHUNK_SHIFT].load(std::memory_order_acquire);
+    }
+    static uint32_t GetLane(BodyHandle handle) { return handle & (BODY_CHUNK_SIZE - 1); }
+    uint32_t GetGeneration(BodyHandle handle) const
+    {
+        return GetChunk(handle)->Generation[GetLane(handle)].load(std::memory_order_relaxed);
+    }
+
+    size_t GetLiveCount() const;
+
+    //~ Integrates every simulated, awake body
+    void Integrate(float dt, IntegrationType type);
+    //~ Bodies per batch of Integrate, 1 without SIMD support
+    static uint32_t GetBatchWidth();
+
+    //~ Integrates one body, what RigidBody::Integrate runs
+    static void IntegrateLane(BodyChunk& chunk, uint32_t lane, float dt, IntegrationType type);
+    //~ Renormalizes the orientation and rotates the inverse inertia tensor into world space
+    static void CalculateDerivedData(BodyChunk& chunk, uint32_t lane);
+
+private:
+    static void ResetLane(BodyChunk& chunk, uint32_t lane);
+
+private:
+    mutable std::mutex m_Mutex;
+    std::atomic<BodyChunk*> m_Chunks[MAX_CHUNKS]{};
+    std::atomic<uint32_t> m_ChunkCount{ 0 };
+    std::vector<BodyHandle> m_FreeHandles;
+    size_t m_LiveCount{ 0 };
+    std::atomic<const PhysicsWorld*> m_World{ nullptr };
+};
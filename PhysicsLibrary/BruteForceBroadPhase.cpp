@@ -0,0 +1,45 @@
+#include "pch.h"
+#include "BruteForceBroadPhase.h"
+
+void BruteForceBroadPhase::Update(const std::vector<ICollider*>& colliders)
+{
+    m_Pairs.clear();
+
+    m_Bounds.resize(colliders.size());
+    for (size_t i = 0; i < colliders.size(); ++i)
+    {
+        m_Bounds[i] = colliders[i]->GetWorldAABB();
+    }
+
+    for (size_t i = 0; i < colliders.size(); ++i)
+    {
+        for (size_t j = i + 1; j < colliders.size(); ++j)
+        {
+            if (!m_Bounds[i].Overlaps(m_Bounds[j])) continue;
+            if (!ShouldTestPair(colliders[i], colliders[j])) continue;
+
+            m_Pairs.push_back({ colliders[i], colliders[j] });
+        }
+    }
+}
+
+void BruteForceBroadPhase::Remove(ICollider*)
+{
+    // Nothing is kept per collider between steps
+}
+
+void BruteForceBroadPhase::Clear()
+{
+    m_Pairs.clear();
+    m_Bounds.clear();
+}
+
+BroadPhaseType BruteForceBroadPhase::GetType() const
+{
+    return BroadPhaseType::BruteForce;
+}
+
+const char* BruteForceBroadPhase::GetName() const
+{
+    return "Brute Force";
+}
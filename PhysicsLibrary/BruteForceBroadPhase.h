@@ -0,0 +1,17 @@
+#pragma once
+
+#include "IBroadPhase.h"
+
+// Tests every pair's AABB, O(n^2). Kept as the reference for the other broadphases
+class BruteForceBroadPhase final : public IBroadPhase
+{
+public:
+    void Update(const std::vector<ICollider*>& colliders) override;
+    void Remove(ICollider* collider) override;
+    void Clear() override;
+    BroadPhaseType GetType() const override;
+    const char* GetName() const override;
+
+private:
+    std::vector<AABB> m_Bounds;
+};
@@ -5,33 +5,12 @@
 #include <cmath>
 #include <algorithm>
 
-#include "CubeCollider.h"
-#include "SphereCollider.h"
-
 CapsuleCollider::CapsuleCollider(RigidBody* body)
     : ICollider(body)
 {
     m_RigidBody->ComputeInverseInertiaTensorCapsule(m_Radius, m_Height);
 }
 
-bool CapsuleCollider::CheckCollision(ICollider* other, Contact& outContact)
-{
-    if (other->GetColliderType() == ColliderType::Capsule)
-    {
-        return CheckCollisionWithCapsule(other, outContact);
-    }
-    if (other->GetColliderType() == ColliderType::Cube)
-    {
-        return CheckCollisionWithCube(other, outContact);
-    }
-    if (other->GetColliderType() == ColliderType::Sphere)
-    {
-        return CheckCollisionWithSphere(other, outContact);
-    }
-
-    return false;
-}
-
 ColliderType CapsuleCollider::GetColliderType() const
 {
     return ColliderType::Capsule;
@@ -89,6 +68,7 @@ void CapsuleCollider::SetScale(const DirectX::XMVECTOR& vector)
     m_Scale = vector;
     m_Radius = avgRadius;
     m_Height = height;
+    m_RigidBody->WakeUp();
     m_RigidBody->ComputeInverseInertiaTensorCapsule(m_Radius, m_Height);
 }
 
@@ -98,15 +78,45 @@ DirectX::XMVECTOR CapsuleCollider::GetScale() const
     return scale;
 }
 
-bool CapsuleCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outContact)
+AABB CapsuleCollider::ComputeWorldAABB() const
 {
     using namespace DirectX;
 
-    if (!other || other->GetColliderType() != ColliderType::Capsule)
-        return false;
+    // Sphere and cube tests use the full height as the segment, capsule-capsule a shorter one.
+    // Bound the longer so no path gets rejected early.
+    const XMVECTOR up = m_RigidBody->GetOrientation().RotateVector(XMVectorSet(0, 1, 0, 0));
+    XMVECTOR extents = XMVectorAbs(XMVectorScale(up, m_Height * 0.5f));
+    extents = XMVectorAdd(extents, XMVectorReplicate(m_Radius));
+
+    XMFLOAT3 center, ext;
+    XMStoreFloat3(&center, m_RigidBody->GetPosition());
+    XMStoreFloat3(&ext, extents);
+    return AABB::FromCenterExtents(center, ext);
+}
+
+DirectX::XMVECTOR CapsuleCollider::Support(const DirectX::XMVECTOR& direction) const
+{
+    using namespace DirectX;
+
+    // Core is the segment the sphere and cube tests use, the same one the bounds are built from
+    const XMVECTOR up = m_RigidBody->GetOrientation().RotateVector(XMVectorSet(0, 1, 0, 0));
+    const float halfSegment = XMVectorGetX(XMVector3Dot(up, direction)) < 0.0f ? -m_Height * 0.5f : m_Height * 0.5f;
+    return XMVectorMultiplyAdd(up, XMVectorReplicate(halfSegment), m_RigidBody->GetPosition());
+}
+
+BoundingSphere CapsuleCollider::ComputeBoundingSphere() const
+{
+    BoundingSphere sphere;
+    DirectX::XMStoreFloat3(&sphere.Center, m_RigidBody->GetPosition());
+    sphere.Radius = m_Height * 0.5f + m_Radius;
+    return sphere;
+}
 
-    CapsuleCollider* capsuleB = other->As<CapsuleCollider>();
-    if (!capsuleB) return false;
+bool CapsuleCollider::CheckCollisionWith(CapsuleCollider& other, Contact& outContact)
+{
+    using namespace DirectX;
+
+    CapsuleCollider* capsuleB = &other;
 
     RigidBody* bodyA = this->GetRigidBody();
     RigidBody* bodyB = capsuleB->GetRigidBody();
@@ -141,7 +151,7 @@ bool CapsuleCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outCo
     float s = 0.0f, t = 0.0f;
     ClosestPtSegmentSegment(a1, a2, b1, b2, p1, p2, s, t);
 
-    XMVECTOR delta = p1 - p2;
+    XMVECTOR delta = p2 - p1;
     float distSq = XMVectorGetX(XMVector3LengthSq(delta));
     float combinedRadius = radiusA + radiusB;
 
@@ -157,7 +167,7 @@ bool CapsuleCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outCo
     XMVECTOR contactPoint = 0.5f * (p1 + p2);
 
     outContact.Colliders[0] = this;
-    outContact.Colliders[1] = other;
+    outContact.Colliders[1] = capsuleB;
     XMStoreFloat3(&outContact.ContactPoint, contactPoint);
     XMStoreFloat3(&outContact.ContactNormal, normal);
     outContact.PenetrationDepth = combinedRadius - dist;
@@ -169,151 +179,6 @@ bool CapsuleCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outCo
     return true;
 }
 
-bool CapsuleCollider::CheckCollisionWithSphere(ICollider* other, Contact& outContact)
-{
-    using namespace DirectX;
-
-    if (!other || other->GetColliderType() != ColliderType::Sphere)
-        return false;
-
-    SphereCollider* sphere = other->As<SphereCollider>();
-    if (!sphere) return false;
-
-    RigidBody* bodyA = GetRigidBody();    // Capsule
-    RigidBody* bodyB = sphere->GetRigidBody(); // Sphere
-
-    if (!bodyA || !bodyB) return false;
-
-    XMVECTOR capsuleCenter = bodyA->GetPosition();
-    XMVECTOR sphereCenter = bodyB->GetPosition();
-
-    const Quaternion q = bodyA->GetOrientation();
-    XMVECTOR up = q.RotateVector(XMVectorSet(0, 1, 0, 0));
-
-    float capsuleHeight = GetHeight();
-    float capsuleRadius = GetRadius();
-
-    float sphereRadius = sphere->GetRadius();
-
-    float halfSegmentLen = 0.5f * (capsuleHeight - 2.0f * capsuleRadius);
-
-    // Capsule segment endpoints
-    XMVECTOR a = capsuleCenter + up * halfSegmentLen;
-    XMVECTOR b = capsuleCenter - up * halfSegmentLen;
-
-    // Find closest point on capsule segment to sphere center
-    XMVECTOR ab = b - a;
-    XMVECTOR ap = sphereCenter - a;
-
-    float denom = XMVectorGetX(XMVector3Dot(ab, ab));
-    float t = 0.0f;
-
-    if (denom > 1e-6f) // small epsilon to avoid divide-by-zero
-    {
-        t = std::clamp(
-            XMVectorGetX(XMVector3Dot(ap, ab)) / denom,
-            0.0f, 1.0f
-        );
-    }
-    else
-    {
-        t = 0.0f; // default to start of segment when degenerate
-    }
-
-    XMVECTOR closest = a + ab * t;
-
-    XMVECTOR diff = sphereCenter - closest;
-    float distSq = XMVectorGetX(XMVector3LengthSq(diff));
-    float totalRadius = capsuleRadius + sphereRadius;
-
-    if (distSq > totalRadius * totalRadius)
-        return false; // No collision
-
-    float distance = std::sqrt(distSq);
-    XMVECTOR normal = (distance > 1e-6f) ? XMVector3Normalize(diff) : XMVectorSet(1, 0, 0, 0);
-
-    outContact.Colliders[0] = this;
-    outContact.Colliders[1] = other;
-    XMStoreFloat3(&outContact.ContactPoint, closest);
-    XMStoreFloat3(&outContact.ContactNormal, normal);
-    outContact.PenetrationDepth = totalRadius - distance;
-
-    outContact.Restitution = 0.5f * (
-        bodyA->GetRestitution() + bodyB->GetRestitution());
-
-    outContact.Friction = 0.5f * (
-        bodyA->GetFriction() + bodyB->GetFriction());
-
-    outContact.Elasticity = 0.5f * (
-        bodyA->GetElasticity() + bodyB->GetElasticity());
-
-    return true;
-}
-
-bool CapsuleCollider::CheckCollisionWithCube(ICollider* other, Contact& outContact)
-{
-    using namespace DirectX;
-
-    if (!other || other->GetColliderType() != ColliderType::Cube)
-        return false;
-
-    CubeCollider* cube = other->As<CubeCollider>();
-    if (!cube) return false;
-
-    RigidBody* capsuleBody = GetRigidBody();
-    RigidBody* cubeBody = cube->GetRigidBody();
-    if (!capsuleBody || !cubeBody) return false;
-
-    const XMVECTOR capsulePos = capsuleBody->GetPosition();
-    const Quaternion capsuleRot = capsuleBody->GetOrientation();
-    const XMVECTOR up = capsuleRot.RotateVector(XMVectorSet(0, 1, 0, 0));
-
-    const float capsuleHeight = GetHeight();
-    const float capsuleRadius = GetRadius();
-    const float halfSegment = 0.5f * (capsuleHeight - 2.0f * capsuleRadius);
-
-    // Define capsule segment (between sphere centers)
-    XMVECTOR a = capsulePos + up * halfSegment;
-    XMVECTOR b = capsulePos - up * halfSegment;
-
-    // OBB box data
-    const XMVECTOR boxPos = cubeBody->GetPosition();
-    const Quaternion boxRot = cubeBody->GetOrientation();
-    const XMVECTOR halfExtents = cube->GetHalfExtents();
-
-    XMVECTOR axes[3];
-    cube->GetOBBAxes(boxRot, axes);
-
-    XMVECTOR closestCapsulePt, closestBoxPt;
-    ClosestPtSegmentOBB(a, b, boxPos, axes, halfExtents, closestCapsulePt, closestBoxPt);
-
-    XMVECTOR diff = closestCapsulePt - closestBoxPt;
-    float distSq = XMVectorGetX(XMVector3LengthSq(diff));
-
-    // === Collision Slop Threshold ===
-    constexpr float collisionSlop = 0.01f;
-    float er = capsuleRadius - collisionSlop;
-    float effectiveRadius = er > 0.001f ? er : 0.001f;
-
-    if (distSq > effectiveRadius * effectiveRadius)
-        return false;
-
-    float distance = std::sqrt(distSq);
-    XMVECTOR normal = (distance > 1e-6f) ? XMVector3Normalize(diff) : XMVectorSet(1, 0, 0, 0);
-
-    outContact.Colliders[0] = this;
-    outContact.Colliders[1] = other;
-    XMStoreFloat3(&outContact.ContactPoint, closestBoxPt);
-    XMStoreFloat3(&outContact.ContactNormal, normal);
-    outContact.PenetrationDepth = capsuleRadius - distance;
-
-    outContact.Restitution = 0.5f * (capsuleBody->GetRestitution() + cubeBody->GetRestitution());
-    outContact.Friction = 0.5f * (capsuleBody->GetFriction() + cubeBody->GetFriction());
-    outContact.Elasticity = 0.5f * (capsuleBody->GetElasticity() + cubeBody->GetElasticity());
-
-    return true;
-}
-
 float CapsuleCollider::ClosestPtSegmentSegment(const DirectX::XMVECTOR& p1, const DirectX::XMVECTOR& p2,
     const DirectX::XMVECTOR& q1, const DirectX::XMVECTOR& q2, DirectX::XMVECTOR& outPt1, DirectX::XMVECTOR& outPt2,
     float& outS, float& outT)
@@ -5,8 +5,9 @@ class CapsuleCollider final : public ICollider
 {
 public:
 	CapsuleCollider(RigidBody* body);
-	bool CheckCollision(ICollider* other, Contact& outContact) override;
 	ColliderType GetColliderType() const override;
+	DirectX::XMVECTOR Support(const DirectX::XMVECTOR& direction) const override;
+	float GetSupportMargin() const override { return m_Radius; }
 
 	// Capsule-specific setters/getters
 	void SetRadius(float radius);
@@ -28,11 +29,14 @@ public:
 	void SetScale(const DirectX::XMVECTOR& vector) override;
 	DirectX::XMVECTOR GetScale() const override;
 
-private:
-	bool CheckCollisionWithCapsule(ICollider* other, Contact& outContact);
-	bool CheckCollisionWithSphere(ICollider* other, Contact& outContact);
-	bool CheckCollisionWithCube(ICollider* other, Contact& outContact);
+	//~ Pair test, reached through CollisionDispatch. Spheres and boxes test capsules themselves
+	bool CheckCollisionWith(CapsuleCollider& other, Contact& outContact);
+
+protected:
+	AABB ComputeWorldAABB() const override;
+	BoundingSphere ComputeBoundingSphere() const override;
 
+private:
 	float ClosestPtSegmentSegment(
 		const DirectX::XMVECTOR& p1, const DirectX::XMVECTOR& p2,
 		const DirectX::XMVECTOR& q1, const DirectX::XMVECTOR& q2,
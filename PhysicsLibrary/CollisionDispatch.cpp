@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "CollisionDispatch.h"
+
+#include <array>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+#include "CapsuleCollider.h"
+#include "Contact.h"
+#include "ConvexHullCollider.h"
+#include "ConvexNarrowPhase.h"
+#include "CubeCollider.h"
+#include "SphereCollider.h"
+
+namespace
+{
+    //~ Shape class behind each ColliderType
+    template<ColliderType Type> struct ShapeOf;
+    template<> struct ShapeOf<ColliderType::Cube> { using Type = CubeCollider; };
+    template<> struct ShapeOf<ColliderType::Sphere> { using Type = SphereCollider; };
+    template<> struct ShapeOf<ColliderType::Capsule> { using Type = CapsuleCollider; };
+    template<> struct ShapeOf<ColliderType::ConvexHull> { using Type = ConvexHullCollider; };
+
+    template<ColliderType Type>
+    using Shape = typename ShapeOf<Type>::Type;
+
+    //~ Shape A has a CheckCollisionWith overload for shape B writing to Output
+    template<typename A, typename B, typename Output>
+    concept HasPairTest = requires(A& a, B& b, Output& output) { { a.CheckCollisionWith(b, output) } -> std::same_as<bool>; };
+
+    template<ColliderType A, ColliderType B, typename Output>
+    bool CollidePair(ICollider* a, ICollider* b, Output& output)
+    {
+        using ShapeA = Shape<A>;
+        using ShapeB = Shape<B>;
+
+        if constexpr (A > B)
+        {
+            return CollidePair<B, A>(b, a, output);
+        }
+        else if constexpr (HasPairTest<ShapeA, ShapeB, Output>)
+        {
+            return static_cast<ShapeA*>(a)->CheckCollisionWith(*static_cast<ShapeB*>(b), output);
+        }
+        else if constexpr (std::is_same_v<Output, Contact> && HasPairTest<ShapeA, ShapeB, ContactManifold>)
+        {
+            ContactManifold manifold;
+            if (!static_cast<ShapeA*>(a)->CheckCollisionWith(*static_cast<ShapeB*>(b), manifold)) return false;
+            output = manifold.GetDeepest();
+            return true;
+        }
+        else if constexpr (std::is_same_v<Output, ContactManifold>)
+        {
+            output.Clear();
+            Contact contact;
+            if (!CollidePair<A, B>(a, b, contact)) return false;
+            output.AddPoint(contact);
+            return true;
+        }
+        else
+        {
+            return ConvexNarrowPhase::Collide(a, b, output);
+        }
+    }
+
+    template<typename Output>
+    using PairFunction = bool (*)(ICollider*, ICollider*, Output&);
+
+    template<typename Output>
+    using PairTable = std::array<std::array<PairFunction<Output>, CollisionDispatch::TYPE_COUNT>, CollisionDispatch::TYPE_COUNT>;
+
+    template<typename Output, size_t A, size_t... B>
+    constexpr std::array<PairFunction<Output>, CollisionDispatch::TYPE_COUNT> MakeRow(std::index_sequence<B...>)
+    {
+        return { &CollidePair<static_cast<ColliderType>(A), static_cast<ColliderType>(B), Output>... };
+    }
+
+    template<typename Output, size_t... A>
+    constexpr PairTable<Output> MakeTable(std::index_sequence<A...> types)
+    {
+        return { MakeRow<Output, A>(types)... };
+    }
+
+    constexpr PairTable<Contact> CONTACT_TABLE = MakeTable<Contact>(std::make_index_sequence<CollisionDispatch::TYPE_COUNT>{});
+    constexpr PairTable<ContactManifold> MANIFOLD_TABLE = MakeTable<ContactManifold>(std::make_index_sequence<CollisionDispatch::TYPE_COUNT>{});
+}
+
+bool CollisionDispatch::Collide(ICollider* a, ICollider* b, Contact& outContact)
+{
+    const size_t typeA = static_cast<size_t>(a->GetColliderType());
+    const size_t typeB = static_cast<size_t>(b->GetColliderType());
+    return CONTACT_TABLE[typeA][typeB](a, b, outContact);
+}
+
+bool CollisionDispatch::Collide(ICollider* a, ICollider* b, ContactManifold& outManifold)
+{
+    const size_t typeA = static_cast<size_t>(a->GetColliderType());
+    const size_t typeB = static_cast<size_t>(b->GetColliderType());
+    return MANIFOLD_TABLE[typeA][typeB](a, b, outManifold);
+}
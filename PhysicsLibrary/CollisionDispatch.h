@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include "ICollider.h"
+
+struct Contact;
+struct ContactManifold;
+
+// Narrowphase entry point. A table indexed by both collider types and generated at compile
+// time holds one function per type pair; each one static_casts straight to the two shape
+// classes, so a pair test costs one indirect call instead of type branches and dynamic_casts.
+//
+// Every unordered pair has a single test, on the shape with the lower ColliderType
+// (CubeCollider tests spheres, SphereCollider has no test for cubes). The table swaps a and b
+// itself when they come in the other order, so contacts always have Colliders[0] of the lower
+// type and the normal pointing from Colliders[0] to Colliders[1]. Pairs without a
+// specialised test run through ConvexNarrowPhase.
+class CollisionDispatch
+{
+public:
+    //~ One contact, the deepest point for pairs that produce a manifold
+    static bool Collide(ICollider* a, ICollider* b, Contact& outContact);
+    //~ Every contact point, a single one for pairs without a manifold test
+    static bool Collide(ICollider* a, ICollider* b, ContactManifold& outManifold);
+
+    static constexpr size_t TYPE_COUNT = static_cast<size_t>(ColliderType::ConvexHull) + 1;
+};
@@ -1,1044 +1,492 @@
 #include "pch.h"
 #include "CollisionResolver.h"
+#include "WorkerPool.h"
 
 #include <algorithm>
-#include <random>
+#include <bit>
+#include <numeric>
 
-void CollisionResolver::ResolveContact(Contact& contact, float deltaTime, float totalTime)
+void CollisionResolver::ResolveContacts(std::vector<Contact>& contacts, ContactCache& cache,
+    const SolverSettings& settings)
 {
-    ICollider* a = contact.Colliders[0];
-    ICollider* b = contact.Colliders[1];
-    if (!a || !b) return;
-
-    if (IsStatic(a) && IsStatic(b)) return;
+    std::vector<uint32_t> indices(contacts.size());
+    std::iota(indices.begin(), indices.end(), 0u);
 
-    if (a->GetColliderType() == ColliderType::Cube && b->GetColliderType() == ColliderType::Cube)
-    {
-        ResolveContactWithCubeVsCube(contact, deltaTime, totalTime);
-    }
-    else if (a->GetColliderType() == ColliderType::Cube && b->GetColliderType() == ColliderType::Sphere)
-    {
-        ResolveVelocity(contact, deltaTime);
-        ResolvePenetrationWithCubeVsSphere(contact, deltaTime);
-    }
-    else if (a->GetColliderType() == ColliderType::Sphere && b->GetColliderType() == ColliderType::Cube)
-    {
-        ICollider* a = contact.Colliders[0];
-        ICollider* b = contact.Colliders[1];
-        contact.Colliders[1] = a;
-        contact.Colliders[0] = b;
-        ResolveVelocity(contact, deltaTime);
-        ResolvePenetrationWithCubeVsSphere(contact, deltaTime);
-    }
-	else
-    {
-        ResolveVelocity(contact, deltaTime);
-        ResolvePenetration(contact, deltaTime);
-    }
+    FetchWarmStart(contacts, cache);
+    SolveContacts(contacts, indices, settings);
+    StoreWarmStart(contacts, cache);
 }
 
-void CollisionResolver::ResolveContacts(std::vector<Contact>& contacts, float deltaTime, float totalTime)
+void CollisionResolver::FetchWarmStart(std::vector<Contact>& contacts, const ContactCache& cache)
 {
     for (Contact& contact : contacts)
     {
-        ResolveContact(contact, deltaTime, totalTime);
-    }
-}
-
-void CollisionResolver::SetToleranceCount(int val)
-{
-    m_ResolveTolerance = val;
-}
+        if (cache.Fetch(contact)) continue;
 
-void CollisionResolver::ResolveContactWithCubeVsCube(Contact& contact, float deltaTime, float totalTime)
-{
-    ResolveVelocityWithCubeVsCube(contact, deltaTime);
-    ResolveFrictionWithCubeVsCube(contact, deltaTime);
-    ResolvePenetration(contact, deltaTime);
-    ResolveRestingStateWithCubeVsCube(contact, deltaTime);
-    ResolveAngularDampingWithCubeVsCube(contact, deltaTime);
+        contact.NormalImpulseMagnitude = 0.0f;
+        contact.FrictionImpulse = { 0.0f, 0.0f, 0.0f };
+    }
 }
 
-void CollisionResolver::ResolvePenetration(Contact& contact, float deltaTime)
+void CollisionResolver::StoreWarmStart(const std::vector<Contact>& contacts, ContactCache& cache)
 {
-    using namespace DirectX;
-
-    ICollider* colliderA = contact.Colliders[0];
-    ICollider* colliderB = contact.Colliders[1];
-
-    RigidBody* bodyA = colliderA->GetRigidBody();
-    RigidBody* bodyB = colliderB->GetRigidBody();
-
-    const bool isStaticA = colliderA->GetColliderState() == ColliderState::Static;
-    const bool isStaticB = colliderB->GetColliderState() == ColliderState::Static;
-
-    // If both objects are static, do nothing
-    if (isStaticA && isStaticB)
-        return;
-
-    const float slop = 0.01f;
-    const float percent = 0.8f;
-
-    float penetration = contact.PenetrationDepth - slop;
-    if (penetration <= 0.0f)
-        return;
-
-    XMVECTOR normal = XMLoadFloat3(&contact.ContactNormal);
-
-    if (isStaticA)
+    for (const Contact& contact : contacts)
     {
-        // Move only B along the normal
-        XMVECTOR correction = XMVectorScale(normal, penetration * percent);
-        XMVECTOR posB = bodyB->GetPosition();
-        posB = XMVectorAdd(posB, correction);
-        bodyB->SetPosition(posB);
-    }
-    else if (isStaticB)
-    {
-        // Move only A against the normal
-        XMVECTOR correction = XMVectorScale(normal, penetration * percent);
-        XMVECTOR posA = bodyA->GetPosition();
-        posA = XMVectorSubtract(posA, correction);
-        bodyA->SetPosition(posA);
-    }
-    else
-    {
-        // Both dynamic  split correction based on inverse mass
-        float invMassA = bodyA->GetInverseMass();
-        float invMassB = bodyB->GetInverseMass();
-        float totalInvMass = invMassA + invMassB;
-
-        if (totalInvMass <= 0.0f)
-            return;
-
-        XMVECTOR correction = XMVectorScale(normal, (penetration * percent) / totalInvMass);
-
-        XMVECTOR posA = bodyA->GetPosition();
-        posA = XMVectorSubtract(posA, XMVectorScale(correction, invMassA));
-        bodyA->SetPosition(posA);
-
-        XMVECTOR posB = bodyB->GetPosition();
-        posB = XMVectorAdd(posB, XMVectorScale(correction, invMassB));
-        bodyB->SetPosition(posB);
+        cache.Store(contact);
     }
 }
 
-void CollisionResolver::ResolveVelocityWithCubeVsCube(Contact& contact, float deltaTime)
+void CollisionResolver::SolveContacts(std::vector<Contact>& contacts, std::span<const uint32_t> indices,
+    const SolverSettings& settings)
 {
-    using namespace DirectX;
-
-    ICollider* colliderA = contact.Colliders[0];
-    ICollider* colliderB = contact.Colliders[1];
-
-    RigidBody* bodyA = colliderA->GetRigidBody();
-    RigidBody* bodyB = colliderB->GetRigidBody();
-
-    const bool isStaticA = colliderA->GetColliderState() == ColliderState::Static;
-    const bool isStaticB = colliderB->GetColliderState() == ColliderState::Static;
+    // Scratch per thread, islands are solved concurrently and reuse it step after step
+    thread_local std::vector<ContactConstraint> constraints;
+    constraints.clear();
 
-    if (isStaticA && isStaticB)
-        return;
-
-    const float invMassA = bodyA->GetInverseMass();
-    const float invMassB = bodyB->GetInverseMass();
-    const float totalInvMass = invMassA + invMassB;
-
-    if (totalInvMass <= 0.0f)
-        return;
-
-    XMVECTOR contactPoint = XMLoadFloat3(&contact.ContactPoint);
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
-
-    // rA = contact - centerA
-    XMVECTOR rA = XMVectorSubtract(contactPoint, bodyA->GetPosition());
-    XMVECTOR rB = XMVectorSubtract(contactPoint, bodyB->GetPosition());
-
-    // Velocity at contact points
-    XMVECTOR vA = XMVectorAdd(bodyA->GetVelocity(), XMVector3Cross(bodyA->GetAngularVelocity(), rA));
-    XMVECTOR vB = XMVectorAdd(bodyB->GetVelocity(), XMVector3Cross(bodyB->GetAngularVelocity(), rB));
-
-    // Relative velocity
-    XMVECTOR vRel = XMVectorSubtract(vA, vB);
-    float vRelAlongNormal = XMVectorGetX(XMVector3Dot(vRel, normal));
-
-    XMFLOAT3 relVelF;
-    XMStoreFloat3(&relVelF, vRel);
-
-    if (contact.PenetrationDepth <= 0.0f && vRelAlongNormal > 0.0f)
-        return;
-
-    // Compute combined restitution with elasticity
-    float restitution = contact.Restitution * contact.Elasticity;
-
-    // Compute angular terms
-    XMVECTOR raCrossN = XMVector3Cross(rA, normal);
-    XMVECTOR rbCrossN = XMVector3Cross(rB, normal);
-
-    XMVECTOR raInertia = XMVector3Transform(raCrossN, bodyA->GetInverseInertiaTensorWorld());
-    XMVECTOR rbInertia = XMVector3Transform(rbCrossN, bodyB->GetInverseInertiaTensorWorld());
-
-    float angularTermA = XMVectorGetX(XMVector3Dot(raInertia, raCrossN));
-    float angularTermB = XMVectorGetX(XMVector3Dot(rbInertia, rbCrossN));
-
-    float denom = totalInvMass + angularTermA + angularTermB;
-
-    if (denom <= 0.0f)
-        return;
-
-    float j = -(1.0f + restitution) * vRelAlongNormal / denom;
-    contact.NormalImpulseMagnitude = j;
-
-    XMVECTOR impulse = XMVectorScale(normal, j);
-
-    // Apply impulses
-    if (!isStaticA)
+    // === Prepare once per step ===
+    for (const uint32_t index : indices)
     {
-        bodyA->ApplyLinearImpulse(impulse);
-        bodyA->ApplyAngularImpulse(impulse, rA);
-    }
+        Contact& contact = contacts[index];
 
-    if (!isStaticB)
-    {
-        XMVECTOR negImpulse = XMVectorNegate(impulse);
-        bodyB->ApplyLinearImpulse(negImpulse);
-        bodyB->ApplyAngularImpulse(negImpulse, rB);
+        ContactConstraint constraint;
+        if (PrepareConstraint(contact, constraint))
+        {
+            constraints.push_back(constraint);
+            continue;
+        }
+        contact.NormalImpulseMagnitude = 0.0f;
+        contact.FrictionImpulse = { 0.0f, 0.0f, 0.0f };
     }
-}
-
-void CollisionResolver::ResolveFrictionWithCubeVsCube(Contact& contact, float deltaTime)
-{
-    using namespace DirectX;
-
-    ICollider* colliderA = contact.Colliders[0];
-    ICollider* colliderB = contact.Colliders[1];
-
-    RigidBody* bodyA = colliderA->GetRigidBody();
-    RigidBody* bodyB = colliderB->GetRigidBody();
-
-    const bool isStaticA = colliderA->GetColliderState() == ColliderState::Static;
-    const bool isStaticB = colliderB->GetColliderState() == ColliderState::Static;
-
-    if (isStaticA && isStaticB)
-        return;
-
-    XMVECTOR contactPoint = XMLoadFloat3(&contact.ContactPoint);
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
-
-    // rA and rB
-    XMVECTOR rA = XMVectorSubtract(contactPoint, bodyA->GetPosition());
-    XMVECTOR rB = XMVectorSubtract(contactPoint, bodyB->GetPosition());
-
-    // Velocity at contact point
-    XMVECTOR vA = XMVectorAdd(bodyA->GetVelocity(), XMVector3Cross(bodyA->GetAngularVelocity(), rA));
-    XMVECTOR vB = XMVectorAdd(bodyB->GetVelocity(), XMVector3Cross(bodyB->GetAngularVelocity(), rB));
-
-    XMVECTOR vRel = XMVectorSubtract(vA, vB);
-
-    // Remove normal component
-    float vRelAlongNormal = XMVectorGetX(XMVector3Dot(vRel, normal));
-    XMVECTOR vRelNormal = XMVectorScale(normal, vRelAlongNormal);
-    XMVECTOR vTangent = XMVectorSubtract(vRel, vRelNormal);
 
-    // Skip if no tangent movement
-    if (XMVector3LengthSq(vTangent).m128_f32[0] < 1e-6f)
-        return;
-
-    XMVECTOR tangent = XMVector3Normalize(vTangent);
-
-    // jt denominator
-    XMVECTOR raCrossT = XMVector3Cross(rA, tangent);
-    XMVECTOR rbCrossT = XMVector3Cross(rB, tangent);
-
-    XMVECTOR raInertia = XMVector3Transform(raCrossT, bodyA->GetInverseInertiaTensorWorld());
-    XMVECTOR rbInertia = XMVector3Transform(rbCrossT, bodyB->GetInverseInertiaTensorWorld());
-
-    float angularTermA = XMVectorGetX(XMVector3Dot(raInertia, raCrossT));
-    float angularTermB = XMVectorGetX(XMVector3Dot(rbInertia, rbCrossT));
-
-    float denom = bodyA->GetInverseMass() + bodyB->GetInverseMass() + angularTermA + angularTermB;
-    if (denom <= 0.0f)
-        return;
-
-    float jt = -XMVectorGetX(XMVector3Dot(vRel, tangent)) / denom;
-
-    // Clamp friction impulse
-    float maxFriction = contact.Friction * std::abs(contact.NormalImpulseMagnitude);
-    jt = std::clamp(jt, -maxFriction, maxFriction);
-
-    XMVECTOR frictionImpulse = XMVectorScale(tangent, jt);
-
-    if (!isStaticA)
+    // === Warm start from last step's impulses, only once every restitution bias is measured ===
+    for (ContactConstraint& constraint : constraints)
     {
-        bodyA->ApplyLinearImpulse(frictionImpulse);
-        bodyA->ApplyAngularImpulse(frictionImpulse, rA);
+        WarmStartConstraint(constraint);
     }
 
-    if (!isStaticB)
+    // === Velocity ===
+    for (int iteration = 0; iteration < settings.VelocityIterations; ++iteration)
     {
-        XMVECTOR negFrictionImpulse = XMVectorNegate(frictionImpulse);
-        bodyB->ApplyLinearImpulse(negFrictionImpulse);
-        bodyB->ApplyAngularImpulse(negFrictionImpulse, rB);
+        for (ContactConstraint& constraint : constraints)
+        {
+            SolveVelocityConstraint(constraint);
+        }
     }
-}
-
-void CollisionResolver::ResolveRestingStateWithCubeVsCube(Contact& contact, float deltaTime)
-{
-    using namespace DirectX;
-
-    ICollider* colliderA = contact.Colliders[0];
-    ICollider* colliderB = contact.Colliders[1];
-
-    RigidBody* bodyA = colliderA->GetRigidBody();
-    RigidBody* bodyB = colliderB->GetRigidBody();
-
-    const bool isStaticA = colliderA->GetColliderState() == ColliderState::Static;
-    const bool isStaticB = colliderB->GetColliderState() == ColliderState::Static;
-
-    if (!(isStaticA ^ isStaticB)) // One must be static
-        return;
-
-    RigidBody* dynamicBody = isStaticA ? bodyB : bodyA;
-    RigidBody* platformBody = isStaticA ? bodyA : bodyB;
-
-    // Optional: if you use IsPlatform() flag on spheres too
-    if (!platformBody->IsPlatform())
-        return;
 
-    // 1. Check upward contact normal
-    static const XMVECTOR worldUp = XMVectorSet(0, 1, 0, 0);
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
-    float upwardness = XMVectorGetX(XMVector3Dot(normal, worldUp));
-    if (upwardness < 0.7f)
-        return;
-
-    // 2. Shallow penetration
-    if (contact.PenetrationDepth > 0.01f)
-        return;
-
-    // 3. Check low contact point velocity
-    XMVECTOR contactPoint = XMLoadFloat3(&contact.ContactPoint);
-    XMVECTOR r = XMVectorSubtract(contactPoint, dynamicBody->GetPosition());
-
-    XMVECTOR velocity = XMVectorAdd(dynamicBody->GetVelocity(), XMVector3Cross(dynamicBody->GetAngularVelocity(), r));
-    float speed = XMVectorGetX(XMVector3Length(velocity));
-    if (speed > 0.3f)
-        return;
-
-    // 4. Vertical velocity must be low
-    XMFLOAT3 velFloat;
-    XMStoreFloat3(&velFloat, dynamicBody->GetVelocity());
-    if (std::abs(velFloat.y) > 0.4f)
-        return;
-
-    // Passed all checks
-    dynamicBody->SetRestingState(true);
-}
-
-void CollisionResolver::ResolveAngularDampingWithCubeVsCube(Contact& contact, float deltaTime)
-{
-    using namespace DirectX;
-
-    for (int i = 0; i < 2; ++i)
+    // === Position ===
+    for (int iteration = 0; iteration < settings.PositionIterations; ++iteration)
     {
-        ICollider* collider = contact.Colliders[i];
-        if (!collider || collider->GetColliderState() == ColliderState::Static)
-            continue;
-
-        RigidBody* body = collider->GetRigidBody();
-        if (!body)
-            continue;
-
-        XMVECTOR angVel = body->GetAngularVelocity();
-
-        const float threshold = 0.01f;
-        if (XMVectorGetX(XMVector3LengthSq(angVel)) < threshold)
+        for (const ContactConstraint& constraint : constraints)
         {
-            body->SetAngularVelocity(XMVectorZero());
-            continue;
+            SolvePositionConstraint(constraint);
         }
+    }
 
-        float damping = body->GetAngularDamping();
-        XMVECTOR damped = XMVectorScale(angVel, std::pow(damping, deltaTime));
-        body->SetAngularVelocity(damped);
+    // === Hand the accumulated impulses back to the contacts ===
+    for (const ContactConstraint& constraint : constraints)
+    {
+        StoreImpulses(constraint);
     }
 }
 
-void CollisionResolver::ResolveVelocityWithCubeVsSphere(Contact& contact, float deltaTime)
+void CollisionResolver::SolveContactsColored(std::vector<Contact>& contacts, std::span<const uint32_t> indices,
+    const SolverSettings& settings, WorkerPool& pool, ContactColoringStats& outStats)
 {
-    using namespace DirectX;
-
-    ICollider* colliderA = contact.Colliders[0]; // Cube
-    ICollider* colliderB = contact.Colliders[1]; // Sphere
-
-    RigidBody* bodyA = colliderA->GetRigidBody();
-    RigidBody* bodyB = colliderB->GetRigidBody();
+    outStats.ColorCount = 0;
+    outStats.OverflowCount = 0;
+    outStats.BatchSizes.clear();
 
-    const bool isStaticA = colliderA->GetColliderState() == ColliderState::Static;
-    const bool isStaticB = colliderB->GetColliderState() == ColliderState::Static;
-
-    if (isStaticA && isStaticB)
+    if (indices.size() < COLORING_MIN_CONTACTS)
     {
+        SolveContacts(contacts, indices, settings);
         return;
     }
 
-    const float invMassA = bodyA->GetInverseMass();
-    const float invMassB = bodyB->GetInverseMass();
-    const float totalInvMass = invMassA + invMassB;
+    // Scratch of the thread that drives the pool. Bound to references because a thread_local
+    // named inside a task would resolve to the worker's own, empty, instance.
+    struct ColoringScratch
+    {
+        std::vector<ContactConstraint> Prepared;
+        std::vector<uint8_t> PreparedValid;
+        std::vector<ContactConstraint> Constraints;
+        std::vector<uint8_t> ColorOf;
+        std::vector<uint64_t> BodyColors;
+    };
+    thread_local ColoringScratch scratch;
+    std::vector<ContactConstraint>& prepared = scratch.Prepared;
+    std::vector<uint8_t>& preparedValid = scratch.PreparedValid;
+    std::vector<ContactConstraint>& constraints = scratch.Constraints;
+    std::vector<uint8_t>& colorOf = scratch.ColorOf;
+    std::vector<uint64_t>& bodyColors = scratch.BodyColors;
+
+    auto forBatches = [&](size_t count, auto&& task)
+        {
+            if (count < COLOR_BATCH_SIZE)
+            {
+                task(0, count);
+                return;
+            }
+            const size_t batches = (count + COLOR_BATCH_SIZE - 1) / COLOR_BATCH_SIZE;
+            pool.ParallelFor(batches, [&](size_t batch)
+                {
+                    const size_t begin = batch * COLOR_BATCH_SIZE;
+                    task(begin, std::min(begin + COLOR_BATCH_SIZE, count));
+                });
+        };
+
+    // === Prepare, every contact reads its own bodies only ===
+    prepared.resize(indices.size());
+    preparedValid.assign(indices.size(), 0);
+    forBatches(indices.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                Contact& contact = contacts[indices[i]];
+                if (PrepareConstraint(contact, prepared[i]))
+                {
+                    preparedValid[i] = 1;
+                    continue;
+                }
+                contact.NormalImpulseMagnitude = 0.0f;
+                contact.FrictionImpulse = { 0.0f, 0.0f, 0.0f };
+            }
+        });
 
-    if (totalInvMass <= 0.0f)
+    // === Colour, lowest colour free on both dynamic bodies; static bodies never block ===
+    uint32_t bodyCount = 0;
+    for (size_t i = 0; i < indices.size(); ++i)
     {
-        return;
+        if (!preparedValid[i]) continue;
+        const Contact& contact = contacts[indices[i]];
+        bodyCount = std::max({ bodyCount,
+            contact.Colliders[0]->GetSimulationIndex() + 1, contact.Colliders[1]->GetSimulationIndex() + 1 });
     }
+    bodyColors.assign(bodyCount, 0);
+    colorOf.assign(indices.size(), GRAPH_COLOR_COUNT);
 
-    XMVECTOR contactPoint = XMLoadFloat3(&contact.ContactPoint);
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
+    size_t colorOffsets[GRAPH_COLOR_COUNT + 2]{};
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        if (!preparedValid[i]) continue;
 
-    XMVECTOR rA = contactPoint - bodyA->GetPosition();
-    XMVECTOR rB = contactPoint - bodyB->GetPosition();
+        const ContactConstraint& constraint = prepared[i];
 
-    XMVECTOR vA = bodyA->GetVelocity() + XMVector3Cross(bodyA->GetAngularVelocity(), rA);
-    XMVECTOR vB = bodyB->GetVelocity();
+        // Further points of the same manifold take the colour of the first one and are kept in
+        // its batch below, so a box resting on a box uses up one colour instead of four
+        if (i > 0 && preparedValid[i - 1] && SameBodies(prepared[i - 1], constraint))
+        {
+            colorOf[i] = colorOf[i - 1];
+            ++colorOffsets[colorOf[i] + 1];
+            continue;
+        }
 
-    XMVECTOR vRel = vA - vB;
-    float vRelAlongNormal = XMVectorGetX(XMVector3Dot(vRel, normal));
+        const uint32_t bodyA = constraint.Source->Colliders[0]->GetSimulationIndex();
+        const uint32_t bodyB = constraint.Source->Colliders[1]->GetSimulationIndex();
 
-    if (contact.PenetrationDepth <= 0.0f && vRelAlongNormal > 1e-4f)
+        const uint64_t used = (constraint.IsStaticA ? 0 : bodyColors[bodyA]) | (constraint.IsStaticB ? 0 : bodyColors[bodyB]);
+        const int color = std::countr_one(used);
+        if (color < GRAPH_COLOR_COUNT)
+        {
+            if (!constraint.IsStaticA) bodyColors[bodyA] |= 1ull << color;
+            if (!constraint.IsStaticB) bodyColors[bodyB] |= 1ull << color;
+            colorOf[i] = static_cast<uint8_t>(color);
+        }
+        ++colorOffsets[colorOf[i] + 1];
+    }
+    for (int color = 0; color <= GRAPH_COLOR_COUNT; ++color)
     {
-        return;
+        colorOffsets[color + 1] += colorOffsets[color];
     }
 
-    float restitution = contact.Restitution * contact.Elasticity;
-
-    XMVECTOR raCrossN = XMVector3Cross(rA, normal);
-    XMVECTOR raInertia = XMVector3Transform(raCrossN, bodyA->GetInverseInertiaTensorWorld());
-    float angularTermA = XMVectorGetX(XMVector3Dot(raInertia, raCrossN));
-
-    float angularTermB = 0.0f;
-    if (!isStaticB)
+    // Constraints regrouped by colour, in island order within a colour (the last group is overflow)
+    constraints.resize(colorOffsets[GRAPH_COLOR_COUNT + 1]);
+    size_t cursor[GRAPH_COLOR_COUNT + 1];
+    std::copy(colorOffsets, colorOffsets + GRAPH_COLOR_COUNT + 1, cursor);
+    for (size_t i = 0; i < indices.size(); ++i)
     {
-        XMVECTOR rbCrossN = XMVector3Cross(rB, normal);
-        XMVECTOR rbInertia = XMVector3Transform(rbCrossN, bodyB->GetInverseInertiaTensorWorld());
-        angularTermB = XMVectorGetX(XMVector3Dot(rbInertia, rbCrossN));
+        if (preparedValid[i]) constraints[cursor[colorOf[i]]++] = prepared[i];
     }
 
-    float denom = totalInvMass + angularTermA + angularTermB;
-    if (denom <= 0.0f)
+    for (int color = 0; color < GRAPH_COLOR_COUNT; ++color)
     {
-        return;
+        const int size = static_cast<int>(colorOffsets[color + 1] - colorOffsets[color]);
+        if (size == 0) continue;
+        ++outStats.ColorCount;
+        outStats.BatchSizes.push_back(size);
     }
+    outStats.OverflowCount = static_cast<int>(colorOffsets[GRAPH_COLOR_COUNT + 1] - colorOffsets[GRAPH_COLOR_COUNT]);
 
-    if (vRelAlongNormal > 0.0f)
-    {
-        if (contact.PenetrationDepth > 0.001f)
+    // Batch bounds moved past the rest of a manifold, its points share both bodies
+    auto alignToManifold = [&](size_t index, size_t colorBegin, size_t colorEnd)
         {
-            float biasRestitution = 0.01f; // small bias to push them apart
-            float jBias = -(1.0f + biasRestitution) * vRelAlongNormal / denom;
-            XMVECTOR biasImpulse = XMVectorScale(normal, jBias);
+            while (index > colorBegin && index < colorEnd && SameBodies(constraints[index - 1], constraints[index])) ++index;
+            return index;
+        };
 
-            if (!isStaticA)
+    // Colours run one after another with a join in between, overflow last on this thread
+    auto sweep = [&](auto&& solve)
+        {
+            for (int color = 0; color < GRAPH_COLOR_COUNT; ++color)
             {
-                bodyA->ApplyLinearImpulse(biasImpulse);
-                bodyA->ApplyAngularImpulse(biasImpulse, rA);
+                const size_t first = colorOffsets[color];
+                const size_t last = colorOffsets[color + 1];
+                forBatches(last - first, [&](size_t begin, size_t end)
+                    {
+                        const size_t from = alignToManifold(first + begin, first, last);
+                        const size_t to = alignToManifold(first + end, first, last);
+                        for (size_t i = from; i < to; ++i) solve(constraints[i]);
+                    });
             }
-
-            if (!isStaticB)
+            for (size_t i = colorOffsets[GRAPH_COLOR_COUNT]; i < colorOffsets[GRAPH_COLOR_COUNT + 1]; ++i)
             {
-                XMVECTOR negBiasImpulse = XMVectorNegate(biasImpulse);
-                bodyB->ApplyLinearImpulse(negBiasImpulse);
-                bodyB->ApplyAngularImpulse(negBiasImpulse, rB);
+                solve(constraints[i]);
             }
-        }
-        return;
-    }
-
-    float j = -(1.0f + restitution) * vRelAlongNormal / denom;
-    contact.NormalImpulseMagnitude = j;
-
-    XMVECTOR impulse = XMVectorScale(normal, j);
+        };
 
-    XMVECTOR velBefore = bodyB->GetVelocity(); // velocity before impulse
+    sweep([](ContactConstraint& constraint) { WarmStartConstraint(constraint); });
 
-    if (!isStaticA)
+    for (int iteration = 0; iteration < settings.VelocityIterations; ++iteration)
     {
-
-        bodyA->ApplyLinearImpulse(impulse);
-        bodyA->ApplyAngularImpulse(impulse, rA);
+        sweep([](ContactConstraint& constraint) { SolveVelocityConstraint(constraint); });
     }
 
-    if (!isStaticB)
+    for (int iteration = 0; iteration < settings.PositionIterations; ++iteration)
     {
-        XMVECTOR negImpulse = XMVectorNegate(impulse);
-
-        bodyB->ApplyLinearImpulse(negImpulse);
-        bodyB->ApplyAngularImpulse(negImpulse, rB); // optional
-
-        XMVECTOR velAfter = bodyB->GetVelocity();
+        sweep([](ContactConstraint& constraint) { SolvePositionConstraint(constraint); });
     }
+
+    forBatches(constraints.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i) StoreImpulses(constraints[i]);
+        });
 }
 
-void CollisionResolver::ResolvePenetrationWithCubeVsSphere(Contact& contact, float deltaTime)
+bool CollisionResolver::IsStatic(ICollider* collider)
 {
-    using namespace DirectX;
-
-    ICollider* colliderA = contact.Colliders[0]; // Cube
-    ICollider* colliderB = contact.Colliders[1]; // Sphere
-
-    RigidBody* bodyA = colliderA->GetRigidBody();
-    RigidBody* bodyB = colliderB->GetRigidBody();
-
-    const bool isStaticA = colliderA->GetColliderState() == ColliderState::Static;
-    const bool isStaticB = colliderB->GetColliderState() == ColliderState::Static;
-
-    // Exit early if both are static
-    if (isStaticA && isStaticB)
-        return;
-
-    const float slop = 0.0001f;    // tolerance before pushing
-    const float percent = 1.0f;    // aggressive correction
-
-    float penetration = contact.PenetrationDepth - slop;
-    if (penetration <= 0.0f)
-        return;
-
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
-
-    // Calculate the correction vector
-    XMVECTOR correction = XMVectorScale(normal, penetration * percent);
-
-    if (isStaticA)
-    {
-        // Push only sphere
-        XMVECTOR posB = bodyB->GetPosition();
-        posB = XMVectorAdd(posB, correction);
-        bodyB->SetPosition(posB);
-
-    }
-    else if (isStaticB)
-    {
-        // Push only cube
-        XMVECTOR posA = bodyA->GetPosition();
-        posA = XMVectorSubtract(posA, correction);
-        bodyA->SetPosition(posA);
-
-    }
-    else
-    {
-        // Both dynamic  split by inverse mass
-        float invMassA = bodyA->GetInverseMass();
-        float invMassB = bodyB->GetInverseMass();
-        float totalInvMass = invMassA + invMassB;
-
-        if (totalInvMass <= 0.0f)
-            return;
-
-        XMVECTOR pushA = XMVectorScale(correction, invMassA / totalInvMass);
-        XMVECTOR pushB = XMVectorScale(correction, invMassB / totalInvMass);
-
-        XMVECTOR posA = bodyA->GetPosition();
-        XMVECTOR posB = bodyB->GetPosition();
-
-        bodyA->SetPosition(XMVectorSubtract(posA, pushA));
-        bodyB->SetPosition(XMVectorAdd(posB, pushB));
-    }
+    return collider->GetColliderState() == ColliderState::Static;
 }
 
-
-void CollisionResolver::ResolvePositionInterpenetration(const Contact& contact)
+bool CollisionResolver::PrepareConstraint(Contact& contact, ContactConstraint& outConstraint)
 {
     using namespace DirectX;
 
     ICollider* a = contact.Colliders[0];
     ICollider* b = contact.Colliders[1];
-    if (!a || !b || contact.PenetrationDepth <= 0.0f) return;
+    if (!a || !b) return false;
+    if (IsStatic(a) && IsStatic(b)) return false;
 
     RigidBody* bodyA = a->GetRigidBody();
     RigidBody* bodyB = b->GetRigidBody();
-    if (!bodyA || !bodyB) return;
-
-    bool isStaticA = IsStatic(a);
-    bool isStaticB = IsStatic(b);
-
-    float invMassA = bodyA->GetInverseMass();
-    float invMassB = bodyB->GetInverseMass();
-    float totalInvMass = invMassA + invMassB;
-    if (totalInvMass <= 0.0f) return;
-
-    XMVECTOR normal = XMLoadFloat3(&contact.ContactNormal);
-    float penetration = contact.PenetrationDepth;
-
-    // === Correct normal direction to match bodyA->bodyB ===
-    XMVECTOR posA = bodyA->GetPosition();
-    XMVECTOR posB = bodyB->GetPosition();
-    XMVECTOR dirAB = posB - posA;
-    if (XMVectorGetX(XMVector3Dot(normal, dirAB)) < 0.0f)
+    if (!bodyA || !bodyB) return false;
+
+    ContactConstraint& c = outConstraint;
+    c.Source = &contact;
+    c.BodyA = bodyA;
+    c.BodyB = bodyB;
+    // Infinite mass bodies are shared between islands like static ones, so they are never written
+    c.IsStaticA = IsStatic(a) || !bodyA->HasFiniteMass();
+    c.IsStaticB = IsStatic(b) || !bodyB->HasFiniteMass();
+    c.InvMassA = c.IsStaticA ? 0.0f : bodyA->GetInverseMass();
+    c.InvMassB = c.IsStaticB ? 0.0f : bodyB->GetInverseMass();
+    if (c.InvMassA + c.InvMassB <= 0.0f) return false;
+
+    const XMMATRIX invInertiaA = bodyA->GetInverseInertiaTensorWorld();
+    const XMMATRIX invInertiaB = bodyB->GetInverseInertiaTensorWorld();
+
+    c.PositionA = bodyA->GetPosition();
+    c.PositionB = bodyB->GetPosition();
+
+    // Pair tests point from A to B, but the fallback normals for coincident centres are arbitrary
+    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
+    if (XMVectorGetX(XMVector3Dot(normal, c.PositionB - c.PositionA)) < 0.0f)
         normal = -normal;
-
-    // === Shape-specific handling ===
-    ColliderType typeA = a->GetColliderType();
-    ColliderType typeB = b->GetColliderType();
-
-    bool isCapsuleInvolved = (typeA == ColliderType::Capsule || typeB == ColliderType::Capsule);
-    bool isCapsuleCapsule = (typeA == ColliderType::Capsule && typeB == ColliderType::Capsule);
-
-    // === Penetration correction params ===
-    constexpr float slop = 0.01f;      // Overlap allowed before correction
-    constexpr float percent = 1.1f;    // Resolve full overlap to prevent sticking
-
-    float cd = penetration - slop;
-    float correctionDepth = cd > 0.0f ? cd : 0.0f;
-    XMVECTOR correction = normal * (correctionDepth * percent / totalInvMass);
-
-    // Optional: abort if correction is effectively nothing (numerical jitter)
-    if (XMVectorGetX(XMVector3LengthSq(correction)) < 1e-8f)
-        return;
-
-    // Mass-weighted biasing
-    float weightA = invMassA / totalInvMass;
-    float weightB = invMassB / totalInvMass;
-
-    // Slightly reduce push if both are capsules (avoids infinite shoving)
-    float capsuleBias = isCapsuleCapsule ? 0.85f : 1.0f;
-
-    if (!isStaticA && invMassA > 0.0f)
-    {
-        XMVECTOR pos = bodyA->GetPosition();
-        bodyA->SetPosition(pos - correction * weightA * capsuleBias);
-    }
-
-    if (!isStaticB && invMassB > 0.0f)
-    {
-        XMVECTOR pos = bodyB->GetPosition();
-        bodyB->SetPosition(pos + correction * weightB * capsuleBias);
-    }
-
-    // === kill small linear velocity after deep overlap correction ===
-    auto DampSmallVelocity = [](RigidBody* body) {
-        XMVECTOR v = body->GetVelocity();
-        if (XMVectorGetX(XMVector3LengthSq(v)) < 1e-4f)
-            body->SetVelocity(XMVectorZero());
-        };
-
-    if (!isStaticA) DampSmallVelocity(bodyA);
-    if (!isStaticB) DampSmallVelocity(bodyB);
+    XMStoreFloat3(&contact.ContactNormal, normal);
+
+    c.Normal = normal;
+    ComputeTangentBasis(normal, c.Tangents[0], c.Tangents[1]);
+
+    const XMVECTOR point = XMLoadFloat3(&contact.ContactPoint);
+    const XMVECTOR rA = point - c.PositionA;
+    const XMVECTOR rB = point - c.PositionB;
+
+    // === Jacobian rows and effective masses for the normal and both tangents ===
+    const XMVECTOR directions[3] = { c.Normal, c.Tangents[0], c.Tangents[1] };
+    for (int i = 0; i < 3; ++i)
+    {
+        ContactConstraint::Row& row = c.Rows[i];
+        row.CrossA = XMVector3Cross(rA, directions[i]);
+        row.CrossB = XMVector3Cross(rB, directions[i]);
+        row.AngularA = c.IsStaticA ? XMVectorZero() : XMVector3TransformNormal(row.CrossA, invInertiaA);
+        row.AngularB = c.IsStaticB ? XMVectorZero() : XMVector3TransformNormal(row.CrossB, invInertiaB);
+
+        const float k = c.InvMassA + c.InvMassB
+            + XMVectorGetX(XMVector3Dot(row.CrossA, row.AngularA))
+            + XMVectorGetX(XMVector3Dot(row.CrossB, row.AngularB));
+        row.EffectiveMass = k > 1e-6f ? 1.0f / k : 0.0f;
+    }
+
+    // Restitution only for real impacts so resting contacts do not bounce in place.
+    // Measured before any impulse of this step touches the bodies.
+    const float normalVel = RelativeVelocity(c, c.Rows[0], c.Normal,
+        bodyA->GetVelocity(), bodyA->GetAngularVelocity(), bodyB->GetVelocity(), bodyB->GetAngularVelocity());
+
+    c.VelocityBias = normalVel < -RESTITUTION_VELOCITY_THRESHOLD
+        ? -std::clamp(contact.Restitution, 0.0f, 1.0f) * normalVel
+        : 0.0f;
+    c.Friction = contact.Friction;
+    c.Penetration = contact.PenetrationDepth;
+    c.NormalImpulse = 0.0f;
+    c.TangentImpulse[0] = 0.0f;
+    c.TangentImpulse[1] = 0.0f;
+    return true;
 }
 
-void CollisionResolver::ResolveVelocity(Contact& contact, float deltaTime)
+void CollisionResolver::WarmStartConstraint(ContactConstraint& constraint)
 {
     using namespace DirectX;
 
-    RigidBody* bodyA = contact.Colliders[0]->GetRigidBody();
-    RigidBody* bodyB = contact.Colliders[1]->GetRigidBody();
-    if (!bodyA || !bodyB) return;
-
-    bool aStatic = IsStatic(contact.Colliders[0]);
-    bool bStatic = IsStatic(contact.Colliders[1]);
-
-    float invMassA = bodyA->GetInverseMass();
-    float invMassB = bodyB->GetInverseMass();
-    if (invMassA + invMassB <= 0.0f) return;
-
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
-    XMVECTOR point = XMLoadFloat3(&contact.ContactPoint);
-
-    XMVECTOR rA = point - bodyA->GetPosition();
-    XMVECTOR rB = point - bodyB->GetPosition();
-
-    XMVECTOR vA = GetVelocityAtPoint(bodyA, rA);
-    XMVECTOR vB = GetVelocityAtPoint(bodyB, rB);
-    XMVECTOR relativeVel = vA - vB;
+    const Contact& contact = *constraint.Source;
+    const XMVECTOR friction = XMLoadFloat3(&contact.FrictionImpulse);
 
-    float sepVel = XMVectorGetX(XMVector3Dot(relativeVel, normal));
-    // if (sepVel > 0.0f) return; // Already separating
+    // Last step's friction is re-expressed on this step's tangents, anything along the new normal is dropped
+    constraint.NormalImpulse = contact.NormalImpulseMagnitude * WARM_START_FACTOR;
+    constraint.TangentImpulse[0] = XMVectorGetX(XMVector3Dot(friction, constraint.Tangents[0])) * WARM_START_FACTOR;
+    constraint.TangentImpulse[1] = XMVectorGetX(XMVector3Dot(friction, constraint.Tangents[1])) * WARM_START_FACTOR;
 
-    // std::cout << "Now Working!\n";
-    // Use restitution and elasticity together
-    float restitution = contact.Restitution;
-    float elasticity = contact.Elasticity;
-    float combinedRestitution = std::clamp(restitution * (1.0f + elasticity), 0.0f, 1.0f);
+    XMVECTOR vA = constraint.BodyA->GetVelocity();
+    XMVECTOR wA = constraint.BodyA->GetAngularVelocity();
+    XMVECTOR vB = constraint.BodyB->GetVelocity();
+    XMVECTOR wB = constraint.BodyB->GetAngularVelocity();
 
-    XMMATRIX invInertiaA = bodyA->GetInverseInertiaTensor();
-    XMMATRIX invInertiaB = bodyB->GetInverseInertiaTensor();
+    ApplyRowImpulse(constraint, constraint.Rows[0], constraint.Normal, constraint.NormalImpulse, vA, wA, vB, wB);
+    ApplyRowImpulse(constraint, constraint.Rows[1], constraint.Tangents[0], constraint.TangentImpulse[0], vA, wA, vB, wB);
+    ApplyRowImpulse(constraint, constraint.Rows[2], constraint.Tangents[1], constraint.TangentImpulse[1], vA, wA, vB, wB);
 
-    if (bStatic)
-    {
-        ReflectFromStatic(bodyA, normal, sepVel, combinedRestitution, rA, invInertiaA);
-        ApplyFriction(contact, relativeVel, -normal * sepVel);
-    }
-    else if (aStatic)
-    {
-        ReflectFromStatic(bodyB, -normal, sepVel, combinedRestitution, rB, invInertiaB);
-        //ApplyFriction(contact, relativeVel, normal * sepVel);
-        ApplyFrictionImproved(contact, relativeVel, normal * sepVel);
-    }
-    else
-    {
-        ResolveDynamicVsDynamic(bodyA, bodyB, normal, sepVel, combinedRestitution, rA, rB, invInertiaA, invInertiaB);
-        //ApplyFriction(contact, relativeVel, normal * sepVel);
-        ApplyFrictionImproved(contact, relativeVel, normal * sepVel);
-    }
+    StoreVelocities(constraint, vA, wA, vB, wB);
 }
 
-void CollisionResolver::ApplyFriction(Contact& contact, DirectX::XMVECTOR relativeVelocity, DirectX::XMVECTOR impulse)
+void CollisionResolver::SolveVelocityConstraint(ContactConstraint& constraint)
 {
     using namespace DirectX;
 
-    RigidBody* bodyA = contact.Colliders[0]->GetRigidBody();
-    RigidBody* bodyB = contact.Colliders[1]->GetRigidBody();
-    if (!bodyA || !bodyB) return;
-
-    float invMassA = bodyA->GetInverseMass();
-    float invMassB = bodyB->GetInverseMass();
-    if (invMassA + invMassB <= 0.0f) return;
-
-    bool isStaticA = IsStatic(contact.Colliders[0]);
-    bool isStaticB = IsStatic(contact.Colliders[1]);
-
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
-    XMVECTOR contactPoint = XMLoadFloat3(&contact.ContactPoint);
-
-    // Get the tangential velocity
-    XMVECTOR velTangent = relativeVelocity - normal * XMVector3Dot(relativeVelocity, normal);
-    if (XMVector3LengthSq(velTangent).m128_f32[0] < 1e-6f) return;
-
-    XMVECTOR tangent = XMVector3Normalize(velTangent);
+    ContactConstraint& c = constraint;
 
-    float friction = contact.Friction;
-    float normalImpulseMag = XMVectorGetX(XMVector3Length(impulse));
-    float maxFrictionImpulseMag = friction * normalImpulseMag;
+    XMVECTOR vA = c.BodyA->GetVelocity();
+    XMVECTOR wA = c.BodyA->GetAngularVelocity();
+    XMVECTOR vB = c.BodyB->GetVelocity();
+    XMVECTOR wB = c.BodyB->GetAngularVelocity();
 
-    float tangentialVelMag = XMVectorGetX(XMVector3Dot(relativeVelocity, tangent));
-    float denom = invMassA + invMassB;
-    float frictionImpulseMag = -tangentialVelMag / denom;
-    frictionImpulseMag = std::clamp(frictionImpulseMag, -maxFrictionImpulseMag, maxFrictionImpulseMag);
+    // === Friction, bounded by the normal impulse accumulated so far ===
+    const float old1 = c.TangentImpulse[0];
+    const float old2 = c.TangentImpulse[1];
+    float friction1 = old1 - c.Rows[1].EffectiveMass * RelativeVelocity(c, c.Rows[1], c.Tangents[0], vA, wA, vB, wB);
+    float friction2 = old2 - c.Rows[2].EffectiveMass * RelativeVelocity(c, c.Rows[2], c.Tangents[1], vA, wA, vB, wB);
 
-    XMVECTOR frictionImpulse = tangent * frictionImpulseMag;
-
-    // === Linear friction ===
-    if (!isStaticA && invMassA > 0.0f)
+    const float maxFriction = c.Friction * c.NormalImpulse;
+    const float frictionMag = std::sqrt(friction1 * friction1 + friction2 * friction2);
+    if (frictionMag > maxFriction)
     {
-        XMVECTOR velA = bodyA->GetVelocity();
-        XMVECTOR tangentVel = tangent * XMVectorGetX(XMVector3Dot(velA, tangent));
-        XMVECTOR damped = tangentVel * -friction;
-        bodyA->SetVelocity(velA + damped);
+        const float scale = frictionMag > 0.0f ? maxFriction / frictionMag : 0.0f;
+        friction1 *= scale;
+        friction2 *= scale;
     }
 
-    if (!isStaticB && invMassB > 0.0f)
-    {
-        XMVECTOR velB = bodyB->GetVelocity();
-        XMVECTOR tangentVel = tangent * XMVectorGetX(XMVector3Dot(velB, tangent));
-        XMVECTOR damped = tangentVel * -friction;
-        bodyB->SetVelocity(velB + damped);
-    }
-
-    // === Angular friction ===
-    XMVECTOR rA = contactPoint - bodyA->GetPosition();
-    XMVECTOR rB = contactPoint - bodyB->GetPosition();
-
-    XMMATRIX invInertiaA = bodyA->GetInverseInertiaTensor();
-    XMMATRIX invInertiaB = bodyB->GetInverseInertiaTensor();
+    c.TangentImpulse[0] = friction1;
+    c.TangentImpulse[1] = friction2;
+    ApplyRowImpulse(c, c.Rows[1], c.Tangents[0], friction1 - old1, vA, wA, vB, wB);
+    ApplyRowImpulse(c, c.Rows[2], c.Tangents[1], friction2 - old2, vA, wA, vB, wB);
 
-    if (!isStaticA && invMassA > 0.0f)
-    {
-        XMVECTOR angImpulseA = XMVector3Transform(XMVector3Cross(rA, frictionImpulse), invInertiaA);
-        XMVECTOR angVelA = bodyA->GetAngularVelocity();
-
-        // Optional damping factor
-        float damping = std::clamp(5.0f * invMassA, 0.1f, 1.0f);
-        angImpulseA *= damping;
-
-        bodyA->SetAngularVelocity(angVelA + angImpulseA);
+    // === Normal, the accumulated impulse is clamped rather than each increment ===
+    const float normalVel = RelativeVelocity(c, c.Rows[0], c.Normal, vA, wA, vB, wB);
+    const float oldImpulse = c.NormalImpulse;
+    c.NormalImpulse = std::max(oldImpulse + c.Rows[0].EffectiveMass * (c.VelocityBias - normalVel), 0.0f);
+    ApplyRowImpulse(c, c.Rows[0], c.Normal, c.NormalImpulse - oldImpulse, vA, wA, vB, wB);
 
-        if (XMVectorGetX(XMVector3LengthSq(angVelA)) < 0.01f)
-        {
-            float noiseStrength = normalImpulseMag * 0.05f;
-            XMVECTOR randomTorque = GenerateRandomAngularNoise(noiseStrength);
-            bodyA->SetAngularVelocity(bodyA->GetAngularVelocity() + randomTorque);
-        }
-    }
-
-    if (!isStaticB && invMassB > 0.0f)
-    {
-        XMVECTOR angImpulseB = XMVector3Transform(XMVector3Cross(rB, -frictionImpulse), invInertiaB);
-        XMVECTOR angVelB = bodyB->GetAngularVelocity();
-
-        float damping = std::clamp(5.0f * invMassB, 0.1f, 1.0f);
-        angImpulseB *= damping;
-
-        bodyB->SetAngularVelocity(angVelB + angImpulseB);
-
-        if (XMVectorGetX(XMVector3LengthSq(angVelB)) < 0.01f)
-        {
-            float noiseStrength = normalImpulseMag * 0.05f;
-            XMVECTOR randomTorque = GenerateRandomAngularNoise(noiseStrength);
-            bodyB->SetAngularVelocity(bodyB->GetAngularVelocity() + randomTorque);
-        }
-    }
+    StoreVelocities(c, vA, wA, vB, wB);
 }
 
-void CollisionResolver::ApplyFrictionImproved(Contact& contact, DirectX::XMVECTOR relativeVelocity,
-	DirectX::XMVECTOR impulse)
+void CollisionResolver::SolvePositionConstraint(const ContactConstraint& constraint)
 {
     using namespace DirectX;
 
-    RigidBody* bodyA = contact.Colliders[0]->GetRigidBody();
-    RigidBody* bodyB = contact.Colliders[1]->GetRigidBody();
-    if (!bodyA || !bodyB) return;
-
-    float invMassA = bodyA->GetInverseMass();
-    float invMassB = bodyB->GetInverseMass();
-    if (invMassA + invMassB <= 0.0f) return;
-
-    bool isStaticA = IsStatic(contact.Colliders[0]);
-    bool isStaticB = IsStatic(contact.Colliders[1]);
-
-    XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&contact.ContactNormal));
-    XMVECTOR contactPoint = XMLoadFloat3(&contact.ContactPoint);
-
-    // --- Tangent Vector ---
-    XMVECTOR tangent = relativeVelocity - normal * XMVector3Dot(relativeVelocity, normal);
-    float tangentLenSq = XMVectorGetX(XMVector3LengthSq(tangent));
-    if (tangentLenSq < 1e-6f) return;
-
-    tangent = XMVectorScale(tangent, 1.0f / std::sqrt(tangentLenSq));
-
-    // --- Friction Impulse ---
-    float friction = contact.Friction;
-    float normalImpulseMag = XMVectorGetX(XMVector3Length(impulse));
-    float maxFrictionImpulseMag = friction * normalImpulseMag;
-
-    float tangentialVelMag = XMVectorGetX(XMVector3Dot(relativeVelocity, tangent));
-    float denom = invMassA + invMassB;
-    float frictionImpulseMag = -tangentialVelMag / denom;
-    frictionImpulseMag = std::clamp(frictionImpulseMag, -maxFrictionImpulseMag, maxFrictionImpulseMag);
-
-    XMVECTOR frictionImpulse = tangent * frictionImpulseMag;
-
-    // --- Apply Linear Impulse ---
-    if (!isStaticA && invMassA > 0.0f)
-        bodyA->ApplyLinearImpulse(-frictionImpulse);
-
-    if (!isStaticB && invMassB > 0.0f)
-        bodyB->ApplyLinearImpulse(frictionImpulse);
-
-    // --- Apply Angular Friction ---
-    XMVECTOR rA = contactPoint - bodyA->GetPosition();
-    XMVECTOR rB = contactPoint - bodyB->GetPosition();
+    const ContactConstraint& c = constraint;
 
-    XMMATRIX invInertiaA = bodyA->GetInverseInertiaTensor();
-    XMMATRIX invInertiaB = bodyB->GetInverseInertiaTensor();
+    // Narrowphase is not rerun, the depth is tracked by how far the bodies moved along the normal
+    const XMVECTOR posA = c.BodyA->GetPosition();
+    const XMVECTOR posB = c.BodyB->GetPosition();
+    const XMVECTOR moved = (posB - c.PositionB) - (posA - c.PositionA);
+    const float penetration = c.Penetration - XMVectorGetX(XMVector3Dot(moved, c.Normal));
 
-    if (!isStaticA && invMassA > 0.0f)
-    {
-        XMVECTOR angularImpulseA = XMVector3Transform(XMVector3Cross(rA, -frictionImpulse), invInertiaA);
-        float damping = std::clamp(5.0f * invMassA, 0.1f, 1.0f);
-        angularImpulseA *= damping;
-
-        XMVECTOR angVelA = bodyA->GetAngularVelocity();
-        bodyA->SetAngularVelocity(angVelA + angularImpulseA);
-
-        if (XMVectorGetX(XMVector3LengthSq(angVelA)) < 0.01f)
-        {
-            float noiseStrength = normalImpulseMag * 0.05f;
-            XMVECTOR randomTorque = GenerateRandomAngularNoise(noiseStrength);
-            bodyA->SetAngularVelocity(bodyA->GetAngularVelocity() + randomTorque);
-        }
-    }
+    const float correction = std::clamp(POSITION_CORRECTION_RATE * (penetration - PENETRATION_SLOP),
+        0.0f, MAX_POSITION_CORRECTION);
+    if (correction <= 0.0f) return;
 
-    if (!isStaticB && invMassB > 0.0f)
-    {
-        XMVECTOR angularImpulseB = XMVector3Transform(XMVector3Cross(rB, frictionImpulse), invInertiaB);
-        float damping = std::clamp(5.0f * invMassB, 0.1f, 1.0f);
-        angularImpulseB *= damping;
-
-        XMVECTOR angVelB = bodyB->GetAngularVelocity();
-        bodyB->SetAngularVelocity(angVelB + angularImpulseB);
-
-        if (XMVectorGetX(XMVector3LengthSq(angVelB)) < 0.01f)
-        {
-            float noiseStrength = normalImpulseMag * 0.05f;
-            XMVECTOR randomTorque = GenerateRandomAngularNoise(noiseStrength);
-            bodyB->SetAngularVelocity(bodyB->GetAngularVelocity() + randomTorque);
-        }
-    }
-}
-
-bool CollisionResolver::IsStatic(ICollider* collider)
-{
-    return collider->GetColliderState() == ColliderState::Static;
+    const XMVECTOR push = c.Normal * (correction / (c.InvMassA + c.InvMassB));
+    if (!c.IsStaticA) c.BodyA->SetPosition(posA - push * c.InvMassA);
+    if (!c.IsStaticB) c.BodyB->SetPosition(posB + push * c.InvMassB);
 }
 
-DirectX::XMVECTOR CollisionResolver::GetVelocityAtPoint(RigidBody* body, const DirectX::XMVECTOR& r)
+float CollisionResolver::RelativeVelocity(const ContactConstraint& constraint, const ContactConstraint::Row& row,
+    const DirectX::XMVECTOR& direction,
+    const DirectX::XMVECTOR& vA, const DirectX::XMVECTOR& wA,
+    const DirectX::XMVECTOR& vB, const DirectX::XMVECTOR& wB)
 {
     using namespace DirectX;
 
-	XMVECTOR linearVel = body->GetVelocity();
-	XMVECTOR angVel = body->GetAngularVelocity();
-
-    return linearVel + XMVector3Cross(angVel, r);
+    // d . (vB + wB x rB - vA - wA x rA), with the cross products folded into the Jacobian row
+    return XMVectorGetX(XMVector3Dot(direction, vB - vA))
+        + XMVectorGetX(XMVector3Dot(row.CrossB, wB))
+        - XMVectorGetX(XMVector3Dot(row.CrossA, wA));
 }
 
-float CollisionResolver::ComputeDenominator(float invMassA, float invMassB, const DirectX::XMVECTOR& rA,
-	const DirectX::XMVECTOR& rB, const DirectX::XMVECTOR& normal, const DirectX::XMMATRIX& invInertiaA,
-	const DirectX::XMMATRIX& invInertiaB)
+void CollisionResolver::ApplyRowImpulse(const ContactConstraint& constraint, const ContactConstraint::Row& row,
+    const DirectX::XMVECTOR& direction, float impulse,
+    DirectX::XMVECTOR& vA, DirectX::XMVECTOR& wA,
+    DirectX::XMVECTOR& vB, DirectX::XMVECTOR& wB)
 {
-    using namespace DirectX;
-
-    XMVECTOR rA_cross_n = XMVector3Cross(rA, normal);
-    XMVECTOR rB_cross_n = XMVector3Cross(rB, normal);
-
-    XMVECTOR angularA = XMVector3Cross(XMVector3Transform(rA_cross_n, invInertiaA), rA);
-    XMVECTOR angularB = XMVector3Cross(XMVector3Transform(rB_cross_n, invInertiaB), rB);
-
-    float angularEffect = XMVectorGetX(XMVector3Dot(angularA + angularB, normal));
-    return invMassA + invMassB + angularEffect;
+    vA -= direction * (impulse * constraint.InvMassA);
+    wA -= row.AngularA * impulse;
+    vB += direction * (impulse * constraint.InvMassB);
+    wB += row.AngularB * impulse;
 }
 
-void CollisionResolver::ApplyImpulse(
-    RigidBody* body,
-    const DirectX::XMVECTOR& impulse,
-    const DirectX::XMVECTOR& r,
-    const DirectX::XMMATRIX& invInertia)
+void CollisionResolver::StoreVelocities(const ContactConstraint& constraint,
+    const DirectX::XMVECTOR& vA, const DirectX::XMVECTOR& wA,
+    const DirectX::XMVECTOR& vB, const DirectX::XMVECTOR& wB)
 {
-    using namespace DirectX;
-
-    float invMass = body->GetInverseMass();
-    if (invMass <= 0.0f) return;
-
-    // === LINEAR IMPULSE ===
-    body->SetVelocity(body->GetVelocity() + impulse * invMass);
-
-    // === ANGULAR IMPULSE ===
-    XMVECTOR angularImpulse = XMVector3Transform(XMVector3Cross(r, impulse), invInertia);
-    XMVECTOR newAngVel = body->GetAngularVelocity() + angularImpulse;
-
-    // === WEIGHT-BASED DAMPING LOGIC ===
-    float mass = invMass > 0.0f ? (1.0f / invMass) : FLT_MAX;
-
-    // More mass => lower damping effect. Less mass => more damping.
-    float baseDamping = body->GetAngularDamping(); // [0..1], set per body
-    float dampingFactor = std::clamp(baseDamping * (1.0f / mass), 0.0f, 1.0f);
-
-    // Apply angular damping by scaling angular velocity (simulate resistance)
-    newAngVel *= (1.0f - dampingFactor);
-
-    body->SetAngularVelocity(newAngVel);
+    if (!constraint.IsStaticA)
+    {
+        constraint.BodyA->SetVelocity(vA);
+        constraint.BodyA->SetAngularVelocity(wA);
+    }
+    if (!constraint.IsStaticB)
+    {
+        constraint.BodyB->SetVelocity(vB);
+        constraint.BodyB->SetAngularVelocity(wB);
+    }
 }
 
-void CollisionResolver::ReflectFromStatic(
-    RigidBody* body,
-    const DirectX::XMVECTOR& normal,
-    float sepVel,
-    float restitution,
-    const DirectX::XMVECTOR& r,
-    const DirectX::XMMATRIX& invInertia)
+void CollisionResolver::StoreImpulses(const ContactConstraint& constraint)
 {
-    using namespace DirectX;
-
-    // === LINEAR REFLECTION ===
-    float bounceVel = -(1.0f + restitution) * sepVel;
-    XMVECTOR reflected = normal * bounceVel;
-
-    XMVECTOR oldVel = body->GetVelocity();
-    XMVECTOR newVel = oldVel + reflected;
-    body->SetVelocity(newVel);
-
-    // === ANGULAR RESPONSE ===
-    float invMass = body->GetInverseMass();
-    if (invMass <= 0.0f) return;
-
-    float mass = 1.0f / invMass;
-    float baseDamping = body->GetAngularDamping(); // user-defined [0..1]
-    float dampingFactor = std::clamp(baseDamping * (1.0f / mass), 0.0f, 1.0f);
-
-    // Calculate angular impulse
-    XMVECTOR angularImpulse = XMVector3Transform(XMVector3Cross(r, reflected), invInertia);
-    XMVECTOR newAngVel = body->GetAngularVelocity() + angularImpulse;
-
-    // Apply angular damping
-    newAngVel *= (1.0f - dampingFactor);
-    body->SetAngularVelocity(newAngVel);
+    Contact& contact = *constraint.Source;
+    contact.NormalImpulseMagnitude = constraint.NormalImpulse;
+    DirectX::XMStoreFloat3(&contact.FrictionImpulse,
+        constraint.Tangents[0] * constraint.TangentImpulse[0] + constraint.Tangents[1] * constraint.TangentImpulse[1]);
 }
 
-void CollisionResolver::ResolveDynamicVsDynamic(
-    RigidBody* bodyA, RigidBody* bodyB,
-    const DirectX::XMVECTOR& normal,
-    float sepVel, float restitution,
-    const DirectX::XMVECTOR& rA, const DirectX::XMVECTOR& rB,
-    const DirectX::XMMATRIX& invInertiaA,
-    const DirectX::XMMATRIX& invInertiaB)
+void CollisionResolver::ComputeTangentBasis(const DirectX::XMVECTOR& normal,
+    DirectX::XMVECTOR& outTangent1, DirectX::XMVECTOR& outTangent2)
 {
     using namespace DirectX;
 
-    float invMassA = bodyA->GetInverseMass();
-    float invMassB = bodyB->GetInverseMass();
-    if (invMassA + invMassB <= 0.0f) return;
-
-    // === Combine Restitution and Elasticity ===
-    float elasticity = 0.5f * (bodyA->GetElasticity() + bodyB->GetElasticity());
-    float combinedRestitution = restitution * (1.0f + elasticity);
+    // Depends only on the normal so last step's friction maps onto the same axes
+    XMFLOAT3 n;
+    XMStoreFloat3(&n, normal);
 
-    // === Angular Effects ===
-    XMVECTOR rA_cross_n = XMVector3Cross(rA, normal);
-    XMVECTOR rB_cross_n = XMVector3Cross(rB, normal);
-
-    XMVECTOR angA = XMVector3Cross(XMVector3Transform(rA_cross_n, invInertiaA), rA);
-    XMVECTOR angB = XMVector3Cross(XMVector3Transform(rB_cross_n, invInertiaB), rB);
-
-    float angularEffect = XMVectorGetX(XMVector3Dot(angA + angB, normal));
-    float denom = invMassA + invMassB + angularEffect;
-    if (denom <= 1e-6f) return;
-
-    // === Impulse Magnitude ===
-    float impulseMag = -combinedRestitution * sepVel / denom;
-    XMVECTOR impulse = normal * impulseMag;
-
-    // === LINEAR + ANGULAR ===
-    ApplyImpulse(bodyA, impulse, rA, invInertiaA);
-    ApplyImpulse(bodyB, -impulse, rB, invInertiaB);
-
-    // === Bounce-back Velocity ===
-    XMVECTOR newVelA = bodyA->GetVelocity() + impulse * invMassA;
-    XMVECTOR newVelB = bodyB->GetVelocity() - impulse * invMassB;
-    bodyA->SetVelocity(newVelA);
-    bodyB->SetVelocity(newVelB);
-
-    // === Friction ===
-    XMVECTOR velA = GetVelocityAtPoint(bodyA, rA);
-    XMVECTOR velB = GetVelocityAtPoint(bodyB, rB);
-    XMVECTOR relativeVel = velA - velB;
-
-    XMVECTOR tangent = relativeVel - normal * XMVector3Dot(relativeVel, normal);
-    if (XMVector3LengthSq(tangent).m128_f32[0] > 1e-6f)
-    {
-        tangent = XMVector3Normalize(tangent);
-
-        float friction = 0.5f * (bodyA->GetFriction() + bodyB->GetFriction());
-        float tangentialVelMag = XMVectorGetX(XMVector3Dot(relativeVel, tangent));
-        float frictionImpulseMag = -tangentialVelMag / denom;
-
-        float normalImpulseMag = XMVectorGetX(XMVector3Length(impulse));
-        float maxFrictionImpulse = friction * normalImpulseMag;
-        frictionImpulseMag = std::clamp(frictionImpulseMag, -maxFrictionImpulse, maxFrictionImpulse);
-
-        XMVECTOR frictionImpulse = tangent * frictionImpulseMag;
-
-        ApplyImpulse(bodyA, frictionImpulse, rA, invInertiaA);
-        ApplyImpulse(bodyB, -frictionImpulse, rB, invInertiaB);
-    }
-}
-
-DirectX::XMVECTOR CollisionResolver::GenerateRandomAngularNoise(float strength)
-{
-    static std::default_random_engine rng(std::random_device{}());
-    static std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-
-    float x = dist(rng);
-    float y = dist(rng);
-    float z = dist(rng);
-
-    using namespace DirectX;
-    XMVECTOR dir = XMVectorSet(x, y, z, 0.0f);
-    dir = XMVector3Normalize(dir);
+    if (std::abs(n.x) >= 0.57735f)
+        outTangent1 = XMVector3Normalize(XMVectorSet(n.y, -n.x, 0.0f, 0.0f));
+    else
+        outTangent1 = XMVector3Normalize(XMVectorSet(0.0f, n.z, -n.y, 0.0f));
 
-    return dir * strength;
+    outTangent2 = XMVector3Cross(normal, outTangent1);
 }
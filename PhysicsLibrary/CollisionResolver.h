@@ -1,67 +1,128 @@
 #pragma once
 
+#include <span>
 #include <vector>
 #include "Contact.h"
+#include "ContactCache.h"
+
+class WorkerPool;
+
+struct SolverSettings
+{
+    int VelocityIterations{ 8 };
+    int PositionIterations{ 3 };
+};
+
+struct ContactColoringStats
+{
+    int ColorCount{ 0 };
+    int OverflowCount{ 0 };      // contacts that found no free colour, solved serially
+    std::vector<int> BatchSizes; // contacts per colour
+};
 
 class CollisionResolver
 {
 public:
-    // Resolve a single contact (positional + velocity)
-    static void ResolveContact(Contact& contact, float deltaTime, float totalTime);
+    // Resolve a batch of contacts (e.g. from PhysicsManager) with sequential impulses,
+    // warm started from and written back to cache. The caller brackets the step with
+    // cache.BeginStep() / EndStep() so the contacts may be solved in several batches
+    static void ResolveContacts(std::vector<Contact>& contacts, ContactCache& cache,
+        const SolverSettings& settings);
+
+    // ResolveContacts in three parts for callers that solve independent groups of contacts
+    // concurrently. The cache is only touched by FetchWarmStart / StoreWarmStart, which run
+    // once over all contacts; SolveContacts only writes the contacts it is given and their
+    // non static bodies, so groups that share no dynamic body can run on different threads.
+    static void FetchWarmStart(std::vector<Contact>& contacts, const ContactCache& cache);
+    static void SolveContacts(std::vector<Contact>& contacts, std::span<const uint32_t> indices,
+        const SolverSettings& settings);
+    static void StoreWarmStart(const std::vector<Contact>& contacts, ContactCache& cache);
+
+    // SolveContacts for one large island: contacts are greedily coloured so that no two of
+    // a colour share a dynamic body, then every colour is solved as parallel batches on
+    // pool with a join in between. Consecutive points of one manifold count as one contact
+    // and always land in the same batch. The result only depends on the contacts, not on the thread
+    // count. Below COLORING_MIN_CONTACTS it falls back to SolveContacts. Must not be called
+    // from inside a pool task.
+    static void SolveContactsColored(std::vector<Contact>& contacts, std::span<const uint32_t> indices,
+        const SolverSettings& settings, WorkerPool& pool, ContactColoringStats& outStats);
 
-    // Resolve a batch of contacts (e.g. from PhysicsManager)
-    static void ResolveContacts(std::vector<Contact>& contacts, float deltaTime, float totalTime);
-    static void SetToleranceCount(int val);
+    //~ Below this a whole island on one thread beats the extra joins of a coloured solve
+    static constexpr size_t COLORING_MIN_CONTACTS = 512;
 
 private:
+    static bool IsStatic(ICollider* collider);
 
-    //~ Cube vs Cube
-    static void ResolveContactWithCubeVsCube(Contact& contact, float deltaTime, float totalTime);
-    static void ResolvePenetration(Contact& contact, float deltaTime);
-    static void ResolveVelocityWithCubeVsCube(Contact& contact, float deltaTime);
-    static void ResolveFrictionWithCubeVsCube(Contact& contact, float deltaTime);
-    static void ResolveRestingStateWithCubeVsCube(Contact& contact, float deltaTime);
-    static void ResolveAngularDampingWithCubeVsCube(Contact& contact, float deltaTime);
+    //~ Sequential impulse solver used by ResolveContacts. Everything that only depends on
+    //~ the pose at the start of the step is computed once in PrepareConstraint.
+    struct ContactConstraint
+    {
+        struct Row
+        {
+            DirectX::XMVECTOR CrossA;   // rA x direction
+            DirectX::XMVECTOR CrossB;   // rB x direction
+            DirectX::XMVECTOR AngularA; // invInertiaA * CrossA
+            DirectX::XMVECTOR AngularB; // invInertiaB * CrossB
+            float EffectiveMass{ 0.0f };
+        };
 
-    //~ Specific to spheres
-    static void ResolveVelocityWithCubeVsSphere(Contact& contact, float deltaTime);
-    static void ResolvePenetrationWithCubeVsSphere(Contact& contact, float deltaTime);
+        Contact* Source{ nullptr };
+        RigidBody* BodyA{ nullptr };
+        RigidBody* BodyB{ nullptr };
+        bool IsStaticA{ false };
+        bool IsStaticB{ false };
+        float InvMassA{ 0.0f };
+        float InvMassB{ 0.0f };
 
-    //~ Resolve Inter Penetration
-    static void ResolvePositionInterpenetration(const Contact& contact);
+        DirectX::XMVECTOR Normal;      // from A to B
+        DirectX::XMVECTOR Tangents[2];
+        DirectX::XMVECTOR PositionA;   // at prepare time, for the position solver
+        DirectX::XMVECTOR PositionB;
+        Row Rows[3];                   // normal, tangent 0, tangent 1
 
-    // Resolve collisions
-    static void ResolveVelocity(Contact& contact, float deltaTime);
+        float VelocityBias{ 0.0f };
+        float Friction{ 0.0f };
+        float Penetration{ 0.0f };
+        float NormalImpulse{ 0.0f };
+        float TangentImpulse[2]{ 0.0f, 0.0f };
+    };
 
-    //~ Helper Functions
-    static void ApplyFriction(Contact& contact, DirectX::XMVECTOR relativeVelocity, DirectX::XMVECTOR impulse);
-    static void ApplyFrictionImproved(Contact& contact, DirectX::XMVECTOR relativeVelocity, DirectX::XMVECTOR impulse);
-    static bool IsStatic(ICollider* collider);
-    static DirectX::XMVECTOR GetVelocityAtPoint(RigidBody* body, const DirectX::XMVECTOR& r);
-    static float ComputeDenominator(
-        float invMassA, float invMassB,
-        const DirectX::XMVECTOR& rA, const DirectX::XMVECTOR& rB,
-        const DirectX::XMVECTOR& normal,
-        const DirectX::XMMATRIX& invInertiaA,
-        const DirectX::XMMATRIX& invInertiaB);
-    static void ApplyImpulse(
-        RigidBody* body, const DirectX::XMVECTOR& impulse,
-        const DirectX::XMVECTOR& r,
-        const DirectX::XMMATRIX& invInertia);
-    static void ReflectFromStatic(
-        RigidBody* body, const DirectX::XMVECTOR& normal,
-        float sepVel, float restitution,
-        const DirectX::XMVECTOR& r,
-        const DirectX::XMMATRIX& invInertia);
-    static void ResolveDynamicVsDynamic(
-        RigidBody* bodyA, RigidBody* bodyB,
-        const DirectX::XMVECTOR& normal,
-        float sepVel, float restitution,
-        const DirectX::XMVECTOR& rA, const DirectX::XMVECTOR& rB,
-        const DirectX::XMMATRIX& invInertiaA, const DirectX::XMMATRIX& invInertiaB);
-
-    static DirectX::XMVECTOR GenerateRandomAngularNoise(float strength);
+    static bool PrepareConstraint(Contact& contact, ContactConstraint& outConstraint);
+    static void WarmStartConstraint(ContactConstraint& constraint);
+    static void SolveVelocityConstraint(ContactConstraint& constraint);
+    static void SolvePositionConstraint(const ContactConstraint& constraint);
+    static float RelativeVelocity(const ContactConstraint& constraint, const ContactConstraint::Row& row,
+        const DirectX::XMVECTOR& direction,
+        const DirectX::XMVECTOR& vA, const DirectX::XMVECTOR& wA,
+        const DirectX::XMVECTOR& vB, const DirectX::XMVECTOR& wB);
+    static void ApplyRowImpulse(const ContactConstraint& constraint, const ContactConstraint::Row& row,
+        const DirectX::XMVECTOR& direction, float impulse,
+        DirectX::XMVECTOR& vA, DirectX::XMVECTOR& wA,
+        DirectX::XMVECTOR& vB, DirectX::XMVECTOR& wB);
+    static void StoreVelocities(const ContactConstraint& constraint,
+        const DirectX::XMVECTOR& vA, const DirectX::XMVECTOR& wA,
+        const DirectX::XMVECTOR& vB, const DirectX::XMVECTOR& wB);
+    static void ComputeTangentBasis(const DirectX::XMVECTOR& normal,
+        DirectX::XMVECTOR& outTangent1, DirectX::XMVECTOR& outTangent2);
+    static void StoreImpulses(const ContactConstraint& constraint);
+    static bool SameBodies(const ContactConstraint& a, const ContactConstraint& b)
+    {
+        return a.BodyA == b.BodyA && a.BodyB == b.BodyB;
+    }
 
 private:
-    inline static int m_ResolveTolerance{ 6 }; // always choose even.
+    //~ Colours tried before a contact goes to the serial overflow pass
+    static constexpr int GRAPH_COLOR_COUNT = 32;
+    //~ Contacts per pool task within one colour, smaller colours run on the calling thread
+    static constexpr size_t COLOR_BATCH_SIZE = 64;
+
+    //~ Share of last step's impulse re-applied before solving
+    static constexpr float WARM_START_FACTOR = 1.0f;
+    //~ Closing speeds below this are treated as resting, no bounce
+    static constexpr float RESTITUTION_VELOCITY_THRESHOLD = 1.0f;
+    //~ Position solver: share of the remaining depth removed per iteration, the depth
+    //~ left alone so contacts persist, and the largest push per iteration
+    static constexpr float POSITION_CORRECTION_RATE = 0.2f;
+    static constexpr float PENETRATION_SLOP = 0.005f;
+    static constexpr float MAX_POSITION_CORRECTION = 0.2f;
 };
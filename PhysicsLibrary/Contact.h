@@ -16,5 +16,36 @@ struct Contact
     float Restitution = 1.0f;
     float Friction = 0.5f;
     float Elasticity = 1.0f;
+    // Solver state, accumulated over the step and warm started from ContactCache
     float NormalImpulseMagnitude = 0.0f;
+    DirectX::XMFLOAT3 FrictionImpulse{ 0.0f, 0.0f, 0.0f }; // applied to Colliders[1]
+};
+
+// Contact area between two colliders as up to four points sharing one normal, e.g. the
+// corners of a box face resting on another box. Each point is a full Contact so the
+// solver and the contact cache treat them exactly like single point contacts.
+struct ContactManifold
+{
+    static constexpr int MAX_POINTS = 4;
+
+    Contact Points[MAX_POINTS];
+    int PointCount = 0;
+
+    void Clear() { PointCount = 0; }
+    bool IsFull() const { return PointCount == MAX_POINTS; }
+    void AddPoint(const Contact& contact)
+    {
+        if (PointCount < MAX_POINTS) Points[PointCount++] = contact;
+    }
+
+    //~ Deepest point, for callers that only take one contact per pair
+    const Contact& GetDeepest() const
+    {
+        int deepest = 0;
+        for (int i = 1; i < PointCount; ++i)
+        {
+            if (Points[i].PenetrationDepth > Points[deepest].PenetrationDepth) deepest = i;
+        }
+        return Points[deepest];
+    }
 };
@@ -0,0 +1,159 @@
+#include "pch.h"
+#include "ContactCache.h"
+
+#include <functional>
+
+namespace
+{
+    //~ Cached points further than this from a new contact (in body space) are a different point
+    constexpr float MATCH_DISTANCE = 0.1f;
+}
+
+void ContactCache::BeginStep()
+{
+    ++m_Step;
+    m_HitCount = 0;
+}
+
+bool ContactCache::Fetch(Contact& contact) const
+{
+    using namespace DirectX;
+
+    bool swapped;
+    const PairKey key = MakeKey(contact, swapped);
+
+    auto it = m_Manifolds.find(key);
+    if (it == m_Manifolds.end()) return false;
+
+    const Manifold& manifold = it->second;
+    const XMFLOAT3 local = ToLocalPoint(manifold.Frame, contact.ContactPoint);
+    const XMVECTOR localPoint = XMLoadFloat3(&local);
+
+    const CachedPoint* best = nullptr;
+    float bestDistanceSq = MATCH_DISTANCE * MATCH_DISTANCE;
+    for (int i = 0; i < manifold.PointCount; ++i)
+    {
+        const CachedPoint& point = manifold.Points[i];
+        const float distanceSq = XMVectorGetX(XMVector3LengthSq(
+            XMVectorSubtract(XMLoadFloat3(&point.LocalPoint), localPoint)));
+
+        if (distanceSq < bestDistanceSq)
+        {
+            bestDistanceSq = distanceSq;
+            best = &point;
+        }
+    }
+    if (!best) return false;
+
+    contact.NormalImpulseMagnitude = best->NormalImpulse;
+    contact.FrictionImpulse = best->FrictionImpulse;
+    if (swapped)
+    {
+        contact.FrictionImpulse = { -best->FrictionImpulse.x, -best->FrictionImpulse.y, -best->FrictionImpulse.z };
+    }
+
+    ++m_HitCount;
+    return true;
+}
+
+void ContactCache::Store(const Contact& contact)
+{
+    bool swapped;
+    const PairKey key = MakeKey(contact, swapped);
+
+    Manifold& manifold = m_Manifolds[key];
+    if (manifold.LastStep != m_Step)
+    {
+        // First contact of this pair this step, last step's points are now stale
+        manifold.PointCount = 0;
+        manifold.LastStep = m_Step;
+        manifold.Frame = contact.Colliders[0];
+    }
+    if (manifold.PointCount == MAX_POINTS_PER_PAIR) return;
+
+    CachedPoint& point = manifold.Points[manifold.PointCount++];
+    point.LocalPoint = ToLocalPoint(manifold.Frame, contact.ContactPoint);
+    point.NormalImpulse = contact.NormalImpulseMagnitude;
+    point.FrictionImpulse = contact.FrictionImpulse;
+    if (swapped)
+    {
+        point.FrictionImpulse = { -contact.FrictionImpulse.x, -contact.FrictionImpulse.y, -contact.FrictionImpulse.z };
+    }
+}
+
+void ContactCache::KeepAlive(const ICollider* a, const ICollider* b)
+{
+    bool swapped;
+    auto it = m_Manifolds.find(MakeKey(a, b, swapped));
+    if (it != m_Manifolds.end()) it->second.LastStep = m_Step;
+}
+
+void ContactCache::EndStep()
+{
+    for (auto it = m_Manifolds.begin(); it != m_Manifolds.end();)
+    {
+        if (it->second.LastStep == m_Step) ++it;
+        else it = m_Manifolds.erase(it);
+    }
+}
+
+void ContactCache::Clear()
+{
+    m_Manifolds.clear();
+    m_HitCount = 0;
+}
+
+void ContactCache::Remove(const ICollider* collider, std::vector<const ICollider*>& outPartners)
+{
+    // Another collider may later be allocated at the same address, it must not inherit these
+    for (auto it = m_Manifolds.begin(); it != m_Manifolds.end();)
+    {
+        if (it->first.First == collider) outPartners.push_back(it->first.Second);
+        else if (it->first.Second == collider) outPartners.push_back(it->first.First);
+        else
+        {
+            ++it;
+            continue;
+        }
+        it = m_Manifolds.erase(it);
+    }
+}
+
+void ContactCache::GetPartners(const ICollider* collider, std::vector<const ICollider*>& outPartners) const
+{
+    for (const auto& [key, manifold] : m_Manifolds)
+    {
+        if (key.First == collider) outPartners.push_back(key.Second);
+        else if (key.Second == collider) outPartners.push_back(key.First);
+    }
+}
+
+size_t ContactCache::PairKeyHash::operator()(const PairKey& key) const
+{
+    const size_t a = std::hash<const ICollider*>{}(key.First);
+    const size_t b = std::hash<const ICollider*>{}(key.Second);
+    return a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+}
+
+ContactCache::PairKey ContactCache::MakeKey(const Contact& contact, bool& outSwapped)
+{
+    return MakeKey(contact.Colliders[0], contact.Colliders[1], outSwapped);
+}
+
+ContactCache::PairKey ContactCache::MakeKey(const ICollider* a, const ICollider* b, bool& outSwapped)
+{
+    outSwapped = std::less<const ICollider*>{}(b, a);
+    return outSwapped ? PairKey{ b, a } : PairKey{ a, b };
+}
+
+DirectX::XMFLOAT3 ContactCache::ToLocalPoint(const ICollider* collider, const DirectX::XMFLOAT3& worldPoint)
+{
+    using namespace DirectX;
+
+    RigidBody* body = collider->GetRigidBody();
+    const XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&worldPoint), body->GetPosition());
+
+    XMFLOAT3 local;
+    XMStoreFloat3(&local, XMVector3InverseRotate(offset, body->GetOrientation().ToXmVector()));
+    return local;
+}
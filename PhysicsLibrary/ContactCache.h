@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Contact.h"
+
+// Solver impulses remembered per collider pair between steps. Each new contact is
+// seeded with what the matching point needed last step (warm starting), so a resting
+// stack starts the step already supported instead of rebuilding its impulses from zero.
+// Points are matched by their position in the body space of the collider the narrowphase
+// reported first, never picked by address, so the match does not depend on where the
+// colliders were allocated. A pair that produced no contact during a step is dropped at
+// EndStep unless it was kept alive.
+class ContactCache
+{
+public:
+    static constexpr int MAX_POINTS_PER_PAIR = ContactManifold::MAX_POINTS;
+
+    ContactCache() = default;
+    ContactCache(const ContactCache&) = delete;
+    ContactCache& operator=(const ContactCache&) = delete;
+
+    void BeginStep();
+
+    //~ Loads the impulses of the closest cached point into contact, false on a miss
+    bool Fetch(Contact& contact) const;
+
+    //~ Records the impulses the solver ended the step with
+    void Store(const Contact& contact);
+
+    //~ Keeps a pair of sleeping bodies without touching its points, they are reused on wake up
+    void KeepAlive(const ICollider* a, const ICollider* b);
+
+    //~ Drops pairs that were neither stored nor kept alive this step
+    void EndStep();
+    void Clear();
+    //~ Forgets every pair involving the collider, before it is destroyed. The colliders it
+    //~ was paired with are appended to outPartners.
+    void Remove(const ICollider* collider, std::vector<const ICollider*>& outPartners);
+    //~ Appends the colliders the collider has a pair with
+    void GetPartners(const ICollider* collider, std::vector<const ICollider*>& outPartners) const;
+
+    size_t GetPairCount() const { return m_Manifolds.size(); }
+    size_t GetHitCount() const { return m_HitCount; }
+
+private:
+    struct PairKey
+    {
+        const ICollider* First{ nullptr };
+        const ICollider* Second{ nullptr };
+
+        bool operator==(const PairKey& other) const
+        {
+            return First == other.First && Second == other.Second;
+        }
+    };
+
+    struct PairKeyHash
+    {
+        size_t operator()(const PairKey& key) const;
+    };
+
+    struct CachedPoint
+    {
+        DirectX::XMFLOAT3 LocalPoint{}; // relative to the manifold's frame body
+        DirectX::XMFLOAT3 FrictionImpulse{}; // applied to the key's second body
+        float NormalImpulse{ 0.0f };
+    };
+
+    struct Manifold
+    {
+        CachedPoint Points[MAX_POINTS_PER_PAIR];
+        int PointCount{ 0 };
+        uint64_t LastStep{ 0 };
+        const ICollider* Frame{ nullptr };
+    };
+
+    //~ Pair key independent of the order the narrowphase reported the colliders in
+    static PairKey MakeKey(const Contact& contact, bool& outSwapped);
+    static PairKey MakeKey(const ICollider* a, const ICollider* b, bool& outSwapped);
+    static DirectX::XMFLOAT3 ToLocalPoint(const ICollider* collider, const DirectX::XMFLOAT3& worldPoint);
+
+private:
+    std::unordered_map<PairKey, Manifold, PairKeyHash> m_Manifolds;
+    uint64_t m_Step{ 0 };
+    mutable size_t m_HitCount{ 0 };
+};
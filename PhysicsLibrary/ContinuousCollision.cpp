@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "ContinuousCollision.h"
+
+#include "ConvexNarrowPhase.h"
+#include "ICollider.h"
+
+using namespace DirectX;
+
+namespace
+{
+    //~ Motion with its component into the surface reversed and scaled by restitution
+    XMVECTOR Bounce(const XMVECTOR& motion, const XMVECTOR& normal, float restitution)
+    {
+        const float into = XMVectorGetX(XMVector3Dot(motion, normal));
+        if (into >= 0.0f) return motion;
+        return motion - normal * ((1.0f + restitution) * into);
+    }
+
+    AABB SweptBounds(const XMVECTOR& from, const XMVECTOR& to, float radius)
+    {
+        AABB bounds;
+        XMStoreFloat3(&bounds.Min, XMVectorMin(from, to));
+        XMStoreFloat3(&bounds.Max, XMVectorMax(from, to));
+        bounds.Expand(radius);
+        return bounds;
+    }
+}
+
+bool ContinuousCollision::IsSweepable(ICollider* collider)
+{
+    RigidBody* body = collider->GetRigidBody();
+    if (!body || !body->IsContinuous()) return false;
+    if (collider->GetColliderState() == ColliderState::Static || !body->HasFiniteMass() || !body->IsAwake()) return false;
+
+    const ColliderType type = collider->GetColliderType();
+    return type == ColliderType::Sphere || type == ColliderType::Capsule;
+}
+
+void ContinuousCollision::BeginStep(const std::vector<ICollider*>& colliders)
+{
+    m_Sweeps.clear();
+    m_Targets.clear();
+
+    for (ICollider* collider : colliders)
+    {
+        RigidBody* body = collider->GetRigidBody();
+        if (!body) continue;
+
+        if (IsSweepable(collider))
+        {
+            Sweep sweep{ collider, {} };
+            XMStoreFloat3(&sweep.Start, body->GetPosition());
+            m_Sweeps.push_back(sweep);
+        }
+        else if (collider->GetColliderState() == ColliderState::Static || !body->HasFiniteMass())
+        {
+            m_Targets.push_back(collider);
+        }
+    }
+}
+
+void ContinuousCollision::Resolve()
+{
+    m_SweptCount = 0;
+    m_ImpactCount = 0;
+    if (m_Sweeps.empty() || m_Targets.empty()) return;
+
+    for (const Sweep& sweep : m_Sweeps)
+    {
+        ICollider* collider = sweep.Collider;
+        RigidBody* body = collider->GetRigidBody();
+
+        XMVECTOR from = XMLoadFloat3(&sweep.Start);
+        XMVECTOR to = body->GetPosition();
+
+        // Slow enough that the discrete test still sees the contact before it is passed
+        const float threshold = m_MotionThreshold * collider->GetSupportMargin();
+        if (XMVectorGetX(XMVector3LengthSq(to - from)) <= threshold * threshold) continue;
+        ++m_SweptCount;
+
+        XMVECTOR velocity = body->GetVelocity();
+        bool hit = false;
+        for (int subStep = 0; subStep < MAX_SUB_STEPS; ++subStep)
+        {
+            float time = 0.0f;
+            XMFLOAT3 normal{};
+            float restitution = 0.0f;
+            if (!FindImpact(collider, from, to, time, normal, restitution)) break;
+
+            hit = true;
+            ++m_ImpactCount;
+
+            // Continue the rest of the step from the impact, bounced off the surface
+            const XMVECTOR n = XMLoadFloat3(&normal);
+            const XMVECTOR impact = XMVectorLerp(from, to, time);
+            const XMVECTOR remaining = Bounce(to - impact, n, restitution);
+            velocity = Bounce(velocity, n, restitution);
+            from = impact;
+            to = impact + remaining;
+
+            // Out of sub steps, stay at the last point known to be clear
+            if (subStep == MAX_SUB_STEPS - 1) to = from;
+        }
+
+        if (hit)
+        {
+            body->SetPosition(to);
+            body->SetVelocity(velocity);
+        }
+    }
+}
+
+bool ContinuousCollision::FindImpact(ICollider* collider, const XMVECTOR& from, const XMVECTOR& to,
+    float& outTime, XMFLOAT3& outNormal, float& outRestitution) const
+{
+    const AABB swept = SweptBounds(from, to, collider->GetBoundingSphere().Radius);
+    const float restitution = collider->GetRigidBody()->GetRestitution();
+
+    bool found = false;
+    outTime = 1.0f;
+    for (ICollider* target : m_Targets)
+    {
+        if (!swept.Overlaps(target->GetWorldAABB())) continue;
+
+        float time = 0.0f;
+        XMFLOAT3 normal{};
+        if (ConvexNarrowPhase::TimeOfImpact(collider, from, to, target, time, normal) && time < outTime)
+        {
+            found = true;
+            outTime = time;
+            outNormal = normal;
+            outRestitution = 0.5f * (restitution + target->GetRigidBody()->GetRestitution());
+        }
+    }
+    return found;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <vector>
+
+class ICollider;
+
+// Swept collision for small fast bodies that opted in with RigidBody::SetContinuous. A sphere
+// or capsule moving further than a fraction of its radius in one step can pass through thin
+// static geometry between two discrete tests. BeginStep records where those bodies start,
+// Resolve then sweeps each one that moved far enough from there to its integrated position
+// against the static colliders (ConvexNarrowPhase::TimeOfImpact), stops it at the first
+// impact, bounces its velocity and sweeps the rest of the step, a few sub steps at most.
+// Every other body keeps its plain discrete step.
+class ContinuousCollision
+{
+public:
+    static constexpr int MAX_SUB_STEPS = 4;
+
+    ContinuousCollision() = default;
+    ContinuousCollision(const ContinuousCollision&) = delete;
+    ContinuousCollision& operator=(const ContinuousCollision&) = delete;
+
+    //~ Continuous, awake, dynamic spheres and capsules
+    static bool IsSweepable(ICollider* collider);
+
+    //~ Before integration, records the start of every sweepable body and the static targets
+    void BeginStep(const std::vector<ICollider*>& colliders);
+    //~ After integration, pulls bodies that passed through static geometry back to the impact
+    void Resolve();
+
+    //~ Bodies are swept once their step moves them more than this times their radius
+    void SetMotionThreshold(float fraction) { m_MotionThreshold = fraction; }
+    float GetMotionThreshold() const { return m_MotionThreshold; }
+
+    //~ Last step: bodies that moved far enough to be swept, and impacts found
+    size_t GetSweptCount() const { return m_SweptCount; }
+    size_t GetImpactCount() const { return m_ImpactCount; }
+
+private:
+    struct Sweep
+    {
+        ICollider* Collider;
+        DirectX::XMFLOAT3 Start;
+    };
+
+    //~ Earliest impact of collider moving from -> to, false when nothing is hit
+    bool FindImpact(ICollider* collider, const DirectX::XMVECTOR& from, const DirectX::XMVECTOR& to,
+        float& outTime, DirectX::XMFLOAT3& outNormal, float& outRestitution) const;
+
+private:
+    std::vector<Sweep> m_Sweeps;
+    std::vector<ICollider*> m_Targets;
+    float m_MotionThreshold{ 0.5f };
+    size_t m_SweptCount{ 0 };
+    size_t m_ImpactCount{ 0 };
+};
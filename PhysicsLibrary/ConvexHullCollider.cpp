@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "ConvexHullCollider.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+ConvexHullCollider::ConvexHullCollider(RigidBody* body)
+    : ICollider(body)
+{
+    // Unit cube until real vertices are set, the same shape a CubeCollider starts as
+    m_Vertices = {
+        { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f },
+        { -0.5f, -0.5f,  0.5f }, { 0.5f, -0.5f,  0.5f }, { -0.5f, 0.5f,  0.5f }, { 0.5f, 0.5f,  0.5f },
+    };
+    UpdateInertia();
+}
+
+ColliderType ConvexHullCollider::GetColliderType() const
+{
+    return ColliderType::ConvexHull;
+}
+
+DirectX::XMVECTOR ConvexHullCollider::Support(const DirectX::XMVECTOR& direction) const
+{
+    using namespace DirectX;
+
+    // Search in local space, the scale moves into the direction: dot(d, R S v) = dot(S R^T d, v)
+    const XMMATRIX rotation = m_RigidBody->GetOrientation().ToRotationMatrix();
+    XMVECTOR localDirection = XMVectorSet(
+        XMVectorGetX(XMVector3Dot(rotation.r[0], direction)),
+        XMVectorGetX(XMVector3Dot(rotation.r[1], direction)),
+        XMVectorGetX(XMVector3Dot(rotation.r[2], direction)),
+        0.0f);
+    localDirection = XMVectorMultiply(localDirection, m_Scale);
+
+    XMFLOAT3 d;
+    XMStoreFloat3(&d, localDirection);
+
+    size_t best = 0;
+    float bestDot = -FLT_MAX;
+    for (size_t i = 0; i < m_Vertices.size(); ++i)
+    {
+        const XMFLOAT3& v = m_Vertices[i];
+        const float dot = v.x * d.x + v.y * d.y + v.z * d.z;
+        if (dot > bestDot)
+        {
+            bestDot = dot;
+            best = i;
+        }
+    }
+
+    XMFLOAT3 scaled;
+    XMStoreFloat3(&scaled, XMVectorMultiply(XMLoadFloat3(&m_Vertices[best]), m_Scale));
+
+    XMVECTOR support = m_RigidBody->GetPosition();
+    support = XMVectorMultiplyAdd(rotation.r[0], XMVectorReplicate(scaled.x), support);
+    support = XMVectorMultiplyAdd(rotation.r[1], XMVectorReplicate(scaled.y), support);
+    support = XMVectorMultiplyAdd(rotation.r[2], XMVectorReplicate(scaled.z), support);
+    return support;
+}
+
+void ConvexHullCollider::SetVertices(std::span<const DirectX::XMFLOAT3> vertices)
+{
+    if (vertices.empty()) return;
+
+    m_Vertices.assign(vertices.begin(), vertices.end());
+    m_RigidBody->WakeUp();
+    UpdateInertia();
+}
+
+void ConvexHullCollider::SetScale(const DirectX::XMVECTOR& vector)
+{
+    m_Scale = vector;
+    m_RigidBody->WakeUp();
+    UpdateInertia();
+}
+
+DirectX::XMVECTOR ConvexHullCollider::GetScale() const
+{
+    DirectX::XMVECTOR scale = m_Scale;
+    return scale;
+}
+
+AABB ConvexHullCollider::ComputeWorldAABB() const
+{
+    using namespace DirectX;
+
+    const XMMATRIX rotation = m_RigidBody->GetOrientation().ToRotationMatrix();
+    const XMVECTOR position = m_RigidBody->GetPosition();
+
+    XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+    XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+    for (const XMFLOAT3& vertex : m_Vertices)
+    {
+        XMFLOAT3 scaled;
+        XMStoreFloat3(&scaled, XMVectorMultiply(XMLoadFloat3(&vertex), m_Scale));
+
+        XMVECTOR world = position;
+        world = XMVectorMultiplyAdd(rotation.r[0], XMVectorReplicate(scaled.x), world);
+        world = XMVectorMultiplyAdd(rotation.r[1], XMVectorReplicate(scaled.y), world);
+        world = XMVectorMultiplyAdd(rotation.r[2], XMVectorReplicate(scaled.z), world);
+        minimum = XMVectorMin(minimum, world);
+        maximum = XMVectorMax(maximum, world);
+    }
+
+    AABB bounds;
+    XMStoreFloat3(&bounds.Min, minimum);
+    XMStoreFloat3(&bounds.Max, maximum);
+    return bounds;
+}
+
+BoundingSphere ConvexHullCollider::ComputeBoundingSphere() const
+{
+    using namespace DirectX;
+
+    float radiusSq = 0.0f;
+    for (const XMFLOAT3& vertex : m_Vertices)
+    {
+        radiusSq = (std::max)(radiusSq, XMVectorGetX(XMVector3LengthSq(XMVectorMultiply(XMLoadFloat3(&vertex), m_Scale))));
+    }
+
+    BoundingSphere sphere;
+    XMStoreFloat3(&sphere.Center, m_RigidBody->GetPosition());
+    sphere.Radius = std::sqrt(radiusSq);
+    return sphere;
+}
+
+void ConvexHullCollider::UpdateInertia()
+{
+    using namespace DirectX;
+
+    XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+    XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+    for (const XMFLOAT3& vertex : m_Vertices)
+    {
+        const XMVECTOR scaled = XMVectorMultiply(XMLoadFloat3(&vertex), m_Scale);
+        minimum = XMVectorMin(minimum, scaled);
+        maximum = XMVectorMax(maximum, scaled);
+    }
+
+    XMFLOAT3 size;
+    XMStoreFloat3(&size, XMVectorSubtract(maximum, minimum));
+    m_RigidBody->ComputeInverseInertiaTensorBox(size.x, size.y, size.z);
+}
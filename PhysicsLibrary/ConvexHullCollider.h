@@ -0,0 +1,38 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "ICollider.h"
+
+// Any convex polyhedron, given by its vertices in local space (the scale is applied on top).
+// Has no pair tests of its own, CollisionDispatch sends every pair to ConvexNarrowPhase, so
+// the vertices only need to be the hull's corners, faces and edges are never built.
+class ConvexHullCollider final : public ICollider
+{
+public:
+    explicit ConvexHullCollider(RigidBody* body);
+    ~ConvexHullCollider() override = default;
+
+    ColliderType GetColliderType() const override;
+    DirectX::XMVECTOR Support(const DirectX::XMVECTOR& direction) const override;
+
+    //~ Points inside the hull are harmless, they just never win a support query
+    void SetVertices(std::span<const DirectX::XMFLOAT3> vertices);
+    const std::vector<DirectX::XMFLOAT3>& GetVertices() const { return m_Vertices; }
+
+    void SetScale(const DirectX::XMVECTOR& vector) override;
+    DirectX::XMVECTOR GetScale() const override;
+
+protected:
+    AABB ComputeWorldAABB() const override;
+    BoundingSphere ComputeBoundingSphere() const override;
+
+private:
+    //~ Box inertia of the scaled local bounds
+    void UpdateInertia();
+
+private:
+    std::vector<DirectX::XMFLOAT3> m_Vertices;
+    DirectX::XMVECTOR m_Scale{ 1.0f, 1.0f, 1.0f };
+};
@@ -0,0 +1,652 @@
+#include "pch.h"
+#include "ConvexNarrowPhase.h"
+
+#include <cfloat>
+#include <cmath>
+#include <initializer_list>
+
+namespace
+{
+    using namespace DirectX;
+
+    //~ A point of the Minkowski difference A - B with the two shape points it came from
+    struct SupportPoint
+    {
+        XMVECTOR Point;
+        XMVECTOR OnA;
+        XMVECTOR OnB;
+    };
+
+    struct Simplex
+    {
+        SupportPoint Points[4];
+        float Weights[4]{}; // barycentric coordinates of the point closest to the origin
+        int Count{ 0 };
+    };
+
+    enum class GjkStatus : uint8_t
+    {
+        Separated,   // closest points found
+        Overlapping, // the origin is inside the simplex, or as good as on it
+        BeyondLimit, // a separating axis proves the cores are further apart than the limit
+    };
+
+    constexpr int MAX_EPA_VERTICES = 64;
+    constexpr int MAX_EPA_FACES = 128;
+    constexpr int MAX_EPA_EDGES = 96;
+    //~ Squared lengths below this count as zero: a touching origin, a degenerate edge or face
+    constexpr float DEGENERATE_EPSILON = 1e-10f;
+
+    float Dot(const XMVECTOR& a, const XMVECTOR& b)
+    {
+        return XMVectorGetX(XMVector3Dot(a, b));
+    }
+
+    //~ The two shapes of a query, a moved by OffsetA first (a swept shape part way along its path)
+    struct MinkowskiPair
+    {
+        const ICollider* A;
+        const ICollider* B;
+        XMVECTOR OffsetA;
+    };
+
+    SupportPoint GetSupport(const MinkowskiPair& pair, const XMVECTOR& direction)
+    {
+        SupportPoint support;
+        support.OnA = pair.A->Support(direction) + pair.OffsetA;
+        support.OnB = pair.B->Support(XMVectorNegate(direction));
+        support.Point = support.OnA - support.OnB;
+        return support;
+    }
+
+    void KeepPoints(Simplex& simplex, std::initializer_list<int> keep, std::initializer_list<float> weights)
+    {
+        SupportPoint points[4];
+        int count = 0;
+        for (const int index : keep) points[count++] = simplex.Points[index];
+
+        int i = 0;
+        for (const float weight : weights) simplex.Weights[i++] = weight;
+        for (i = 0; i < count; ++i) simplex.Points[i] = points[i];
+        simplex.Count = count;
+    }
+
+    //~ Closest point of a triangle to the origin (Ericson, Real-Time Collision Detection 5.1.5),
+    //~ the simplex shrinks to the feature it lies on
+    XMVECTOR SolveTriangle(Simplex& simplex, int ia, int ib, int ic)
+    {
+        const XMVECTOR a = simplex.Points[ia].Point;
+        const XMVECTOR b = simplex.Points[ib].Point;
+        const XMVECTOR c = simplex.Points[ic].Point;
+        const XMVECTOR ab = b - a;
+        const XMVECTOR ac = c - a;
+
+        const float d1 = -Dot(ab, a);
+        const float d2 = -Dot(ac, a);
+        if (d1 <= 0.0f && d2 <= 0.0f)
+        {
+            KeepPoints(simplex, { ia }, { 1.0f });
+            return a;
+        }
+
+        const float d3 = -Dot(ab, b);
+        const float d4 = -Dot(ac, b);
+        if (d3 >= 0.0f && d4 <= d3)
+        {
+            KeepPoints(simplex, { ib }, { 1.0f });
+            return b;
+        }
+
+        const float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        {
+            const float v = d1 / (d1 - d3);
+            KeepPoints(simplex, { ia, ib }, { 1.0f - v, v });
+            return a + ab * v;
+        }
+
+        const float d5 = -Dot(ab, c);
+        const float d6 = -Dot(ac, c);
+        if (d6 >= 0.0f && d5 <= d6)
+        {
+            KeepPoints(simplex, { ic }, { 1.0f });
+            return c;
+        }
+
+        const float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        {
+            const float w = d2 / (d2 - d6);
+            KeepPoints(simplex, { ia, ic }, { 1.0f - w, w });
+            return a + ac * w;
+        }
+
+        const float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        {
+            const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            KeepPoints(simplex, { ib, ic }, { 1.0f - w, w });
+            return b + (c - b) * w;
+        }
+
+        const float denominator = 1.0f / (va + vb + vc);
+        const float v = vb * denominator;
+        const float w = vc * denominator;
+        KeepPoints(simplex, { ia, ib, ic }, { 1.0f - v - w, v, w });
+        return a + ab * v + ac * w;
+    }
+
+    //~ Closest point of the simplex to the origin, false when the tetrahedron contains the origin
+    bool SolveSimplex(Simplex& simplex, XMVECTOR& outClosest)
+    {
+        switch (simplex.Count)
+        {
+        case 1:
+            simplex.Weights[0] = 1.0f;
+            outClosest = simplex.Points[0].Point;
+            return true;
+
+        case 2:
+        {
+            const XMVECTOR a = simplex.Points[0].Point;
+            const XMVECTOR ab = simplex.Points[1].Point - a;
+            const float lengthSq = Dot(ab, ab);
+            const float t = lengthSq > DEGENERATE_EPSILON ? -Dot(a, ab) / lengthSq : 0.0f;
+            if (t <= 0.0f)
+            {
+                KeepPoints(simplex, { 0 }, { 1.0f });
+                outClosest = a;
+            }
+            else if (t >= 1.0f)
+            {
+                KeepPoints(simplex, { 1 }, { 1.0f });
+                outClosest = simplex.Points[0].Point;
+            }
+            else
+            {
+                simplex.Weights[0] = 1.0f - t;
+                simplex.Weights[1] = t;
+                outClosest = a + ab * t;
+            }
+            return true;
+        }
+
+        case 3:
+            outClosest = SolveTriangle(simplex, 0, 1, 2);
+            return true;
+
+        default:
+        {
+            // Faces with the origin on their outer side, each opposite the vertex it is tested against
+            static constexpr int FACES[4][4] = { { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+
+            float bestDistanceSq = FLT_MAX;
+            Simplex best;
+            bool outside = false;
+            for (const auto& face : FACES)
+            {
+                const XMVECTOR a = simplex.Points[face[0]].Point;
+                const XMVECTOR normal = XMVector3Cross(simplex.Points[face[1]].Point - a, simplex.Points[face[2]].Point - a);
+                const float originSide = -Dot(normal, a);
+                const float vertexSide = Dot(normal, simplex.Points[face[3]].Point - a);
+
+                // A flat tetrahedron has no inside, every face is a candidate then
+                if (originSide * vertexSide > 0.0f && std::abs(vertexSide) > DEGENERATE_EPSILON) continue;
+                outside = true;
+
+                Simplex candidate = simplex;
+                const XMVECTOR closest = SolveTriangle(candidate, face[0], face[1], face[2]);
+                const float distanceSq = Dot(closest, closest);
+                if (distanceSq < bestDistanceSq)
+                {
+                    bestDistanceSq = distanceSq;
+                    best = candidate;
+                    outClosest = closest;
+                }
+            }
+            if (!outside) return false;
+
+            simplex = best;
+            return true;
+        }
+        }
+    }
+
+    bool ContainsPoint(const Simplex& simplex, const XMVECTOR& point)
+    {
+        for (int i = 0; i < simplex.Count; ++i)
+        {
+            if (XMVectorGetX(XMVector3LengthSq(simplex.Points[i].Point - point)) < DEGENERATE_EPSILON) return true;
+        }
+        return false;
+    }
+
+    //~ GJK distance loop (van den Bergen). Stops early once a support plane proves the cores are
+    //~ more than limit apart, so far away pairs cost a couple of support calls.
+    GjkStatus RunGjk(const MinkowskiPair& pair, float limit, Simplex& simplex, XMVECTOR& outClosest, int& outIterations)
+    {
+        XMVECTOR direction = pair.B->GetRigidBody()->GetPosition() - pair.A->GetRigidBody()->GetPosition() - pair.OffsetA;
+        if (Dot(direction, direction) < DEGENERATE_EPSILON) direction = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+
+        simplex.Count = 1;
+        simplex.Points[0] = GetSupport(pair, XMVectorNegate(direction));
+        simplex.Weights[0] = 1.0f;
+        XMVECTOR v = simplex.Points[0].Point;
+
+        const float limitSq = limit * limit;
+        for (outIterations = 0; outIterations < ConvexNarrowPhase::MAX_GJK_ITERATIONS; ++outIterations)
+        {
+            const float distanceSq = Dot(v, v);
+            if (distanceSq < DEGENERATE_EPSILON)
+            {
+                outClosest = v;
+                return GjkStatus::Overlapping;
+            }
+
+            const SupportPoint w = GetSupport(pair, XMVectorNegate(v));
+            const float vw = Dot(v, w.Point);
+
+            // Separating plane further out than the limit
+            if (vw > 0.0f && vw * vw > limitSq * distanceSq)
+            {
+                outClosest = v;
+                return GjkStatus::BeyondLimit;
+            }
+
+            // No real progress, v is the closest point up to the tolerance
+            if (distanceSq - vw <= ConvexNarrowPhase::GJK_TOLERANCE * distanceSq || ContainsPoint(simplex, w.Point))
+            {
+                outClosest = v;
+                return GjkStatus::Separated;
+            }
+
+            simplex.Points[simplex.Count++] = w;
+            if (!SolveSimplex(simplex, v))
+            {
+                outClosest = XMVectorZero();
+                return GjkStatus::Overlapping;
+            }
+        }
+
+        outClosest = v;
+        return GjkStatus::Separated;
+    }
+
+    void ClosestPoints(const Simplex& simplex, XMVECTOR& outA, XMVECTOR& outB)
+    {
+        outA = XMVectorZero();
+        outB = XMVectorZero();
+        for (int i = 0; i < simplex.Count; ++i)
+        {
+            outA += simplex.Points[i].OnA * simplex.Weights[i];
+            outB += simplex.Points[i].OnB * simplex.Weights[i];
+        }
+    }
+
+    //~ Grows a GJK simplex that ended on a vertex, edge or triangle around the origin into a
+    //~ tetrahedron, false when the Minkowski difference is flat in some direction
+    bool BuildTetrahedron(const MinkowskiPair& pair, Simplex& simplex)
+    {
+        static const XMVECTOR AXES[3] = {
+            XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f),
+            XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f),
+            XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f),
+        };
+
+        if (simplex.Count == 1)
+        {
+            for (int i = 0; i < 6 && simplex.Count == 1; ++i)
+            {
+                const SupportPoint support = GetSupport(pair, i < 3 ? AXES[i] : XMVectorNegate(AXES[i - 3]));
+                if (!ContainsPoint(simplex, support.Point)) simplex.Points[simplex.Count++] = support;
+            }
+            if (simplex.Count == 1) return false;
+        }
+
+        if (simplex.Count == 2)
+        {
+            const XMVECTOR line = simplex.Points[1].Point - simplex.Points[0].Point;
+
+            // Least aligned world axis, crossed with the line and turned around it in 60 degree steps
+            int axis = 0;
+            XMVECTOR absLine = XMVectorAbs(line);
+            if (XMVectorGetY(absLine) < XMVectorGetByIndex(absLine, axis)) axis = 1;
+            if (XMVectorGetZ(absLine) < XMVectorGetByIndex(absLine, axis)) axis = 2;
+            const XMVECTOR perpendicular = XMVector3Normalize(XMVector3Cross(line, AXES[axis]));
+            const XMVECTOR rotation = XMQuaternionRotationNormal(XMVector3Normalize(line), XM_PI / 3.0f);
+
+            XMVECTOR direction = perpendicular;
+            for (int i = 0; i < 6 && simplex.Count == 2; ++i)
+            {
+                const SupportPoint support = GetSupport(pair, direction);
+                const XMVECTOR offset = XMVector3Cross(line, support.Point - simplex.Points[0].Point);
+                if (Dot(offset, offset) > DEGENERATE_EPSILON) simplex.Points[simplex.Count++] = support;
+                direction = XMVector3Rotate(direction, rotation);
+            }
+            if (simplex.Count == 2) return false;
+        }
+
+        if (simplex.Count == 3)
+        {
+            const XMVECTOR origin = simplex.Points[0].Point;
+            const XMVECTOR normal = XMVector3Cross(simplex.Points[1].Point - origin, simplex.Points[2].Point - origin);
+            for (const XMVECTOR& direction : { normal, XMVectorNegate(normal) })
+            {
+                const SupportPoint support = GetSupport(pair, direction);
+                if (std::abs(Dot(normal, support.Point - origin)) > DEGENERATE_EPSILON)
+                {
+                    simplex.Points[simplex.Count++] = support;
+                    break;
+                }
+            }
+            if (simplex.Count == 3) return false;
+        }
+        return true;
+    }
+
+    struct EpaFace
+    {
+        int Index[3];
+        XMVECTOR Normal; // unit, pointing out of the polytope
+        float Distance;  // of the face plane from the origin
+    };
+
+    struct EpaPolytope
+    {
+        SupportPoint Vertices[MAX_EPA_VERTICES];
+        EpaFace Faces[MAX_EPA_FACES];
+        int VertexCount{ 0 };
+        int FaceCount{ 0 };
+        XMVECTOR Interior; // centroid of the starting tetrahedron, stays inside as the polytope grows
+
+        bool AddFace(int a, int b, int c)
+        {
+            if (FaceCount == MAX_EPA_FACES) return false;
+
+            const XMVECTOR pa = Vertices[a].Point;
+            XMVECTOR normal = XMVector3Cross(Vertices[b].Point - pa, Vertices[c].Point - pa);
+            const float lengthSq = Dot(normal, normal);
+            if (lengthSq < DEGENERATE_EPSILON * DEGENERATE_EPSILON) return false;
+            normal = normal / std::sqrt(lengthSq);
+
+            EpaFace& face = Faces[FaceCount++];
+            face.Index[0] = a;
+            face.Index[1] = b;
+            face.Index[2] = c;
+            if (Dot(normal, pa - Interior) < 0.0f)
+            {
+                normal = XMVectorNegate(normal);
+                face.Index[1] = c;
+                face.Index[2] = b;
+            }
+            face.Normal = normal;
+            face.Distance = Dot(normal, pa);
+            return true;
+        }
+    };
+
+    //~ Adds edge, or drops it when the face on its other side was removed as well
+    void AddHorizonEdge(int (*edges)[2], int& edgeCount, int from, int to)
+    {
+        for (int i = 0; i < edgeCount; ++i)
+        {
+            if (edges[i][0] == to && edges[i][1] == from)
+            {
+                edges[i][0] = edges[edgeCount - 1][0];
+                edges[i][1] = edges[edgeCount - 1][1];
+                --edgeCount;
+                return;
+            }
+        }
+        if (edgeCount < MAX_EPA_EDGES)
+        {
+            edges[edgeCount][0] = from;
+            edges[edgeCount][1] = to;
+            ++edgeCount;
+        }
+    }
+
+    //~ Expanding polytope: the face of A - B closest to the origin is the minimum translation
+    //~ separating the cores, its normal points from a to b
+    bool RunEpa(const MinkowskiPair& pair, const Simplex& simplex,
+        XMVECTOR& outNormal, float& outDepth, XMVECTOR& outPointA, XMVECTOR& outPointB)
+    {
+        EpaPolytope polytope;
+        polytope.Interior = XMVectorZero();
+        for (int i = 0; i < 4; ++i)
+        {
+            polytope.Vertices[i] = simplex.Points[i];
+            polytope.Interior += simplex.Points[i].Point * 0.25f;
+        }
+        polytope.VertexCount = 4;
+
+        if (!polytope.AddFace(0, 1, 2) || !polytope.AddFace(0, 3, 1) ||
+            !polytope.AddFace(0, 2, 3) || !polytope.AddFace(1, 3, 2))
+        {
+            return false;
+        }
+
+        int closest = 0;
+        for (int iteration = 0; iteration < ConvexNarrowPhase::MAX_EPA_ITERATIONS; ++iteration)
+        {
+            closest = 0;
+            for (int i = 1; i < polytope.FaceCount; ++i)
+            {
+                if (polytope.Faces[i].Distance < polytope.Faces[closest].Distance) closest = i;
+            }
+
+            const EpaFace face = polytope.Faces[closest];
+            const SupportPoint support = GetSupport(pair, face.Normal);
+            const float supportDistance = Dot(face.Normal, support.Point);
+
+            // The boundary is no further out than this face
+            if (supportDistance - face.Distance < ConvexNarrowPhase::EPA_TOLERANCE * (std::max)(1.0f, face.Distance)) break;
+            if (polytope.VertexCount == MAX_EPA_VERTICES) break;
+
+            const int newIndex = polytope.VertexCount++;
+            polytope.Vertices[newIndex] = support;
+
+            // Remove every face the new point sees, their outline is the horizon
+            int edges[MAX_EPA_EDGES][2];
+            int edgeCount = 0;
+            for (int i = 0; i < polytope.FaceCount;)
+            {
+                const EpaFace& candidate = polytope.Faces[i];
+                if (Dot(candidate.Normal, support.Point - polytope.Vertices[candidate.Index[0]].Point) <= 0.0f)
+                {
+                    ++i;
+                    continue;
+                }
+
+                AddHorizonEdge(edges, edgeCount, candidate.Index[0], candidate.Index[1]);
+                AddHorizonEdge(edges, edgeCount, candidate.Index[1], candidate.Index[2]);
+                AddHorizonEdge(edges, edgeCount, candidate.Index[2], candidate.Index[0]);
+                polytope.Faces[i] = polytope.Faces[--polytope.FaceCount];
+            }
+
+            bool valid = edgeCount > 0;
+            for (int i = 0; i < edgeCount && valid; ++i)
+            {
+                valid = polytope.AddFace(edges[i][0], edges[i][1], newIndex);
+            }
+
+            // Rounding left a hole, the last face found is as good as it gets
+            if (!valid || polytope.FaceCount == 0)
+            {
+                polytope.Faces[0] = face;
+                polytope.FaceCount = 1;
+                closest = 0;
+                break;
+            }
+        }
+
+        closest = 0;
+        for (int i = 1; i < polytope.FaceCount; ++i)
+        {
+            if (polytope.Faces[i].Distance < polytope.Faces[closest].Distance) closest = i;
+        }
+        const EpaFace& face = polytope.Faces[closest];
+
+        // Barycentric coordinates of the origin's projection on the face carry over to the shapes
+        const SupportPoint& v0 = polytope.Vertices[face.Index[0]];
+        const SupportPoint& v1 = polytope.Vertices[face.Index[1]];
+        const SupportPoint& v2 = polytope.Vertices[face.Index[2]];
+        const XMVECTOR projection = face.Normal * face.Distance;
+
+        const XMVECTOR e0 = v1.Point - v0.Point;
+        const XMVECTOR e1 = v2.Point - v0.Point;
+        const XMVECTOR e2 = projection - v0.Point;
+        const float d00 = Dot(e0, e0);
+        const float d01 = Dot(e0, e1);
+        const float d11 = Dot(e1, e1);
+        const float d20 = Dot(e2, e0);
+        const float d21 = Dot(e2, e1);
+        const float denominator = d00 * d11 - d01 * d01;
+
+        float v = 1.0f / 3.0f;
+        float w = 1.0f / 3.0f;
+        if (std::abs(denominator) > DEGENERATE_EPSILON)
+        {
+            v = (d11 * d20 - d01 * d21) / denominator;
+            w = (d00 * d21 - d01 * d20) / denominator;
+        }
+        const float u = 1.0f - v - w;
+
+        outNormal = face.Normal;
+        outDepth = (std::max)(face.Distance, 0.0f);
+        outPointA = v0.OnA * u + v1.OnA * v + v2.OnA * w;
+        outPointB = v0.OnB * u + v1.OnB * v + v2.OnB * w;
+        return true;
+    }
+}
+
+ConvexNarrowPhase::DistanceResult ConvexNarrowPhase::Distance(const ICollider* a, const ICollider* b)
+{
+    return Distance(a, b, XMVectorZero());
+}
+
+ConvexNarrowPhase::DistanceResult ConvexNarrowPhase::Distance(const ICollider* a, const ICollider* b, const XMVECTOR& offsetA)
+{
+    DistanceResult result;
+    if (!a || !b) return result;
+
+    Simplex simplex;
+    XMVECTOR closest;
+    const GjkStatus status = RunGjk({ a, b, offsetA }, FLT_MAX, simplex, closest, result.Iterations);
+
+    result.Overlapping = status == GjkStatus::Overlapping;
+    if (result.Overlapping) return result;
+
+    XMVECTOR pointA, pointB;
+    ClosestPoints(simplex, pointA, pointB);
+    XMStoreFloat3(&result.PointA, pointA);
+    XMStoreFloat3(&result.PointB, pointB);
+    result.Distance = XMVectorGetX(XMVector3Length(closest));
+    return result;
+}
+
+bool ConvexNarrowPhase::TimeOfImpact(const ICollider* moving, const XMVECTOR& from, const XMVECTOR& to,
+    const ICollider* target, float& outTime, XMFLOAT3& outNormal)
+{
+    if (!moving || !target) return false;
+
+    const float margin = moving->GetSupportMargin() + target->GetSupportMargin();
+    const XMVECTOR start = from - moving->GetRigidBody()->GetPosition();
+    const XMVECTOR motion = to - from;
+
+    float t = 0.0f;
+    for (int iteration = 0; iteration < MAX_TOI_ITERATIONS; ++iteration)
+    {
+        const DistanceResult distance = Distance(moving, target, start + motion * t);
+        if (distance.Overlapping || distance.Distance <= 0.0f) return false;
+
+        // Plane through the closest points separates the shapes, the moving one needs at least
+        // gap / approach of the remaining time to cross it
+        const XMVECTOR towardTarget = (XMLoadFloat3(&distance.PointB) - XMLoadFloat3(&distance.PointA)) / distance.Distance;
+        const float gap = distance.Distance - margin;
+        const float approach = Dot(motion, towardTarget);
+        if (approach <= 0.0f) return false;
+
+        if (gap <= TOI_TOLERANCE)
+        {
+            // Already touching at the start of the sweep is the regular narrowphase's job
+            if (t == 0.0f && gap < 0.0f) return false;
+
+            outTime = t;
+            XMStoreFloat3(&outNormal, XMVectorNegate(towardTarget));
+            return true;
+        }
+
+        t += (gap - 0.5f * TOI_TOLERANCE) / approach;
+        if (t > 1.0f) return false;
+    }
+    return false;
+}
+
+bool ConvexNarrowPhase::Collide(ICollider* a, ICollider* b, Contact& outContact)
+{
+    if (!a || !b) return false;
+
+    const float marginA = a->GetSupportMargin();
+    const float marginB = b->GetSupportMargin();
+    const float margin = marginA + marginB;
+
+    const MinkowskiPair pair{ a, b, XMVectorZero() };
+    Simplex simplex;
+    XMVECTOR closest;
+    int iterations = 0;
+    const GjkStatus status = RunGjk(pair, margin, simplex, closest, iterations);
+    if (status == GjkStatus::BeyondLimit) return false;
+
+    XMVECTOR normal;
+    XMVECTOR pointA;
+    XMVECTOR pointB;
+    float depth;
+
+    const float distance = XMVectorGetX(XMVector3Length(closest));
+    if (status == GjkStatus::Separated && distance * distance > DEGENERATE_EPSILON)
+    {
+        // Cores apart, only the margins overlap
+        if (distance >= margin) return false;
+
+        ClosestPoints(simplex, pointA, pointB);
+        normal = XMVectorNegate(closest) / distance;
+        depth = margin - distance;
+    }
+    else
+    {
+        // Cores overlap (or touch), EPA needs a tetrahedron around the origin to start from
+        if (simplex.Count < 4 && !BuildTetrahedron(pair, simplex)) simplex.Count = 0;
+
+        float coreDepth = 0.0f;
+        if (simplex.Count < 4 || !RunEpa(pair, simplex, normal, coreDepth, pointA, pointB))
+        {
+            // Flat cores, e.g. two crossing capsule segments: push apart along the centres
+            if (margin <= 0.0f) return false;
+
+            normal = b->GetRigidBody()->GetPosition() - a->GetRigidBody()->GetPosition();
+            normal = Dot(normal, normal) > DEGENERATE_EPSILON ? XMVector3Normalize(normal) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+            pointA = a->Support(normal);
+            pointB = b->Support(XMVectorNegate(normal));
+            coreDepth = (std::max)(0.0f, Dot(pointA - pointB, normal));
+        }
+        depth = coreDepth + margin;
+    }
+
+    // Surface points on the full shapes, the contact sits halfway between them
+    pointA += normal * marginA;
+    pointB -= normal * marginB;
+
+    outContact.Colliders[0] = a;
+    outContact.Colliders[1] = b;
+    XMStoreFloat3(&outContact.ContactPoint, (pointA + pointB) * 0.5f);
+    XMStoreFloat3(&outContact.ContactNormal, normal);
+    outContact.PenetrationDepth = depth;
+
+    RigidBody* bodyA = a->GetRigidBody();
+    RigidBody* bodyB = b->GetRigidBody();
+    outContact.Restitution = 0.5f * (bodyA->GetRestitution() + bodyB->GetRestitution());
+    outContact.Friction = 0.5f * (bodyA->GetFriction() + bodyB->GetFriction());
+    outContact.Elasticity = 0.5f * (bodyA->GetElasticity() + bodyB->GetElasticity());
+    return depth > 0.0f;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include "Contact.h"
+
+// Shape independent narrowphase for any pair of convex colliders, driven only by their support
+// mappings (ICollider::Support). GJK finds the distance between the two shapes or that they
+// overlap, EPA then expands the last GJK simplex to the penetration depth and normal.
+// Round shapes run as their core (a sphere's centre, a capsule's segment) plus a margin, so
+// both algorithms only ever see polytopes and a sphere comes out exact instead of faceted.
+class ConvexNarrowPhase
+{
+public:
+    struct DistanceResult
+    {
+        bool Overlapping{ false };  // the cores overlap, Distance and the points are not set
+        float Distance{ 0.0f };     // between the cores, margins not included
+        DirectX::XMFLOAT3 PointA{}; // closest points on the cores
+        DirectX::XMFLOAT3 PointB{};
+        int Iterations{ 0 };
+    };
+
+    //~ GJK between the cores of a and b, with a first moved by offsetA
+    static DistanceResult Distance(const ICollider* a, const ICollider* b);
+    static DistanceResult Distance(const ICollider* a, const ICollider* b, const DirectX::XMVECTOR& offsetA);
+
+    //~ Conservative advancement of moving, translated from body position from to to with its
+    //~ current orientation, against the resting target. Finds the first t in [0, 1] at which
+    //~ the full shapes come within TOI_TOLERANCE, outNormal pointing from target to moving.
+    //~ False when they never meet, move apart, or already overlap at from.
+    static bool TimeOfImpact(const ICollider* moving, const DirectX::XMVECTOR& from, const DirectX::XMVECTOR& to,
+        const ICollider* target, float& outTime, DirectX::XMFLOAT3& outNormal);
+
+    //~ Contact between the full shapes (margins included), normal from a to b
+    static bool Collide(ICollider* a, ICollider* b, Contact& outContact);
+
+    static constexpr int MAX_GJK_ITERATIONS = 32;
+    static constexpr int MAX_EPA_ITERATIONS = 48;
+    //~ GJK stops once a new support point gets the distance this much (relative) closer
+    static constexpr float GJK_TOLERANCE = 1e-4f;
+    //~ EPA stops once the closest face is within this of the shape boundary
+    static constexpr float EPA_TOLERANCE = 1e-4f;
+    static constexpr int MAX_TOI_ITERATIONS = 24;
+    //~ Gap at which a sweep counts as touching, the shapes stop just short of each other
+    static constexpr float TOI_TOLERANCE = 5e-3f;
+};
@@ -9,184 +9,368 @@
 #include "CapsuleCollider.h"
 #include "SphereCollider.h"
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define BOX_SAT_SIMD 1
+#include <immintrin.h>
+#endif
 
-CubeCollider::CubeCollider(RigidBody* body)
-    : ICollider(body)
-{
-    DirectX::XMFLOAT3 scale; DirectX::XMStoreFloat3(&scale, m_Scale);
-    m_RigidBody->ComputeInverseInertiaTensorBox(scale.x, scale.y, scale.z);
-}
-
-bool CubeCollider::CheckCollision(ICollider* other, Contact& outContact)
+namespace
 {
-    if (!other) return false;
+    using namespace DirectX;
 
-    if (other->GetColliderType() == ColliderType::Cube)
+    //~ A face axis of the second box, or an edge pair, only wins over the current best when its
+    //~ overlap is clearly smaller. Resting boxes have several axes within rounding of each other,
+    //~ flipping between them every step would move the contact points around.
+    constexpr float AXIS_TOLERANCE_RELATIVE = 0.95f;
+    constexpr float AXIS_TOLERANCE_ABSOLUTE = 0.001f;
+    //~ Clipping a quad against four planes gives at most eight vertices
+    constexpr int MAX_CLIP_POINTS = 8;
+    //~ Added to |R| in the separating axis test, so two nearly parallel edges (cross product
+    //~ close to zero) never report a separation that only comes from rounding
+    constexpr float SAT_EPSILON = 1e-6f;
+    //~ Squared length below which an edge pair is parallel, its face axes cover that direction
+    constexpr float PARALLEL_EDGE_EPSILON = 1e-6f;
+
+    struct OrientedBox
     {
-        Contact contact = GenerateContactWithCube(other->As<CubeCollider>());
-        outContact = contact;
+        XMVECTOR Center;
+        XMVECTOR Axes[3]; // unit length
+        float Half[3];
+    };
 
-        return contact.PenetrationDepth > 0.0f;
-    }
+    struct ClipPolygon
+    {
+        XMVECTOR Points[MAX_CLIP_POINTS];
+        int Count{ 0 };
+    };
 
-    if (other->GetColliderType() == ColliderType::Sphere)
+    bool ClearlySmaller(float candidate, float current)
     {
-        return CheckCollisionWithSphere(other, outContact);
+        return candidate < current * AXIS_TOLERANCE_RELATIVE - AXIS_TOLERANCE_ABSOLUTE;
     }
-    if (other->GetColliderType() == ColliderType::Capsule)
+
+    OrientedBox MakeOrientedBox(const CubeCollider& collider)
     {
-        return CheckCollisionWithCapsule(other, outContact);
+        const XMMATRIX rotation = collider.GetRigidBody()->GetOrientation().ToRotationMatrix();
+        XMFLOAT3 half;
+        XMStoreFloat3(&half, XMVectorAbs(collider.GetHalfExtents()));
+
+        OrientedBox box;
+        box.Center = collider.GetRigidBody()->GetPosition();
+        box.Axes[0] = XMVector3Normalize(rotation.r[0]);
+        box.Axes[1] = XMVector3Normalize(rotation.r[1]);
+        box.Axes[2] = XMVector3Normalize(rotation.r[2]);
+        box.Half[0] = half.x;
+        box.Half[1] = half.y;
+        box.Half[2] = half.z;
+        return box;
     }
 
-    return false;
-}
-
-ColliderType CubeCollider::GetColliderType() const
-{
-    return ColliderType::Cube;
-}
-
-RigidBody* CubeCollider::GetRigidBody() const
-{
-    return ICollider::GetRigidBody();
-}
-
-DirectX::XMVECTOR CubeCollider::GetHalfExtents() const
-{
-    DirectX::XMVECTOR scale = GetScale();
-    return DirectX::XMVectorScale(scale, 0.5f);
-}
-
-bool CubeCollider::CheckCollisionWithCube(ICollider* other, Contact& outContact)
-{
-    using namespace DirectX;
-
-    // === STEP 1: Type check & cast ===
-    if (!other || other->GetColliderType() != ColliderType::Cube) return false;
-    const CubeCollider* B = other->As<CubeCollider>();
-    if (!B) return false;
-
-    // === STEP 2: Get transforms and OBB axes ===
-    const XMVECTOR posA = m_RigidBody->GetPosition();
-    const XMVECTOR posB = B->GetRigidBody()->GetPosition();
-
-    const XMVECTOR halfA = GetHalfExtents();
-    const XMVECTOR halfB = B->GetHalfExtents();
-
-    const Quaternion qA = m_RigidBody->GetOrientation();
-    const Quaternion qB = B->GetRigidBody()->GetOrientation();
-
-    XMVECTOR axesA[3];
-    XMVECTOR axesB[3];
-
-    GetOBBAxes(qA, axesA);
-    GetOBBAxes(qB, axesB);
-
-    const XMVECTOR toCenter = posB - posA;
+    // Four float lanes for the separating axis test, the kernel below is written once against
+    // these. Only lanes 0..2 carry an axis, lane 3 is padding and masked out of every test.
+    namespace lanes
+    {
+#if defined(BOX_SAT_SIMD)
+        using Float = __m128;
+
+        inline Float Set(float v) { return _mm_set1_ps(v); }
+        inline Float Set(float x, float y, float z) { return _mm_setr_ps(x, y, z, 0.0f); }
+        inline Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+        inline Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+        inline Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+        inline Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+        inline Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+        inline Float Abs(Float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        inline Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+        inline Float Select(Float a, Float b, Float mask)
+        {
+            return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+        }
+        inline int Bits(Float mask) { return _mm_movemask_ps(mask) & 0x7; }
+        inline void Store(float* p, Float v) { _mm_storeu_ps(p, v); }
+        //~ Lane j gets lane (j + 1) % 3, and (j + 2) % 3
+        inline Float Next(Float a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)); }
+        inline Float Previous(Float a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)); }
+#else
+        struct Float { float v[4]; };
+
+        template <typename Op>
+        inline Float Map(Float a, Float b, Op op)
+        {
+            return { { op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]) } };
+        }
 
-    float minOverlap = FLT_MAX;
-    XMVECTOR bestAxis = XMVectorZero();
+        inline Float Set(float v) { return { { v, v, v, v } }; }
+        inline Float Set(float x, float y, float z) { return { { x, y, z, 0.0f } }; }
+        inline Float Add(Float a, Float b) { return Map(a, b, [](float x, float y) { return x + y; }); }
+        inline Float Sub(Float a, Float b) { return Map(a, b, [](float x, float y) { return x - y; }); }
+        inline Float Mul(Float a, Float b) { return Map(a, b, [](float x, float y) { return x * y; }); }
+        inline Float Div(Float a, Float b) { return Map(a, b, [](float x, float y) { return x / y; }); }
+        inline Float Sqrt(Float a) { return Map(a, a, [](float x, float) { return std::sqrt(x); }); }
+        inline Float Abs(Float a) { return Map(a, a, [](float x, float) { return std::abs(x); }); }
+        //~ Masks are 1 / 0 here, Select and Bits only look at non zero
+        inline Float Less(Float a, Float b) { return Map(a, b, [](float x, float y) { return x < y ? 1.0f : 0.0f; }); }
+        inline Float Select(Float a, Float b, Float mask)
+        {
+            return { { mask.v[0] != 0.0f ? b.v[0] : a.v[0], mask.v[1] != 0.0f ? b.v[1] : a.v[1],
+                mask.v[2] != 0.0f ? b.v[2] : a.v[2], mask.v[3] != 0.0f ? b.v[3] : a.v[3] } };
+        }
+        inline int Bits(Float mask)
+        {
+            return (mask.v[0] != 0.0f ? 1 : 0) | (mask.v[1] != 0.0f ? 2 : 0) | (mask.v[2] != 0.0f ? 4 : 0);
+        }
+        inline void Store(float* p, Float v) { for (int i = 0; i < 4; ++i) p[i] = v.v[i]; }
+        inline Float Next(Float a) { return { { a.v[1], a.v[2], a.v[0], a.v[3] } }; }
+        inline Float Previous(Float a) { return { { a.v[2], a.v[0], a.v[1], a.v[3] } }; }
+#endif
+    }
 
-    // === STEP 3: Test all 15 axes ===
-    for (int i = 0; i < 3; ++i)
+    //~ Index of the smallest of the first three values, the first one on ties
+    int ArgMin3(const float values[4])
     {
-        XMVECTOR axis = axesA[i];
-        if (!TryNormalize(axis)) continue;
+        int best = 0;
+        if (values[1] < values[best]) best = 1;
+        if (values[2] < values[best]) best = 2;
+        return best;
+    }
 
-        float projA = ProjectOBB(axis, axesA, halfA);
-        float projB = ProjectOBB(axis, axesB, halfB);
-        float dist = fabsf(XMVectorGetX(XMVector3Dot(toCenter, axis)));
-        float overlap = projA + projB - dist;
+    // The 15 axis separating axis test in the form of Gottschalk et al. (OBBTree): every
+    // axis is expressed through R = rotation of b in a's frame (R[i][j] = dot(a_i, b_j)) and
+    // the centre offset in a's frame, so no axis is ever built, normalized or projected on its
+    // own. The three face axes of a box and the three cross products a_i x b_j for one i each
+    // fill one register, giving five groups with an early out after each.
+    // Overlaps are measured along unit axes, an edge pair's raw overlap is divided by
+    // |a_i x b_j| = sqrt(1 - R[i][j]^2). Parallel edge pairs are skipped.
+    bool TestAxes(const OrientedBox& a, const OrientedBox& b, CubeCollider::AxisOverlap& out)
+    {
+        using namespace lanes;
 
-        if (overlap < 0) return false; // Separating axis found
+        XMFLOAT3 axisA[3];
+        XMFLOAT3 axisB[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            XMStoreFloat3(&axisA[k], a.Axes[k]);
+            XMStoreFloat3(&axisB[k], b.Axes[k]);
+        }
+        XMFLOAT3 offset;
+        XMStoreFloat3(&offset, b.Center - a.Center);
+
+        // Components of the three axes of each box side by side, lane k is axis k
+        const Float ax = Set(axisA[0].x, axisA[1].x, axisA[2].x);
+        const Float ay = Set(axisA[0].y, axisA[1].y, axisA[2].y);
+        const Float az = Set(axisA[0].z, axisA[1].z, axisA[2].z);
+        const Float bx = Set(axisB[0].x, axisB[1].x, axisB[2].x);
+        const Float by = Set(axisB[0].y, axisB[1].y, axisB[2].y);
+        const Float bz = Set(axisB[0].z, axisB[1].z, axisB[2].z);
+
+        // Rows of R (lane j = b_j) and its columns (lane i = a_i)
+        Float row[3];
+        Float absRow[3];
+        Float absColumn[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            row[k] = Add(Add(Mul(bx, Set(axisA[k].x)), Mul(by, Set(axisA[k].y))), Mul(bz, Set(axisA[k].z)));
+            const Float column = Add(Add(Mul(ax, Set(axisB[k].x)), Mul(ay, Set(axisB[k].y))), Mul(az, Set(axisB[k].z)));
+            absRow[k] = Add(Abs(row[k]), Set(SAT_EPSILON));
+            absColumn[k] = Add(Abs(column), Set(SAT_EPSILON));
+        }
 
-        if (overlap < minOverlap)
+        // Centre offset along the axes of a (t) and of b
+        const Float offsetA = Add(Add(Mul(ax, Set(offset.x)), Mul(ay, Set(offset.y))), Mul(az, Set(offset.z)));
+        const Float offsetB = Add(Add(Mul(bx, Set(offset.x)), Mul(by, Set(offset.y))), Mul(bz, Set(offset.z)));
+        float t[4];
+        Store(t, offsetA);
+
+        const Float halfA = Set(a.Half[0], a.Half[1], a.Half[2]);
+        const Float halfB = Set(b.Half[0], b.Half[1], b.Half[2]);
+        const Float zero = Set(0.0f);
+        alignas(16) float overlaps[4];
+
+        // === Face axes of a: a.Half[i] + sum_j b.Half[j] |R[i][j]| - |t[i]| ===
+        Float overlap = Sub(Add(halfA, Add(Add(Mul(Set(b.Half[0]), absColumn[0]), Mul(Set(b.Half[1]), absColumn[1])),
+            Mul(Set(b.Half[2]), absColumn[2]))), Abs(offsetA));
+        if (Bits(Less(overlap, zero))) return false;
+        Store(overlaps, overlap);
+        out.FaceAxis[0] = ArgMin3(overlaps);
+        out.FaceOverlap[0] = overlaps[out.FaceAxis[0]];
+
+        // === Face axes of b: b.Half[j] + sum_i a.Half[i] |R[i][j]| - |dot(offset, b_j)| ===
+        overlap = Sub(Add(halfB, Add(Add(Mul(Set(a.Half[0]), absRow[0]), Mul(Set(a.Half[1]), absRow[1])),
+            Mul(Set(a.Half[2]), absRow[2]))), Abs(offsetB));
+        if (Bits(Less(overlap, zero))) return false;
+        Store(overlaps, overlap);
+        out.FaceAxis[1] = ArgMin3(overlaps);
+        out.FaceOverlap[1] = overlaps[out.FaceAxis[1]];
+
+        // === Edge pairs a_i x b_j, lane j ===
+        out.EdgeOverlap = FLT_MAX;
+        out.EdgeA = -1;
+        out.EdgeB = -1;
+        const Float halfBNext = Next(halfB);
+        const Float halfBPrevious = Previous(halfB);
+        for (int i = 0; i < 3; ++i)
         {
-            minOverlap = overlap;
-            bestAxis = axis;
-            if (XMVectorGetX(XMVector3Dot(toCenter, axis)) < 0)
-                bestAxis = -axis;
+            const int i1 = (i + 1) % 3;
+            const int i2 = (i + 2) % 3;
+
+            const Float radiusA = Add(Mul(Set(a.Half[i1]), absRow[i2]), Mul(Set(a.Half[i2]), absRow[i1]));
+            const Float radiusB = Add(Mul(halfBNext, Previous(absRow[i])), Mul(halfBPrevious, Next(absRow[i])));
+            const Float distance = Abs(Sub(Mul(Set(t[i2]), row[i1]), Mul(Set(t[i1]), row[i2])));
+            const Float lengthSq = Sub(Set(1.0f), Mul(row[i], row[i]));
+            const Float parallel = Less(lengthSq, Set(PARALLEL_EDGE_EPSILON));
+
+            overlap = Sub(Add(radiusA, radiusB), distance);
+            if (Bits(Less(overlap, zero)) & ~Bits(parallel)) return false;
+
+            overlap = Select(Div(overlap, Sqrt(Select(lengthSq, Set(1.0f), parallel))), Set(FLT_MAX), parallel);
+            Store(overlaps, overlap);
+            const int j = ArgMin3(overlaps);
+            if (overlaps[j] < out.EdgeOverlap)
+            {
+                out.EdgeOverlap = overlaps[j];
+                out.EdgeA = i;
+                out.EdgeB = j;
+            }
         }
+        return true;
     }
 
-    for (int i = 0; i < 3; ++i)
+    //~ Corners of the face whose outward normal is sign * Axes[axis], in winding order
+    void GetFace(const OrientedBox& box, int axis, float sign, ClipPolygon& outFace)
     {
-        XMVECTOR axis = axesB[i];
-        if (!TryNormalize(axis)) continue;
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        const XMVECTOR center = box.Center + box.Axes[axis] * (sign * box.Half[axis]);
+        const XMVECTOR du = box.Axes[u] * box.Half[u];
+        const XMVECTOR dv = box.Axes[v] * box.Half[v];
+
+        outFace.Points[0] = center + du + dv;
+        outFace.Points[1] = center - du + dv;
+        outFace.Points[2] = center - du - dv;
+        outFace.Points[3] = center + du - dv;
+        outFace.Count = 4;
+    }
 
-        float projA = ProjectOBB(axis, axesA, halfA);
-        float projB = ProjectOBB(axis, axesB, halfB);
-        float dist = fabsf(XMVectorGetX(XMVector3Dot(toCenter, axis)));
-        float overlap = projA + projB - dist;
+    //~ Sutherland-Hodgman against one plane, keeps the side where dot(normal, p) <= offset
+    void ClipAgainstPlane(const ClipPolygon& input, const XMVECTOR& normal, float offset, ClipPolygon& output)
+    {
+        output.Count = 0;
+        if (input.Count == 0) return;
 
-        if (overlap < 0) return false;
+        XMVECTOR previous = input.Points[input.Count - 1];
+        float previousDistance = XMVectorGetX(XMVector3Dot(normal, previous)) - offset;
 
-        if (overlap < minOverlap)
+        for (int i = 0; i < input.Count && output.Count < MAX_CLIP_POINTS; ++i)
         {
-            minOverlap = overlap;
-            bestAxis = axis;
-            if (XMVectorGetX(XMVector3Dot(toCenter, axis)) < 0)
-                bestAxis = -axis;
+            const XMVECTOR current = input.Points[i];
+            const float distance = XMVectorGetX(XMVector3Dot(normal, current)) - offset;
+
+            // Edge crosses the plane, keep the crossing point
+            if ((previousDistance <= 0.0f) != (distance <= 0.0f))
+            {
+                const float t = previousDistance / (previousDistance - distance);
+                output.Points[output.Count++] = XMVectorLerp(previous, current, t);
+            }
+            if (distance <= 0.0f && output.Count < MAX_CLIP_POINTS)
+            {
+                output.Points[output.Count++] = current;
+            }
+
+            previous = current;
+            previousDistance = distance;
         }
     }
 
-    for (int i = 0; i < 3; ++i)
+    //~ Keeps four of the points spanning the largest area, starting from the deepest
+    int ReducePoints(const XMVECTOR* points, const float* depths, int count, const XMVECTOR& normal, int outIndices[4])
     {
-        for (int j = 0; j < 3; ++j)
+        if (count <= 4)
         {
-            XMVECTOR axis = XMVector3Cross(axesA[i], axesB[j]);
-            if (!TryNormalize(axis)) continue;
-
-            float projA = ProjectOBB(axis, axesA, halfA);
-            float projB = ProjectOBB(axis, axesB, halfB);
-            float dist = fabsf(XMVectorGetX(XMVector3Dot(toCenter, axis)));
-            float overlap = projA + projB - dist;
+            for (int i = 0; i < count; ++i) outIndices[i] = i;
+            return count;
+        }
 
-            if (overlap < 0) return false;
+        int first = 0;
+        for (int i = 1; i < count; ++i)
+        {
+            if (depths[i] > depths[first]) first = i;
+        }
 
-            if (overlap < minOverlap)
+        int second = first == 0 ? 1 : 0;
+        float bestDistanceSq = -1.0f;
+        for (int i = 0; i < count; ++i)
+        {
+            const float distanceSq = XMVectorGetX(XMVector3LengthSq(points[i] - points[first]));
+            if (i != first && distanceSq > bestDistanceSq)
             {
-                minOverlap = overlap;
-                bestAxis = axis;
-                if (XMVectorGetX(XMVector3Dot(toCenter, axis)) < 0)
-                    bestAxis = -axis;
+                bestDistanceSq = distanceSq;
+                second = i;
             }
         }
-    }
 
-    // === STEP 4: Fill out contact data ===
-    outContact.Colliders[0] = this;
-    outContact.Colliders[1] = other;
+        // Largest triangle on either side of the first two points, signed area along the normal
+        int third = -1;
+        int fourth = -1;
+        float maxArea = 0.0f;
+        float minArea = 0.0f;
+        const XMVECTOR edge = points[second] - points[first];
+        for (int i = 0; i < count; ++i)
+        {
+            if (i == first || i == second) continue;
 
-    XMStoreFloat3(&outContact.ContactNormal, bestAxis);
-    outContact.PenetrationDepth = minOverlap;
+            const float area = XMVectorGetX(XMVector3Dot(XMVector3Cross(edge, points[i] - points[first]), normal));
+            if (third < 0 || area > maxArea)
+            {
+                maxArea = area;
+                third = i;
+            }
+            if (fourth < 0 || area < minArea)
+            {
+                minArea = area;
+                fourth = i;
+            }
+        }
 
-    // Approximate center point between boxes (improve later via clipping or contact manifold)
-    XMVECTOR midpoint = 0.5f * (posA + posB);
-    XMStoreFloat3(&outContact.ContactPoint, midpoint);
+        outIndices[0] = first;
+        outIndices[1] = second;
+        outIndices[2] = third;
+        if (fourth == third) return 3;
+        outIndices[3] = fourth;
+        return 4;
+    }
+}
 
-    outContact.Restitution = 0.5f * (
-        m_RigidBody->GetRestitution() + B->GetRigidBody()->GetRestitution());
-    outContact.Friction = 0.5f * (
-        m_RigidBody->GetFriction() + B->GetRigidBody()->GetFriction());
-    outContact.Elasticity = 0.5f * (
-        m_RigidBody->GetElasticity() + B->GetRigidBody()->GetElasticity());
 
-    return true;
+CubeCollider::CubeCollider(RigidBody* body)
+    : ICollider(body)
+{
+    DirectX::XMFLOAT3 scale; DirectX::XMStoreFloat3(&scale, m_Scale);
+    m_RigidBody->ComputeInverseInertiaTensorBox(scale.x, scale.y, scale.z);
 }
 
-bool CubeCollider::CheckCollisionWithSphere(ICollider* other, Contact& outContact)
+ColliderType CubeCollider::GetColliderType() const
 {
-    if (!other || other->GetColliderType() != ColliderType::Sphere) return false;
+    return ColliderType::Cube;
+}
 
-    SphereCollider* sphere = other->As<SphereCollider>();
-    if (!sphere) return false;
+RigidBody* CubeCollider::GetRigidBody() const
+{
+    return ICollider::GetRigidBody();
+}
+
+DirectX::XMVECTOR CubeCollider::GetHalfExtents() const
+{
+    DirectX::XMVECTOR scale = GetScale();
+    return DirectX::XMVectorScale(scale, 0.5f);
+}
 
+bool CubeCollider::CheckCollisionWith(SphereCollider& sphere, Contact& outContact)
+{
     using namespace DirectX;
 
     // === STEP 1: Get transforms ===
-    XMVECTOR sphereCenter = sphere->GetRigidBody()->GetPosition();
-    float radius = sphere->GetRadius();
+    XMVECTOR sphereCenter = sphere.GetRigidBody()->GetPosition();
+    float radius = sphere.GetRadius();
 
     XMVECTOR cubeCenter = m_RigidBody->GetPosition();
     XMVECTOR cubeHalfExtents = GetHalfExtents();
@@ -220,38 +404,34 @@ bool CubeCollider::CheckCollisionWithSphere(ICollider* other, Contact& outContac
 
     // === STEP 5: Fill contact ===
     outContact.Colliders[0] = this;
-    outContact.Colliders[1] = other;
+    outContact.Colliders[1] = &sphere;
 
     XMStoreFloat3(&outContact.ContactPoint, closest);
     XMStoreFloat3(&outContact.ContactNormal, normal);
     outContact.PenetrationDepth = radius - distance;
 
     outContact.Restitution = 0.5f * (
-        m_RigidBody->GetRestitution() + sphere->GetRigidBody()->GetRestitution());
+        m_RigidBody->GetRestitution() + sphere.GetRigidBody()->GetRestitution());
 
     outContact.Friction = 0.5f * (
-        m_RigidBody->GetFriction() + sphere->GetRigidBody()->GetFriction());
+        m_RigidBody->GetFriction() + sphere.GetRigidBody()->GetFriction());
 
     outContact.Elasticity = 0.5f * (
-        m_RigidBody->GetElasticity() + sphere->GetRigidBody()->GetElasticity());
+        m_RigidBody->GetElasticity() + sphere.GetRigidBody()->GetElasticity());
 
     return true;
 }
 
-bool CubeCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outContact)
+bool CubeCollider::CheckCollisionWith(CapsuleCollider& capsule, Contact& outContact)
 {
     using namespace DirectX;
 
-    if (!other || other->GetColliderType() != ColliderType::Capsule) return false;
-    CapsuleCollider* capsule = other->As<CapsuleCollider>();
-    if (!capsule) return false;
-
     RigidBody* cubeBody = m_RigidBody;
-    RigidBody* capsuleBody = capsule->GetRigidBody();
+    RigidBody* capsuleBody = capsule.GetRigidBody();
     if (!cubeBody || !capsuleBody) return false;
 
-    float capsuleRadius = capsule->GetRadius();
-    float capsuleHeight = capsule->GetHeight();
+    float capsuleRadius = capsule.GetRadius();
+    float capsuleHeight = capsule.GetHeight();
 
     // === STEP 1: Get capsule segment endpoints ===
     Quaternion q = capsuleBody->GetOrientation();
@@ -295,7 +475,7 @@ bool CubeCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outConta
 
     // === STEP 4: Fill Contact ===
     outContact.Colliders[0] = this;
-    outContact.Colliders[1] = capsule;
+    outContact.Colliders[1] = &capsule;
 
     XMStoreFloat3(&outContact.ContactPoint, contactPoint);
     XMStoreFloat3(&outContact.ContactNormal, normal);
@@ -308,62 +488,171 @@ bool CubeCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outConta
     return true;
 }
 
-Contact CubeCollider::GenerateContactWithCube(CubeCollider* other)
+bool CubeCollider::CheckCollisionWith(const CubeCollider& other, ContactManifold& outManifold) const
 {
     using namespace DirectX;
 
+    outManifold.Clear();
+
+    // === STEP 1: Both boxes as centre, unit axes and half extents ===
+    const OrientedBox boxes[2] = { MakeOrientedBox(*this), MakeOrientedBox(other) };
+    const OrientedBox& a = boxes[0];
+    const OrientedBox& b = boxes[1];
+    const XMVECTOR toCenter = b.Center - a.Center;
+
+    // === STEP 2: SAT, the best face axis of each box and the best edge pair kept apart ===
+    AxisOverlap axes;
+    if (!TestAxes(a, b, axes)) return false;
+
+    const float* faceOverlap = axes.FaceOverlap;
+    const int* faceAxis = axes.FaceAxis;
+    const float edgeOverlap = axes.EdgeOverlap;
+    const int edgeA = axes.EdgeA;
+    const int edgeB = axes.EdgeB;
+
     Contact contact{};
+    contact.Colliders[0] = const_cast<CubeCollider*>(this);
+    contact.Colliders[1] = const_cast<CubeCollider*>(&other);
+    contact.Restitution = std::min(m_RigidBody->GetRestitution(), other.GetRigidBody()->GetRestitution());
+    contact.Friction = std::sqrt(m_RigidBody->GetFriction() * other.GetRigidBody()->GetFriction());
+    contact.Elasticity = std::min(m_RigidBody->GetElasticity(), other.GetRigidBody()->GetElasticity());
 
-    // Step 1: Compute axes
-    XMVECTOR axesA[3];
-    XMVECTOR axesB[3];
-    this->ComputeWorldAxes(axesA);
-    other->ComputeWorldAxes(axesB);
+    const int reference = ClearlySmaller(faceOverlap[1], faceOverlap[0]) ? 1 : 0;
+    const float bestFaceOverlap = std::min(faceOverlap[0], faceOverlap[1]);
 
-    // Step 2: Build SAT test axes
-    std::vector<XMVECTOR> testAxes;
-    BuildSATTestAxes(axesA, axesB, testAxes);
+    // === STEP 3a: Edge vs edge, one point between the closest points of the two edges ===
+    if (edgeA >= 0 && ClearlySmaller(edgeOverlap, bestFaceOverlap))
+    {
+        XMVECTOR edgeNormal = XMVector3Normalize(XMVector3Cross(a.Axes[edgeA], b.Axes[edgeB]));
+        if (XMVectorGetX(XMVector3Dot(toCenter, edgeNormal)) < 0.0f) edgeNormal = -edgeNormal;
 
-    // Step 3: Run SAT test
-    float penetration;
-    XMVECTOR normal;
-    bool collided = TestOBBsWithSAT(this, other, testAxes, penetration, normal);
+        // Centre of the edge of A furthest along the normal, and of the edge of B furthest against it
+        XMVECTOR pointA = a.Center;
+        XMVECTOR pointB = b.Center;
+        for (int k = 0; k < 3; ++k)
+        {
+            if (k != edgeA)
+            {
+                const float side = XMVectorGetX(XMVector3Dot(a.Axes[k], edgeNormal)) > 0.0f ? 1.0f : -1.0f;
+                pointA += a.Axes[k] * (side * a.Half[k]);
+            }
+            if (k != edgeB)
+            {
+                const float side = XMVectorGetX(XMVector3Dot(b.Axes[k], edgeNormal)) > 0.0f ? -1.0f : 1.0f;
+                pointB += b.Axes[k] * (side * b.Half[k]);
+            }
+        }
+
+        // Closest points of the two edge lines, clamped to the edges
+        const XMVECTOR directionA = a.Axes[edgeA];
+        const XMVECTOR directionB = b.Axes[edgeB];
+        const XMVECTOR offset = pointA - pointB;
+        const float cosine = XMVectorGetX(XMVector3Dot(directionA, directionB));
+        const float projA = XMVectorGetX(XMVector3Dot(directionA, offset));
+        const float projB = XMVectorGetX(XMVector3Dot(directionB, offset));
+        const float denominator = 1.0f - cosine * cosine;
+
+        float s = denominator > 1e-6f ? (cosine * projB - projA) / denominator : 0.0f;
+        s = std::clamp(s, -a.Half[edgeA], a.Half[edgeA]);
+        const float t = std::clamp(projB + s * cosine, -b.Half[edgeB], b.Half[edgeB]);
+
+        const XMVECTOR closestA = pointA + directionA * s;
+        const XMVECTOR closestB = pointB + directionB * t;
+
+        XMStoreFloat3(&contact.ContactPoint, (closestA + closestB) * 0.5f);
+        XMStoreFloat3(&contact.ContactNormal, edgeNormal);
+        contact.PenetrationDepth = edgeOverlap;
+        outManifold.AddPoint(contact);
+        return true;
+    }
 
-    if (!collided)
-        return contact; // No collision
+    // === STEP 3b: Face contact, the incident face clipped by the side planes of the reference face ===
+    const OrientedBox& referenceBox = boxes[reference];
+    const OrientedBox& incidentBox = boxes[1 - reference];
+    const int referenceAxis = faceAxis[reference];
 
-    // Step 4: Ensure normal points from A to B
-    XMVECTOR centerA = this->GetCenter();
-    XMVECTOR centerB = other->GetCenter();
-    XMVECTOR centerDelta = XMVectorSubtract(centerB, centerA);
+    // Reference face normal pointing at the incident box
+    XMVECTOR normal = referenceBox.Axes[referenceAxis];
+    if (XMVectorGetX(XMVector3Dot(incidentBox.Center - referenceBox.Center, normal)) < 0.0f) normal = -normal;
 
-    if (XMVectorGetX(XMVector3Dot(centerDelta, normal)) < 0.0f)
+    // Incident face: the face of the other box most anti-parallel to the reference normal
+    int incidentAxis = 0;
+    float bestAlignment = -1.0f;
+    for (int k = 0; k < 3; ++k)
     {
-        normal = XMVectorNegate(normal);
+        const float alignment = std::abs(XMVectorGetX(XMVector3Dot(incidentBox.Axes[k], normal)));
+        if (alignment > bestAlignment)
+        {
+            bestAlignment = alignment;
+            incidentAxis = k;
+        }
     }
+    const float incidentSign = XMVectorGetX(XMVector3Dot(incidentBox.Axes[incidentAxis], normal)) > 0.0f ? -1.0f : 1.0f;
 
-    // Step 5: Fill out contact
-    XMStoreFloat3(&contact.ContactNormal, normal);
-    contact.PenetrationDepth = penetration;
+    ClipPolygon polygon;
+    ClipPolygon clipped;
+    GetFace(incidentBox, incidentAxis, incidentSign, polygon);
 
-    // Approximate contact point: midpoint between centers
-    XMVECTOR midPoint = XMVectorScale(XMVectorAdd(centerA, centerB), 0.5f);
-    XMStoreFloat3(&contact.ContactPoint, midPoint);
+    for (int side = 1; side <= 2; ++side)
+    {
+        const int k = (referenceAxis + side) % 3;
+        const XMVECTOR sideNormal = referenceBox.Axes[k];
+        const float centerOffset = XMVectorGetX(XMVector3Dot(sideNormal, referenceBox.Center));
 
-    contact.Colliders[0] = this;
-    contact.Colliders[1] = other;
+        ClipAgainstPlane(polygon, sideNormal, centerOffset + referenceBox.Half[k], clipped);
+        ClipAgainstPlane(clipped, -sideNormal, -centerOffset + referenceBox.Half[k], polygon);
+    }
 
-    // Transfer physical properties
-    contact.Restitution = Min(m_RigidBody->GetRestitution(), other->GetRigidBody()->GetRestitution());
-    contact.Friction = std::sqrt(m_RigidBody->GetFriction() * other->GetRigidBody()->GetFriction());
-    contact.Elasticity = Min(m_RigidBody->GetElasticity(), other->GetRigidBody()->GetElasticity());
+    // Only points below the reference face touch, each is moved halfway up to the face
+    const float faceOffset = XMVectorGetX(XMVector3Dot(normal, referenceBox.Center)) + referenceBox.Half[referenceAxis];
+    XMVECTOR points[MAX_CLIP_POINTS];
+    float depths[MAX_CLIP_POINTS];
+    int pointCount = 0;
+    for (int i = 0; i < polygon.Count; ++i)
+    {
+        const float separation = XMVectorGetX(XMVector3Dot(normal, polygon.Points[i])) - faceOffset;
+        if (separation > 0.0f) continue;
+
+        points[pointCount] = polygon.Points[i] - normal * (separation * 0.5f);
+        depths[pointCount] = -separation;
+        ++pointCount;
+    }
 
-    return contact;
+    // Solver normal goes from this box to the other one
+    XMStoreFloat3(&contact.ContactNormal, reference == 0 ? normal : -normal);
+
+    if (pointCount == 0)
+    {
+        // Rounding left nothing inside the face, fall back to the deepest incident corner
+        GetFace(incidentBox, incidentAxis, incidentSign, polygon);
+        int deepest = 0;
+        for (int i = 1; i < polygon.Count; ++i)
+        {
+            if (XMVectorGetX(XMVector3Dot(normal, polygon.Points[i])) <
+                XMVectorGetX(XMVector3Dot(normal, polygon.Points[deepest]))) deepest = i;
+        }
+        XMStoreFloat3(&contact.ContactPoint, polygon.Points[deepest]);
+        contact.PenetrationDepth = bestFaceOverlap;
+        outManifold.AddPoint(contact);
+        return true;
+    }
+
+    int kept[ContactManifold::MAX_POINTS];
+    const int keptCount = ReducePoints(points, depths, pointCount, normal, kept);
+    for (int i = 0; i < keptCount; ++i)
+    {
+        XMStoreFloat3(&contact.ContactPoint, points[kept[i]]);
+        contact.PenetrationDepth = depths[kept[i]];
+        outManifold.AddPoint(contact);
+    }
+    return true;
 }
 
 void CubeCollider::SetScale(const DirectX::XMVECTOR& vector)
 {
     m_Scale = vector;
+    // Resizing a sleeping body has to refresh its bounds and contacts
+    m_RigidBody->WakeUp();
     DirectX::XMFLOAT3 scale; DirectX::XMStoreFloat3(&scale, m_Scale);
     m_RigidBody->ComputeInverseInertiaTensorBox(scale.x, scale.y, scale.z);
 }
@@ -374,29 +663,57 @@ DirectX::XMVECTOR CubeCollider::GetScale() const
     return scale;
 }
 
-void CubeCollider::GetOBBAxes(const Quaternion& q, DirectX::XMVECTOR axes[3])
+AABB CubeCollider::ComputeWorldAABB() const
 {
     using namespace DirectX;
-    XMMATRIX rotMat = q.ToRotationMatrix();
-    axes[0] = rotMat.r[0]; // Right (local X)
-    axes[1] = rotMat.r[1]; // Up    (local Y)
-    axes[2] = rotMat.r[2]; // Forward (local Z)
+
+    const XMMATRIX rotation = m_RigidBody->GetOrientation().ToRotationMatrix();
+    const XMVECTOR half = XMVectorAbs(GetHalfExtents());
+
+    // Project the oriented box onto the world axes
+    XMVECTOR extents = XMVectorAbs(XMVectorScale(rotation.r[0], XMVectorGetX(half)));
+    extents = XMVectorAdd(extents, XMVectorAbs(XMVectorScale(rotation.r[1], XMVectorGetY(half))));
+    extents = XMVectorAdd(extents, XMVectorAbs(XMVectorScale(rotation.r[2], XMVectorGetZ(half))));
+
+    XMFLOAT3 center, ext;
+    XMStoreFloat3(&center, m_RigidBody->GetPosition());
+    XMStoreFloat3(&ext, extents);
+    return AABB::FromCenterExtents(center, ext);
 }
 
-float CubeCollider::ProjectOBB(const DirectX::XMVECTOR& axis, const DirectX::XMVECTOR axes[3], const DirectX::XMVECTOR& halfExtents)
+DirectX::XMVECTOR CubeCollider::Support(const DirectX::XMVECTOR& direction) const
 {
     using namespace DirectX;
-    return fabsf(XMVectorGetX(XMVector3Dot(axes[0], axis))) * XMVectorGetX(halfExtents) +
-        fabsf(XMVectorGetX(XMVector3Dot(axes[1], axis))) * XMVectorGetY(halfExtents) +
-        fabsf(XMVectorGetX(XMVector3Dot(axes[2], axis))) * XMVectorGetZ(halfExtents);
+
+    const XMMATRIX rotation = m_RigidBody->GetOrientation().ToRotationMatrix();
+    const XMVECTOR half = XMVectorAbs(GetHalfExtents());
+
+    // The corner on the direction's side of every face pair
+    XMVECTOR support = m_RigidBody->GetPosition();
+    for (int i = 0; i < 3; ++i)
+    {
+        const float extent = XMVectorGetByIndex(half, i);
+        const float side = XMVectorGetX(XMVector3Dot(rotation.r[i], direction)) < 0.0f ? -extent : extent;
+        support = XMVectorMultiplyAdd(rotation.r[i], XMVectorReplicate(side), support);
+    }
+    return support;
 }
 
-bool CubeCollider::TryNormalize(DirectX::XMVECTOR& axis)
+BoundingSphere CubeCollider::ComputeBoundingSphere() const
+{
+    BoundingSphere sphere;
+    DirectX::XMStoreFloat3(&sphere.Center, m_RigidBody->GetPosition());
+    sphere.Radius = DirectX::XMVectorGetX(DirectX::XMVector3Length(GetHalfExtents()));
+    return sphere;
+}
+
+void CubeCollider::GetOBBAxes(const Quaternion& q, DirectX::XMVECTOR axes[3])
 {
     using namespace DirectX;
-    if (XMVector3LengthSq(axis).m128_f32[0] < 1e-6f) return false;
-    axis = XMVector3Normalize(axis);
-    return true;
+    XMMATRIX rotMat = q.ToRotationMatrix();
+    axes[0] = rotMat.r[0]; // Right (local X)
+    axes[1] = rotMat.r[1]; // Up    (local Y)
+    axes[2] = rotMat.r[2]; // Forward (local Z)
 }
 
 void CubeCollider::ComputeWorldAxes(DirectX::XMVECTOR outAxes[3]) const
@@ -422,106 +739,9 @@ void CubeCollider::ComputeWorldAxes(DirectX::XMVECTOR outAxes[3]) const
     }
 }
 
-void CubeCollider::BuildSATTestAxes(const DirectX::XMVECTOR axesA[3], const DirectX::XMVECTOR axesB[3],
-	std::vector<DirectX::XMVECTOR>& outAxes)
+bool CubeCollider::FindAxisOverlap(const CubeCollider& other, AxisOverlap& outOverlap) const
 {
-    using namespace DirectX;
-    outAxes.clear();
-    outAxes.reserve(15);
-
-    // === 3 Axes from A ===
-    for (int i = 0; i < 3; ++i)
-    {
-        XMVECTOR axis = XMVector3Normalize(axesA[i]);
-        outAxes.push_back(axis);
-    }
-
-    // === 3 Axes from B ===
-    for (int i = 0; i < 3; ++i)
-    {
-        XMVECTOR axis = XMVector3Normalize(axesB[i]);
-        outAxes.push_back(axis);
-    }
-
-    // === 9 Cross Product Axes ===
-    for (int i = 0; i < 3; ++i)
-    {
-        for (int j = 0; j < 3; ++j)
-        {
-            XMVECTOR cross = XMVector3Cross(axesA[i], axesB[j]);
-            float lengthSq = XMVectorGetX(XMVector3LengthSq(cross));
-
-            if (lengthSq > 1e-6f) // Ignore near-zero axes due to collinearity
-            {
-                outAxes.push_back(XMVector3Normalize(cross));
-            }
-        }
-    }
-}
-
-bool CubeCollider::TestOBBsWithSAT(const CubeCollider* boxA, const CubeCollider* boxB,
-	const std::vector<DirectX::XMVECTOR>& axes, float& minPenetrationDepth, DirectX::XMVECTOR& outCollisionNormal)
-{
-    using namespace DirectX;
-
-    const XMVECTOR centerA = boxA->GetCenter();
-    const XMVECTOR centerB = boxB->GetCenter();
-
-    XMVECTOR axesA[3], axesB[3];
-    boxA->ComputeWorldAxes(axesA);
-    boxB->ComputeWorldAxes(axesB);
-
-    const XMVECTOR centerOffset = XMVectorSubtract(centerB, centerA);
-
-    minPenetrationDepth = FLT_MAX;
-    outCollisionNormal = XMVectorZero();
-
-    for (const auto& axis : axes)
-    {
-        if (XMVector3Equal(axis, XMVectorZero())) continue;
-
-        XMVECTOR normalizedAxis = XMVector3Normalize(axis);
-
-        // === Projection of box A onto axis ===
-        float projectionA = 0.0f;
-        for (int i = 0; i < 3; ++i)
-        {
-            projectionA += abs(XMVectorGetX(XMVector3Dot(normalizedAxis, axesA[i])));
-        }
-
-        // === Projection of box B onto axis ===
-        float projectionB = 0.0f;
-        for (int i = 0; i < 3; ++i)
-        {
-            projectionB += abs(XMVectorGetX(XMVector3Dot(normalizedAxis, axesB[i])));
-        }
-
-        // === Distance between centers on this axis ===
-        float centerDistance = abs(XMVectorGetX(XMVector3Dot(normalizedAxis, centerOffset)));
-
-        float totalProjection = projectionA + projectionB;
-
-        if (centerDistance > totalProjection)
-        {
-            // Found a separating axis
-            return false;
-        }
-
-        float overlap = totalProjection - centerDistance;
-        if (overlap < minPenetrationDepth)
-        {
-            minPenetrationDepth = overlap;
-            outCollisionNormal = normalizedAxis;
-
-            // Ensure normal always points from A to B
-            if (XMVectorGetX(XMVector3Dot(normalizedAxis, centerOffset)) < 0)
-            {
-                outCollisionNormal = XMVectorNegate(normalizedAxis);
-            }
-        }
-    }
-
-    return true;
+    return TestAxes(MakeOrientedBox(*this), MakeOrientedBox(other), outOverlap);
 }
 
 DirectX::XMVECTOR CubeCollider::GetCenter() const
@@ -1,52 +1,56 @@
 #pragma once
-#include <vector>
+#include <cfloat>
 
 #include "ICollider.h"
 
+class SphereCollider;
+class CapsuleCollider;
 
 class CubeCollider final : public ICollider
 {
 public:
+	//~ Least overlap of two boxes along each kind of separating axis, all along unit axes
+	struct AxisOverlap
+	{
+		float FaceOverlap[2]{ FLT_MAX, FLT_MAX }; // best face axis of the first / second box
+		int FaceAxis[2]{ 0, 0 };
+		float EdgeOverlap{ FLT_MAX };             // best cross product of an edge of each box
+		int EdgeA{ -1 };                          // -1 when every edge pair is parallel
+		int EdgeB{ -1 };
+	};
+
 	CubeCollider(RigidBody* body);
 	~CubeCollider() override = default;
-	bool CheckCollision(ICollider* other, Contact& outContact) override;
 	ColliderType GetColliderType() const override;
+	DirectX::XMVECTOR Support(const DirectX::XMVECTOR& direction) const override;
 	RigidBody* GetRigidBody() const override;
 	DirectX::XMVECTOR GetHalfExtents() const;
 
 	void GetOBBAxes(const Quaternion& q, DirectX::XMVECTOR axes[3]);
-	float ProjectOBB(const DirectX::XMVECTOR& axis, const DirectX::XMVECTOR axes[3], const DirectX::XMVECTOR& halfExtents);
-	bool TryNormalize(DirectX::XMVECTOR& axis);
-
 	void ComputeWorldAxes(DirectX::XMVECTOR outAxes[3]) const;
-	void BuildSATTestAxes(const DirectX::XMVECTOR axesA[3],
-		const DirectX::XMVECTOR axesB[3],
-		std::vector<DirectX::XMVECTOR>& outAxes);
-	bool TestOBBsWithSAT(
-		const CubeCollider* boxA,
-		const CubeCollider* boxB,
-		const std::vector<DirectX::XMVECTOR>& axes,
-		float& minPenetrationDepth,
-		DirectX::XMVECTOR& outCollisionNormal
-	);
+
+	//~ All 15 separating axes of this box and other at once (SIMD where available), false
+	//~ when one of them separates the boxes
+	bool FindAxisOverlap(const CubeCollider& other, AxisOverlap& outOverlap) const;
 
 	DirectX::XMVECTOR GetCenter() const;
 	DirectX::XMVECTOR GetClosestPoint(DirectX::XMVECTOR point) const;
 
 
-private:
-	//~ Cube Collision Check
-	bool CheckCollisionWithCube(ICollider* other, Contact& outContact);
-	bool CheckCollisionWithSphere(ICollider* other, Contact& outContact);
-	bool CheckCollisionWithCapsule(ICollider* other, Contact& outContact);
-
-	Contact GenerateContactWithCube(CubeCollider* other);
-
-public:
+	//~ Pair tests, reached through CollisionDispatch. Box vs box: SAT for the axis of least
+	//~ overlap, then the incident face clipped against the reference face (up to four points)
+	//~ or the closest points of two edges
+	bool CheckCollisionWith(const CubeCollider& other, ContactManifold& outManifold) const;
+	bool CheckCollisionWith(SphereCollider& sphere, Contact& outContact);
+	bool CheckCollisionWith(CapsuleCollider& capsule, Contact& outContact);
 
 	void SetScale(const DirectX::XMVECTOR& vector) override;
 	DirectX::XMVECTOR GetScale() const override;
 
+protected:
+	AABB ComputeWorldAABB() const override;
+	BoundingSphere ComputeBoundingSphere() const override;
+
 private:
 	DirectX::XMVECTOR m_Scale{ 1.0f, 1.0f, 1.0f };
 };
@@ -3,6 +3,7 @@
 #include "RigidBody.h"
 
 #include <DirectXMath.h>
+#include <cmath>
 
 #include "ICollider.h"
 
@@ -10,7 +11,7 @@ Drag::Drag(float k1, float k2)
     : K1(k1), K2(k2)
 {}
 
-void Drag::UpdateForce(ICollider* collider, float duration)
+void Drag::UpdateForce(ICollider* collider, float /*duration*/)
 {
     if (!collider) return;
     RigidBody* body = collider->GetRigidBody();
@@ -29,3 +30,54 @@ void Drag::UpdateForce(ICollider* collider, float duration)
 
     body->AddForce(dragForce);
 }
+
+void Drag::UpdateForces(std::span<ICollider* const> colliders, float /*duration*/)
+{
+    // === Gather ===
+    // Sleeping bodies have zero velocity, the per collider path would skip them too
+    m_Targets.clear();
+    m_X.clear();
+    m_Y.clear();
+    m_Z.clear();
+    for (ICollider* collider : colliders)
+    {
+        if (!collider) continue;
+        const RigidBody* body = collider->GetRigidBody();
+        if (!body || !body->IsAwake()) continue;
+
+        const BodyHandle handle = body->GetHandle();
+        BodyChunk& chunk = *body->GetStore().GetChunk(handle);
+        const uint32_t lane = BodyStore::GetLane(handle);
+
+        m_Targets.push_back({ &chunk, lane });
+        m_X.push_back(chunk.Velocity.X[lane]);
+        m_Y.push_back(chunk.Velocity.Y[lane]);
+        m_Z.push_back(chunk.Velocity.Z[lane]);
+    }
+
+    // === Forces ===
+    // -(k1 * speed + k2 * speed^2) along the velocity, no branches so the loop vectorises
+    const size_t count = m_Targets.size();
+    float* x = m_X.data();
+    float* y = m_Y.data();
+    float* z = m_Z.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float speed = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        const float scale = speed > 0.0f ? -(K1 + K2 * speed) : 0.0f;
+        x[i] *= scale;
+        y[i] *= scale;
+        z[i] *= scale;
+    }
+
+    // === Scatter ===
+    for (size_t i = 0; i < count; ++i)
+    {
+        BodyChunk& chunk = *m_Targets[i].Chunk;
+        const uint32_t lane = m_Targets[i].Lane;
+
+        chunk.Force.X[lane] += x[i];
+        chunk.Force.Y[lane] += y[i];
+        chunk.Force.Z[lane] += z[i];
+    }
+}
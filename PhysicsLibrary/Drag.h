@@ -1,13 +1,23 @@
 #pragma once
 #include "ForceGenerator.h"
+#include "BodyStore.h"
+
+#include <vector>
 
 class Drag : public ForceGenerator
 {
 public:
 	Drag(float k1, float k2);
 	void UpdateForce(ICollider* collider, float duration) override;
+	void UpdateForces(std::span<ICollider* const> colliders, float duration) override;
 
 private:
+	//~ Gathered velocities of the awake bodies, turned into forces in place
+	std::vector<BodyLane> m_Targets;
+	std::vector<float> m_X;
+	std::vector<float> m_Y;
+	std::vector<float> m_Z;
+
 	float K1; 
 	float K2; 
 };
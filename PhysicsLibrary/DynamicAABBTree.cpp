@@ -0,0 +1,408 @@
+#include "pch.h"
+#include "DynamicAABBTree.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define AABB_TREE_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    //~ Fat boxes are stretched this many steps ahead along the displacement
+    constexpr float DISPLACEMENT_MULTIPLIER = 2.0f;
+
+    //~ Stands in for the infinite inverse of a zero direction component. Finite, so a slab
+    //~ product is never 0 * inf = NaN, and still far beyond any max distance.
+    constexpr float PARALLEL_INV_DIRECTION = 1e30f;
+
+    float SafeInverse(float value)
+    {
+        if (value != 0.0f) return 1.0f / value;
+        return std::signbit(value) ? -PARALLEL_INV_DIRECTION : PARALLEL_INV_DIRECTION;
+    }
+
+    AABB Union(const AABB& a, const AABB& b)
+    {
+        AABB result = a;
+        result.Merge(b);
+        return result;
+    }
+}
+
+DynamicAABBTree::DynamicAABBTree(float margin)
+    : m_Margin(margin)
+{
+}
+
+int DynamicAABBTree::CreateProxy(const AABB& tightBox, uint32_t userData)
+{
+    const int proxyId = AllocateNode();
+
+    Node& node = m_Nodes[proxyId];
+    node.Box = tightBox;
+    node.Box.Expand(m_Margin);
+    node.UserData = userData;
+    node.Height = 0;
+
+    InsertLeaf(proxyId);
+    ++m_ProxyCount;
+    return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxyId)
+{
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    --m_ProxyCount;
+}
+
+bool DynamicAABBTree::MoveProxy(int proxyId, const AABB& tightBox, const DirectX::XMFLOAT3& displacement)
+{
+    if (m_Nodes[proxyId].Box.Contains(tightBox)) return false;
+
+    RemoveLeaf(proxyId);
+
+    AABB fat = tightBox;
+    fat.Expand(m_Margin);
+
+    // Predict further motion so a steadily moving body is not reinserted every step
+    const float dx = DISPLACEMENT_MULTIPLIER * displacement.x;
+    const float dy = DISPLACEMENT_MULTIPLIER * displacement.y;
+    const float dz = DISPLACEMENT_MULTIPLIER * displacement.z;
+    if (dx < 0.0f) fat.Min.x += dx; else fat.Max.x += dx;
+    if (dy < 0.0f) fat.Min.y += dy; else fat.Max.y += dy;
+    if (dz < 0.0f) fat.Min.z += dz; else fat.Max.z += dz;
+
+    m_Nodes[proxyId].Box = fat;
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAABBTree::Clear()
+{
+    m_Nodes.clear();
+    m_Root = NULL_NODE;
+    m_FreeList = NULL_NODE;
+    m_ProxyCount = 0;
+}
+
+DirectX::XMFLOAT3 DynamicAABBTree::InverseDirection(const DirectX::XMFLOAT3& direction)
+{
+    return { SafeInverse(direction.x), SafeInverse(direction.y), SafeInverse(direction.z) };
+}
+
+bool DynamicAABBTree::RayAABB(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& invDirection,
+    const AABB& box, float maxDistance, float& outEntry)
+{
+    float t1 = (box.Min.x - origin.x) * invDirection.x;
+    float t2 = (box.Max.x - origin.x) * invDirection.x;
+    float tMin = std::min(t1, t2);
+    float tMax = std::max(t1, t2);
+
+    t1 = (box.Min.y - origin.y) * invDirection.y;
+    t2 = (box.Max.y - origin.y) * invDirection.y;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    t1 = (box.Min.z - origin.z) * invDirection.z;
+    t2 = (box.Max.z - origin.z) * invDirection.z;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    tMin = std::max(tMin, 0.0f);
+    if (tMax < tMin || tMin > maxDistance) return false;
+
+    outEntry = tMin;
+    return true;
+}
+
+void DynamicAABBTree::RayPacket::SetLane(int lane, const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction,
+    float maxDistance, float radius)
+{
+    OriginX[lane] = origin.x;
+    OriginY[lane] = origin.y;
+    OriginZ[lane] = origin.z;
+    InvDirectionX[lane] = SafeInverse(direction.x);
+    InvDirectionY[lane] = SafeInverse(direction.y);
+    InvDirectionZ[lane] = SafeInverse(direction.z);
+    Radius[lane] = radius;
+    MaxDistance[lane] = maxDistance;
+}
+
+uint32_t DynamicAABBTree::RayPacketAABB(const RayPacket& packet, const AABB& box)
+{
+#if defined(AABB_TREE_SIMD)
+    const __m128 radius = _mm_load_ps(packet.Radius);
+    __m128 tMin = _mm_setzero_ps();
+    __m128 tMax = _mm_load_ps(packet.MaxDistance);
+
+    auto slab = [&](float boxMin, float boxMax, const float* origin, const float* invDirection)
+        {
+            const __m128 o = _mm_load_ps(origin);
+            const __m128 inv = _mm_load_ps(invDirection);
+            const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(boxMin), radius), o), inv);
+            const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_set1_ps(boxMax), radius), o), inv);
+            tMin = _mm_max_ps(tMin, _mm_min_ps(t1, t2));
+            tMax = _mm_min_ps(tMax, _mm_max_ps(t1, t2));
+        };
+    slab(box.Min.x, box.Max.x, packet.OriginX, packet.InvDirectionX);
+    slab(box.Min.y, box.Max.y, packet.OriginY, packet.InvDirectionY);
+    slab(box.Min.z, box.Max.z, packet.OriginZ, packet.InvDirectionZ);
+
+    return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tMin, tMax)));
+#else
+    uint32_t mask = 0;
+    for (int lane = 0; lane < RayPacket::WIDTH; ++lane)
+    {
+        float tMin = 0.0f;
+        float tMax = packet.MaxDistance[lane];
+
+        auto slab = [&](float boxMin, float boxMax, float origin, float invDirection)
+            {
+                const float t1 = (boxMin - packet.Radius[lane] - origin) * invDirection;
+                const float t2 = (boxMax + packet.Radius[lane] - origin) * invDirection;
+                tMin = std::max(tMin, std::min(t1, t2));
+                tMax = std::min(tMax, std::max(t1, t2));
+            };
+        slab(box.Min.x, box.Max.x, packet.OriginX[lane], packet.InvDirectionX[lane]);
+        slab(box.Min.y, box.Max.y, packet.OriginY[lane], packet.InvDirectionY[lane]);
+        slab(box.Min.z, box.Max.z, packet.OriginZ[lane], packet.InvDirectionZ[lane]);
+
+        if (tMin <= tMax) mask |= 1u << lane;
+    }
+    return mask;
+#endif
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+    if (m_FreeList == NULL_NODE)
+    {
+        m_Nodes.emplace_back();
+        return static_cast<int>(m_Nodes.size()) - 1;
+    }
+
+    const int nodeId = m_FreeList;
+    m_FreeList = m_Nodes[nodeId].Parent;
+    m_Nodes[nodeId] = Node{};
+    return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int nodeId)
+{
+    m_Nodes[nodeId].Parent = m_FreeList;
+    m_Nodes[nodeId].Height = -1;
+    m_FreeList = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+    if (m_Root == NULL_NODE)
+    {
+        m_Root = leaf;
+        m_Nodes[leaf].Parent = NULL_NODE;
+        return;
+    }
+
+    // === Find the cheapest sibling by surface area ===
+    const AABB leafBox = m_Nodes[leaf].Box;
+    int index = m_Root;
+    while (!m_Nodes[index].IsLeaf())
+    {
+        const Node& node = m_Nodes[index];
+        const float area = node.Box.SurfaceArea();
+        const float combinedArea = Union(node.Box, leafBox).SurfaceArea();
+
+        // Cost of pairing with this node, and the growth every descendant pays
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child)
+            {
+                const Node& c = m_Nodes[child];
+                const float merged = Union(leafBox, c.Box).SurfaceArea();
+                return (c.IsLeaf() ? merged : merged - c.Box.SurfaceArea()) + inheritanceCost;
+            };
+
+        const float cost1 = descendCost(node.Child1);
+        const float cost2 = descendCost(node.Child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.Child1 : node.Child2;
+    }
+
+    // === Splice a new parent above the sibling ===
+    const int sibling = index;
+    const int oldParent = m_Nodes[sibling].Parent;
+    const int newParent = AllocateNode();
+
+    m_Nodes[newParent].Parent = oldParent;
+    m_Nodes[newParent].Box = Union(leafBox, m_Nodes[sibling].Box);
+    m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+    m_Nodes[newParent].Child1 = sibling;
+    m_Nodes[newParent].Child2 = leaf;
+    m_Nodes[sibling].Parent = newParent;
+    m_Nodes[leaf].Parent = newParent;
+
+    if (oldParent == NULL_NODE)
+    {
+        m_Root = newParent;
+    }
+    else if (m_Nodes[oldParent].Child1 == sibling)
+    {
+        m_Nodes[oldParent].Child1 = newParent;
+    }
+    else
+    {
+        m_Nodes[oldParent].Child2 = newParent;
+    }
+
+    // === Refit and rebalance ancestors ===
+    index = m_Nodes[leaf].Parent;
+    while (index != NULL_NODE)
+    {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+        node.Box = Union(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+
+        index = node.Parent;
+    }
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == m_Root)
+    {
+        m_Root = NULL_NODE;
+        return;
+    }
+
+    const int parent = m_Nodes[leaf].Parent;
+    const int grandParent = m_Nodes[parent].Parent;
+    const int sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+    if (grandParent == NULL_NODE)
+    {
+        m_Root = sibling;
+        m_Nodes[sibling].Parent = NULL_NODE;
+        FreeNode(parent);
+        return;
+    }
+
+    if (m_Nodes[grandParent].Child1 == parent) m_Nodes[grandParent].Child1 = sibling;
+    else m_Nodes[grandParent].Child2 = sibling;
+    m_Nodes[sibling].Parent = grandParent;
+    FreeNode(parent);
+
+    int index = grandParent;
+    while (index != NULL_NODE)
+    {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+        node.Box = Union(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+
+        index = node.Parent;
+    }
+}
+
+// Rotates the taller grandchild up when the children of iA differ in height by more
+// than one. Returns the node now sitting where iA was.
+int DynamicAABBTree::Balance(int iA)
+{
+    Node& A = m_Nodes[iA];
+    if (A.IsLeaf() || A.Height < 2) return iA;
+
+    const int iB = A.Child1;
+    const int iC = A.Child2;
+    Node& B = m_Nodes[iB];
+    Node& C = m_Nodes[iC];
+
+    const int balance = C.Height - B.Height;
+
+    // === Rotate C up ===
+    if (balance > 1)
+    {
+        const int iF = C.Child1;
+        const int iG = C.Child2;
+        Node& F = m_Nodes[iF];
+        Node& G = m_Nodes[iG];
+
+        C.Child1 = iA;
+        C.Parent = A.Parent;
+        A.Parent = iC;
+
+        if (C.Parent == NULL_NODE) m_Root = iC;
+        else if (m_Nodes[C.Parent].Child1 == iA) m_Nodes[C.Parent].Child1 = iC;
+        else m_Nodes[C.Parent].Child2 = iC;
+
+        if (F.Height > G.Height)
+        {
+            C.Child2 = iF;
+            A.Child2 = iG;
+            G.Parent = iA;
+            A.Box = Union(B.Box, G.Box);
+            C.Box = Union(A.Box, F.Box);
+            A.Height = 1 + std::max(B.Height, G.Height);
+            C.Height = 1 + std::max(A.Height, F.Height);
+        }
+        else
+        {
+            C.Child2 = iG;
+            A.Child2 = iF;
+            F.Parent = iA;
+            A.Box = Union(B.Box, F.Box);
+            C.Box = Union(A.Box, G.Box);
+            A.Height = 1 + std::max(B.Height, F.Height);
+            C.Height = 1 + std::max(A.Height, G.Height);
+        }
+        return iC;
+    }
+
+    // === Rotate B up ===
+    if (balance < -1)
+    {
+        const int iD = B.Child1;
+        const int iE = B.Child2;
+        Node& D = m_Nodes[iD];
+        Node& E = m_Nodes[iE];
+
+        B.Child1 = iA;
+        B.Parent = A.Parent;
+        A.Parent = iB;
+
+        if (B.Parent == NULL_NODE) m_Root = iB;
+        else if (m_Nodes[B.Parent].Child1 == iA) m_Nodes[B.Parent].Child1 = iB;
+        else m_Nodes[B.Parent].Child2 = iB;
+
+        if (D.Height > E.Height)
+        {
+            B.Child2 = iD;
+            A.Child1 = iE;
+            E.Parent = iA;
+            A.Box = Union(C.Box, E.Box);
+            B.Box = Union(A.Box, D.Box);
+            A.Height = 1 + std::max(C.Height, E.Height);
+            B.Height = 1 + std::max(A.Height, D.Height);
+        }
+        else
+        {
+            B.Child2 = iE;
+            A.Child1 = iD;
+            D.Parent = iA;
+            A.Box = Union(C.Box, D.Box);
+            B.Box = Union(A.Box, E.Box);
+            A.Height = 1 + std::max(C.Height, D.Height);
+            B.Height = 1 + std::max(A.Height, E.Height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "AABB.h"
+
+// Bounding volume hierarchy over fat AABBs. Leaves hold a box slightly larger than the
+// collider so small motion needs no tree update at all; only a leaf whose tight box
+// escapes its fat box is removed and reinserted. Insertion follows the surface area
+// heuristic and every ancestor is rebalanced with a single rotation on the way back up.
+class DynamicAABBTree
+{
+public:
+    static constexpr int NULL_NODE = -1;
+
+    // Four rays tested against each node at once, laid out as structure of arrays so one
+    // slab test covers every lane. A lane's boxes are grown by its radius, which turns the
+    // ray into a sphere cast at the bounds level, and a negative max distance switches it off.
+    struct RayPacket
+    {
+        static constexpr int WIDTH = 4;
+
+        alignas(16) float OriginX[WIDTH]{};
+        alignas(16) float OriginY[WIDTH]{};
+        alignas(16) float OriginZ[WIDTH]{};
+        alignas(16) float InvDirectionX[WIDTH]{};
+        alignas(16) float InvDirectionY[WIDTH]{};
+        alignas(16) float InvDirectionZ[WIDTH]{};
+        alignas(16) float Radius[WIDTH]{};
+        alignas(16) float MaxDistance[WIDTH]{ -1.0f, -1.0f, -1.0f, -1.0f };
+
+        //~ direction must be normalized
+        void SetLane(int lane, const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction,
+            float maxDistance, float radius = 0.0f);
+    };
+
+    explicit DynamicAABBTree(float margin = 0.1f);
+
+    int CreateProxy(const AABB& tightBox, uint32_t userData);
+    void DestroyProxy(int proxyId);
+
+    //~ Returns true when the leaf had to be reinserted
+    bool MoveProxy(int proxyId, const AABB& tightBox, const DirectX::XMFLOAT3& displacement);
+
+    void Clear();
+
+    const AABB& GetFatAABB(int proxyId) const { return m_Nodes[proxyId].Box; }
+    uint32_t GetUserData(int proxyId) const { return m_Nodes[proxyId].UserData; }
+    int GetHeight() const { return m_Root == NULL_NODE ? 0 : m_Nodes[m_Root].Height; }
+    int GetProxyCount() const { return m_ProxyCount; }
+    float GetMargin() const { return m_Margin; }
+
+    //~ callback(proxyId) -> false stops the query
+    template<typename Callback>
+    void Query(const AABB& box, Callback&& callback) const;
+
+    //~ callback(proxyId, entryDistance) -> new max distance, 0 stops the cast.
+    //~ direction must be normalized.
+    template<typename Callback>
+    void RayCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float maxDistance, Callback&& callback) const;
+
+    //~ callback(proxyId, laneMask) -> false stops the cast. Called for every leaf at least one
+    //~ lane of the packet reaches (bit i set for lane i), and may shorten the lanes' max distance.
+    template<typename Callback>
+    void RayCastPacket(RayPacket& packet, Callback&& callback) const;
+
+    //~ Per axis inverse for RayAABB, a zero component gets a huge finite value of its sign
+    //~ instead of inf so a ray starting on a slab plane never multiplies 0 by inf
+    static DirectX::XMFLOAT3 InverseDirection(const DirectX::XMFLOAT3& direction);
+    static bool RayAABB(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& invDirection,
+        const AABB& box, float maxDistance, float& outEntry);
+    //~ Lanes of the packet whose grown box the ray enters within its max distance, as a bit mask
+    static uint32_t RayPacketAABB(const RayPacket& packet, const AABB& box);
+
+private:
+    struct Node
+    {
+        AABB Box{};
+        uint32_t UserData{ 0 };
+        int Parent{ NULL_NODE }; // next free node while on the free list
+        int Child1{ NULL_NODE };
+        int Child2{ NULL_NODE };
+        int Height{ -1 };        // leaf = 0, free = -1
+
+        bool IsLeaf() const { return Child1 == NULL_NODE; }
+    };
+
+    // Traversal stack living on the caller's stack so queries stay thread safe.
+    // A balanced tree never gets close to the fixed capacity, the vector is a safety net.
+    struct NodeStack
+    {
+        static constexpr int CAPACITY = 128;
+        int Fixed[CAPACITY];
+        int Count{ 0 };
+        std::vector<int> Overflow;
+
+        void Push(int nodeId)
+        {
+            if (Count < CAPACITY) Fixed[Count++] = nodeId;
+            else Overflow.push_back(nodeId);
+        }
+        int Pop()
+        {
+            if (!Overflow.empty())
+            {
+                const int nodeId = Overflow.back();
+                Overflow.pop_back();
+                return nodeId;
+            }
+            return Fixed[--Count];
+        }
+        bool Empty() const { return Count == 0 && Overflow.empty(); }
+    };
+
+    int AllocateNode();
+    void FreeNode(int nodeId);
+
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    int Balance(int nodeId);
+
+private:
+    std::vector<Node> m_Nodes;
+    int m_Root{ NULL_NODE };
+    int m_FreeList{ NULL_NODE };
+    int m_ProxyCount{ 0 };
+    float m_Margin{ 0.1f };
+};
+
+template<typename Callback>
+void DynamicAABBTree::Query(const AABB& box, Callback&& callback) const
+{
+    if (m_Root == NULL_NODE) return;
+
+    NodeStack stack;
+    stack.Push(m_Root);
+
+    while (!stack.Empty())
+    {
+        const int nodeId = stack.Pop();
+
+        const Node& node = m_Nodes[nodeId];
+        if (!node.Box.Overlaps(box)) continue;
+
+        if (node.IsLeaf())
+        {
+            if (!callback(nodeId)) return;
+        }
+        else
+        {
+            stack.Push(node.Child1);
+            stack.Push(node.Child2);
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::RayCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float maxDistance, Callback&& callback) const
+{
+    if (m_Root == NULL_NODE) return;
+
+    const DirectX::XMFLOAT3 invDirection = InverseDirection(direction);
+
+    NodeStack stack;
+    stack.Push(m_Root);
+
+    while (!stack.Empty())
+    {
+        const int nodeId = stack.Pop();
+
+        const Node& node = m_Nodes[nodeId];
+        float entry;
+        if (!RayAABB(origin, invDirection, node.Box, maxDistance, entry)) continue;
+
+        if (node.IsLeaf())
+        {
+            const float clipped = callback(nodeId, entry);
+            if (clipped <= 0.0f) return;
+            if (clipped < maxDistance) maxDistance = clipped;
+        }
+        else
+        {
+            stack.Push(node.Child1);
+            stack.Push(node.Child2);
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::RayCastPacket(RayPacket& packet, Callback&& callback) const
+{
+    if (m_Root == NULL_NODE) return;
+
+    NodeStack stack;
+    stack.Push(m_Root);
+
+    while (!stack.Empty())
+    {
+        const int nodeId = stack.Pop();
+
+        // A node is entered as long as any lane still reaches it, the rest ride along masked
+        const Node& node = m_Nodes[nodeId];
+        const uint32_t mask = RayPacketAABB(packet, node.Box);
+        if (!mask) continue;
+
+        if (node.IsLeaf())
+        {
+            if (!callback(nodeId, mask)) return;
+        }
+        else
+        {
+            stack.Push(node.Child1);
+            stack.Push(node.Child2);
+        }
+    }
+}
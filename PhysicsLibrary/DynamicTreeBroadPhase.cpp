@@ -0,0 +1,251 @@
+#include "pch.h"
+#include "DynamicTreeBroadPhase.h"
+
+#include <algorithm>
+
+DynamicTreeBroadPhase::DynamicTreeBroadPhase(float margin)
+    : m_StaticTree(margin), m_DynamicTree(margin)
+{
+}
+
+void DynamicTreeBroadPhase::Update(const std::vector<ICollider*>& colliders)
+{
+    ++m_Frame;
+    m_ReinsertCount = 0;
+    m_MoveBuffer.clear();
+
+    // === Sync proxies and refit moved leaves ===
+    for (uint32_t i = 0; i < colliders.size(); ++i)
+    {
+        ICollider* collider = colliders[i];
+        const AABB box = collider->GetWorldAABB();
+        const bool isStatic = collider->GetColliderState() == ColliderState::Static;
+
+        uint32_t id;
+        auto it = m_ProxyLookup.find(collider);
+        if (it == m_ProxyLookup.end())
+        {
+            id = CreateProxy(collider, box, isStatic);
+            m_MoveBuffer.push_back(id);
+        }
+        else
+        {
+            id = it->second;
+            Proxy& proxy = m_Proxies[id];
+
+            if (proxy.IsStatic != isStatic)
+            {
+                // State toggled from the UI, move it to the other tree
+                TreeFor(proxy).DestroyProxy(proxy.TreeId);
+                proxy.IsStatic = isStatic;
+                proxy.TreeId = TreeFor(proxy).CreateProxy(box, id);
+                m_MoveBuffer.push_back(id);
+            }
+            else
+            {
+                const DirectX::XMFLOAT3 oldCenter = proxy.Box.GetCenter();
+                const DirectX::XMFLOAT3 newCenter = box.GetCenter();
+                const DirectX::XMFLOAT3 displacement{
+                    newCenter.x - oldCenter.x, newCenter.y - oldCenter.y, newCenter.z - oldCenter.z };
+
+                if (TreeFor(proxy).MoveProxy(proxy.TreeId, box, displacement)) m_MoveBuffer.push_back(id);
+            }
+            proxy.Box = box;
+        }
+
+        Proxy& proxy = m_Proxies[id];
+        proxy.ListIndex = i;
+        proxy.LastSeen = m_Frame;
+    }
+    m_ReinsertCount = m_MoveBuffer.size();
+
+    RemoveStaleProxies();
+
+    // === Drop pairs whose fat boxes drifted apart ===
+    for (auto it = m_FatPairs.begin(); it != m_FatPairs.end();)
+    {
+        const Proxy& a = m_Proxies[static_cast<uint32_t>(*it >> 32)];
+        const Proxy& b = m_Proxies[static_cast<uint32_t>(*it & 0xFFFFFFFFu)];
+        if (a.Alive && b.Alive && TreeFor(a).GetFatAABB(a.TreeId).Overlaps(TreeFor(b).GetFatAABB(b.TreeId)))
+        {
+            ++it;
+            continue;
+        }
+        it = m_FatPairs.erase(it);
+    }
+
+    // === Only proxies whose fat box changed can start new overlaps ===
+    for (const uint32_t id : m_MoveBuffer)
+    {
+        const Proxy& proxy = m_Proxies[id];
+        const AABB& fatBox = TreeFor(proxy).GetFatAABB(proxy.TreeId);
+
+        auto collect = [&](const DynamicAABBTree& tree)
+            {
+                tree.Query(fatBox, [&](int treeId)
+                    {
+                        const uint32_t otherId = tree.GetUserData(treeId);
+                        if (otherId != id) m_FatPairs.insert(MakePairKey(id, otherId));
+                        return true;
+                    });
+            };
+
+        // Static proxies never look at each other
+        collect(m_DynamicTree);
+        if (!proxy.IsStatic) collect(m_StaticTree);
+    }
+
+    // === Narrow the persistent fat pairs down to touching tight boxes ===
+    m_PairKeys.clear();
+    for (const uint64_t key : m_FatPairs)
+    {
+        const Proxy& a = m_Proxies[static_cast<uint32_t>(key >> 32)];
+        const Proxy& b = m_Proxies[static_cast<uint32_t>(key & 0xFFFFFFFFu)];
+        if (!a.Box.Overlaps(b.Box)) continue;
+        if (!ShouldTestPair(a.Collider, b.Collider)) continue;
+
+        const uint32_t lo = std::min(a.ListIndex, b.ListIndex);
+        const uint32_t hi = std::max(a.ListIndex, b.ListIndex);
+        m_PairKeys.push_back((static_cast<uint64_t>(lo) << 32) | hi);
+    }
+
+    std::sort(m_PairKeys.begin(), m_PairKeys.end());
+
+    m_Pairs.clear();
+    m_Pairs.reserve(m_PairKeys.size());
+    for (const uint64_t pairKey : m_PairKeys)
+    {
+        const uint32_t i = static_cast<uint32_t>(pairKey >> 32);
+        const uint32_t j = static_cast<uint32_t>(pairKey & 0xFFFFFFFFu);
+        m_Pairs.push_back({ colliders[i], colliders[j] });
+    }
+}
+
+void DynamicTreeBroadPhase::Remove(ICollider* collider)
+{
+    // The proxy is no longer found, so it is not seen this step and goes with the stale ones
+    m_ProxyLookup.erase(collider);
+}
+
+void DynamicTreeBroadPhase::Clear()
+{
+    m_Pairs.clear();
+    m_StaticTree.Clear();
+    m_DynamicTree.Clear();
+    m_Proxies.clear();
+    m_FreeProxies.clear();
+    m_ProxyLookup.clear();
+    m_MoveBuffer.clear();
+    m_FatPairs.clear();
+    m_PairKeys.clear();
+    m_ReinsertCount = 0;
+}
+
+BroadPhaseType DynamicTreeBroadPhase::GetType() const
+{
+    return BroadPhaseType::DynamicTree;
+}
+
+const char* DynamicTreeBroadPhase::GetName() const
+{
+    return "Dynamic AABB Tree";
+}
+
+void DynamicTreeBroadPhase::QueryOverlap(const AABB& box, std::vector<ICollider*>& outColliders) const
+{
+    auto collect = [&](const DynamicAABBTree& tree)
+        {
+            tree.Query(box, [&](int treeId)
+                {
+                    const Proxy& proxy = m_Proxies[tree.GetUserData(treeId)];
+                    if (proxy.Box.Overlaps(box)) outColliders.push_back(proxy.Collider);
+                    return true;
+                });
+        };
+
+    collect(m_StaticTree);
+    collect(m_DynamicTree);
+}
+
+void DynamicTreeBroadPhase::RayCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction,
+    float maxDistance, std::vector<BroadPhaseRayHit>& outHits) const
+{
+    using namespace DirectX;
+
+    XMFLOAT3 dir;
+    XMStoreFloat3(&dir, XMVector3Normalize(XMLoadFloat3(&direction)));
+    const XMFLOAT3 invDirection = DynamicAABBTree::InverseDirection(dir);
+
+    const size_t first = outHits.size();
+    auto collect = [&](const DynamicAABBTree& tree)
+        {
+            tree.RayCast(origin, dir, maxDistance, [&](int treeId, float)
+                {
+                    const Proxy& proxy = m_Proxies[tree.GetUserData(treeId)];
+
+                    float entry;
+                    if (DynamicAABBTree::RayAABB(origin, invDirection, proxy.Box, maxDistance, entry))
+                    {
+                        outHits.push_back({ proxy.Collider, entry });
+                    }
+                    return maxDistance;
+                });
+        };
+
+    collect(m_StaticTree);
+    collect(m_DynamicTree);
+
+    std::sort(outHits.begin() + first, outHits.end(), [](const BroadPhaseRayHit& a, const BroadPhaseRayHit& b)
+        {
+            return a.Distance < b.Distance;
+        });
+}
+
+uint32_t DynamicTreeBroadPhase::CreateProxy(ICollider* collider, const AABB& box, bool isStatic)
+{
+    uint32_t id;
+    if (!m_FreeProxies.empty())
+    {
+        id = m_FreeProxies.back();
+        m_FreeProxies.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(m_Proxies.size());
+        m_Proxies.emplace_back();
+    }
+
+    Proxy& proxy = m_Proxies[id];
+    proxy.Collider = collider;
+    proxy.Box = box;
+    proxy.IsStatic = isStatic;
+    proxy.Alive = true;
+    proxy.TreeId = TreeFor(proxy).CreateProxy(box, id);
+
+    m_ProxyLookup[collider] = id;
+    return id;
+}
+
+void DynamicTreeBroadPhase::RemoveStaleProxies()
+{
+    for (uint32_t id = 0; id < m_Proxies.size(); ++id)
+    {
+        Proxy& proxy = m_Proxies[id];
+        if (!proxy.Alive || proxy.LastSeen == m_Frame) continue;
+
+        TreeFor(proxy).DestroyProxy(proxy.TreeId);
+        // A detached proxy's address may already belong to a new collider's proxy
+        auto it = m_ProxyLookup.find(proxy.Collider);
+        if (it != m_ProxyLookup.end() && it->second == id) m_ProxyLookup.erase(it);
+        proxy.Alive = false;
+        proxy.TreeId = DynamicAABBTree::NULL_NODE;
+        m_FreeProxies.push_back(id);
+    }
+}
+
+uint64_t DynamicTreeBroadPhase::MakePairKey(uint32_t a, uint32_t b)
+{
+    const uint32_t lo = std::min(a, b);
+    const uint32_t hi = std::max(a, b);
+    return (static_cast<uint64_t>(lo) << 32) | hi;
+}
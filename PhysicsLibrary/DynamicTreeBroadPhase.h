@@ -0,0 +1,73 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "DynamicAABBTree.h"
+#include "IBroadPhase.h"
+
+struct BroadPhaseRayHit
+{
+    ICollider* Collider{ nullptr };
+    float Distance{ 0.0f }; // entry distance into the collider's AABB
+};
+
+// Two dynamic AABB trees: one for ColliderState::Static colliders, one for the rest.
+// Fat box overlaps are kept as persistent pairs and only proxies whose fat box was
+// reinserted this step query the trees for new ones, so resting bodies and platforms
+// cost a containment check per step. Static proxies never query the static tree.
+// Both trees also serve overlap and raycast queries for gameplay code.
+class DynamicTreeBroadPhase final : public IBroadPhase
+{
+public:
+    explicit DynamicTreeBroadPhase(float margin = 0.1f);
+
+    void Update(const std::vector<ICollider*>& colliders) override;
+    void Remove(ICollider* collider) override;
+    void Clear() override;
+    BroadPhaseType GetType() const override;
+    const char* GetName() const override;
+
+    //~ Colliders whose AABB overlaps box, as of the last Update
+    void QueryOverlap(const AABB& box, std::vector<ICollider*>& outColliders) const;
+
+    //~ Colliders whose AABB the ray enters within maxDistance, nearest first
+    void RayCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction,
+        float maxDistance, std::vector<BroadPhaseRayHit>& outHits) const;
+
+    int GetStaticTreeHeight() const { return m_StaticTree.GetHeight(); }
+    int GetDynamicTreeHeight() const { return m_DynamicTree.GetHeight(); }
+    size_t GetReinsertCount() const { return m_ReinsertCount; }
+
+private:
+    struct Proxy
+    {
+        ICollider* Collider{ nullptr };
+        AABB Box{};
+        int TreeId{ DynamicAABBTree::NULL_NODE };
+        uint32_t ListIndex{ 0 };
+        uint64_t LastSeen{ 0 };
+        bool IsStatic{ false };
+        bool Alive{ false };
+    };
+
+    uint32_t CreateProxy(ICollider* collider, const AABB& box, bool isStatic);
+    void RemoveStaleProxies();
+    DynamicAABBTree& TreeFor(const Proxy& proxy) { return proxy.IsStatic ? m_StaticTree : m_DynamicTree; }
+    const DynamicAABBTree& TreeFor(const Proxy& proxy) const { return proxy.IsStatic ? m_StaticTree : m_DynamicTree; }
+    static uint64_t MakePairKey(uint32_t a, uint32_t b);
+
+private:
+    DynamicAABBTree m_StaticTree;
+    DynamicAABBTree m_DynamicTree;
+
+    std::vector<Proxy> m_Proxies;
+    std::vector<uint32_t> m_FreeProxies;
+    std::unordered_map<ICollider*, uint32_t> m_ProxyLookup;
+    std::vector<uint32_t> m_MoveBuffer;
+    std::unordered_set<uint64_t> m_FatPairs;
+
+    std::vector<uint64_t> m_PairKeys;
+    uint64_t m_Frame{ 0 };
+    size_t m_ReinsertCount{ 0 };
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 class ICollider;
 
 class ForceGenerator
@@ -14,4 +16,11 @@ public:
 	ForceGenerator& operator=(const ForceGenerator&) = default;
 
 	virtual void UpdateForce(ICollider* body, float duration) = 0;
+
+	//~ Every collider registered with this generator in one call. Generators with a cheaper
+	//~ batched form override it, the rest fall back to one UpdateForce per collider.
+	virtual void UpdateForces(std::span<ICollider* const> colliders, float duration)
+	{
+		for (ICollider* collider : colliders) UpdateForce(collider, duration);
+	}
 };
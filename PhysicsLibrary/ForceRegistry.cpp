@@ -5,56 +5,80 @@
 
 void ForceRegistry::Add(ICollider* collider, ForceGenerator* fg)
 {
-    RegisteredForces.push({ collider, fg });
+    if (!collider || !fg) return;
+
+    GeneratorGroup* group = FindGroup(fg);
+    if (!group)
+    {
+        group = &Groups.emplace_back();
+        group->Generator = fg;
+    }
+
+    const auto [slot, added] = group->Slots.try_emplace(collider, static_cast<uint32_t>(group->Colliders.size()));
+    if (added) group->Colliders.push_back(collider);
 }
 
 void ForceRegistry::Remove(ICollider* collider, ForceGenerator* fg)
 {
-    Concurrency::concurrent_queue<ForceRegistration> tempQueue;
-
-    ForceRegistration reg;
-    while (RegisteredForces.try_pop(reg))
+    if (GeneratorGroup* group = FindGroup(fg))
     {
-        if (!(reg.Collider == collider && reg.ForceGenerates == fg))
-        {
-            tempQueue.push(reg); // Keep it
-        }
+        RemoveFromGroup(*group, collider);
     }
+}
 
-    // Restore filtered entries
-    ForceRegistration requeue;
-    while (tempQueue.try_pop(requeue))
+void ForceRegistry::Remove(ICollider* collider)
+{
+    for (GeneratorGroup& group : Groups)
     {
-        RegisteredForces.push(requeue);
+        RemoveFromGroup(group, collider);
     }
 }
 
 void ForceRegistry::Clear()
 {
-    ForceRegistration reg;
-    while (RegisteredForces.try_pop(reg)) { /* drop all */ }
+    Groups.clear();
 }
 
 void ForceRegistry::UpdateForces(float duration)
 {
-    Concurrency::concurrent_queue<ForceRegistration> tempQueue;
-
-    ForceRegistration reg;
-    while (RegisteredForces.try_pop(reg))
+    for (GeneratorGroup& group : Groups)
     {
-        if (reg.Collider && reg.ForceGenerates)
-        {
-            reg.ForceGenerates->UpdateForce(reg.Collider, duration);
-        }
+        if (group.Colliders.empty()) continue;
+        group.Generator->UpdateForces(group.Colliders, duration);
+    }
+}
 
-        // Re-add it after use (preserves queue)
-        tempQueue.push(reg);
+size_t ForceRegistry::GetRegistrationCount() const
+{
+    size_t count = 0;
+    for (const GeneratorGroup& group : Groups)
+    {
+        count += group.Colliders.size();
     }
+    return count;
+}
+
+ForceRegistry::GeneratorGroup* ForceRegistry::FindGroup(const ForceGenerator* fg)
+{
+    // A handful of generators at most, a linear scan beats hashing
+    auto it = std::find_if(Groups.begin(), Groups.end(),
+        [fg](const GeneratorGroup& group) { return group.Generator == fg; });
+    return it != Groups.end() ? &*it : nullptr;
+}
+
+void ForceRegistry::RemoveFromGroup(GeneratorGroup& group, const ICollider* collider)
+{
+    auto it = group.Slots.find(collider);
+    if (it == group.Slots.end()) return;
+
+    const uint32_t slot = it->second;
+    group.Slots.erase(it);
 
-    // Restore the original queue
-    ForceRegistration requeue;
-    while (tempQueue.try_pop(requeue))
+    ICollider* last = group.Colliders.back();
+    group.Colliders.pop_back();
+    if (slot < group.Colliders.size())
     {
-        RegisteredForces.push(requeue);
+        group.Colliders[slot] = last;
+        group.Slots[last] = slot;
     }
 }
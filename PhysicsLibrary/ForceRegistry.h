@@ -1,25 +1,37 @@
 #pragma once
+#include <unordered_map>
 #include <vector>
 #include "ForceGenerator.h"
 #include "ICollider.h"
 
-#include <concurrent_queue.h>
-
 
+// Registrations grouped by generator, each group a flat array of colliders handed to its
+// generator as one span per step. Registering the same pair twice has no effect.
+// Not thread safe, PhysicsWorld only touches it from the step and its collider changes,
+// which its owner already serialises.
 class  ForceRegistry
 {
 public:
     void Add(ICollider* collider, ForceGenerator* fg);
+    //~ O(1), the last collider of the group takes the removed one's slot
     void Remove(ICollider* collider, ForceGenerator* fg);
+    //~ Every registration of the collider, one O(1) removal per generator
+    void Remove(ICollider* collider);
     void Clear();
     void UpdateForces(float duration);
 
+    size_t GetRegistrationCount() const;
+
 protected:
-    struct ForceRegistration
+    struct GeneratorGroup
     {
-        ICollider* Collider;
-        ForceGenerator* ForceGenerates;
+        ForceGenerator* Generator{ nullptr };
+        std::vector<ICollider*> Colliders;
+        std::unordered_map<const ICollider*, uint32_t> Slots; // index into Colliders
     };
 
-    Concurrency::concurrent_queue<ForceRegistration> RegisteredForces;
+    GeneratorGroup* FindGroup(const ForceGenerator* fg);
+    static void RemoveFromGroup(GeneratorGroup& group, const ICollider* collider);
+
+    std::vector<GeneratorGroup> Groups;
 };
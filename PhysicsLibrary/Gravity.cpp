@@ -9,18 +9,11 @@ Gravity::Gravity(const DirectX::XMVECTOR& g)
 {
 }
 
-void Gravity::UpdateForce(ICollider* collider, float duration)
+void Gravity::UpdateForce(ICollider* collider, float /*duration*/)
 {
     //~ Pre checks
-    if (!IsGravityOn() || !collider) return;
+    if (!IsGravityOn() || !ShouldApply(collider)) return;
     RigidBody* rigidBody = collider->GetRigidBody();
-    if (collider->IsReverseAware() != m_Reversed)
-    {
-        collider->SetReverseAware(m_Reversed);
-        rigidBody->SetRestingState(false);
-    }
-    if (rigidBody->GetRestingState()) return;
-    if (!rigidBody->HasFiniteMass() || collider->GetColliderState() == ColliderState::Static) return;
 
     //~ Thread safe access
     DirectX::XMVECTOR gravity = m_GravityForce;
@@ -34,6 +27,71 @@ void Gravity::UpdateForce(ICollider* collider, float duration)
     rigidBody->AddForce(force);
 }
 
+void Gravity::UpdateForces(std::span<ICollider* const> colliders, float /*duration*/)
+{
+    if (!IsGravityOn()) return;
+
+    // === Gather ===
+    m_Targets.clear();
+    m_InverseMass.clear();
+    for (ICollider* collider : colliders)
+    {
+        if (!ShouldApply(collider)) continue;
+
+        const RigidBody* body = collider->GetRigidBody();
+        const BodyLane target{ body->GetStore().GetChunk(body->GetHandle()), BodyStore::GetLane(body->GetHandle()) };
+        m_Targets.push_back(target);
+        m_InverseMass.push_back(target.Chunk->InverseMass[target.Lane]);
+    }
+
+    // === Forces ===
+    // g * mass, every target has a finite mass since ShouldApply left the others out
+    DirectX::XMFLOAT3 gravity{};
+    DirectX::XMStoreFloat3(&gravity, m_GravityForce);
+
+    const size_t count = m_Targets.size();
+    m_X.resize(count);
+    m_Y.resize(count);
+    m_Z.resize(count);
+    const float* inverseMass = m_InverseMass.data();
+    float* x = m_X.data();
+    float* y = m_Y.data();
+    float* z = m_Z.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float mass = 1.0f / inverseMass[i];
+        x[i] = gravity.x * mass;
+        y[i] = gravity.y * mass;
+        z[i] = gravity.z * mass;
+    }
+
+    // === Scatter ===
+    // Every target is awake, so the force goes straight into the store without AddForce's wake up
+    for (size_t i = 0; i < count; ++i)
+    {
+        BodyChunk& chunk = *m_Targets[i].Chunk;
+        const uint32_t lane = m_Targets[i].Lane;
+
+        chunk.Force.X[lane] += x[i];
+        chunk.Force.Y[lane] += y[i];
+        chunk.Force.Z[lane] += z[i];
+    }
+}
+
+bool Gravity::ShouldApply(ICollider* collider)
+{
+    if (!collider) return false;
+    RigidBody* rigidBody = collider->GetRigidBody();
+    if (collider->IsReverseAware() != m_Reversed)
+    {
+        collider->SetReverseAware(m_Reversed);
+        rigidBody->SetRestingState(false);
+        rigidBody->WakeUp();
+    }
+    if (rigidBody->GetRestingState() || !rigidBody->IsAwake()) return false;
+    return rigidBody->HasFiniteMass() && collider->GetColliderState() != ColliderState::Static;
+}
+
 bool Gravity::IsGravityOn() const
 {
     return m_GravityOn;
@@ -56,6 +114,11 @@ void Gravity::ReverseGravity()
     m_GravityForce = XMLoadFloat3(&gravity);
 }
 
+bool Gravity::IsReversed() const
+{
+    return m_Reversed;
+}
+
 DirectX::XMVECTOR Gravity::GetGravityForce() const
 {
     return m_GravityForce;
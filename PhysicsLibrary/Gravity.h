@@ -1,6 +1,8 @@
 #pragma once
 #include "ForceGenerator.h"
+#include "BodyStore.h"
 #include <DirectXMath.h>
+#include <vector>
 
 
 class Gravity : public ForceGenerator
@@ -8,13 +10,25 @@ class Gravity : public ForceGenerator
 public:
     Gravity(const DirectX::XMVECTOR& g);
     void UpdateForce(ICollider* collider, float duration) override;
+    void UpdateForces(std::span<ICollider* const> colliders, float duration) override;
 
     bool IsGravityOn() const;
     void SetGravity(bool flag);
     void ReverseGravity();
+    bool IsReversed() const;
     DirectX::XMVECTOR GetGravityForce() const;
 
 private:
+    //~ Same checks as UpdateForce, true when the body should receive gravity this step
+    bool ShouldApply(ICollider* collider);
+
+private:
+    //~ Gathered inverse masses of the bodies to pull, and the forces computed from them
+    std::vector<BodyLane> m_Targets;
+    std::vector<float> m_InverseMass;
+    std::vector<float> m_X;
+    std::vector<float> m_Y;
+    std::vector<float> m_Z;
     bool m_Reversed{ false };
     bool m_GravityOn{ false };
     DirectX::XMVECTOR m_GravityForce;
@@ -0,0 +1,9 @@
+#include "pch.h"
+#include "IBroadPhase.h"
+
+bool IBroadPhase::ShouldTestPair(ICollider* a, ICollider* b)
+{
+    // Static vs static never produces a response
+    return !(a->GetColliderState() == ColliderState::Static &&
+        b->GetColliderState() == ColliderState::Static);
+}
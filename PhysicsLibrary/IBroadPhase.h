@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "AABB.h"
+#include "ICollider.h"
+
+enum class BroadPhaseType: uint8_t
+{
+    BruteForce,
+    SpatialHash,
+    SweepAndPrune,
+    DynamicTree,
+};
+
+// Candidate pair handed to the narrowphase. A always came before B in the
+// collider list passed to Update, so CheckCollision keeps the old i < j roles.
+struct ColliderPair
+{
+    ICollider* A{ nullptr };
+    ICollider* B{ nullptr };
+};
+
+class IBroadPhase
+{
+public:
+    IBroadPhase() = default;
+    virtual ~IBroadPhase() = default;
+
+    IBroadPhase(const IBroadPhase&) = delete;
+    IBroadPhase(IBroadPhase&&) = delete;
+    IBroadPhase& operator=(const IBroadPhase&) = delete;
+    IBroadPhase& operator=(IBroadPhase&&) = delete;
+
+    //~ Rebuilds the candidate pair list for this step
+    virtual void Update(const std::vector<ICollider*>& colliders) = 0;
+    //~ Detaches the collider's proxy, a collider later allocated at the same address starts
+    //~ from a new one. The proxy itself goes at the next Update, like any collider that left.
+    virtual void Remove(ICollider* collider) = 0;
+    virtual void Clear() = 0;
+    virtual BroadPhaseType GetType() const = 0;
+    virtual const char* GetName() const = 0;
+
+    const std::vector<ColliderPair>& GetPairs() const { return m_Pairs; }
+
+    static bool ShouldTestPair(ICollider* a, ICollider* b);
+
+protected:
+    std::vector<ColliderPair> m_Pairs;
+};
@@ -1,10 +1,27 @@
 #include "pch.h"
 #include "ICollider.h"
+#include "CollisionDispatch.h"
+#include "Contact.h"
 
 ICollider::ICollider(RigidBody* attachBody)
 	: m_RigidBody(attachBody)
 {}
 
+bool ICollider::CheckCollision(ICollider* other, Contact& outContact)
+{
+	if (!other || !BoundsOverlap(other)) return false;
+
+	return CollisionDispatch::Collide(this, other, outContact);
+}
+
+bool ICollider::GenerateManifold(ICollider* other, ContactManifold& outManifold)
+{
+	outManifold.Clear();
+	if (!other || !BoundsOverlap(other)) return false;
+
+	return CollisionDispatch::Collide(this, other, outManifold);
+}
+
 void ICollider::RegisterCollision(const ICollider* collider)
 {
 	RigidBody* rigidBody = collider->GetRigidBody();
@@ -28,7 +45,7 @@ void ICollider::RegisterCollision(const ICollider* collider)
 	}
 }
 
-ColliderState ICollider::GetColliderState()
+ColliderState ICollider::GetColliderState() const
 {
 	ColliderState state = m_ColliderState;
 	return state;
@@ -46,6 +63,7 @@ const char* ICollider::ToString() const
 	case ColliderType::Cube:    return "Cube";
 	case ColliderType::Sphere:  return "Sphere";
 	case ColliderType::Capsule: return "Capsule";
+	case ColliderType::ConvexHull: return "ConvexHull";
 	default:                    return "Unknown";
 	}
 	return "null";
@@ -58,6 +76,7 @@ const char* ICollider::GetColliderTypeName() const
 	    case ColliderType::Cube: return "Cube";
 	    case ColliderType::Sphere: return "Sphere";
 	    case ColliderType::Capsule: return "Capsule";
+	    case ColliderType::ConvexHull: return "ConvexHull";
 	    default: return "Unknown";
     }
 }
@@ -82,6 +101,13 @@ void ICollider::Update(float deltaTime)
 		DirectX::XMMatrixRotationQuaternion(m_RigidBody->GetOrientation().ToXmVector()) *
 		DirectX::XMMatrixTranslationFromVector(m_RigidBody->GetPosition());
 
+	UpdateBounds();
+}
+
+void ICollider::UpdateBounds()
+{
+	m_WorldAABB = ComputeWorldAABB();
+	m_BoundingSphere = ComputeBoundingSphere();
 }
 
 DirectX::XMMATRIX ICollider::GetWorldMatrix() const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include "AABB.h"
 #include "RigidBody.h"
 
 #include <atomic>
@@ -8,12 +9,14 @@
 #include <unordered_map>
 
 struct Contact;
+struct ContactManifold;
 
 enum class ColliderType: uint8_t
 {
     Cube,
     Sphere,
     Capsule,
+    ConvexHull,
 };
 
 enum class ColliderState: uint8_t
@@ -31,16 +34,24 @@ public:
     ICollider(RigidBody* attachBody);
     virtual ~ICollider() = default;
 
-    // Collision interface
-    virtual bool CheckCollision(ICollider* other, Contact& outContact) = 0;
+    // Collision interface, bounds test then the pair test CollisionDispatch picks for both types
+    bool CheckCollision(ICollider* other, Contact& outContact);
+    //~ Every contact point against other, up to four for box pairs
+    bool GenerateManifold(ICollider* other, ContactManifold& outManifold);
     virtual ColliderType GetColliderType() const = 0;
 
+    //~ Support mapping for ConvexNarrowPhase: the world space point of the shape's core that is
+    //~ furthest along direction (need not be normalized). The full shape is the core grown by
+    //~ GetSupportMargin, which lets spheres and capsules use a point and a segment as core.
+    virtual DirectX::XMVECTOR Support(const DirectX::XMVECTOR& direction) const = 0;
+    virtual float GetSupportMargin() const { return 0.0f; }
+
     void RegisterCollision(const ICollider* collider);
 
     // Access to parent rigid body
     virtual RigidBody* GetRigidBody() const { return m_RigidBody; }
 
-    ColliderState GetColliderState();
+    ColliderState GetColliderState() const;
     void SetColliderState(ColliderState state);
     virtual void SetScale(const DirectX::XMVECTOR& vector) = 0;
     virtual DirectX::XMVECTOR GetScale() const = 0;
@@ -69,11 +80,28 @@ public:
     void SetReverseAware(bool flag) { m_ReverseAware = flag; }
     bool IsReverseAware() const { return m_ReverseAware; }
 
+    //~ World space bounds, refreshed once per step by Update
+    void UpdateBounds();
+    const AABB& GetWorldAABB() const { return m_WorldAABB; }
+    const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+    bool BoundsOverlap(const ICollider* other) const { return m_WorldAABB.Overlaps(other->m_WorldAABB); }
+
+    //~ Position in the current step's collider list, assigned by IslandManager
+    void SetSimulationIndex(uint32_t index) { m_SimulationIndex = index; }
+    uint32_t GetSimulationIndex() const { return m_SimulationIndex; }
+
+protected:
+    virtual AABB ComputeWorldAABB() const = 0;
+    virtual BoundingSphere ComputeBoundingSphere() const = 0;
+
 protected:
     bool m_ReverseAware{ false };
     ColliderState m_ColliderState = ColliderState::Dynamic;
     RigidBody* m_RigidBody;
     DirectX::XMMATRIX m_TransformationMatrix{};
+    AABB m_WorldAABB{};
+    BoundingSphere m_BoundingSphere{};
+    uint32_t m_SimulationIndex{ 0 };
 
     //~ Platform
     struct CollisionInfo
@@ -0,0 +1,257 @@
+#include "pch.h"
+#include "IslandManager.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    //~ A static collider moving faster than this (a platform) keeps the bodies on it awake
+    constexpr float KINEMATIC_SPEED_SQ = 1e-6f;
+
+    bool IsSleepingDynamic(const ICollider* collider)
+    {
+        RigidBody* body = collider->GetRigidBody();
+        return collider->GetColliderState() != ColliderState::Static && body && !body->IsAwake();
+    }
+}
+
+bool IslandManager::IsAwakeDynamic(ICollider* collider)
+{
+    RigidBody* body = collider->GetRigidBody();
+    return collider->GetColliderState() != ColliderState::Static && body && body->HasFiniteMass() && body->IsAwake();
+}
+
+size_t IslandManager::WakeTouchedIslands(const std::vector<ICollider*>& colliders, const std::vector<Contact>& contacts)
+{
+    m_TouchedSleepIslands.clear();
+    for (const Contact& contact : contacts)
+    {
+        ICollider* a = contact.Colliders[0];
+        ICollider* b = contact.Colliders[1];
+
+        if (IsAwakeDynamic(a) && IsSleepingDynamic(b)) m_TouchedSleepIslands.push_back(b->GetRigidBody()->GetSleepIsland());
+        else if (IsAwakeDynamic(b) && IsSleepingDynamic(a)) m_TouchedSleepIslands.push_back(a->GetRigidBody()->GetSleepIsland());
+    }
+    return WakeIslands(colliders, m_TouchedSleepIslands);
+}
+
+size_t IslandManager::WakeAll(const std::vector<ICollider*>& colliders)
+{
+    size_t woken = 0;
+    for (ICollider* collider : colliders)
+    {
+        if (!IsSleepingDynamic(collider)) continue;
+        collider->GetRigidBody()->WakeUp();
+        ++woken;
+    }
+    return woken;
+}
+
+void IslandManager::QueueWake(const ICollider* collider)
+{
+    if (IsSleepingDynamic(collider)) m_QueuedSleepIslands.push_back(collider->GetRigidBody()->GetSleepIsland());
+}
+
+size_t IslandManager::WakeQueued(const std::vector<ICollider*>& colliders)
+{
+    return WakeIslands(colliders, m_QueuedSleepIslands);
+}
+
+void IslandManager::Build(const std::vector<ICollider*>& colliders, const std::vector<Contact>& contacts)
+{
+    using namespace DirectX;
+
+    const uint32_t count = static_cast<uint32_t>(colliders.size());
+
+    // === Union bodies that touch ===
+    m_Parent.resize(count);
+    std::iota(m_Parent.begin(), m_Parent.end(), 0u);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        colliders[i]->SetSimulationIndex(i);
+    }
+
+    for (const Contact& contact : contacts)
+    {
+        ICollider* a = contact.Colliders[0];
+        ICollider* b = contact.Colliders[1];
+        if (IsAwakeDynamic(a) && IsAwakeDynamic(b))
+        {
+            Union(a->GetSimulationIndex(), b->GetSimulationIndex());
+        }
+    }
+
+    // === Number islands by first appearance so the layout is stable ===
+    m_RootIsland.assign(count, NO_ISLAND);
+    m_BodyIsland.assign(count, NO_ISLAND);
+
+    uint32_t islandCount = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (!IsAwakeDynamic(colliders[i])) continue;
+
+        const uint32_t root = Find(i);
+        if (m_RootIsland[root] == NO_ISLAND) m_RootIsland[root] = islandCount++;
+        m_BodyIsland[i] = m_RootIsland[root];
+    }
+
+    // === Bucket colliders per island ===
+    m_ColliderOffsets.assign(islandCount + 1, 0);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (m_BodyIsland[i] != NO_ISLAND) ++m_ColliderOffsets[m_BodyIsland[i] + 1];
+    }
+    std::partial_sum(m_ColliderOffsets.begin(), m_ColliderOffsets.end(), m_ColliderOffsets.begin());
+
+    m_IslandColliders.resize(m_ColliderOffsets.back());
+    std::vector<uint32_t> cursor(m_ColliderOffsets.begin(), m_ColliderOffsets.end() - 1);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (m_BodyIsland[i] != NO_ISLAND) m_IslandColliders[cursor[m_BodyIsland[i]]++] = colliders[i];
+    }
+
+    m_LargestIslandSize = 0;
+    for (uint32_t island = 0; island < islandCount; ++island)
+    {
+        m_LargestIslandSize = std::max<size_t>(m_LargestIslandSize, m_ColliderOffsets[island + 1] - m_ColliderOffsets[island]);
+    }
+
+    // === Bucket contacts, a contact belongs to the island of its awake dynamic side ===
+    m_IslandCanSleep.assign(islandCount, 1);
+
+    std::vector<uint32_t> contactIsland(contacts.size(), NO_ISLAND);
+    m_ContactOffsets.assign(islandCount + 1, 0);
+    for (uint32_t c = 0; c < contacts.size(); ++c)
+    {
+        ICollider* a = contacts[c].Colliders[0];
+        ICollider* b = contacts[c].Colliders[1];
+
+        ICollider* other = nullptr;
+        if (IsAwakeDynamic(a))
+        {
+            contactIsland[c] = m_BodyIsland[a->GetSimulationIndex()];
+            other = b;
+        }
+        else if (IsAwakeDynamic(b))
+        {
+            contactIsland[c] = m_BodyIsland[b->GetSimulationIndex()];
+            other = a;
+        }
+        if (contactIsland[c] == NO_ISLAND) continue;
+
+        ++m_ContactOffsets[contactIsland[c] + 1];
+
+        if (other->GetColliderState() == ColliderState::Static &&
+            XMVectorGetX(XMVector3LengthSq(other->GetRigidBody()->GetVelocity())) > KINEMATIC_SPEED_SQ)
+        {
+            m_IslandCanSleep[contactIsland[c]] = 0;
+        }
+    }
+    std::partial_sum(m_ContactOffsets.begin(), m_ContactOffsets.end(), m_ContactOffsets.begin());
+
+    m_IslandContacts.resize(m_ContactOffsets.back());
+    cursor.assign(m_ContactOffsets.begin(), m_ContactOffsets.end() - 1);
+    for (uint32_t c = 0; c < contacts.size(); ++c)
+    {
+        if (contactIsland[c] != NO_ISLAND) m_IslandContacts[cursor[contactIsland[c]]++] = c;
+    }
+
+    // === Solve order, ties keep island order so the schedule is the same every run ===
+    m_SolveOrder.clear();
+    for (uint32_t island = 0; island < islandCount; ++island)
+    {
+        if (m_ContactOffsets[island + 1] > m_ContactOffsets[island]) m_SolveOrder.push_back(island);
+    }
+    std::stable_sort(m_SolveOrder.begin(), m_SolveOrder.end(), [this](uint32_t a, uint32_t b)
+        {
+            return m_ContactOffsets[a + 1] - m_ContactOffsets[a] > m_ContactOffsets[b + 1] - m_ContactOffsets[b];
+        });
+}
+
+size_t IslandManager::UpdateSleep(float dt, const SleepSettings& settings)
+{
+    size_t sleptBodies = 0;
+    for (size_t island = 0; island < GetIslandCount(); ++island)
+    {
+        const std::span<ICollider* const> colliders = GetIslandColliders(island);
+
+        // Every timer keeps running so a woken island does not inherit stale ones
+        float minSleepTime = settings.TimeToSleep;
+        for (ICollider* collider : colliders)
+        {
+            const float sleepTime = collider->GetRigidBody()->UpdateSleepTime(
+                dt, settings.LinearVelocity, settings.AngularVelocity);
+            minSleepTime = std::min(minSleepTime, sleepTime);
+        }
+
+        if (!settings.Enabled || !m_IslandCanSleep[island] || minSleepTime < settings.TimeToSleep) continue;
+
+        const uint32_t sleepIsland = m_NextSleepIsland++;
+        if (m_NextSleepIsland == 0) m_NextSleepIsland = 1;
+
+        for (ICollider* collider : colliders)
+        {
+            collider->GetRigidBody()->PutToSleep(sleepIsland);
+        }
+        sleptBodies += colliders.size();
+    }
+    return sleptBodies;
+}
+
+std::span<ICollider* const> IslandManager::GetIslandColliders(size_t island) const
+{
+    return { m_IslandColliders.data() + m_ColliderOffsets[island],
+             m_ColliderOffsets[island + 1] - m_ColliderOffsets[island] };
+}
+
+std::span<const uint32_t> IslandManager::GetIslandContacts(size_t island) const
+{
+    return { m_IslandContacts.data() + m_ContactOffsets[island],
+             m_ContactOffsets[island + 1] - m_ContactOffsets[island] };
+}
+
+size_t IslandManager::WakeIslands(const std::vector<ICollider*>& colliders, std::vector<uint32_t>& sleepIslands)
+{
+    if (sleepIslands.empty()) return 0;
+
+    std::sort(sleepIslands.begin(), sleepIslands.end());
+    sleepIslands.erase(std::unique(sleepIslands.begin(), sleepIslands.end()), sleepIslands.end());
+
+    size_t woken = 0;
+    for (ICollider* collider : colliders)
+    {
+        if (!IsSleepingDynamic(collider)) continue;
+
+        RigidBody* body = collider->GetRigidBody();
+        if (std::binary_search(sleepIslands.begin(), sleepIslands.end(), body->GetSleepIsland()))
+        {
+            body->WakeUp();
+            ++woken;
+        }
+    }
+    sleepIslands.clear();
+    return woken;
+}
+
+uint32_t IslandManager::Find(uint32_t index)
+{
+    // Path halving
+    while (m_Parent[index] != index)
+    {
+        m_Parent[index] = m_Parent[m_Parent[index]];
+        index = m_Parent[index];
+    }
+    return index;
+}
+
+void IslandManager::Union(uint32_t a, uint32_t b)
+{
+    const uint32_t rootA = Find(a);
+    const uint32_t rootB = Find(b);
+    if (rootA == rootB) return;
+
+    // Lower index wins so the result does not depend on contact order
+    if (rootA < rootB) m_Parent[rootB] = rootA;
+    else m_Parent[rootA] = rootB;
+}
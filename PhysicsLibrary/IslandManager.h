@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Contact.h"
+
+struct SleepSettings
+{
+    bool Enabled{ true };
+    float LinearVelocity{ 0.08f };  // m/s
+    float AngularVelocity{ 0.1f };  // rad/s
+    float TimeToSleep{ 0.5f };      // seconds every body of an island must stay below both
+};
+
+// Splits the awake dynamic bodies into islands, the connected components of the contact
+// graph, with a union-find over the step's contacts. Static colliders carry contacts but
+// never join two islands. An island only sleeps as a whole, once every body in it has been
+// slow for TimeToSleep, and any awake body touching a sleeping one wakes its entire island
+// again, so a settled pile costs nothing per step until something disturbs it.
+class IslandManager
+{
+public:
+    static constexpr uint32_t NO_ISLAND = 0xFFFFFFFFu;
+
+    IslandManager() = default;
+    IslandManager(const IslandManager&) = delete;
+    IslandManager& operator=(const IslandManager&) = delete;
+
+    //~ Bodies that are integrated, solved and may start a narrowphase test
+    static bool IsAwakeDynamic(ICollider* collider);
+
+    //~ Wakes every sleeping island an awake body made contact with, returns the bodies woken
+    size_t WakeTouchedIslands(const std::vector<ICollider*>& colliders, const std::vector<Contact>& contacts);
+    size_t WakeAll(const std::vector<ICollider*>& colliders);
+
+    //~ Marks the island of a sleeping body to be woken by the next WakeQueued, for bodies
+    //~ changed or left without a support outside of a step (a UI edit, a removed collider)
+    void QueueWake(const ICollider* collider);
+    //~ Wakes the queued islands, returns the bodies woken
+    size_t WakeQueued(const std::vector<ICollider*>& colliders);
+
+    //~ Groups the awake dynamic colliders and the contacts between them into islands
+    void Build(const std::vector<ICollider*>& colliders, const std::vector<Contact>& contacts);
+
+    //~ Advances sleep timers after the solve, returns the number of bodies put to sleep
+    size_t UpdateSleep(float dt, const SleepSettings& settings);
+
+    size_t GetIslandCount() const { return m_IslandCanSleep.size(); }
+    size_t GetLargestIslandSize() const { return m_LargestIslandSize; }
+
+    //~ Islands are numbered in order of their first collider in the step's list
+    std::span<ICollider* const> GetIslandColliders(size_t island) const;
+    //~ Indices into the contact list handed to Build
+    std::span<const uint32_t> GetIslandContacts(size_t island) const;
+    //~ Islands that have contacts, most contacts first so parallel solves start on the longest ones
+    const std::vector<uint32_t>& GetSolveOrder() const { return m_SolveOrder; }
+
+private:
+    //~ Wakes every sleeping body whose sleep island is listed, empties the list
+    static size_t WakeIslands(const std::vector<ICollider*>& colliders, std::vector<uint32_t>& sleepIslands);
+
+    uint32_t Find(uint32_t index);
+    void Union(uint32_t a, uint32_t b);
+
+private:
+    std::vector<uint32_t> m_Parent;
+    std::vector<uint32_t> m_RootIsland;
+    std::vector<uint32_t> m_BodyIsland;
+
+    // Islands stored back to back, offsets has one extra entry at the end
+    std::vector<uint32_t> m_ColliderOffsets;
+    std::vector<ICollider*> m_IslandColliders;
+    std::vector<uint32_t> m_ContactOffsets;
+    std::vector<uint32_t> m_IslandContacts;
+    std::vector<uint8_t> m_IslandCanSleep;
+    std::vector<uint32_t> m_SolveOrder;
+
+    std::vector<uint32_t> m_TouchedSleepIslands;
+    std::vector<uint32_t> m_QueuedSleepIslands;
+    uint32_t m_NextSleepIsland{ 1 };
+    size_t m_LargestIslandSize{ 0 };
+};
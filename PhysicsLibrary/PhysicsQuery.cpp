@@ -0,0 +1,383 @@
+#include "pch.h"
+#include "PhysicsQuery.h"
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+    constexpr float PARALLEL_EPSILON = 1e-8f;
+
+    float Dot(const XMVECTOR& a, const XMVECTOR& b)
+    {
+        return XMVectorGetX(XMVector3Dot(a, b));
+    }
+
+    //~ Ray against a sphere, the origin is known to be outside it
+    bool RaySphere(const XMVECTOR& origin, const XMVECTOR& direction, const XMVECTOR& center, float radius, float& outT)
+    {
+        const XMVECTOR m = origin - center;
+        const float b = Dot(m, direction);
+        const float c = Dot(m, m) - radius * radius;
+        if (b > 0.0f && c > 0.0f) return false;
+
+        const float discriminant = b * b - c;
+        if (discriminant < 0.0f) return false;
+
+        outT = (std::max)(0.0f, -b - std::sqrt(discriminant));
+        return true;
+    }
+
+    //~ Ray against the capsule around segment a-b, the origin is known to be outside it
+    bool RayCapsule(const XMVECTOR& origin, const XMVECTOR& direction, const XMVECTOR& a, const XMVECTOR& b,
+        float radius, float& outT)
+    {
+        const XMVECTOR ba = b - a;
+        const XMVECTOR oa = origin - a;
+        const float baba = Dot(ba, ba);
+        const float bard = Dot(ba, direction);
+        const float baoa = Dot(ba, oa);
+
+        // Side of the infinite cylinder first, only valid between the two cap planes
+        const float qa = baba - bard * bard;
+        if (qa > PARALLEL_EPSILON * baba)
+        {
+            const float qb = baba * Dot(direction, oa) - baoa * bard;
+            const float qc = baba * Dot(oa, oa) - baoa * baoa - radius * radius * baba;
+            const float discriminant = qb * qb - qa * qc;
+            if (discriminant >= 0.0f)
+            {
+                const float t = (-qb - std::sqrt(discriminant)) / qa;
+                const float y = baoa + t * bard;
+                if (t >= 0.0f && y >= 0.0f && y <= baba)
+                {
+                    outT = t;
+                    return true;
+                }
+            }
+        }
+
+        float tA = FLT_MAX, tB = FLT_MAX;
+        const bool hitA = RaySphere(origin, direction, a, radius, tA);
+        const bool hitB = RaySphere(origin, direction, b, radius, tB);
+        if (!hitA && !hitB) return false;
+
+        outT = (std::min)(tA, tB);
+        return true;
+    }
+
+    //~ Ray against a box centred on the local origin, outAxis is the slab the ray entered by
+    bool RayBox(const XMFLOAT3& origin, const XMFLOAT3& direction, const XMFLOAT3& half, float maxT,
+        float& outT, int& outAxis)
+    {
+        const float o[3] = { origin.x, origin.y, origin.z };
+        const float d[3] = { direction.x, direction.y, direction.z };
+        const float h[3] = { half.x, half.y, half.z };
+
+        float tMin = 0.0f;
+        float tMax = maxT;
+        outAxis = -1;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (std::abs(d[axis]) < PARALLEL_EPSILON)
+            {
+                if (o[axis] < -h[axis] || o[axis] > h[axis]) return false;
+                continue;
+            }
+
+            const float inv = 1.0f / d[axis];
+            float t1 = (-h[axis] - o[axis]) * inv;
+            float t2 = (h[axis] - o[axis]) * inv;
+            if (t1 > t2) std::swap(t1, t2);
+            if (t1 > tMin)
+            {
+                tMin = t1;
+                outAxis = axis;
+            }
+            tMax = (std::min)(tMax, t2);
+            if (tMin > tMax) return false;
+        }
+
+        outT = tMin;
+        return true;
+    }
+
+    //~ Cast against a box grown by radius (a sphere swept against the box): the union of the
+    //~ box grown along each axis alone and the capsules around its twelve edges
+    bool RayRoundedBox(const XMFLOAT3& origin, const XMFLOAT3& direction, const XMFLOAT3& half, float radius,
+        float maxT, float& outT)
+    {
+        int axis;
+        float t;
+        if (!RayBox(origin, direction, { half.x + radius, half.y + radius, half.z + radius }, maxT, t, axis)) return false;
+
+        // Entered through a face of the grown box away from its rounded edges and corners
+        const XMFLOAT3 p{ origin.x + direction.x * t, origin.y + direction.y * t, origin.z + direction.z * t };
+        const int outside = (std::abs(p.x) > half.x) + (std::abs(p.y) > half.y) + (std::abs(p.z) > half.z);
+        if (outside <= 1)
+        {
+            outT = t;
+            return true;
+        }
+
+        float best = FLT_MAX;
+        const XMFLOAT3 slabs[3] = {
+            { half.x + radius, half.y, half.z }, { half.x, half.y + radius, half.z }, { half.x, half.y, half.z + radius } };
+        for (const XMFLOAT3& slab : slabs)
+        {
+            if (RayBox(origin, direction, slab, maxT, t, axis)) best = (std::min)(best, t);
+        }
+
+        const XMVECTOR o = XMLoadFloat3(&origin);
+        const XMVECTOR d = XMLoadFloat3(&direction);
+        const float h[3] = { half.x, half.y, half.z };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const int u = (axis + 1) % 3;
+            const int v = (axis + 2) % 3;
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                float a[3], b[3];
+                a[axis] = -h[axis];
+                b[axis] = h[axis];
+                a[u] = b[u] = (corner & 1) ? h[u] : -h[u];
+                a[v] = b[v] = (corner & 2) ? h[v] : -h[v];
+                if (RayCapsule(o, d, XMVectorSet(a[0], a[1], a[2], 0.0f), XMVectorSet(b[0], b[1], b[2], 0.0f), radius, t))
+                {
+                    best = (std::min)(best, t);
+                }
+            }
+        }
+
+        if (best > maxT) return false;
+        outT = best;
+        return true;
+    }
+
+    //~ Point of the body's core (sphere centre, capsule segment, solid box) closest to point
+    XMVECTOR ClosestPointOnCore(const BodySnapshot& body, const XMVECTOR& point)
+    {
+        const XMVECTOR position = XMLoadFloat3(&body.Position);
+        const XMVECTOR orientation = XMLoadFloat4(&body.Orientation);
+        const QueryShape& shape = body.Shape;
+
+        switch (shape.Type)
+        {
+        case ColliderType::Sphere:
+            return position;
+        case ColliderType::Capsule:
+        {
+            const XMVECTOR segment = XMLoadFloat3(&shape.HalfSegment);
+            const float lengthSq = Dot(segment, segment);
+            if (lengthSq <= 0.0f) return position;
+
+            const float along = std::clamp(Dot(point - position, segment) / lengthSq, -1.0f, 1.0f);
+            return position + segment * along;
+        }
+        default:
+        {
+            const XMVECTOR center = XMLoadFloat3(&shape.Center);
+            const XMVECTOR half = XMLoadFloat3(&shape.HalfExtents);
+            const XMVECTOR local = XMVector3InverseRotate(point - position, orientation) - center;
+            const XMVECTOR clamped = XMVectorClamp(local, XMVectorNegate(half), half);
+            return position + XMVector3Rotate(clamped + center, orientation);
+        }
+        }
+    }
+
+    float CoreMargin(const QueryShape& shape)
+    {
+        return shape.Type == ColliderType::Sphere || shape.Type == ColliderType::Capsule ? shape.Radius : 0.0f;
+    }
+
+    //~ Exact cast of a sphere of radius (0 for a ray) against one body, within maxT
+    bool CastAgainst(const BodySnapshot& body, const XMVECTOR& origin, const XMVECTOR& direction, float radius,
+        float maxT, float& outT, XMVECTOR& outNormal)
+    {
+        const QueryShape& shape = body.Shape;
+        const float margin = CoreMargin(shape) + radius;
+
+        // Starting inside, hit right away
+        const XMVECTOR startOffset = origin - ClosestPointOnCore(body, origin);
+        if (Dot(startOffset, startOffset) <= margin * margin)
+        {
+            outT = 0.0f;
+            outNormal = XMVectorNegate(direction);
+            return true;
+        }
+
+        const XMVECTOR position = XMLoadFloat3(&body.Position);
+        const XMVECTOR orientation = XMLoadFloat4(&body.Orientation);
+
+        float t = 0.0f;
+        switch (shape.Type)
+        {
+        case ColliderType::Sphere:
+            if (!RaySphere(origin, direction, position, margin, t)) return false;
+            break;
+        case ColliderType::Capsule:
+        {
+            const XMVECTOR segment = XMLoadFloat3(&shape.HalfSegment);
+            if (!RayCapsule(origin, direction, position - segment, position + segment, margin, t)) return false;
+            break;
+        }
+        default:
+        {
+            XMFLOAT3 localOrigin, localDirection;
+            XMStoreFloat3(&localOrigin, XMVector3InverseRotate(origin - position, orientation) - XMLoadFloat3(&shape.Center));
+            XMStoreFloat3(&localDirection, XMVector3InverseRotate(direction, orientation));
+
+            if (radius > 0.0f)
+            {
+                if (!RayRoundedBox(localOrigin, localDirection, shape.HalfExtents, radius, maxT, t)) return false;
+                break;
+            }
+
+            // A plain ray ends exactly on the box, the entry slab gives the normal
+            int axis;
+            if (!RayBox(localOrigin, localDirection, shape.HalfExtents, maxT, t, axis) || axis < 0) return false;
+
+            const float d[3] = { localDirection.x, localDirection.y, localDirection.z };
+            float n[3] = { 0.0f, 0.0f, 0.0f };
+            n[axis] = d[axis] > 0.0f ? -1.0f : 1.0f;
+            outT = t;
+            outNormal = XMVector3Rotate(XMVectorSet(n[0], n[1], n[2], 0.0f), orientation);
+            return true;
+        }
+        }
+        if (t > maxT) return false;
+
+        const XMVECTOR centre = origin + direction * t;
+        outT = t;
+        outNormal = XMVector3Normalize(centre - ClosestPointOnCore(body, centre));
+        return true;
+    }
+
+    //~ Fills the packet from up to four queries, lanes without a query stay switched off
+    void BuildPacket(std::span<const CastQuery> queries, DynamicAABBTree::RayPacket& packet, XMFLOAT3* directions)
+    {
+        for (size_t lane = 0; lane < queries.size(); ++lane)
+        {
+            const CastQuery& query = queries[lane];
+            const XMVECTOR direction = XMLoadFloat3(&query.Direction);
+            if (XMVectorGetX(XMVector3LengthSq(direction)) <= 0.0f || query.MaxDistance < 0.0f) continue;
+
+            XMStoreFloat3(&directions[lane], XMVector3Normalize(direction));
+            packet.SetLane(static_cast<int>(lane), query.Origin, directions[lane], query.MaxDistance, query.Radius);
+        }
+    }
+
+    void CastPacket(const PhysicsSnapshot& snapshot, std::span<const CastQuery> queries, std::span<QueryHit> outHits)
+    {
+        DynamicAABBTree::RayPacket packet;
+        XMFLOAT3 directions[DynamicAABBTree::RayPacket::WIDTH];
+        BuildPacket(queries, packet, directions);
+
+        for (QueryHit& hit : outHits) hit = QueryHit{};
+
+        const DynamicAABBTree& tree = snapshot.GetQueryTree();
+        tree.RayCastPacket(packet, [&](int proxyId, uint32_t mask)
+            {
+                const BodyHandle handle = tree.GetUserData(proxyId);
+                const BodySnapshot& body = snapshot.GetEntry(handle);
+
+                for (size_t lane = 0; lane < queries.size(); ++lane)
+                {
+                    if (!(mask & (1u << lane)) || handle == queries[lane].Ignore) continue;
+
+                    const CastQuery& query = queries[lane];
+                    const XMVECTOR origin = XMLoadFloat3(&query.Origin);
+                    const XMVECTOR direction = XMLoadFloat3(&directions[lane]);
+
+                    float t;
+                    XMVECTOR normal;
+                    if (!CastAgainst(body, origin, direction, query.Radius, packet.MaxDistance[lane], t, normal)) continue;
+
+                    // Closer than anything before, later leaves only count when closer still
+                    packet.MaxDistance[lane] = t;
+
+                    QueryHit& hit = outHits[lane];
+                    hit.Body = handle;
+                    hit.Distance = t;
+                    XMStoreFloat3(&hit.Normal, normal);
+                    XMStoreFloat3(&hit.Point, t > 0.0f ? origin + direction * t - normal * query.Radius : origin);
+                }
+                return true;
+            });
+    }
+}
+
+bool PhysicsQuery::Cast(const PhysicsSnapshot& snapshot, const CastQuery& query, QueryHit& outHit)
+{
+    CastPacket(snapshot, std::span<const CastQuery>(&query, 1), std::span<QueryHit>(&outHit, 1));
+    return outHit.IsHit();
+}
+
+void PhysicsQuery::CastBatch(const PhysicsSnapshot& snapshot, std::span<const CastQuery> queries,
+    std::span<QueryHit> outHits, WorkerPool* pool)
+{
+    constexpr size_t width = DynamicAABBTree::RayPacket::WIDTH;
+
+    const size_t count = (std::min)(queries.size(), outHits.size());
+    const size_t packets = (count + width - 1) / width;
+    const size_t tasks = (packets + PACKETS_PER_TASK - 1) / PACKETS_PER_TASK;
+
+    // Every task writes its own range of hits only
+    auto task = [&](size_t index)
+        {
+            const size_t first = index * PACKETS_PER_TASK * width;
+            const size_t last = (std::min)(count, first + PACKETS_PER_TASK * width);
+            for (size_t begin = first; begin < last; begin += width)
+            {
+                const size_t lanes = (std::min)(width, last - begin);
+                CastPacket(snapshot, queries.subspan(begin, lanes), outHits.subspan(begin, lanes));
+            }
+        };
+
+    if (pool && tasks > 1)
+    {
+        pool->ParallelFor(tasks, task);
+        return;
+    }
+    for (size_t index = 0; index < tasks; ++index) task(index);
+}
+
+size_t PhysicsQuery::OverlapSphere(const PhysicsSnapshot& snapshot, const XMFLOAT3& center, float radius,
+    std::vector<BodyHandle>& outBodies)
+{
+    const size_t first = outBodies.size();
+    const XMVECTOR point = XMLoadFloat3(&center);
+
+    const DynamicAABBTree& tree = snapshot.GetQueryTree();
+    tree.Query(AABB::FromCenterExtents(center, { radius, radius, radius }), [&](int proxyId)
+        {
+            const BodyHandle handle = tree.GetUserData(proxyId);
+            const BodySnapshot& body = snapshot.GetEntry(handle);
+
+            const XMVECTOR offset = point - ClosestPointOnCore(body, point);
+            const float reach = CoreMargin(body.Shape) + radius;
+            if (Dot(offset, offset) <= reach * reach) outBodies.push_back(handle);
+            return true;
+        });
+    return outBodies.size() - first;
+}
+
+size_t PhysicsQuery::OverlapBounds(const PhysicsSnapshot& snapshot, const AABB& box, std::vector<BodyHandle>& outBodies)
+{
+    const size_t first = outBodies.size();
+
+    // The tree holds fat boxes, so each candidate is checked again against its tight bounds
+    const DynamicAABBTree& tree = snapshot.GetQueryTree();
+    tree.Query(box, [&](int proxyId)
+        {
+            const BodyHandle handle = tree.GetUserData(proxyId);
+            const BodySnapshot& body = snapshot.GetEntry(handle);
+            if (body.Bounds.Overlaps(box)) outBodies.push_back(handle);
+            return true;
+        });
+    return outBodies.size() - first;
+}
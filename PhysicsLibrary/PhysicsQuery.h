@@ -0,0 +1,61 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cfloat>
+#include <span>
+#include <vector>
+
+#include "BodyStore.h"
+#include "PhysicsSnapshot.h"
+
+class WorkerPool;
+
+//~ A ray, or with a radius a sphere swept along the ray
+struct CastQuery
+{
+    DirectX::XMFLOAT3 Origin{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 Direction{ 0.0f, 0.0f, 1.0f }; // normalized by the query
+    float MaxDistance{ FLT_MAX };
+    float Radius{ 0.0f };
+    BodyHandle Ignore{ BodyStore::INVALID_HANDLE };  // e.g. the body casting, for line of sight
+};
+
+struct QueryHit
+{
+    BodyHandle Body{ BodyStore::INVALID_HANDLE };
+    float Distance{ 0.0f };                         // travelled by the ray origin / sphere centre
+    DirectX::XMFLOAT3 Point{ 0.0f, 0.0f, 0.0f };    // on the surface of the body hit
+    DirectX::XMFLOAT3 Normal{ 0.0f, 0.0f, 0.0f };   // of that surface, against the cast
+
+    bool IsHit() const { return Body != BodyStore::INVALID_HANDLE; }
+};
+
+// Scene queries against one published PhysicsSnapshot: ray casts, sphere casts and overlap
+// tests. The snapshot's tree narrows the candidates, the exact test then runs on the frame's
+// copy of each body's shape and pose, so nothing here touches the live simulation and any
+// number of threads can query the same frame at once.
+// Casts always run as four lane packets through DynamicAABBTree::RayCastPacket, one query
+// fills a single lane and batches fill all four, so batches benefit from neighbouring
+// queries being close (rays of one agent, a picking grid). Hulls are tested as the oriented
+// box around their vertices. A cast starting inside a body hits it at distance 0, with the
+// normal facing back along the cast.
+class PhysicsQuery
+{
+public:
+    //~ Closest hit along the cast, false when nothing is hit within its max distance
+    static bool Cast(const PhysicsSnapshot& snapshot, const CastQuery& query, QueryHit& outHit);
+    //~ outHits[i] is the closest hit of queries[i] (Body is INVALID_HANDLE on a miss). Packets
+    //~ are spread over the pool when one is given, the calling thread works along.
+    static void CastBatch(const PhysicsSnapshot& snapshot, std::span<const CastQuery> queries,
+        std::span<QueryHit> outHits, WorkerPool* pool = nullptr);
+
+    //~ Appends every body the sphere touches, returns how many were added
+    static size_t OverlapSphere(const PhysicsSnapshot& snapshot, const DirectX::XMFLOAT3& center, float radius,
+        std::vector<BodyHandle>& outBodies);
+    //~ Appends every body whose bounds overlap the box, no exact test
+    static size_t OverlapBounds(const PhysicsSnapshot& snapshot, const AABB& box, std::vector<BodyHandle>& outBodies);
+
+    //~ Packets handed to a worker at a time by CastBatch
+    static constexpr size_t PACKETS_PER_TASK = 16;
+};
@@ -0,0 +1,224 @@
+#include "pch.h"
+#include "PhysicsSnapshot.h"
+
+#include "BodyStore.h"
+#include "CapsuleCollider.h"
+#include "ConvexHullCollider.h"
+#include "CubeCollider.h"
+#include "SphereCollider.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    QueryShape MakeQueryShape(const ICollider* collider)
+    {
+        using namespace DirectX;
+
+        QueryShape shape;
+        shape.Type = collider->GetColliderType();
+        switch (shape.Type)
+        {
+        case ColliderType::Sphere:
+            shape.Radius = static_cast<const SphereCollider*>(collider)->GetRadius();
+            break;
+        case ColliderType::Capsule:
+        {
+            // The axis CapsuleCollider itself collides along
+            const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(collider);
+            const XMVECTOR up = capsule->GetRigidBody()->GetOrientation().RotateVector(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            shape.Radius = capsule->GetRadius();
+            XMStoreFloat3(&shape.HalfSegment, XMVectorScale(up, capsule->GetHeight() * 0.5f));
+            break;
+        }
+        case ColliderType::Cube:
+            XMStoreFloat3(&shape.HalfExtents, XMVectorAbs(static_cast<const CubeCollider*>(collider)->GetHalfExtents()));
+            break;
+        case ColliderType::ConvexHull:
+        {
+            const XMVECTOR scale = collider->GetScale();
+            XMVECTOR low = XMVectorReplicate(FLT_MAX);
+            XMVECTOR high = XMVectorReplicate(-FLT_MAX);
+            for (const XMFLOAT3& vertex : static_cast<const ConvexHullCollider*>(collider)->GetVertices())
+            {
+                const XMVECTOR v = XMVectorMultiply(XMLoadFloat3(&vertex), scale);
+                low = XMVectorMin(low, v);
+                high = XMVectorMax(high, v);
+            }
+            XMStoreFloat3(&shape.Center, XMVectorScale(XMVectorAdd(low, high), 0.5f));
+            XMStoreFloat3(&shape.HalfExtents, XMVectorScale(XMVectorSubtract(high, low), 0.5f));
+            break;
+        }
+        }
+        return shape;
+    }
+
+    //~ Tight world bounds of the shape at the given pose
+    AABB ComputeQueryBounds(const QueryShape& shape, const DirectX::XMVECTOR& position, const DirectX::XMVECTOR& orientation)
+    {
+        using namespace DirectX;
+
+        XMVECTOR center = position;
+        XMVECTOR extents;
+        switch (shape.Type)
+        {
+        case ColliderType::Sphere:
+            extents = XMVectorReplicate(shape.Radius);
+            break;
+        case ColliderType::Capsule:
+            extents = XMVectorAdd(XMVectorAbs(XMLoadFloat3(&shape.HalfSegment)), XMVectorReplicate(shape.Radius));
+            break;
+        default:
+        {
+            const XMMATRIX rotation = XMMatrixRotationQuaternion(orientation);
+            const XMVECTOR half = XMLoadFloat3(&shape.HalfExtents);
+            center = XMVectorAdd(position, XMVector3Rotate(XMLoadFloat3(&shape.Center), orientation));
+            extents = XMVectorAdd(XMVectorAdd(
+                XMVectorAbs(XMVectorScale(rotation.r[0], XMVectorGetX(half))),
+                XMVectorAbs(XMVectorScale(rotation.r[1], XMVectorGetY(half)))),
+                XMVectorAbs(XMVectorScale(rotation.r[2], XMVectorGetZ(half))));
+            break;
+        }
+        }
+
+        XMFLOAT3 c, e;
+        XMStoreFloat3(&c, center);
+        XMStoreFloat3(&e, extents);
+        return AABB::FromCenterExtents(c, e);
+    }
+}
+
+DirectX::XMMATRIX BodySnapshot::Interpolate(float alpha) const
+{
+    using namespace DirectX;
+
+    const XMVECTOR position = XMVectorLerp(XMLoadFloat3(&PreviousPosition), XMLoadFloat3(&Position), alpha);
+    const XMVECTOR orientation = XMQuaternionSlerp(XMLoadFloat4(&PreviousOrientation), XMLoadFloat4(&Orientation), alpha);
+
+    return XMMatrixScalingFromVector(XMLoadFloat3(&Scale)) *
+        XMMatrixRotationQuaternion(orientation) *
+        XMMatrixTranslationFromVector(position);
+}
+
+void PhysicsSnapshot::Capture(const std::vector<ICollider*>& colliders, const PhysicsSnapshot& previous,
+    uint64_t step, float simulationTime)
+{
+    using namespace DirectX;
+
+    m_Step = step;
+    m_SimulationTime = simulationTime;
+    m_BodyCount = 0;
+
+    for (ICollider* collider : colliders)
+    {
+        const RigidBody* body = collider->GetRigidBody();
+        if (!body) continue;
+
+        const BodyHandle handle = body->GetHandle();
+        if (handle >= m_Bodies.size()) m_Bodies.resize(static_cast<size_t>(handle) + 1);
+
+        // Rebuilt from the solved pose, the collider's cached matrix predates the solver
+        const XMVECTOR position = body->GetPosition();
+        const XMVECTOR orientation = body->GetOrientation().ToXmVector();
+
+        const XMVECTOR scale = collider->GetScale();
+
+        BodySnapshot& entry = m_Bodies[handle];
+        XMStoreFloat4x4(&entry.Transformation,
+            XMMatrixScalingFromVector(scale) *
+            XMMatrixRotationQuaternion(orientation) *
+            XMMatrixTranslationFromVector(position));
+        XMStoreFloat3(&entry.Position, position);
+        XMStoreFloat4(&entry.Orientation, orientation);
+        XMStoreFloat3(&entry.Scale, scale);
+
+        if (const BodySnapshot* last = previous.Find(body))
+        {
+            const bool sameStep = previous.GetStep() == step;
+            entry.PreviousPosition = sameStep ? last->PreviousPosition : last->Position;
+            entry.PreviousOrientation = sameStep ? last->PreviousOrientation : last->Orientation;
+        }
+        else
+        {
+            entry.PreviousPosition = entry.Position;
+            entry.PreviousOrientation = entry.Orientation;
+        }
+        XMStoreFloat3(&entry.Velocity, body->GetVelocity());
+        XMStoreFloat3(&entry.AngularVelocity, body->GetAngularVelocity());
+        entry.Awake = body->IsAwake();
+        entry.Step = step;
+        entry.Generation = body->GetStore().GetGeneration(handle);
+        ++m_BodyCount;
+
+        XMStoreFloat3(&entry.Acceleration, body->GetAcceleration());
+        entry.Mass = body->GetMass();
+        entry.LinearDamping = body->GetDamping();
+        entry.AngularDamping = body->GetAngularDamping();
+        entry.Elasticity = body->GetElasticity();
+        entry.Restitution = body->GetRestitution();
+        entry.Friction = body->GetFriction();
+        entry.State = collider->GetColliderState();
+        entry.Platform = body->IsPlatform();
+        entry.Resting = body->GetRestingState();
+
+        entry.Shape = MakeQueryShape(collider);
+        entry.Height = entry.Shape.Type == ColliderType::Capsule ? static_cast<const CapsuleCollider*>(collider)->GetHeight() : 0.0f;
+        entry.Bounds = ComputeQueryBounds(entry.Shape, position, orientation);
+        if (entry.QueryProxy == DynamicAABBTree::NULL_NODE)
+        {
+            entry.QueryProxy = m_QueryTree.CreateProxy(entry.Bounds, handle);
+        }
+        else
+        {
+            const XMFLOAT3 displacement{ entry.Position.x - entry.PreviousPosition.x,
+                entry.Position.y - entry.PreviousPosition.y, entry.Position.z - entry.PreviousPosition.z };
+            m_QueryTree.MoveProxy(entry.QueryProxy, entry.Bounds, displacement);
+        }
+    }
+
+    // Bodies that left the simulation since this buffer was last written
+    for (BodySnapshot& entry : m_Bodies)
+    {
+        if (entry.Step != step && entry.QueryProxy != DynamicAABBTree::NULL_NODE)
+        {
+            m_QueryTree.DestroyProxy(entry.QueryProxy);
+            entry.QueryProxy = DynamicAABBTree::NULL_NODE;
+        }
+    }
+}
+
+void PhysicsSnapshot::SetInterpolation(float stepTime, float pendingTime)
+{
+    m_StepTime = stepTime;
+    m_PendingTime = pendingTime;
+    m_CaptureTime = std::chrono::steady_clock::now();
+}
+
+void PhysicsSnapshot::SetInterpolation(const PhysicsSnapshot& frame)
+{
+    m_StepTime = frame.m_StepTime;
+    m_PendingTime = frame.m_PendingTime;
+    m_CaptureTime = frame.m_CaptureTime;
+}
+
+float PhysicsSnapshot::GetInterpolationAlpha() const
+{
+    if (m_StepTime <= 0.0f) return 1.0f;
+
+    const float sinceCapture = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_CaptureTime).count();
+    return std::clamp((m_PendingTime + sinceCapture) / m_StepTime, 0.0f, 1.0f);
+}
+
+const BodySnapshot* PhysicsSnapshot::Find(const RigidBody* body) const
+{
+    if (!body) return nullptr;
+
+    const BodyHandle handle = body->GetHandle();
+    if (handle >= m_Bodies.size()) return nullptr;
+
+    // Entries left over from older frames, or from a body that used to own this handle
+    const BodySnapshot& entry = m_Bodies[handle];
+    if (entry.Step != m_Step || entry.Generation != body->GetStore().GetGeneration(handle)) return nullptr;
+    return &entry;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "DynamicAABBTree.h"
+#include "ICollider.h"
+
+//~ What scene queries test a body against
+struct QueryShape
+{
+    ColliderType Type{ ColliderType::Sphere };
+    DirectX::XMFLOAT3 Center{ 0.0f, 0.0f, 0.0f }; // boxes in the body's frame, hulls use their vertex bounds
+    DirectX::XMFLOAT3 HalfExtents{ 0.0f, 0.0f, 0.0f };
+    float Radius{ 0.0f };                         // spheres and capsules
+    DirectX::XMFLOAT3 HalfSegment{ 0.0f, 0.0f, 0.0f }; // capsules, world space, the core is position -+ this
+};
+
+//~ Pose and velocities of one body at the end of a step
+struct BodySnapshot
+{
+    DirectX::XMFLOAT4X4 Transformation; // scale * rotation * translation of the collider
+    DirectX::XMFLOAT3 Position;
+    DirectX::XMFLOAT4 Orientation;      // (i, j, k, r)
+    DirectX::XMFLOAT3 Velocity;
+    DirectX::XMFLOAT3 AngularVelocity;
+    bool Awake{ false };
+
+    //~ Pose one step earlier, the same pose when the body was not in the previous frame
+    DirectX::XMFLOAT3 PreviousPosition;
+    DirectX::XMFLOAT4 PreviousOrientation;
+    DirectX::XMFLOAT3 Scale;
+
+    uint64_t Step{ 0 };
+    uint32_t Generation{ 0 };
+
+    QueryShape Shape{};
+    AABB Bounds{};
+    int QueryProxy{ DynamicAABBTree::NULL_NODE };
+
+    //~ The rest of what the editor shows and edits through BodyEdit
+    DirectX::XMFLOAT3 Acceleration;
+    float Mass{ 0.0f };
+    float LinearDamping{ 0.0f };
+    float AngularDamping{ 0.0f };
+    float Elasticity{ 0.0f };
+    float Restitution{ 0.0f };
+    float Friction{ 0.0f };
+    float Height{ 0.0f }; // capsules, the radius is in Shape
+    ColliderState State{ ColliderState::Dynamic };
+    bool Platform{ false };
+    bool Resting{ false };
+
+    //~ Transformation blended from the previous pose (alpha 0) to the current one (alpha 1)
+    DirectX::XMMATRIX Interpolate(float alpha) const;
+};
+
+// Immutable copy of every simulated body taken after a step, handed to other threads
+// through a TripleBuffer so they read one consistent frame without touching live state.
+// Entries are indexed by body handle, a body missing from the frame (not yet simulated,
+// or removed) is reported as nullptr. Each frame also keeps a tree over its bodies' bounds
+// that PhysicsQuery casts against; it is updated in place, so a frame only reinserts the
+// bodies that moved out of their fat box since the buffer was last written.
+class PhysicsSnapshot
+{
+public:
+    //~ Physics thread: records the colliders' bodies as frame `step`, previous poses come from
+    //~ the frame published before it. When that frame is the same step (republished after an
+    //~ edit) its own previous poses carry over, so the blend does not jump ahead.
+    void Capture(const std::vector<ICollider*>& colliders, const PhysicsSnapshot& previous,
+        uint64_t step, float simulationTime);
+    //~ Physics thread: length of the step and simulation time still waiting in the accumulator
+    void SetInterpolation(float stepTime, float pendingTime);
+    //~ Physics thread: same timing as frame, for a republish of the step it holds
+    void SetInterpolation(const PhysicsSnapshot& frame);
+
+    const BodySnapshot* Find(const RigidBody* body) const;
+    //~ Tree leaves hold the body handle as user data
+    const DynamicAABBTree& GetQueryTree() const { return m_QueryTree; }
+    const BodySnapshot& GetEntry(BodyHandle handle) const { return m_Bodies[handle]; }
+
+    //~ How far real time has moved past the previous pose, in steps, clamped to [0, 1]
+    float GetInterpolationAlpha() const;
+
+    uint64_t GetStep() const { return m_Step; }
+    float GetSimulationTime() const { return m_SimulationTime; }
+    size_t GetBodyCount() const { return m_BodyCount; }
+
+private:
+    std::vector<BodySnapshot> m_Bodies;
+    DynamicAABBTree m_QueryTree{};
+    uint64_t m_Step{ 0 };
+    float m_SimulationTime{ 0.0f };
+    size_t m_BodyCount{ 0 };
+
+    float m_StepTime{ 0.0f };
+    float m_PendingTime{ 0.0f };
+    std::chrono::steady_clock::time_point m_CaptureTime{};
+};
@@ -0,0 +1,348 @@
+#include "pch.h"
+#include "PhysicsWorld.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "BruteForceBroadPhase.h"
+#include "DynamicTreeBroadPhase.h"
+#include "SpatialHashBroadPhase.h"
+#include "SweepAndPruneBroadPhase.h"
+#include "RigidBody.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    float ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    }
+
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    template<typename T>
+    void HashBytes(uint64_t& hash, const T& value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (const unsigned char byte : bytes)
+        {
+            hash = (hash ^ byte) * FNV_PRIME;
+        }
+    }
+}
+
+PhysicsWorld::PhysicsWorld(BodyStore& store)
+    : m_Store(store),
+    m_Gravity(std::make_unique<Gravity>(DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f)))
+{
+    if (!m_Store.AttachWorld(this))
+    {
+        throw std::logic_error("BodyStore is already stepped by another PhysicsWorld, give this one its own store");
+    }
+    RebuildBroadPhase(BroadPhaseType::SpatialHash);
+}
+
+PhysicsWorld::~PhysicsWorld()
+{
+    // The colliders belong to the caller and may be gone already, only the store is let go
+    m_Store.DetachWorld(this);
+}
+
+void PhysicsWorld::Step(float dt, const WorldSettings& settings)
+{
+    CompactColliders();
+    ++m_StepCount;
+    m_TotalTime += dt;
+
+    const std::vector<ICollider*>& colliders = m_Colliders;
+    // Before integration, so bodies that lost a support start falling this step
+    m_IslandManager.WakeQueued(colliders);
+    const bool continuous = settings.ContinuousCollision;
+    if (continuous)
+    {
+        m_ContinuousCollision.BeginStep(colliders);
+    }
+
+    // === Integrate bodies ===
+    // One pass over the body store, every simulated awake body in memory order
+    m_Store.Integrate(dt, settings.Integration);
+
+    // === Continuous Collision ===
+    // Fast opted in bodies are pulled back to where they first hit static geometry
+    if (continuous)
+    {
+        m_ContinuousCollision.Resolve();
+        m_Stats.SweptBodyCount = static_cast<int>(m_ContinuousCollision.GetSweptCount());
+        m_Stats.SweptImpactCount = static_cast<int>(m_ContinuousCollision.GetImpactCount());
+    }
+    else
+    {
+        m_Stats.SweptBodyCount = 0;
+        m_Stats.SweptImpactCount = 0;
+    }
+
+    for (ICollider* collider : colliders)
+    {
+        // Sleeping bodies keep their pose and bounds, they only stay listed for the broadphase
+        if (collider->GetRigidBody()->IsAwake())
+        {
+            // After integration so the cached bounds match the poses the narrowphase sees
+            collider->Update(dt);
+        }
+    }
+
+    // Sleeping bodies do not receive gravity, so toggling it has to wake them
+    const bool gravityOn = m_Gravity->IsGravityOn();
+    const bool gravityToggled = gravityOn != m_LastGravityOn;
+    m_LastGravityOn = gravityOn;
+
+    if ((!settings.Sleep.Enabled || gravityToggled) && m_Stats.SleepingBodyCount > 0)
+    {
+        m_IslandManager.WakeAll(colliders);
+    }
+
+    m_ForceRegistry.UpdateForces(dt);
+
+    // === Broad Phase ===
+    if (!m_BroadPhase || m_BroadPhase->GetType() != settings.BroadPhase)
+    {
+        RebuildBroadPhase(settings.BroadPhase);
+    }
+    m_BroadPhase->Update(colliders);
+
+    // === Narrow Phase ===
+    m_ContactCache.BeginStep();
+
+    // Only ever reconfigured between steps, never during a phase
+    m_WorkerPool.Configure(settings.ThreadCount, settings.AffinityMask);
+
+    const Clock::time_point narrowStart = Clock::now();
+    const std::vector<ColliderPair>& pairs = m_BroadPhase->GetPairs();
+    m_NarrowPhase.Begin();
+    for (const ColliderPair& pair : pairs)
+    {
+        // Nothing can change between two sleeping (or static) bodies
+        if (!IslandManager::IsAwakeDynamic(pair.A) && !IslandManager::IsAwakeDynamic(pair.B))
+        {
+            m_ContactCache.KeepAlive(pair.A, pair.B);
+            continue;
+        }
+        m_NarrowPhase.AddPair(pair.A, pair.B);
+    }
+
+    std::vector<Contact>& contacts = m_Contacts;
+    contacts.clear();
+    m_NarrowPhase.Run(contacts, &m_WorkerPool);
+    m_Stats.NarrowPhaseTime = ElapsedMs(narrowStart);
+    for (const ColliderPair& touching : m_NarrowPhase.GetTouchingPairs())
+    {
+        touching.A->RegisterCollision(touching.B);
+        touching.B->RegisterCollision(touching.A);
+    }
+    m_Stats.CandidatePairCount = static_cast<int>(pairs.size());
+    m_Stats.BatchedPairCount = static_cast<int>(m_NarrowPhase.GetBatchedPairCount());
+    m_Stats.ContactCount = static_cast<int>(contacts.size());
+
+    // === Islands ===
+    m_IslandManager.WakeTouchedIslands(colliders, contacts);
+    m_IslandManager.Build(colliders, contacts);
+
+    // === Contact Resolution ===
+    SolveIslands(contacts, settings.Solver);
+    m_ContactCache.EndStep();
+    m_Stats.WarmStartedContactCount = static_cast<int>(m_ContactCache.GetHitCount());
+
+    // === Sleep ===
+    m_IslandManager.UpdateSleep(dt, settings.Sleep);
+
+    int sleepingBodies = 0;
+    for (ICollider* collider : colliders)
+    {
+        if (!collider->GetRigidBody()->IsAwake()) ++sleepingBodies;
+    }
+    m_Stats.IslandCount = static_cast<int>(m_IslandManager.GetIslandCount());
+    m_Stats.LargestIslandSize = static_cast<int>(m_IslandManager.GetLargestIslandSize());
+    m_Stats.SleepingBodyCount = sleepingBodies;
+}
+
+bool PhysicsWorld::AddCollider(ICollider* collider)
+{
+    if (!collider || !collider->GetRigidBody()) return false;
+
+    // Compact first, the collider may be re-added right after it was removed
+    CompactColliders();
+    if (m_ColliderSet.contains(collider)) return false;
+    // Integration never reaches a body of another store
+    if (&collider->GetRigidBody()->GetStore() != &m_Store)
+    {
+        assert(false && "the body was made in another BodyStore than this world's");
+        return false;
+    }
+    m_ColliderSet.insert(collider);
+
+    m_ForceRegistry.Add(collider, m_Gravity.get());
+    collider->GetRigidBody()->SetSimulated(true);
+    m_Colliders.push_back(collider);
+    return true;
+}
+
+bool PhysicsWorld::RemoveCollider(ICollider* collider)
+{
+    if (!m_ColliderSet.erase(collider)) return false;
+
+    m_ForceRegistry.Remove(collider);
+
+    // Whatever slept on or against it lost a support, every touching pair is in the cache
+    // (sleeping ones are kept alive there), so wake their islands before the pairs go
+    m_TouchedPartners.clear();
+    m_ContactCache.Remove(collider, m_TouchedPartners);
+    m_IslandManager.QueueWake(collider);
+    for (const ICollider* partner : m_TouchedPartners)
+    {
+        m_IslandManager.QueueWake(partner);
+    }
+
+    // The store stops integrating the body, its owner keeps the last pose
+    collider->GetRigidBody()->SetSimulated(false);
+
+    // Proxies are keyed by address, a new collider at the same one must not inherit its proxy
+    if (m_BroadPhase) m_BroadPhase->Remove(collider);
+    m_HasRemovals = true;
+    return true;
+}
+
+bool PhysicsWorld::EditCollider(ICollider* collider, const BodyEdit& edit)
+{
+    if (!m_ColliderSet.contains(collider)) return false;
+
+    // Queued before the edit, after a pose edit wakes the body alone it no longer counts as sleeping
+    m_TouchedPartners.clear();
+    m_ContactCache.GetPartners(collider, m_TouchedPartners);
+    m_IslandManager.QueueWake(collider);
+    for (const ICollider* partner : m_TouchedPartners)
+    {
+        m_IslandManager.QueueWake(partner);
+    }
+
+    edit.Apply(collider);
+    // A sleeping or static body is not updated by the step, its matrix and bounds follow the edit now
+    collider->Update(0.0f);
+    return true;
+}
+
+void PhysicsWorld::Clear()
+{
+    for (ICollider* collider : m_Colliders)
+    {
+        if (m_ColliderSet.contains(collider)) collider->GetRigidBody()->SetSimulated(false);
+    }
+    m_Colliders.clear();
+    m_ColliderSet.clear();
+    m_HasRemovals = false;
+
+    m_ForceRegistry.Clear();
+    m_ContactCache.Clear();
+    if (m_BroadPhase) m_BroadPhase->Clear();
+
+    m_Contacts.clear();
+    m_Stats = WorldStepStats{};
+}
+
+const std::vector<ICollider*>& PhysicsWorld::GetColliders()
+{
+    CompactColliders();
+    return m_Colliders;
+}
+
+const char* PhysicsWorld::GetBroadPhaseName() const
+{
+    return m_BroadPhase ? m_BroadPhase->GetName() : "None";
+}
+
+uint64_t PhysicsWorld::ComputeStateHash()
+{
+    using namespace DirectX;
+
+    CompactColliders();
+
+    uint64_t hash = FNV_OFFSET;
+    for (const ICollider* collider : m_Colliders)
+    {
+        const RigidBody* body = collider->GetRigidBody();
+
+        XMFLOAT3 position, velocity, angularVelocity;
+        XMStoreFloat3(&position, body->GetPosition());
+        XMStoreFloat3(&velocity, body->GetVelocity());
+        XMStoreFloat3(&angularVelocity, body->GetAngularVelocity());
+        const Quaternion orientation = body->GetOrientation();
+
+        HashBytes(hash, position);
+        HashBytes(hash, orientation.GetR());
+        HashBytes(hash, orientation.GetI());
+        HashBytes(hash, orientation.GetJ());
+        HashBytes(hash, orientation.GetK());
+        HashBytes(hash, velocity);
+        HashBytes(hash, angularVelocity);
+        HashBytes(hash, static_cast<uint8_t>(body->IsAwake()));
+    }
+    return hash;
+}
+
+void PhysicsWorld::CompactColliders()
+{
+    if (!m_HasRemovals) return;
+
+    // One pass for every removal since the last one, the remaining colliders keep their order
+    std::erase_if(m_Colliders, [this](const ICollider* c) { return !m_ColliderSet.contains(c); });
+    m_HasRemovals = false;
+}
+
+void PhysicsWorld::RebuildBroadPhase(BroadPhaseType type)
+{
+    switch (type)
+    {
+    case BroadPhaseType::BruteForce:    m_BroadPhase = std::make_unique<BruteForceBroadPhase>(); break;
+    case BroadPhaseType::SpatialHash:   m_BroadPhase = std::make_unique<SpatialHashBroadPhase>(); break;
+    case BroadPhaseType::SweepAndPrune: m_BroadPhase = std::make_unique<SweepAndPruneBroadPhase>(); break;
+    case BroadPhaseType::DynamicTree:   m_BroadPhase = std::make_unique<DynamicTreeBroadPhase>(); break;
+    default: m_BroadPhase = std::make_unique<SpatialHashBroadPhase>(); break;
+    }
+}
+
+void PhysicsWorld::SolveIslands(std::vector<Contact>& contacts, const SolverSettings& settings)
+{
+    const Clock::time_point start = Clock::now();
+    CollisionResolver::FetchWarmStart(contacts, m_ContactCache);
+    const std::vector<uint32_t>& order = m_IslandManager.GetSolveOrder();
+
+    // Islands too big for one thread come first (largest first) and are spread over the
+    // pool by graph colouring, one at a time. Coloured on a single thread as well: the colour
+    // order solves differently from the serial one, and a step must not depend on the pool.
+    ContactColoringStats coloringStats;
+    ContactColoringStats islandStats;
+    size_t first = 0;
+    for (; first < order.size(); ++first)
+    {
+        const std::span<const uint32_t> island = m_IslandManager.GetIslandContacts(order[first]);
+        if (island.size() < CollisionResolver::COLORING_MIN_CONTACTS) break;
+
+        CollisionResolver::SolveContactsColored(contacts, island, settings, m_WorkerPool,
+            first == 0 ? coloringStats : islandStats);
+    }
+
+    // Islands share no dynamic body, so each one gives the same result on any thread
+    m_WorkerPool.ParallelFor(order.size() - first, [&](size_t i)
+        {
+            CollisionResolver::SolveContacts(contacts, m_IslandManager.GetIslandContacts(order[first + i]), settings);
+        });
+
+    CollisionResolver::StoreWarmStart(contacts, m_ContactCache);
+    m_Stats.IslandSolveTime = ElapsedMs(start);
+    m_Stats.Coloring = std::move(coloringStats);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "BatchNarrowPhase.h"
+#include "BodyEdit.h"
+#include "CollisionResolver.h"
+#include "ContactCache.h"
+#include "ContinuousCollision.h"
+#include "ForceRegistry.h"
+#include "Gravity.h"
+#include "IBroadPhase.h"
+#include "IntegrationType.h"
+#include "IslandManager.h"
+#include "WorkerPool.h"
+
+//~ Everything a step reads besides the colliders, handed in whole every step
+struct WorldSettings
+{
+    IntegrationType Integration{ IntegrationType::SemiImplicitEuler };
+    BroadPhaseType BroadPhase{ BroadPhaseType::SpatialHash };
+    SolverSettings Solver{};
+    SleepSettings Sleep{};
+    bool ContinuousCollision{ true };
+
+    //~ Workers for the narrowphase and the islands, the caller counts as one. Results do not
+    //~ depend on them.
+    int ThreadCount{ 1 };
+    uint64_t AffinityMask{ 0 };
+};
+
+//~ What the last step found, for the UI
+struct WorldStepStats
+{
+    int CandidatePairCount{ 0 };
+    int BatchedPairCount{ 0 };
+    int ContactCount{ 0 };
+    int WarmStartedContactCount{ 0 };
+    int IslandCount{ 0 };
+    int LargestIslandSize{ 0 };
+    int SleepingBodyCount{ 0 };
+    int SweptBodyCount{ 0 };
+    int SweptImpactCount{ 0 };
+    float NarrowPhaseTime{ 0.0f }; // ms
+    float IslandSolveTime{ 0.0f }; // ms
+    ContactColoringStats Coloring{};
+};
+
+// One simulation: its colliders, gravity, and every stage of a step (integrate, sweep,
+// forces, broadphase, narrowphase, islands, solve, sleep). PhysicsManager steps it on the
+// physics thread, ReplayPlayer steps one headless. A step only depends on the colliders'
+// state, the order they were added in and the settings, never on the clock, on addresses
+// or on the thread count, so the same input always ends in the same bodies, bit for bit.
+// Not thread safe, the owner serialises steps and collider changes. Integration runs over
+// the world's whole BodyStore, so each store has one world attached at a time and bodies
+// must come from their world's store. Worlds that run side by side (the live one and a
+// ReplayPlayer) each get a store of their own.
+class PhysicsWorld
+{
+public:
+    //~ Throws std::logic_error when another world is already attached to store
+    explicit PhysicsWorld(BodyStore& store = BodyStore::Get());
+    ~PhysicsWorld();
+    PhysicsWorld(const PhysicsWorld&) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+    void Step(float dt, const WorldSettings& settings);
+
+    //~ False when the collider is already in the world, or its body lives in another store
+    bool AddCollider(ICollider* collider);
+    //~ False when the collider is not in the world. Sleeping bodies it touched wake at the
+    //~ next step. The list is compacted once before the next step or add, so removing many
+    //~ at once stays linear.
+    bool RemoveCollider(ICollider* collider);
+    //~ False when the collider is not in the world. Sleeping bodies it touches wake with it
+    //~ at the next step.
+    bool EditCollider(ICollider* collider, const BodyEdit& edit);
+    void Clear();
+
+    //~ In the order they were added
+    const std::vector<ICollider*>& GetColliders();
+    Gravity* GetGravity() const { return m_Gravity.get(); }
+    const WorldStepStats& GetStats() const { return m_Stats; }
+    const char* GetBroadPhaseName() const;
+
+    uint64_t GetStepCount() const { return m_StepCount; }
+    float GetTotalTime() const { return m_TotalTime; }
+
+    //~ FNV-1a over the raw bits of every collider's pose, velocities and sleep state, in
+    //~ collider order. Equal hashes mean bit identical worlds.
+    uint64_t ComputeStateHash();
+
+private:
+    void CompactColliders();
+    void RebuildBroadPhase(BroadPhaseType type);
+    void SolveIslands(std::vector<Contact>& contacts, const SolverSettings& settings);
+
+private:
+    BodyStore& m_Store;
+    std::vector<ICollider*> m_Colliders;
+    std::unordered_set<const ICollider*> m_ColliderSet;
+    bool m_HasRemovals{ false };
+    std::vector<const ICollider*> m_TouchedPartners{};
+
+    std::unique_ptr<Gravity> m_Gravity{ nullptr };
+    bool m_LastGravityOn{ true };
+    ForceRegistry m_ForceRegistry{};
+    ContinuousCollision m_ContinuousCollision{};
+    std::unique_ptr<IBroadPhase> m_BroadPhase{ nullptr };
+    BatchNarrowPhase m_NarrowPhase{};
+    //~ Kept between steps so the buffer only grows when a step has more contacts than any before
+    std::vector<Contact> m_Contacts{};
+    ContactCache m_ContactCache{};
+    IslandManager m_IslandManager{};
+    WorkerPool m_WorkerPool{};
+
+    WorldStepStats m_Stats{};
+    uint64_t m_StepCount{ 0 };
+    float m_TotalTime{ 0.0f };
+};
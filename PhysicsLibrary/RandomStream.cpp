@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "RandomStream.h"
+
+#include <random>
+
+namespace
+{
+    constexpr uint64_t PCG_MULTIPLIER = 6364136223846793005ull;
+}
+
+void RandomStream::Seed(uint64_t seed, uint64_t stream)
+{
+    // The increment picks the stream and has to be odd
+    m_State = 0;
+    m_Increment = (stream << 1u) | 1u;
+    NextUInt();
+    m_State += seed;
+    NextUInt();
+}
+
+uint32_t RandomStream::NextUInt()
+{
+    const uint64_t state = m_State;
+    m_State = state * PCG_MULTIPLIER + m_Increment;
+
+    const uint32_t xorShifted = static_cast<uint32_t>(((state >> 18u) ^ state) >> 27u);
+    const uint32_t rotation = static_cast<uint32_t>(state >> 59u);
+    return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31u));
+}
+
+float RandomStream::NextFloat()
+{
+    // 24 bits fit a float mantissa exactly, so the result never rounds up to 1
+    return static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f);
+}
+
+float RandomStream::Range(float min, float max)
+{
+    return min + (max - min) * NextFloat();
+}
+
+int RandomStream::Range(int min, int max)
+{
+    if (max < min) return min;
+
+    const uint32_t span = static_cast<uint32_t>(static_cast<int64_t>(max) - min) + 1u;
+    if (span == 0) return static_cast<int>(NextUInt()); // the whole int range
+
+    // Draws below threshold would make the low values of the range more likely
+    const uint32_t threshold = (0u - span) % span;
+    while (true)
+    {
+        const uint32_t value = NextUInt();
+        if (value >= threshold) return static_cast<int>(static_cast<int64_t>(min) + value % span);
+    }
+}
+
+uint64_t RandomStream::MakeSeed()
+{
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// Seeded random numbers that come out the same on every compiler and platform (PCG32). The
+// std distributions are free to differ between standard libraries, these do their own
+// mapping to floats and ranges. A seed gives 2^63 independent streams, one per subsystem, so
+// drawing more numbers in one of them never shifts what another one draws.
+class RandomStream
+{
+public:
+    RandomStream() { Seed(0, 0); }
+    explicit RandomStream(uint64_t seed, uint64_t stream = 0) { Seed(seed, stream); }
+
+    void Seed(uint64_t seed, uint64_t stream = 0);
+
+    uint32_t NextUInt();
+    //~ [0, 1) in steps of 2^-24
+    float NextFloat();
+    //~ [min, max)
+    float Range(float min, float max);
+    //~ [min, max], unbiased
+    int Range(int min, int max);
+
+    //~ A seed from the OS, for runs that do not need to be reproduced
+    static uint64_t MakeSeed();
+
+private:
+    uint64_t m_State{ 0 };
+    uint64_t m_Increment{ 1 };
+};
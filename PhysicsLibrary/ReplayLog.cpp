@@ -0,0 +1,346 @@
+#include "pch.h"
+#include "ReplayLog.h"
+
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#include "CapsuleCollider.h"
+#include "ConvexHullCollider.h"
+#include "RigidBody.h"
+#include "SphereCollider.h"
+
+namespace
+{
+    constexpr uint32_t FILE_MAGIC = 0x4C505250; // "PRPL"
+    constexpr uint32_t FILE_VERSION = 1;
+
+    // Plain values only, written as they sit in memory (every platform built for is little endian)
+    template<typename T>
+    void Write(std::ostream& out, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool Read(std::istream& in, T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return static_cast<bool>(in);
+    }
+
+    // Field by field, so padding and the thread count never end up in the file
+    void WriteInput(std::ostream& out, const ReplayLog::StepInput& input)
+    {
+        Write(out, input.DeltaTime);
+        Write(out, input.Settings.Integration);
+        Write(out, input.Settings.BroadPhase);
+        Write(out, input.Settings.Solver.VelocityIterations);
+        Write(out, input.Settings.Solver.PositionIterations);
+        Write(out, input.Settings.Sleep.Enabled);
+        Write(out, input.Settings.Sleep.LinearVelocity);
+        Write(out, input.Settings.Sleep.AngularVelocity);
+        Write(out, input.Settings.Sleep.TimeToSleep);
+        Write(out, input.Settings.ContinuousCollision);
+        Write(out, input.GravityOn);
+        Write(out, input.GravityReversed);
+    }
+
+    bool ReadInput(std::istream& in, ReplayLog::StepInput& input)
+    {
+        return Read(in, input.DeltaTime)
+            && Read(in, input.Settings.Integration)
+            && Read(in, input.Settings.BroadPhase)
+            && Read(in, input.Settings.Solver.VelocityIterations)
+            && Read(in, input.Settings.Solver.PositionIterations)
+            && Read(in, input.Settings.Sleep.Enabled)
+            && Read(in, input.Settings.Sleep.LinearVelocity)
+            && Read(in, input.Settings.Sleep.AngularVelocity)
+            && Read(in, input.Settings.Sleep.TimeToSleep)
+            && Read(in, input.Settings.ContinuousCollision)
+            && Read(in, input.GravityOn)
+            && Read(in, input.GravityReversed);
+    }
+
+    void WriteBody(std::ostream& out, const ReplayBody& body)
+    {
+        Write(out, body.Type);
+        Write(out, body.State);
+        Write(out, body.Scale);
+        Write(out, body.Radius);
+        Write(out, body.Height);
+        Write(out, static_cast<uint32_t>(body.Vertices.size()));
+        for (const DirectX::XMFLOAT3& vertex : body.Vertices) Write(out, vertex);
+
+        Write(out, body.Position);
+        Write(out, body.Orientation);
+        Write(out, body.Velocity);
+        Write(out, body.Acceleration);
+        Write(out, body.AngularVelocity);
+        Write(out, body.InverseInertia);
+        Write(out, body.InverseMass);
+        Write(out, body.LinearDamping);
+        Write(out, body.AngularDamping);
+        Write(out, body.Elasticity);
+        Write(out, body.Restitution);
+        Write(out, body.Friction);
+        Write(out, body.Platform);
+        Write(out, body.Continuous);
+        Write(out, body.Resting);
+        Write(out, body.ReverseAware);
+    }
+
+    bool ReadBody(std::istream& in, ReplayBody& body)
+    {
+        uint32_t vertexCount = 0;
+        if (!Read(in, body.Type) || !Read(in, body.State) || !Read(in, body.Scale)
+            || !Read(in, body.Radius) || !Read(in, body.Height) || !Read(in, vertexCount))
+        {
+            return false;
+        }
+
+        body.Vertices.resize(vertexCount);
+        for (DirectX::XMFLOAT3& vertex : body.Vertices)
+        {
+            if (!Read(in, vertex)) return false;
+        }
+
+        return Read(in, body.Position)
+            && Read(in, body.Orientation)
+            && Read(in, body.Velocity)
+            && Read(in, body.Acceleration)
+            && Read(in, body.AngularVelocity)
+            && Read(in, body.InverseInertia)
+            && Read(in, body.InverseMass)
+            && Read(in, body.LinearDamping)
+            && Read(in, body.AngularDamping)
+            && Read(in, body.Elasticity)
+            && Read(in, body.Restitution)
+            && Read(in, body.Friction)
+            && Read(in, body.Platform)
+            && Read(in, body.Continuous)
+            && Read(in, body.Resting)
+            && Read(in, body.ReverseAware);
+    }
+}
+
+void ReplayLog::Begin(uint64_t seed)
+{
+    m_Seed = seed;
+    m_Bodies.clear();
+    m_Commands.clear();
+    m_Inputs.clear();
+    m_Steps.clear();
+    m_BodyIds.clear();
+}
+
+void ReplayLog::RecordAdd(const ICollider* collider)
+{
+    const uint32_t body = static_cast<uint32_t>(m_Bodies.size());
+    m_Bodies.push_back(CaptureBody(collider));
+    m_BodyIds[collider] = body;
+    m_Commands.push_back({ CommandType::Add, body, {} });
+}
+
+void ReplayLog::RecordRemove(const ICollider* collider)
+{
+    auto it = m_BodyIds.find(collider);
+    if (it == m_BodyIds.end()) return;
+
+    m_Commands.push_back({ CommandType::Remove, it->second, {} });
+    m_BodyIds.erase(it);
+}
+
+void ReplayLog::RecordClear()
+{
+    m_Commands.push_back({ CommandType::Clear, 0, {} });
+    m_BodyIds.clear();
+}
+
+void ReplayLog::RecordEdit(const ICollider* collider, const BodyEdit& edit)
+{
+    auto it = m_BodyIds.find(collider);
+    if (it == m_BodyIds.end()) return;
+
+    m_Commands.push_back({ CommandType::Edit, it->second, edit });
+}
+
+void ReplayLog::RecordStep(const StepInput& input, uint64_t stateHash)
+{
+    if (m_Inputs.empty() || !SameInput(m_Inputs.back(), input))
+    {
+        m_Inputs.push_back(input);
+    }
+
+    Step step;
+    step.FirstCommand = m_Steps.empty() ? 0 : m_Steps.back().FirstCommand + m_Steps.back().CommandCount;
+    step.CommandCount = static_cast<uint32_t>(m_Commands.size()) - step.FirstCommand;
+    step.Input = static_cast<uint32_t>(m_Inputs.size() - 1);
+    step.StateHash = stateHash;
+    m_Steps.push_back(step);
+}
+
+std::span<const ReplayLog::Command> ReplayLog::GetCommands(const Step& step) const
+{
+    return std::span<const Command>(m_Commands).subspan(step.FirstCommand, step.CommandCount);
+}
+
+bool ReplayLog::Save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    Write(out, FILE_MAGIC);
+    Write(out, FILE_VERSION);
+    Write(out, m_Seed);
+
+    Write(out, static_cast<uint32_t>(m_Bodies.size()));
+    for (const ReplayBody& body : m_Bodies) WriteBody(out, body);
+
+    Write(out, static_cast<uint32_t>(m_Commands.size()));
+    for (const Command& command : m_Commands)
+    {
+        Write(out, command.Type);
+        Write(out, command.Body);
+        if (command.Type == CommandType::Edit)
+        {
+            Write(out, command.Edit.Field);
+            Write(out, command.Edit.Value);
+        }
+    }
+
+    Write(out, static_cast<uint32_t>(m_Inputs.size()));
+    for (const StepInput& input : m_Inputs) WriteInput(out, input);
+
+    Write(out, static_cast<uint32_t>(m_Steps.size()));
+    for (const Step& step : m_Steps)
+    {
+        Write(out, step.FirstCommand);
+        Write(out, step.CommandCount);
+        Write(out, step.Input);
+        Write(out, step.StateHash);
+    }
+    return static_cast<bool>(out);
+}
+
+bool ReplayLog::Load(const std::string& path)
+{
+    Begin(0);
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!Read(in, magic) || magic != FILE_MAGIC) return false;
+    if (!Read(in, version) || version != FILE_VERSION) return false;
+    if (!Read(in, m_Seed)) return false;
+
+    uint32_t count = 0;
+    if (!Read(in, count)) return false;
+    m_Bodies.resize(count);
+    for (ReplayBody& body : m_Bodies)
+    {
+        if (!ReadBody(in, body)) return false;
+    }
+
+    if (!Read(in, count)) return false;
+    m_Commands.resize(count);
+    for (Command& command : m_Commands)
+    {
+        if (!Read(in, command.Type) || !Read(in, command.Body)) return false;
+        if (command.Type > CommandType::Edit) return false;
+        if (command.Type != CommandType::Clear && command.Body >= m_Bodies.size()) return false;
+        if (command.Type == CommandType::Edit
+            && (!Read(in, command.Edit.Field) || !Read(in, command.Edit.Value) || command.Edit.Field > BodyField::State))
+        {
+            return false;
+        }
+    }
+
+    if (!Read(in, count)) return false;
+    m_Inputs.resize(count);
+    for (StepInput& input : m_Inputs)
+    {
+        if (!ReadInput(in, input)) return false;
+    }
+
+    if (!Read(in, count)) return false;
+    m_Steps.resize(count);
+    for (Step& step : m_Steps)
+    {
+        if (!Read(in, step.FirstCommand) || !Read(in, step.CommandCount) || !Read(in, step.Input)
+            || !Read(in, step.StateHash))
+        {
+            return false;
+        }
+        if (step.Input >= m_Inputs.size()) return false;
+        if (static_cast<uint64_t>(step.FirstCommand) + step.CommandCount > m_Commands.size()) return false;
+    }
+    return true;
+}
+
+ReplayBody ReplayLog::CaptureBody(const ICollider* collider)
+{
+    using namespace DirectX;
+
+    ReplayBody body;
+    body.Type = collider->GetColliderType();
+    body.State = collider->GetColliderState();
+    body.ReverseAware = collider->IsReverseAware();
+    XMStoreFloat3(&body.Scale, collider->GetScale());
+
+    switch (body.Type)
+    {
+    case ColliderType::Sphere:
+        body.Radius = collider->As<SphereCollider>()->GetRadius();
+        break;
+    case ColliderType::Capsule:
+        body.Radius = collider->As<CapsuleCollider>()->GetRadius();
+        body.Height = collider->As<CapsuleCollider>()->GetHeight();
+        break;
+    case ColliderType::ConvexHull:
+        body.Vertices = collider->As<ConvexHullCollider>()->GetVertices();
+        break;
+    default:
+        break;
+    }
+
+    const RigidBody* rigidBody = collider->GetRigidBody();
+    const Quaternion orientation = rigidBody->GetOrientation();
+    XMStoreFloat3(&body.Position, rigidBody->GetPosition());
+    body.Orientation = { orientation.GetI(), orientation.GetJ(), orientation.GetK(), orientation.GetR() };
+    XMStoreFloat3(&body.Velocity, rigidBody->GetVelocity());
+    XMStoreFloat3(&body.Acceleration, rigidBody->GetAcceleration());
+    XMStoreFloat3(&body.AngularVelocity, rigidBody->GetAngularVelocity());
+    XMStoreFloat3x3(&body.InverseInertia, rigidBody->GetInverseInertiaTensor());
+    body.InverseMass = rigidBody->GetInverseMass();
+    body.LinearDamping = rigidBody->GetDamping();
+    body.AngularDamping = rigidBody->GetAngularDamping();
+    body.Elasticity = rigidBody->GetElasticity();
+    body.Restitution = rigidBody->GetRestitution();
+    body.Friction = rigidBody->GetFriction();
+    body.Platform = rigidBody->IsPlatform();
+    body.Continuous = rigidBody->IsContinuous();
+    body.Resting = rigidBody->GetRestingState();
+    return body;
+}
+
+bool ReplayLog::SameInput(const StepInput& a, const StepInput& b)
+{
+    // Bitwise on the floats: a replay has to see exactly what the run saw
+    return std::memcmp(&a.DeltaTime, &b.DeltaTime, sizeof(float)) == 0
+        && a.Settings.Integration == b.Settings.Integration
+        && a.Settings.BroadPhase == b.Settings.BroadPhase
+        && a.Settings.Solver.VelocityIterations == b.Settings.Solver.VelocityIterations
+        && a.Settings.Solver.PositionIterations == b.Settings.Solver.PositionIterations
+        && a.Settings.Sleep.Enabled == b.Settings.Sleep.Enabled
+        && std::memcmp(&a.Settings.Sleep.LinearVelocity, &b.Settings.Sleep.LinearVelocity, sizeof(float)) == 0
+        && std::memcmp(&a.Settings.Sleep.AngularVelocity, &b.Settings.Sleep.AngularVelocity, sizeof(float)) == 0
+        && std::memcmp(&a.Settings.Sleep.TimeToSleep, &b.Settings.Sleep.TimeToSleep, sizeof(float)) == 0
+        && a.Settings.ContinuousCollision == b.Settings.ContinuousCollision
+        && a.GravityOn == b.GravityOn
+        && a.GravityReversed == b.GravityReversed;
+}
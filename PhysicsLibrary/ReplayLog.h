@@ -0,0 +1,123 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BodyEdit.h"
+#include "ICollider.h"
+#include "PhysicsWorld.h"
+
+//~ A collider as it joined the world, enough to build one that simulates the same
+struct ReplayBody
+{
+    ColliderType Type{ ColliderType::Sphere };
+    ColliderState State{ ColliderState::Dynamic };
+    DirectX::XMFLOAT3 Scale{ 1.0f, 1.0f, 1.0f };  // boxes and hulls
+    float Radius{ 0.0f };                         // spheres and capsules
+    float Height{ 0.0f };                         // capsules
+    std::vector<DirectX::XMFLOAT3> Vertices;      // hulls, local space
+
+    DirectX::XMFLOAT3 Position{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4 Orientation{ 0.0f, 0.0f, 0.0f, 1.0f }; // I, J, K, R
+    DirectX::XMFLOAT3 Velocity{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 Acceleration{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 AngularVelocity{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3X3 InverseInertia{};
+    float InverseMass{ 1.0f };
+    float LinearDamping{ 0.0f };
+    float AngularDamping{ 0.0f };
+    float Elasticity{ 0.0f };
+    float Restitution{ 0.0f };
+    float Friction{ 0.0f };
+    bool Platform{ false };
+    bool Continuous{ false };
+    bool Resting{ false };
+    bool ReverseAware{ false };
+};
+
+// The input of a recorded run: every collider that joined or left the world, at the step it
+// happened, and what each step was given (dt, settings, gravity). Bodies are kept as they
+// were when they joined, so playing the log back needs neither the scene that spawned them
+// nor its random numbers. Edits made to bodies in the world (dragging a model in the
+// editor) are kept with the step they landed on. Every step also keeps the world's state
+// hash, ReplayPlayer compares against it. Recording has to start with an empty world, and
+// changes made to bodies directly instead of through PhysicsWorld::EditCollider are not
+// part of the log.
+class ReplayLog
+{
+public:
+    enum class CommandType : uint8_t
+    {
+        Add,
+        Remove,
+        Clear,
+        Edit,
+    };
+
+    struct Command
+    {
+        CommandType Type{ CommandType::Add };
+        uint32_t Body{ 0 }; // index into GetBodies, unused by Clear
+        BodyEdit Edit{};    // Edit only
+    };
+
+    //~ Everything besides the commands that decides how a step plays out
+    struct StepInput
+    {
+        float DeltaTime{ 0.0f };
+        WorldSettings Settings{};
+        bool GravityOn{ false };
+        bool GravityReversed{ false };
+    };
+
+    struct Step
+    {
+        uint32_t FirstCommand{ 0 };
+        uint32_t CommandCount{ 0 };
+        uint32_t Input{ 0 };     // index into GetInputs, steps with the same input share one
+        uint64_t StateHash{ 0 }; // PhysicsWorld::ComputeStateHash after the step
+    };
+
+    // === Recording ===
+    //~ Drops everything recorded so far. The seed is only stored, for the run's own random streams.
+    void Begin(uint64_t seed);
+    void RecordAdd(const ICollider* collider);
+    void RecordRemove(const ICollider* collider);
+    void RecordClear();
+    void RecordEdit(const ICollider* collider, const BodyEdit& edit);
+    //~ Closes a step, its commands are the ones recorded since the previous step
+    void RecordStep(const StepInput& input, uint64_t stateHash);
+
+    // === Reading ===
+    uint64_t GetSeed() const { return m_Seed; }
+    const std::vector<ReplayBody>& GetBodies() const { return m_Bodies; }
+    const std::vector<StepInput>& GetInputs() const { return m_Inputs; }
+    const std::vector<Step>& GetSteps() const { return m_Steps; }
+    std::span<const Command> GetCommands(const Step& step) const;
+
+    // === Files ===
+    //~ Little endian binary. False when the file cannot be written, or is not a replay log
+    //~ of this version.
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+    static ReplayBody CaptureBody(const ICollider* collider);
+
+private:
+    static bool SameInput(const StepInput& a, const StepInput& b);
+
+private:
+    uint64_t m_Seed{ 0 };
+    std::vector<ReplayBody> m_Bodies;
+    std::vector<Command> m_Commands;
+    std::vector<StepInput> m_Inputs;
+    std::vector<Step> m_Steps;
+
+    //~ Recording only: the body each collider in the world was recorded as when it joined
+    std::unordered_map<const ICollider*, uint32_t> m_BodyIds;
+};
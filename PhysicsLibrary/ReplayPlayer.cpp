@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "ReplayPlayer.h"
+
+#include "CapsuleCollider.h"
+#include "ConvexHullCollider.h"
+#include "CubeCollider.h"
+#include "RigidBody.h"
+#include "SphereCollider.h"
+
+ReplayPlayer::ReplayPlayer(const ReplayLog& log)
+    : m_Log(log)
+{
+    m_Bodies.resize(log.GetBodies().size());
+    m_Colliders.resize(log.GetBodies().size());
+    m_FirstMismatch = log.GetSteps().size();
+}
+
+bool ReplayPlayer::StepOnce()
+{
+    if (m_StepIndex >= m_Log.GetSteps().size()) return false;
+
+    const ReplayLog::Step& step = m_Log.GetSteps()[m_StepIndex];
+    for (const ReplayLog::Command& command : m_Log.GetCommands(step))
+    {
+        switch (command.Type)
+        {
+        case ReplayLog::CommandType::Add:
+            m_World.AddCollider(BuildBody(command.Body));
+            break;
+        case ReplayLog::CommandType::Remove:
+            m_World.RemoveCollider(m_Colliders[command.Body].get());
+            break;
+        case ReplayLog::CommandType::Clear:
+            m_World.Clear();
+            break;
+        case ReplayLog::CommandType::Edit:
+            m_World.EditCollider(m_Colliders[command.Body].get(), command.Edit);
+            break;
+        }
+    }
+
+    const ReplayLog::StepInput& input = m_Log.GetInputs()[step.Input];
+    Gravity* gravity = m_World.GetGravity();
+    gravity->SetGravity(input.GravityOn);
+    if (gravity->IsReversed() != input.GravityReversed) gravity->ReverseGravity();
+
+    WorldSettings settings = input.Settings;
+    settings.ThreadCount = m_ThreadCount;
+    settings.AffinityMask = 0;
+    m_World.Step(input.DeltaTime, settings);
+
+    m_LastHash = m_World.ComputeStateHash();
+    if (m_LastHash != step.StateHash && m_FirstMismatch == m_Log.GetSteps().size())
+    {
+        m_FirstMismatch = m_StepIndex;
+    }
+    ++m_StepIndex;
+    return true;
+}
+
+bool ReplayPlayer::Run()
+{
+    while (m_FirstMismatch == m_Log.GetSteps().size() && StepOnce())
+    {
+    }
+    return m_FirstMismatch == m_Log.GetSteps().size();
+}
+
+ICollider* ReplayPlayer::BuildBody(uint32_t index)
+{
+    using namespace DirectX;
+
+    const ReplayBody& recorded = m_Log.GetBodies()[index];
+    auto body = std::make_unique<RigidBody>(m_Store);
+
+    // Shape first, it sets the inertia the recorded one then replaces bit for bit
+    std::unique_ptr<ICollider> collider;
+    switch (recorded.Type)
+    {
+    case ColliderType::Sphere:
+    {
+        auto sphere = std::make_unique<SphereCollider>(body.get());
+        sphere->SetRadius(recorded.Radius);
+        collider = std::move(sphere);
+        break;
+    }
+    case ColliderType::Capsule:
+    {
+        auto capsule = std::make_unique<CapsuleCollider>(body.get());
+        capsule->SetRadius(recorded.Radius);
+        capsule->SetHeight(recorded.Height);
+        collider = std::move(capsule);
+        break;
+    }
+    case ColliderType::ConvexHull:
+    {
+        auto hull = std::make_unique<ConvexHullCollider>(body.get());
+        hull->SetVertices(recorded.Vertices);
+        hull->SetScale(XMLoadFloat3(&recorded.Scale));
+        collider = std::move(hull);
+        break;
+    }
+    case ColliderType::Cube:
+    default:
+    {
+        auto cube = std::make_unique<CubeCollider>(body.get());
+        cube->SetScale(XMLoadFloat3(&recorded.Scale));
+        collider = std::move(cube);
+        break;
+    }
+    }
+
+    body->SetPosition(XMLoadFloat3(&recorded.Position));
+    // Not through SetOrientation, normalizing the recorded quaternion again can move its last bit
+    m_Store.GetChunk(body->GetHandle())->Orientation.Store(BodyStore::GetLane(body->GetHandle()),
+        XMLoadFloat4(&recorded.Orientation));
+    body->SetVelocity(XMLoadFloat3(&recorded.Velocity));
+    body->SetAcceleration(XMLoadFloat3(&recorded.Acceleration));
+    body->SetAngularVelocity(XMLoadFloat3(&recorded.AngularVelocity));
+    body->SetInverseMass(recorded.InverseMass);
+    body->SetInverseInertiaTensor(XMLoadFloat3x3(&recorded.InverseInertia));
+    body->SetLinearDamping(recorded.LinearDamping);
+    body->SetAngularDamping(recorded.AngularDamping);
+    body->SetElasticity(recorded.Elasticity);
+    body->SetRestitution(recorded.Restitution);
+    body->SetFriction(recorded.Friction);
+    body->SetAsPlatform(recorded.Platform);
+    body->SetContinuous(recorded.Continuous);
+    body->SetRestingState(recorded.Resting);
+
+    collider->SetColliderState(recorded.State);
+    collider->SetReverseAware(recorded.ReverseAware);
+
+    ICollider* result = collider.get();
+    m_Bodies[index] = std::move(body);
+    m_Colliders[index] = std::move(collider);
+    return result;
+}
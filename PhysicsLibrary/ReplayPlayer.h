@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "PhysicsWorld.h"
+#include "ReplayLog.h"
+
+// Plays a ReplayLog back in a PhysicsWorld and BodyStore of its own, without a window or a
+// scene, so it may run beside the live simulation: builds every recorded body when its Add
+// comes up, applies the commands and input of each step, steps the world and checks its
+// state hash against the recorded one. Bodies that left the world are kept until the
+// player goes away, so their addresses are never reused mid run.
+class ReplayPlayer
+{
+public:
+    //~ The log has to outlive the player
+    explicit ReplayPlayer(const ReplayLog& log);
+    ReplayPlayer(const ReplayPlayer&) = delete;
+    ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+
+    //~ Workers to step with, the hashes must not depend on it
+    void SetThreadCount(int count) { m_ThreadCount = count; }
+
+    //~ Plays the next recorded step, false once there is none left
+    bool StepOnce();
+    //~ Plays every remaining step, stops at the first whose hash differs from the log.
+    //~ True when all of them matched.
+    bool Run();
+
+    size_t GetStepIndex() const { return m_StepIndex; }
+    size_t GetStepCount() const { return m_Log.GetSteps().size(); }
+    uint64_t GetLastStateHash() const { return m_LastHash; }
+    //~ First step whose hash differed, GetStepCount() while every step so far matched
+    size_t GetFirstMismatch() const { return m_FirstMismatch; }
+
+    PhysicsWorld& GetWorld() { return m_World; }
+
+private:
+    ICollider* BuildBody(uint32_t index);
+
+private:
+    const ReplayLog& m_Log;
+    //~ Declared first, the world and the bodies hand their lanes back to it
+    BodyStore m_Store{};
+    PhysicsWorld m_World{ m_Store };
+    int m_ThreadCount{ 1 };
+    size_t m_StepIndex{ 0 };
+    size_t m_FirstMismatch{ 0 };
+    uint64_t m_LastHash{ 0 };
+
+    std::vector<std::unique_ptr<RigidBody>> m_Bodies;
+    std::vector<std::unique_ptr<ICollider>> m_Colliders; // by body index, built on its Add
+};
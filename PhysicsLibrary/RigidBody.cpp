@@ -5,92 +5,78 @@
 #include <iostream>
 #include <string>
 
-RigidBody::RigidBody()
+RigidBody::RigidBody(BodyStore& store)
     :
-    InverseMass(1.0f),
-    Orientation(1, 0, 0, 0)
+    m_Store(&store),
+    m_Handle(store.Allocate()),
+    m_Chunk(store.GetChunk(m_Handle)),
+    m_Lane(BodyStore::GetLane(m_Handle))
 {
-    m_InverseInertiaTensorLocal = DirectX::XMMatrixIdentity();
     CalculateDerivedData();
 }
 
+RigidBody::~RigidBody()
+{
+    m_Store->Release(m_Handle);
+}
+
 void RigidBody::AddForce(const DirectX::XMVECTOR& force)
 {
-    DirectX::XMVECTOR current = ForceAccum.Get();
-    DirectX::XMVECTOR updated = DirectX::XMVectorAdd(current, force);
-    ForceAccum.Set(updated);
+    WakeUp();
+    DirectX::XMVECTOR current = m_Chunk->Force.Load(m_Lane);
+    m_Chunk->Force.Store(m_Lane, DirectX::XMVectorAdd(current, force));
 }
 
 void RigidBody::AddTorque(const DirectX::XMVECTOR& torque)
 {
-    DirectX::XMVECTOR current = TorqueAccum.Get();
-    DirectX::XMVECTOR updated = DirectX::XMVectorAdd(current, torque);
-    TorqueAccum.Set(updated);
+    WakeUp();
+    DirectX::XMVECTOR current = m_Chunk->Torque.Load(m_Lane);
+    m_Chunk->Torque.Store(m_Lane, DirectX::XMVectorAdd(current, torque));
 }
 
 void RigidBody::Integrate(float dt, IntegrationType type)
 {
-    switch (type)
-    {
-    case IntegrationType::Euler:
-        IntegrateEuler(dt);
-        break;
-    case IntegrationType::SemiImplicitEuler:
-        IntegrateSemiImplicitEuler(dt);
-        break;
-    case IntegrationType::Verlet:
-        IntegrateVerlet(dt);
-        break;
-    }
+    BodyStore::IntegrateLane(*m_Chunk, m_Lane, dt, type);
 }
 
 DirectX::XMMATRIX RigidBody::GetTransformMatrix()
 {
     using namespace DirectX;
-    XMMATRIX rotation = Orientation.ToRotationMatrix();
-    XMMATRIX translation = XMMatrixTranslationFromVector(Position.Get());
+    XMMATRIX rotation = XMMatrixRotationQuaternion(m_Chunk->Orientation.Load(m_Lane));
+    XMMATRIX translation = XMMatrixTranslationFromVector(GetPosition());
     return rotation * translation;
 }
 
 void RigidBody::CalculateDerivedData()
 {
-    using namespace DirectX;
-
-    Orientation.Normalize(); // Prevent drift
-
-    XMMATRIX rotMatrix = XMMatrixRotationQuaternion(Orientation.ToXmVector());
-    XMMATRIX translation = XMMatrixTranslationFromVector(Position.Get());
-
-    TransformMatrix = rotMatrix * translation; // Full local-to-world matrix
-
-    XMMATRIX rotTranspose = XMMatrixTranspose(rotMatrix);
-    InverseInertiaTensorWorld = XMMatrixMultiply(
-        XMMatrixMultiply(rotMatrix, m_InverseInertiaTensorLocal),
-        rotTranspose
-    );
+    BodyStore::CalculateDerivedData(*m_Chunk, m_Lane);
 }
+
 void RigidBody::ClearAccumulators()
 {
-    ForceAccum.Set(DirectX::XMVectorZero());
-    TorqueAccum.Set(DirectX::XMVectorZero());
+    m_Chunk->Force.Store(m_Lane, DirectX::XMVectorZero());
+    m_Chunk->Torque.Store(m_Lane, DirectX::XMVectorZero());
 }
 
 // Setters
 void RigidBody::SetPosition(const DirectX::XMVECTOR& pos)
 {
-    Position.Set(pos);
-    m_VerletNeedsReset = true;
+    WakeUp();
+    m_Chunk->Position.Store(m_Lane, pos);
+    m_Chunk->VerletNeedsReset[m_Lane] = 1;
 }
 
 void RigidBody::SetVelocity(const DirectX::XMVECTOR& vel)
 {
-    Velocity.Set(vel);
-    m_VerletNeedsReset = true;
+    WakeUp();
+    m_Chunk->Velocity.Store(m_Lane, vel);
+    m_Chunk->VerletNeedsReset[m_Lane] = 1;
 }
 
 void RigidBody::SetDamping(float d)
 {
-    m_LinearDamping.store(d, std::memory_order_relaxed);
+    m_Chunk->LinearDamping[m_Lane] = d;
+    m_Chunk->DampingDirty.store(true, std::memory_order_release);
 }
 
 
@@ -114,83 +100,89 @@ void RigidBody::SetFriction(float v)
 
 void RigidBody::SetAcceleration(const DirectX::XMVECTOR& acc)
 {
-    Acceleration.Set(acc);
+    WakeUp();
+    m_Chunk->Acceleration.Store(m_Lane, acc);
 }
 
 
 void RigidBody::SetOrientation(const Quaternion& q)
 {
-    Orientation = q;
-    Orientation.Normalize(); // direct math is fine
+    WakeUp();
+    Quaternion normalized = q;
+    normalized.Normalize(); // direct math is fine
+    m_Chunk->Orientation.Store(m_Lane, normalized.ToXmVector());
 }
 
 
 void RigidBody::SetAngularVelocity(const DirectX::XMVECTOR& av)
 {
-    AngularVelocity.Set(av);
+    WakeUp();
+    m_Chunk->AngularVelocity.Store(m_Lane, av);
 }
 
 
 void RigidBody::SetMass(float mass)
 {
-    InverseMass.store((mass > 0.0f) ? 1.0f / mass : 0.0f, std::memory_order_relaxed);
+    m_Chunk->InverseMass[m_Lane] = (mass > 0.0f) ? 1.0f / mass : 0.0f;
 }
 
 
 void RigidBody::SetInverseMass(float invMass)
 {
-    InverseMass.store(invMass, std::memory_order_relaxed);
+    m_Chunk->InverseMass[m_Lane] = invMass;
 }
 
 
 void RigidBody::SetLinearDamping(float d)
 {
-    m_LinearDamping.store(d, std::memory_order_relaxed);
+    m_Chunk->LinearDamping[m_Lane] = d;
+    m_Chunk->DampingDirty.store(true, std::memory_order_release);
 }
 
 
 void RigidBody::SetAngularDamping(float d)
 {
-    AngularDamping.store(d, std::memory_order_relaxed);
+    m_Chunk->AngularDamping[m_Lane] = d;
+    m_Chunk->DampingDirty.store(true, std::memory_order_release);
 }
 
 
 void RigidBody::SetInverseInertiaTensor(const DirectX::XMMATRIX& tensor)
 {
-    m_InverseInertiaTensorLocal = tensor;
+    m_Chunk->InverseInertiaLocal.Store(m_Lane, tensor);
 }
 
 
 // Getters
-DirectX::XMVECTOR RigidBody::GetPosition()
+DirectX::XMVECTOR RigidBody::GetPosition() const
 {
-    return Position.Get();
+    return m_Chunk->Position.Load(m_Lane);
 }
 
-DirectX::XMVECTOR RigidBody::GetVelocity()
+DirectX::XMVECTOR RigidBody::GetVelocity() const
 {
-    return Velocity.Get();
+    return m_Chunk->Velocity.Load(m_Lane);
 }
 
-DirectX::XMVECTOR RigidBody::GetAcceleration()
+DirectX::XMVECTOR RigidBody::GetAcceleration() const
 {
-    return Acceleration.Get();
+    return m_Chunk->Acceleration.Load(m_Lane);
 }
 
-DirectX::XMVECTOR RigidBody::GetAngularVelocity()
+DirectX::XMVECTOR RigidBody::GetAngularVelocity() const
 {
-    return AngularVelocity.Get();
+    return m_Chunk->AngularVelocity.Load(m_Lane);
 }
 
 Quaternion RigidBody::GetOrientation() const
 {
-    auto result = Orientation;
-    return result;
+    const BodyStreamQuaternion& q = m_Chunk->Orientation;
+    return Quaternion(q.R[m_Lane], q.I[m_Lane], q.J[m_Lane], q.K[m_Lane]);
 }
 
 float RigidBody::GetMass() const
 {
-    float invMass = InverseMass.load(std::memory_order_relaxed);
+    float invMass = m_Chunk->InverseMass[m_Lane];
     return (invMass > 0.0f) ? 1.0f / invMass : INFINITY;
 }
 
@@ -201,32 +193,32 @@ float RigidBody::GetElasticity() const
 
 float RigidBody::GetInverseMass() const
 {
-    return InverseMass.load(std::memory_order_relaxed);
+    return m_Chunk->InverseMass[m_Lane];
 }
 
 DirectX::XMMATRIX RigidBody::GetInverseInertiaTensor() const
 {
-    return m_InverseInertiaTensorLocal;
+    return m_Chunk->InverseInertiaLocal.Load(m_Lane);
 }
 
 DirectX::XMMATRIX RigidBody::GetInverseInertiaTensorWorld() const
 {
-    return InverseInertiaTensorWorld;
+    return m_Chunk->InverseInertiaWorld.Load(m_Lane);
 }
 
 bool RigidBody::HasFiniteMass() const
 {
-    return InverseMass.load(std::memory_order_relaxed) > 0.0f;
+    return m_Chunk->InverseMass[m_Lane] > 0.0f;
 }
 
 float RigidBody::GetDamping() const
 {
-    return m_LinearDamping.load(std::memory_order_relaxed);
+    return m_Chunk->LinearDamping[m_Lane];
 }
 
-float RigidBody::GetAngularDamping()
+float RigidBody::GetAngularDamping() const
 {
-    return AngularDamping.load(std::memory_order_relaxed);
+    return m_Chunk->AngularDamping[m_Lane];
 }
 
 float RigidBody::GetRestitution() const
@@ -249,6 +241,63 @@ bool RigidBody::GetRestingState() const
     return m_Resting.load(std::memory_order_relaxed);
 }
 
+void RigidBody::PutToSleep(uint32_t sleepIsland)
+{
+    m_SleepIsland = sleepIsland;
+    m_Chunk->Velocity.Store(m_Lane, DirectX::XMVectorZero());
+    m_Chunk->AngularVelocity.Store(m_Lane, DirectX::XMVectorZero());
+    ClearAccumulators();
+    m_Chunk->Awake[m_Lane].store(0, std::memory_order_release);
+}
+
+void RigidBody::WakeUp()
+{
+    // Only a real transition restarts the timer, the solver writes velocities every step
+    if (!m_Chunk->Awake[m_Lane].exchange(1, std::memory_order_acq_rel))
+    {
+        m_SleepTime = 0.0f;
+        m_Chunk->VerletNeedsReset[m_Lane] = 1;
+    }
+}
+
+bool RigidBody::IsAwake() const
+{
+    return m_Chunk->Awake[m_Lane].load(std::memory_order_acquire) != 0;
+}
+
+uint32_t RigidBody::GetSleepIsland() const
+{
+    return m_SleepIsland;
+}
+
+float RigidBody::UpdateSleepTime(float dt, float linearThreshold, float angularThreshold)
+{
+    using namespace DirectX;
+
+    const float linearSq = XMVectorGetX(XMVector3LengthSq(GetVelocity()));
+    const float angularSq = XMVectorGetX(XMVector3LengthSq(GetAngularVelocity()));
+
+    if (linearSq > linearThreshold * linearThreshold || angularSq > angularThreshold * angularThreshold)
+    {
+        m_SleepTime = 0.0f;
+    }
+    else
+    {
+        m_SleepTime += dt;
+    }
+    return m_SleepTime;
+}
+
+void RigidBody::SetSimulated(bool state)
+{
+    m_Chunk->Simulated[m_Lane].store(state ? 1 : 0, std::memory_order_release);
+}
+
+bool RigidBody::IsSimulated() const
+{
+    return m_Chunk->Simulated[m_Lane].load(std::memory_order_acquire) != 0;
+}
+
 void RigidBody::ConstrainVelocity(const DirectX::XMVECTOR& contactNormal)
 {
     const DirectX::XMVECTOR velocity = GetVelocity();
@@ -272,6 +321,16 @@ bool RigidBody::IsPlatform() const
     return m_Platform.load(std::memory_order_relaxed);
 }
 
+void RigidBody::SetContinuous(bool state)
+{
+    m_Continuous.store(state, std::memory_order_relaxed);
+}
+
+bool RigidBody::IsContinuous() const
+{
+    return m_Continuous.load(std::memory_order_relaxed);
+}
+
 void RigidBody::ComputeInverseInertiaTensorBox(float width, float height, float depth)
 {
     using namespace DirectX;
@@ -285,12 +344,12 @@ void RigidBody::ComputeInverseInertiaTensorBox(float width, float height, float
     float invIyy = (Iyy > 0.0f) ? (1.0f / Iyy) : 0.0f;
     float invIzz = (Izz > 0.0f) ? (1.0f / Izz) : 0.0f;
 
-    m_InverseInertiaTensorLocal = XMMatrixSet(
+    SetInverseInertiaTensor(XMMatrixSet(
         invIxx, 0.0f, 0.0f, 0.0f,
         0.0f, invIyy, 0.0f, 0.0f,
         0.0f, 0.0f, invIzz, 0.0f,
         0.0f, 0.0f, 0.0f, 1.0f
-    );
+    ));
 }
 
 void RigidBody::ComputeInverseInertiaTensorSphere(float radius)
@@ -298,21 +357,20 @@ void RigidBody::ComputeInverseInertiaTensorSphere(float radius)
     float mass = GetMass();
     if (mass <= 0.0f)
     {
-        m_InverseInertiaTensorLocal.r[0] = DirectX::XMVectorZero();
-        m_InverseInertiaTensorLocal.r[1] = DirectX::XMVectorZero();
-        m_InverseInertiaTensorLocal.r[2] = DirectX::XMVectorZero();
-        m_InverseInertiaTensorLocal.r[3] = DirectX::XMVectorZero();
+        SetInverseInertiaTensor(DirectX::XMMATRIX{ DirectX::XMVectorZero(), DirectX::XMVectorZero(),
+            DirectX::XMVectorZero(), DirectX::XMVectorZero() });
         return;
     }
 
     float factor = 2.0f / 5.0f * mass * radius * radius;
     float inv = 1.0f / factor;
 
-    m_InverseInertiaTensorLocal = DirectX::XMMatrixIdentity();
-    m_InverseInertiaTensorLocal.r[0] = DirectX::XMVectorSet(inv, 0, 0, 0);
-    m_InverseInertiaTensorLocal.r[1] = DirectX::XMVectorSet(0, inv, 0, 0);
-    m_InverseInertiaTensorLocal.r[2] = DirectX::XMVectorSet(0, 0, inv, 0);
-    m_InverseInertiaTensorLocal.r[3] = DirectX::XMVectorSet(0, 0, 0, 1);
+    DirectX::XMMATRIX tensor = DirectX::XMMatrixIdentity();
+    tensor.r[0] = DirectX::XMVectorSet(inv, 0, 0, 0);
+    tensor.r[1] = DirectX::XMVectorSet(0, inv, 0, 0);
+    tensor.r[2] = DirectX::XMVectorSet(0, 0, inv, 0);
+    tensor.r[3] = DirectX::XMVectorSet(0, 0, 0, 1);
+    SetInverseInertiaTensor(tensor);
 }
 
 void RigidBody::ComputeInverseInertiaTensorCapsule(float radius, float height)
@@ -322,10 +380,8 @@ void RigidBody::ComputeInverseInertiaTensorCapsule(float radius, float height)
     float mass = GetMass();
     if (mass <= 0.0f)
     {
-        m_InverseInertiaTensorLocal.r[0] = DirectX::XMVectorZero();
-        m_InverseInertiaTensorLocal.r[1] = DirectX::XMVectorZero();
-        m_InverseInertiaTensorLocal.r[2] = DirectX::XMVectorZero();
-        m_InverseInertiaTensorLocal.r[3] = DirectX::XMVectorZero();
+        SetInverseInertiaTensor(DirectX::XMMATRIX{ DirectX::XMVectorZero(), DirectX::XMVectorZero(),
+            DirectX::XMVectorZero(), DirectX::XMVectorZero() });
         return;
     }
 
@@ -358,12 +414,12 @@ void RigidBody::ComputeInverseInertiaTensorCapsule(float radius, float height)
     float invIyy = (Iyy > 0.0f) ? 1.0f / Iyy : 0.0f;
     float invIzz = (Izz > 0.0f) ? 1.0f / Izz : 0.0f;
 
-    m_InverseInertiaTensorLocal = XMMatrixSet(
+    SetInverseInertiaTensor(XMMatrixSet(
         invIxx, 0.0f, 0.0f, 0.0f,
         0.0f, invIyy, 0.0f, 0.0f,
         0.0f, 0.0f, invIzz, 0.0f,
         0.0f, 0.0f, 0.0f, 1.0f
-    );
+    ));
 }
 
 void RigidBody::ApplyLinearImpulse(const DirectX::XMVECTOR& impulse)
@@ -377,149 +433,7 @@ void RigidBody::ApplyLinearImpulse(const DirectX::XMVECTOR& impulse)
 void RigidBody::ApplyAngularImpulse(const DirectX::XMVECTOR& impulse, const DirectX::XMVECTOR& contactVector)
 {
     DirectX::XMVECTOR torque = DirectX::XMVector3Cross(contactVector, impulse);
-    DirectX::XMVECTOR deltaAngular = DirectX::XMVector3Transform(torque, InverseInertiaTensorWorld);
+    DirectX::XMVECTOR deltaAngular = DirectX::XMVector3Transform(torque, GetInverseInertiaTensorWorld());
 
     SetAngularVelocity(DirectX::XMVectorAdd(GetAngularVelocity(), deltaAngular));
 }
-
-void RigidBody::IntegrateEuler(float dt)
-{
-    CalculateDerivedData();
-
-    if (InverseMass.load(std::memory_order_relaxed) <= 0.0f) return;
-
-    DirectX::XMVECTOR pos = Position.Get();
-    DirectX::XMVECTOR vel = Velocity.Get();
-    DirectX::XMVECTOR acc = Acceleration.Get();
-    DirectX::XMVECTOR force = ForceAccum.Get();
-
-    DirectX::XMVECTOR acceleration = DirectX::XMVectorAdd(acc, DirectX::XMVectorScale(force, InverseMass));
-
-    pos = DirectX::XMVectorAdd(pos, DirectX::XMVectorScale(vel, dt));
-    vel = DirectX::XMVectorAdd(vel, DirectX::XMVectorScale(acceleration, dt));
-
-    ApplyLinearDamping(vel, dt);
-
-    Position.Set(pos);
-    Velocity.Set(vel);
-
-    IntegrateAngular(dt);
-    ClearAccumulators();
-}
-
-void RigidBody::IntegrateSemiImplicitEuler(float dt)
-{
-    CalculateDerivedData();
-
-    if (InverseMass.load(std::memory_order_relaxed) <= 0.0f) return;
-
-    DirectX::XMVECTOR pos = Position.Get();
-    DirectX::XMVECTOR vel = Velocity.Get();
-    DirectX::XMVECTOR acc = Acceleration.Get();
-    DirectX::XMVECTOR force = ForceAccum.Get();
-
-    DirectX::XMVECTOR acceleration = DirectX::XMVectorAdd(acc, DirectX::XMVectorScale(force, InverseMass));
-
-    vel = DirectX::XMVectorAdd(vel, DirectX::XMVectorScale(acceleration, dt));
-    pos = DirectX::XMVectorAdd(pos, DirectX::XMVectorScale(vel, dt));
-
-    ApplyLinearDamping(vel, dt);
-
-    Position.Set(pos);
-    Velocity.Set(vel);
-
-    IntegrateAngular(dt);
-    ClearAccumulators();
-}
-
-void RigidBody::IntegrateVerlet(float dt)
-{
-    CalculateDerivedData();
-
-    if (InverseMass.load(std::memory_order_relaxed) <= 0.0f) return;
-
-    DirectX::XMVECTOR pos = Position.Get();
-
-    if (m_VerletNeedsReset)
-    {
-        DirectX::XMVECTOR vel = Velocity.Get();
-        DirectX::XMVECTOR lastPos = DirectX::XMVectorSubtract(pos, DirectX::XMVectorScale(vel, dt));
-        m_LastPosition.Set(lastPos);
-        m_VerletNeedsReset = false;
-    }
-
-    DirectX::XMVECTOR lastPos = m_LastPosition.Get();
-    DirectX::XMVECTOR acc = Acceleration.Get();
-    DirectX::XMVECTOR force = ForceAccum.Get();
-
-    DirectX::XMVECTOR acceleration = DirectX::XMVectorAdd(acc, DirectX::XMVectorScale(force, InverseMass));
-    acceleration = ClampVectorLength(acceleration, 100.0f);
-
-    DirectX::XMVECTOR posDelta = DirectX::XMVectorSubtract(pos, lastPos);
-    DirectX::XMVECTOR accelTerm = DirectX::XMVectorScale(acceleration, dt * dt);
-    DirectX::XMVECTOR newPos = DirectX::XMVectorAdd(pos, DirectX::XMVectorAdd(posDelta, accelTerm));
-
-    DirectX::XMVECTOR vel = DirectX::XMVectorScale(posDelta, 1.0f / dt);
-    ApplyLinearDamping(vel, dt);
-
-    m_LastPosition.Set(pos);
-    Position.Set(newPos);
-    Velocity.Set(vel);
-
-    IntegrateAngular(dt);
-    ClearAccumulators();
-}
-
-void RigidBody::IntegrateAngular(float dt)
-{
-    DirectX::XMVECTOR angVel = AngularVelocity.Get();
-    DirectX::XMVECTOR torque = TorqueAccum.Get();
-
-    DirectX::XMVECTOR angularAcc = DirectX::XMVector3Transform(torque, m_InverseInertiaTensorLocal);
-    angVel = DirectX::XMVectorAdd(angVel, DirectX::XMVectorScale(angularAcc, dt));
-
-    float angDamp = AngularDamping.load(std::memory_order_relaxed);
-    angVel = DirectX::XMVectorScale(angVel, std::pow(angDamp, dt));
-
-    AngularVelocity.Set(angVel);
-
-    Orientation.AddScaledVector(angVel, dt);
-    Orientation.Normalize();
-
-    // Optional: sleep threshold
-    if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(angVel)) < 1e-5f)
-        AngularVelocity.Set(DirectX::XMVectorZero());
-}
-
-void RigidBody::ApplyLinearDamping(DirectX::XMVECTOR& vel, float dt) const
-{
-    float damping = m_LinearDamping.load(std::memory_order_relaxed);
-    vel = DirectX::XMVectorScale(vel, std::pow(damping, dt));
-
-    if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(vel)) < 1e-5f)
-        vel = DirectX::XMVectorZero();
-}
-
-void RigidBody::ResetVerletState(float delta)
-{
-    const auto pos = Position.Get();
-    const auto vel = Velocity.Get();
-    const auto lastPos = DirectX::XMVectorSubtract(pos, DirectX::XMVectorScale(vel, delta));
-    m_LastPosition.Set(lastPos);
-}
-
-DirectX::XMVECTOR RigidBody::ClampVectorLength(DirectX::XMVECTOR vec, float maxLength)
-{
-    using namespace DirectX;
-
-    XMVECTOR lenSq = XMVector3LengthSq(vec);
-    float lengthSquared = XMVectorGetX(lenSq);
-
-    if (lengthSquared > maxLength * maxLength)
-    {
-        XMVECTOR len = XMVectorSqrt(lenSq);
-        vec = XMVectorDivide(XMVectorScale(vec, maxLength), len); // vec * (max / length)
-    }
-
-    return vec;
-}
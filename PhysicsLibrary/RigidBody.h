@@ -1,37 +1,22 @@
 #pragma once
 #include <DirectXMath.h>
 
-#include <windows.h>
 #include "Quaternion.h"
 #include "IntegrationType.h"
+#include "BodyStore.h"
 
 
-struct AtomicVector
-{
-    DirectX::XMVECTOR value = DirectX::XMVectorZero();
-    std::atomic_flag lock = ATOMIC_FLAG_INIT;
-
-    DirectX::XMVECTOR Get()
-    {
-        while (lock.test_and_set(std::memory_order_acquire)); // spin
-        DirectX::XMVECTOR val = value;
-        lock.clear(std::memory_order_release);
-        return val;
-    }
-
-    void Set(DirectX::XMVECTOR v)
-    {
-        while (lock.test_and_set(std::memory_order_acquire)); // spin
-        value = v;
-        lock.clear(std::memory_order_release);
-    }
-};
-
-
+// View over one lane of the BodyStore. The body owns its lane for its whole lifetime, the
+// hot state lives in the store's arrays and only rarely read settings stay in here.
 class RigidBody
 {
 public:
-    RigidBody();
+    //~ Takes a lane in store, throws std::length_error when the store is full
+    explicit RigidBody(BodyStore& store = BodyStore::Get());
+    ~RigidBody();
+
+    RigidBody(const RigidBody&) = delete;
+    RigidBody& operator=(const RigidBody&) = delete;
 
     void CalculateDerivedData();
 
@@ -58,10 +43,10 @@ public:
     void SetFriction(float v);
 
     // Getters
-    DirectX::XMVECTOR GetPosition();
-    DirectX::XMVECTOR GetVelocity();
-    DirectX::XMVECTOR GetAcceleration();
-    DirectX::XMVECTOR GetAngularVelocity();
+    DirectX::XMVECTOR GetPosition() const;
+    DirectX::XMVECTOR GetVelocity() const;
+    DirectX::XMVECTOR GetAcceleration() const;
+    DirectX::XMVECTOR GetAngularVelocity() const;
     Quaternion GetOrientation() const;
     float GetMass() const;
     float GetElasticity() const;
@@ -70,18 +55,39 @@ public:
     DirectX::XMMATRIX GetInverseInertiaTensorWorld() const;
     bool HasFiniteMass() const;
     float GetDamping() const;
-    float GetAngularDamping();
+    float GetAngularDamping() const;
     float GetRestitution() const;
     float GetFriction() const;
 
     void SetRestingState(bool state);
     bool GetRestingState() const;
 
+    //~ Sleeping bodies are skipped by integration and the narrowphase until something wakes them.
+    //~ Setting a pose, a velocity or adding a force wakes the body.
+    void PutToSleep(uint32_t sleepIsland);
+    void WakeUp();
+    bool IsAwake() const;
+    uint32_t GetSleepIsland() const;
+
+    //~ Accumulates time spent below both speed thresholds, resets once either is exceeded
+    float UpdateSleepTime(float dt, float linearThreshold, float angularThreshold);
+
+    //~ Only simulated bodies are advanced by BodyStore::Integrate, set while the physics owns the body
+    void SetSimulated(bool state);
+    bool IsSimulated() const;
+    BodyHandle GetHandle() const { return m_Handle; }
+    //~ Only a world stepping this store may simulate the body
+    BodyStore& GetStore() const { return *m_Store; }
+
     void ConstrainVelocity(const DirectX::XMVECTOR& contactNormal);
 
     void SetAsPlatform(bool state);
     bool IsPlatform() const;
 
+    //~ Opt in to swept collision against static geometry, for small bodies fast enough to tunnel
+    void SetContinuous(bool state);
+    bool IsContinuous() const;
+
     void ComputeInverseInertiaTensorBox(float width, float height, float depth);
     void ComputeInverseInertiaTensorSphere(float radius);
     void ComputeInverseInertiaTensorCapsule(float radius, float height);
@@ -90,38 +96,17 @@ public:
     void ApplyAngularImpulse(const DirectX::XMVECTOR& impulse, const DirectX::XMVECTOR& contactVector);
 
 private:
-    void IntegrateEuler(float dt);
-    void IntegrateSemiImplicitEuler(float dt);
-    void IntegrateVerlet(float dt);
-
-    void IntegrateAngular(float dt);
-    void ApplyLinearDamping(DirectX::XMVECTOR& vel, float dt) const;
+    BodyStore* m_Store;
+    BodyHandle m_Handle;
+    BodyChunk* m_Chunk;
+    uint32_t m_Lane;
 
-    void ResetVerletState(float delta);
-    DirectX::XMVECTOR ClampVectorLength(DirectX::XMVECTOR vec, float maxLength);
-
-private:
-    bool m_VerletNeedsReset{ false };
     std::atomic<bool> m_Platform{ false };
+    std::atomic<bool> m_Continuous{ false };
     std::atomic<bool> m_Resting{ false };
-    std::atomic<float> InverseMass{ 10.f };
-    std::atomic<float> m_LinearDamping{ 0.75f };
+    float m_SleepTime{ 0.0f };
+    uint32_t m_SleepIsland{ 0 };
     std::atomic<float> m_Elastic{ 0.56f };
     std::atomic<float> m_Restitution{ 0.35f };
     std::atomic<float> m_Friction{ 0.38f };
-    std::atomic<float> AngularDamping{ 0.39f };
-
-
-    Quaternion Orientation;
-    AtomicVector Position;
-    AtomicVector m_LastPosition;
-    AtomicVector Velocity;
-    AtomicVector Acceleration;
-    AtomicVector ForceAccum;
-    AtomicVector AngularVelocity;
-    AtomicVector TorqueAccum;
-
-    DirectX::XMMATRIX m_InverseInertiaTensorLocal;
-    DirectX::XMMATRIX InverseInertiaTensorWorld;
-    DirectX::XMMATRIX TransformMatrix;
 };
@@ -0,0 +1,190 @@
+#include "pch.h"
+#include "SpatialHashBroadPhase.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    //~ 21 bits per axis keeps the packed key collision free
+    constexpr int CELL_LIMIT = (1 << 20) - 1;
+}
+
+SpatialHashBroadPhase::SpatialHashBroadPhase(float cellSize)
+{
+    SetCellSize(cellSize);
+}
+
+void SpatialHashBroadPhase::Update(const std::vector<ICollider*>& colliders)
+{
+    m_Pairs.clear();
+    m_Entries.clear();
+    m_Oversized.clear();
+    m_PairKeys.clear();
+
+    const size_t count = colliders.size();
+    m_Bounds.resize(count);
+    m_IsOversized.assign(count, 0);
+
+    // === Bucket every collider into the cells its AABB touches ===
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const AABB& box = m_Bounds[i] = colliders[i]->GetWorldAABB();
+
+        const int x0 = ToCell(box.Min.x), x1 = ToCell(box.Max.x);
+        const int y0 = ToCell(box.Min.y), y1 = ToCell(box.Max.y);
+        const int z0 = ToCell(box.Min.z), z1 = ToCell(box.Max.z);
+
+        const int64_t cells = static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+        if (cells > m_MaxCellsPerCollider)
+        {
+            m_Oversized.push_back(i);
+            m_IsOversized[i] = 1;
+            continue;
+        }
+
+        for (int x = x0; x <= x1; ++x)
+            for (int y = y0; y <= y1; ++y)
+                for (int z = z0; z <= z1; ++z)
+                    m_Entries.push_back({ MakeKey(x, y, z), i });
+    }
+
+    std::sort(m_Entries.begin(), m_Entries.end(), [](const CellEntry& a, const CellEntry& b)
+        {
+            return a.Key != b.Key ? a.Key < b.Key : a.Index < b.Index;
+        });
+
+    // === Pairs inside each occupied cell ===
+    m_OccupiedCells = 0;
+    size_t begin = 0;
+    while (begin < m_Entries.size())
+    {
+        const uint64_t key = m_Entries[begin].Key;
+        size_t end = begin + 1;
+        while (end < m_Entries.size() && m_Entries[end].Key == key) ++end;
+        ++m_OccupiedCells;
+
+        for (size_t a = begin; a < end; ++a)
+        {
+            const uint32_t i = m_Entries[a].Index;
+            for (size_t b = a + 1; b < end; ++b)
+            {
+                const uint32_t j = m_Entries[b].Index;
+
+                const AABB& boxA = m_Bounds[i];
+                const AABB& boxB = m_Bounds[j];
+                if (!boxA.Overlaps(boxB)) continue;
+
+                // Report from the cell owning the overlap's min corner only
+                const uint64_t owner = MakeKey(
+                    ToCell(std::max(boxA.Min.x, boxB.Min.x)),
+                    ToCell(std::max(boxA.Min.y, boxB.Min.y)),
+                    ToCell(std::max(boxA.Min.z, boxB.Min.z)));
+                if (owner != key) continue;
+
+                if (!ShouldTestPair(colliders[i], colliders[j])) continue;
+                m_PairKeys.push_back((static_cast<uint64_t>(i) << 32) | j);
+            }
+        }
+        begin = end;
+    }
+
+    // === Oversized colliders against everything ===
+    for (const uint32_t o : m_Oversized)
+    {
+        for (uint32_t j = 0; j < count; ++j)
+        {
+            if (j == o) continue;
+            if (m_IsOversized[j] && j < o) continue; // already reported from j
+
+            if (!m_Bounds[o].Overlaps(m_Bounds[j])) continue;
+            if (!ShouldTestPair(colliders[o], colliders[j])) continue;
+
+            const uint32_t lo = std::min(o, j);
+            const uint32_t hi = std::max(o, j);
+            m_PairKeys.push_back((static_cast<uint64_t>(lo) << 32) | hi);
+        }
+    }
+
+    // Stable order so the narrowphase walks the same pairs every run
+    std::sort(m_PairKeys.begin(), m_PairKeys.end());
+
+    m_Pairs.reserve(m_PairKeys.size());
+    for (const uint64_t pairKey : m_PairKeys)
+    {
+        const uint32_t i = static_cast<uint32_t>(pairKey >> 32);
+        const uint32_t j = static_cast<uint32_t>(pairKey & 0xFFFFFFFFu);
+        m_Pairs.push_back({ colliders[i], colliders[j] });
+    }
+}
+
+void SpatialHashBroadPhase::Remove(ICollider*)
+{
+    // The grid is rebuilt from the collider list every step, nothing to detach
+}
+
+void SpatialHashBroadPhase::Clear()
+{
+    m_Pairs.clear();
+    m_Bounds.clear();
+    m_Entries.clear();
+    m_Oversized.clear();
+    m_IsOversized.clear();
+    m_PairKeys.clear();
+    m_OccupiedCells = 0;
+}
+
+BroadPhaseType SpatialHashBroadPhase::GetType() const
+{
+    return BroadPhaseType::SpatialHash;
+}
+
+const char* SpatialHashBroadPhase::GetName() const
+{
+    return "Spatial Hash";
+}
+
+void SpatialHashBroadPhase::SetCellSize(float size)
+{
+    m_CellSize = std::max(size, 0.1f);
+    m_InvCellSize = 1.0f / m_CellSize;
+}
+
+float SpatialHashBroadPhase::GetCellSize() const
+{
+    return m_CellSize;
+}
+
+void SpatialHashBroadPhase::SetMaxCellsPerCollider(int count)
+{
+    m_MaxCellsPerCollider = std::max(count, 1);
+}
+
+int SpatialHashBroadPhase::GetMaxCellsPerCollider() const
+{
+    return m_MaxCellsPerCollider;
+}
+
+size_t SpatialHashBroadPhase::GetOccupiedCellCount() const
+{
+    return m_OccupiedCells;
+}
+
+size_t SpatialHashBroadPhase::GetOversizedCount() const
+{
+    return m_Oversized.size();
+}
+
+int SpatialHashBroadPhase::ToCell(float value) const
+{
+    const float cell = std::floor(value * m_InvCellSize);
+    return static_cast<int>(std::clamp(cell, static_cast<float>(-CELL_LIMIT), static_cast<float>(CELL_LIMIT)));
+}
+
+uint64_t SpatialHashBroadPhase::MakeKey(int x, int y, int z)
+{
+    const uint64_t ux = static_cast<uint64_t>(x + CELL_LIMIT) & 0x1FFFFF;
+    const uint64_t uy = static_cast<uint64_t>(y + CELL_LIMIT) & 0x1FFFFF;
+    const uint64_t uz = static_cast<uint64_t>(z + CELL_LIMIT) & 0x1FFFFF;
+    return (ux << 42) | (uy << 21) | uz;
+}
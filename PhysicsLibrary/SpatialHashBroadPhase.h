@@ -0,0 +1,51 @@
+#pragma once
+
+#include "IBroadPhase.h"
+
+// Uniform grid broadphase. Every collider is bucketed into each cell its world AABB
+// touches, so two colliders only meet when they share a cell. A pair is reported by
+// the single cell holding the min corner of the two boxes' overlap, which removes
+// duplicates without a hash set. Colliders spanning too many cells (platforms) are
+// kept aside and tested against everything instead.
+class SpatialHashBroadPhase final : public IBroadPhase
+{
+public:
+    explicit SpatialHashBroadPhase(float cellSize = 4.0f);
+
+    void Update(const std::vector<ICollider*>& colliders) override;
+    void Remove(ICollider* collider) override;
+    void Clear() override;
+    BroadPhaseType GetType() const override;
+    const char* GetName() const override;
+
+    void SetCellSize(float size);
+    float GetCellSize() const;
+
+    void SetMaxCellsPerCollider(int count);
+    int GetMaxCellsPerCollider() const;
+
+    size_t GetOccupiedCellCount() const;
+    size_t GetOversizedCount() const;
+
+private:
+    struct CellEntry
+    {
+        uint64_t Key;
+        uint32_t Index;
+    };
+
+    int ToCell(float value) const;
+    static uint64_t MakeKey(int x, int y, int z);
+
+private:
+    float m_CellSize{ 4.0f };
+    float m_InvCellSize{ 0.25f };
+    int m_MaxCellsPerCollider{ 64 };
+    size_t m_OccupiedCells{ 0 };
+
+    std::vector<AABB> m_Bounds;
+    std::vector<CellEntry> m_Entries;
+    std::vector<uint32_t> m_Oversized;
+    std::vector<uint8_t> m_IsOversized;
+    std::vector<uint64_t> m_PairKeys;
+};
@@ -5,7 +5,6 @@
 #include <algorithm>
 
 #include "CapsuleCollider.h"
-#include "CubeCollider.h"
 
 
 SphereCollider::SphereCollider(RigidBody* body)
@@ -14,26 +13,15 @@ SphereCollider::SphereCollider(RigidBody* body)
     m_RigidBody->ComputeInverseInertiaTensorSphere(m_Radius);
 }
 
-bool SphereCollider::CheckCollision(ICollider* other, Contact& outContact)
+ColliderType SphereCollider::GetColliderType() const
 {
-    if (other->GetColliderType() == ColliderType::Sphere)
-    {
-        return CheckCollisionWithSphere(other, outContact);
-    }
-    if (other->GetColliderType() == ColliderType::Cube)
-    {
-        return CheckCollisionWithCube(other, outContact);
-    }
-    if (other->GetColliderType() == ColliderType::Capsule)
-    {
-        return CheckCollisionWithCapsule(other, outContact);
-    }
-    return false;
+    return ColliderType::Sphere;
 }
 
-ColliderType SphereCollider::GetColliderType() const
+DirectX::XMVECTOR SphereCollider::Support(const DirectX::XMVECTOR&) const
 {
-    return ColliderType::Sphere;
+    // All of the sphere is margin
+    return m_RigidBody->GetPosition();
 }
 
 RigidBody* SphereCollider::GetRigidBody() const
@@ -64,6 +52,7 @@ void SphereCollider::SetScale(const DirectX::XMVECTOR& vector)
 
     m_Radius = avg * 0.5f;
     m_Scale = { scale.x, scale.y, scale.z };
+    if (m_RigidBody) m_RigidBody->WakeUp();
     m_RigidBody->ComputeInverseInertiaTensorSphere(m_Radius);
 }
 
@@ -73,13 +62,26 @@ DirectX::XMVECTOR SphereCollider::GetScale() const
     return DirectX::XMVectorSet(diameter, diameter, diameter, 0.0f);
 }
 
-bool SphereCollider::CheckCollisionWithSphere(ICollider* other, Contact& outContact)
+AABB SphereCollider::ComputeWorldAABB() const
+{
+    DirectX::XMFLOAT3 center;
+    DirectX::XMStoreFloat3(&center, m_RigidBody->GetPosition());
+    return AABB::FromCenterExtents(center, { m_Radius, m_Radius, m_Radius });
+}
+
+BoundingSphere SphereCollider::ComputeBoundingSphere() const
+{
+    BoundingSphere sphere;
+    DirectX::XMStoreFloat3(&sphere.Center, m_RigidBody->GetPosition());
+    sphere.Radius = m_Radius;
+    return sphere;
+}
+
+bool SphereCollider::CheckCollisionWith(SphereCollider& other, Contact& outContact)
 {
     using namespace DirectX;
-    if (!other || other->GetColliderType() != ColliderType::Sphere) return false;
 
-    SphereCollider* otherSphere = other->As<SphereCollider>();
-    if (!otherSphere) return false;
+    SphereCollider* otherSphere = &other;
 
     XMVECTOR centerA = m_RigidBody->GetPosition();
     XMVECTOR centerB = otherSphere->GetRigidBody()->GetPosition();
@@ -99,7 +101,7 @@ bool SphereCollider::CheckCollisionWithSphere(ICollider* other, Contact& outCont
 
     // Fill contact
     outContact.Colliders[0] = this;
-    outContact.Colliders[1] = other;
+    outContact.Colliders[1] = otherSphere;
 
     XMStoreFloat3(&outContact.ContactNormal, normal);
     XMStoreFloat3(&outContact.ContactPoint, centerA + normal * radiusA); // Approximate contact point
@@ -117,83 +119,11 @@ bool SphereCollider::CheckCollisionWithSphere(ICollider* other, Contact& outCont
     return true;
 }
 
-bool SphereCollider::CheckCollisionWithCube(ICollider* other, Contact& outContact)
-{
-    using namespace DirectX;
-
-    if (!other || other->GetColliderType() != ColliderType::Cube)
-        return false;
-
-    CubeCollider* cube = other->As<CubeCollider>();
-    if (!cube)
-        return false;
-
-    // === STEP 1: Gather transforms ===
-    XMVECTOR sphereCenter = m_RigidBody->GetPosition();
-    float radius = GetRadius();
-
-    XMVECTOR cubeCenter = cube->GetRigidBody()->GetPosition();
-    XMVECTOR cubeHalfExtents = cube->GetHalfExtents();
-    Quaternion cubeOrientation = cube->GetRigidBody()->GetOrientation();
-
-    // === STEP 2: Get cube's local axes (normalized) ===
-    XMVECTOR axes[3];
-    cube->GetOBBAxes(cubeOrientation, axes); // Should return right, up, forward vectors
-
-    // === STEP 3: Find closest point on the cube to the sphere center ===
-    XMVECTOR relative = sphereCenter - cubeCenter;
-    XMVECTOR closest = cubeCenter;
-
-    for (int i = 0; i < 3; ++i)
-    {
-        float distance = XMVectorGetX(XMVector3Dot(relative, axes[i]));
-        float extent = std::abs(XMVectorGetByIndex(cubeHalfExtents, i));
-        float clamped = std::clamp(distance, -extent, extent);
-        closest += axes[i] * clamped;
-    }
-
-    // === STEP 4: Check collision ===
-    XMVECTOR diff = sphereCenter - closest;
-    float distSq = XMVectorGetX(XMVector3LengthSq(diff));
-
-    if (distSq > radius * radius)
-        return false; // No collision
-
-    float distance = std::sqrt(distSq);
-
-    // Fallback direction if inside cube center
-    XMVECTOR normal = (distance > 1e-6f)
-        ? XMVector3Normalize(diff)
-        : XMVector3Normalize(sphereCenter - cubeCenter);
-
-    // === STEP 5: Fill out Contact struct ===
-    outContact.Colliders[0] = this;
-    outContact.Colliders[1] = other;
-
-    // Contact point on cube surface (or slightly into sphere for better response)
-    XMStoreFloat3(&outContact.ContactPoint, closest);
-
-    // Normal points from cube sphere
-    XMStoreFloat3(&outContact.ContactNormal, normal);
-
-    // Penetration depth
-    outContact.PenetrationDepth = radius - distance;
-
-    // Combined physics properties
-    outContact.Restitution = 0.5f * (m_RigidBody->GetRestitution() + cube->GetRigidBody()->GetRestitution());
-    outContact.Friction = 0.5f * (m_RigidBody->GetFriction() + cube->GetRigidBody()->GetFriction());
-    outContact.Elasticity = 0.5f * (m_RigidBody->GetElasticity() + cube->GetRigidBody()->GetElasticity());
-
-    return true;
-}
-
-bool SphereCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outContact)
+bool SphereCollider::CheckCollisionWith(CapsuleCollider& other, Contact& outContact)
 {
     using namespace DirectX;
 
-    if (!other || other->GetColliderType() != ColliderType::Capsule) return false;
-    CapsuleCollider* capsule = other->As<CapsuleCollider>();
-    if (!capsule) return false;
+    CapsuleCollider* capsule = &other;
 
     RigidBody* sphereBody = m_RigidBody;
     RigidBody* capsuleBody = capsule->GetRigidBody();
@@ -227,8 +157,10 @@ bool SphereCollider::CheckCollisionWithCapsule(ICollider* other, Contact& outCon
         return false; // No collision
 
     float distance = std::sqrt(distSq);
-    XMVECTOR normal = (distance > 1e-6f) ? XMVector3Normalize(delta) : XMVectorSet(1, 0, 0, 0);
-    XMVECTOR contactPoint = closestPoint + normal * capsuleRadius;
+    XMVECTOR toSphere = (distance > 1e-6f) ? XMVector3Normalize(delta) : XMVectorSet(1, 0, 0, 0);
+    XMVECTOR contactPoint = closestPoint + toSphere * capsuleRadius;
+    // Contacts point from Colliders[0] to Colliders[1], here from the sphere to the capsule
+    XMVECTOR normal = -toSphere;
 
     // === Fill Contact ===
     outContact.Colliders[0] = this;
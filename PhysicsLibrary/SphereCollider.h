@@ -3,14 +3,17 @@
 #include "ICollider.h"
 #include <DirectXMath.h>
 
+class CapsuleCollider;
+
 class SphereCollider final : public ICollider
 {
 public:
     explicit SphereCollider(RigidBody* body);
     ~SphereCollider() override = default;
 
-    bool CheckCollision(ICollider* other, Contact& outContact) override;
     ColliderType GetColliderType() const override;
+    DirectX::XMVECTOR Support(const DirectX::XMVECTOR& direction) const override;
+    float GetSupportMargin() const override { return m_Radius; }
     RigidBody* GetRigidBody() const override;
 
     // Sphere-specific
@@ -20,11 +23,15 @@ public:
     void SetScale(const DirectX::XMVECTOR& vector) override;
     DirectX::XMVECTOR GetScale() const override;
 
-private:
-    bool CheckCollisionWithSphere(ICollider* other, Contact& outContact);
-    bool CheckCollisionWithCube(ICollider* other, Contact& outContact);
-    bool CheckCollisionWithCapsule(ICollider* other, Contact& outContact);
+    //~ Pair tests, reached through CollisionDispatch
+    bool CheckCollisionWith(SphereCollider& other, Contact& outContact);
+    bool CheckCollisionWith(CapsuleCollider& other, Contact& outContact);
 
+protected:
+    AABB ComputeWorldAABB() const override;
+    BoundingSphere ComputeBoundingSphere() const override;
+
+private:
     float ClosestPtPointSegment(DirectX::XMVECTOR p, DirectX::XMVECTOR a, DirectX::XMVECTOR b);
 
 private:
@@ -0,0 +1,326 @@
+#include "pch.h"
+#include "SweepAndPruneBroadPhase.h"
+
+#include <algorithm>
+
+namespace
+{
+    //~ Past this share of new proxies a full sort beats repairing with insertion sort
+    constexpr size_t REBUILD_DIVISOR = 4;
+}
+
+void SweepAndPruneBroadPhase::Update(const std::vector<ICollider*>& colliders)
+{
+    ++m_Frame;
+    m_AddedPairs.clear();
+    m_RemovedPairs.clear();
+    m_NewProxies = 0;
+    m_SwapCount = 0;
+    m_Rebuilt = false;
+
+    // === Sync proxies with this step's colliders ===
+    for (uint32_t i = 0; i < colliders.size(); ++i)
+    {
+        ICollider* collider = colliders[i];
+
+        uint32_t id;
+        auto it = m_ProxyLookup.find(collider);
+        if (it == m_ProxyLookup.end()) id = CreateProxy(collider);
+        else id = it->second;
+
+        Proxy& proxy = m_Proxies[id];
+        proxy.Box = collider->GetWorldAABB();
+        proxy.ListIndex = i;
+        proxy.LastSeen = m_Frame;
+    }
+
+    RemoveStaleProxies();
+
+    // === Repair the sorted axes ===
+    if (m_NewProxies > 0 && m_NewProxies * REBUILD_DIVISOR >= m_ProxyLookup.size())
+    {
+        RebuildFromScratch();
+    }
+    else
+    {
+        RefreshEndpoints();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            InsertionSort(axis);
+        }
+    }
+
+    BuildPairList(colliders);
+}
+
+void SweepAndPruneBroadPhase::Remove(ICollider* collider)
+{
+    // The proxy is no longer found, so it is not seen this step and goes with the stale ones
+    m_ProxyLookup.erase(collider);
+}
+
+void SweepAndPruneBroadPhase::Clear()
+{
+    m_Pairs.clear();
+    m_Proxies.clear();
+    m_FreeProxies.clear();
+    m_ProxyLookup.clear();
+    for (auto& endpoints : m_Endpoints) endpoints.clear();
+    m_Overlaps.clear();
+    m_AddedPairs.clear();
+    m_RemovedPairs.clear();
+    m_SortScratch.clear();
+    m_NewProxies = 0;
+    m_SwapCount = 0;
+    m_Rebuilt = false;
+}
+
+BroadPhaseType SweepAndPruneBroadPhase::GetType() const
+{
+    return BroadPhaseType::SweepAndPrune;
+}
+
+const char* SweepAndPruneBroadPhase::GetName() const
+{
+    return "Sweep And Prune";
+}
+
+uint32_t SweepAndPruneBroadPhase::CreateProxy(ICollider* collider)
+{
+    uint32_t id;
+    if (!m_FreeProxies.empty())
+    {
+        id = m_FreeProxies.back();
+        m_FreeProxies.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(m_Proxies.size());
+        m_Proxies.emplace_back();
+    }
+
+    Proxy& proxy = m_Proxies[id];
+    proxy.Collider = collider;
+    proxy.Alive = true;
+    m_ProxyLookup[collider] = id;
+
+    // Appended at the end, insertion sort walks them into place and reports their overlaps
+    for (auto& endpoints : m_Endpoints)
+    {
+        endpoints.push_back({ FLT_MAX, id << 1 });
+        endpoints.push_back({ FLT_MAX, (id << 1) | 1u });
+    }
+
+    ++m_NewProxies;
+    return id;
+}
+
+void SweepAndPruneBroadPhase::RemoveStaleProxies()
+{
+    bool anyStale = false;
+    for (uint32_t id = 0; id < m_Proxies.size(); ++id)
+    {
+        Proxy& proxy = m_Proxies[id];
+        if (!proxy.Alive || proxy.LastSeen == m_Frame) continue;
+
+        // A detached proxy's address may already belong to a new collider's proxy
+        auto it = m_ProxyLookup.find(proxy.Collider);
+        if (it != m_ProxyLookup.end() && it->second == id) m_ProxyLookup.erase(it);
+        proxy.Alive = false;
+        m_FreeProxies.push_back(id);
+        anyStale = true;
+    }
+    if (!anyStale) return;
+
+    for (auto& endpoints : m_Endpoints)
+    {
+        endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [this](const Endpoint& e)
+            {
+                return !m_Proxies[e.ProxyId()].Alive;
+            }), endpoints.end());
+    }
+
+    for (auto it = m_Overlaps.begin(); it != m_Overlaps.end();)
+    {
+        const Proxy& a = m_Proxies[static_cast<uint32_t>(*it >> 32)];
+        const Proxy& b = m_Proxies[static_cast<uint32_t>(*it & 0xFFFFFFFFu)];
+        if (a.Alive && b.Alive)
+        {
+            ++it;
+            continue;
+        }
+
+        m_RemovedPairs.push_back({ a.Collider, b.Collider });
+        it = m_Overlaps.erase(it);
+    }
+}
+
+void SweepAndPruneBroadPhase::RefreshEndpoints()
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        for (Endpoint& e : m_Endpoints[axis])
+        {
+            const AABB& box = m_Proxies[e.ProxyId()].Box;
+            e.Value = e.IsMax() ? AxisMax(box, axis) : AxisMin(box, axis);
+        }
+    }
+}
+
+void SweepAndPruneBroadPhase::InsertionSort(int axis)
+{
+    std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+
+    for (size_t i = 1; i < endpoints.size(); ++i)
+    {
+        const Endpoint moving = endpoints[i];
+        size_t j = i;
+
+        while (j > 0 && endpoints[j - 1].Value > moving.Value)
+        {
+            const Endpoint& passed = endpoints[j - 1];
+
+            if (!moving.IsMax() && passed.IsMax())
+            {
+                // Min slid below another max: they may overlap now
+                const uint32_t a = moving.ProxyId();
+                const uint32_t b = passed.ProxyId();
+                if (m_Proxies[a].Box.Overlaps(m_Proxies[b].Box)) AddPair(a, b);
+            }
+            else if (moving.IsMax() && !passed.IsMax())
+            {
+                // Max slid below another min: separated on this axis
+                const uint32_t a = moving.ProxyId();
+                const uint32_t b = passed.ProxyId();
+                if (!m_Proxies[a].Box.Overlaps(m_Proxies[b].Box)) RemovePair(a, b);
+            }
+
+            endpoints[j] = passed;
+            --j;
+            ++m_SwapCount;
+        }
+        endpoints[j] = moving;
+    }
+}
+
+void SweepAndPruneBroadPhase::RebuildFromScratch()
+{
+    m_Rebuilt = true;
+    RefreshEndpoints();
+
+    for (auto& endpoints : m_Endpoints)
+    {
+        std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint& a, const Endpoint& b)
+            {
+                return a.Value != b.Value ? a.Value < b.Value : a.Data < b.Data;
+            });
+    }
+
+    // Plain sweep along x with an active list
+    std::unordered_set<uint64_t> overlaps;
+    overlaps.reserve(m_Overlaps.size());
+
+    std::vector<uint32_t> active;
+    for (const Endpoint& e : m_Endpoints[0])
+    {
+        const uint32_t id = e.ProxyId();
+        if (e.IsMax())
+        {
+            auto it = std::find(active.begin(), active.end(), id);
+            if (it != active.end())
+            {
+                *it = active.back();
+                active.pop_back();
+            }
+            continue;
+        }
+
+        const AABB& box = m_Proxies[id].Box;
+        for (const uint32_t other : active)
+        {
+            if (box.Overlaps(m_Proxies[other].Box)) overlaps.insert(MakePairKey(id, other));
+        }
+        active.push_back(id);
+    }
+
+    // Diff against the previous set so added/removed stay meaningful
+    for (const uint64_t key : m_Overlaps)
+    {
+        if (overlaps.count(key)) continue;
+        const Proxy& a = m_Proxies[static_cast<uint32_t>(key >> 32)];
+        const Proxy& b = m_Proxies[static_cast<uint32_t>(key & 0xFFFFFFFFu)];
+        m_RemovedPairs.push_back({ a.Collider, b.Collider });
+    }
+    for (const uint64_t key : overlaps)
+    {
+        if (m_Overlaps.count(key)) continue;
+        const Proxy& a = m_Proxies[static_cast<uint32_t>(key >> 32)];
+        const Proxy& b = m_Proxies[static_cast<uint32_t>(key & 0xFFFFFFFFu)];
+        m_AddedPairs.push_back(a.ListIndex < b.ListIndex ? ColliderPair{ a.Collider, b.Collider } : ColliderPair{ b.Collider, a.Collider });
+    }
+
+    m_Overlaps = std::move(overlaps);
+}
+
+void SweepAndPruneBroadPhase::AddPair(uint32_t a, uint32_t b)
+{
+    if (!m_Overlaps.insert(MakePairKey(a, b)).second) return;
+
+    const Proxy& proxyA = m_Proxies[a];
+    const Proxy& proxyB = m_Proxies[b];
+    m_AddedPairs.push_back(proxyA.ListIndex < proxyB.ListIndex
+        ? ColliderPair{ proxyA.Collider, proxyB.Collider }
+        : ColliderPair{ proxyB.Collider, proxyA.Collider });
+}
+
+void SweepAndPruneBroadPhase::RemovePair(uint32_t a, uint32_t b)
+{
+    if (m_Overlaps.erase(MakePairKey(a, b)) == 0) return;
+    m_RemovedPairs.push_back({ m_Proxies[a].Collider, m_Proxies[b].Collider });
+}
+
+void SweepAndPruneBroadPhase::BuildPairList(const std::vector<ICollider*>& colliders)
+{
+    m_Pairs.clear();
+    m_SortScratch.clear();
+    m_SortScratch.reserve(m_Overlaps.size());
+
+    for (const uint64_t key : m_Overlaps)
+    {
+        const Proxy& a = m_Proxies[static_cast<uint32_t>(key >> 32)];
+        const Proxy& b = m_Proxies[static_cast<uint32_t>(key & 0xFFFFFFFFu)];
+        if (!ShouldTestPair(a.Collider, b.Collider)) continue;
+
+        const uint32_t lo = std::min(a.ListIndex, b.ListIndex);
+        const uint32_t hi = std::max(a.ListIndex, b.ListIndex);
+        m_SortScratch.push_back((static_cast<uint64_t>(lo) << 32) | hi);
+    }
+
+    // Same order as the other broadphases: by position in the collider list
+    std::sort(m_SortScratch.begin(), m_SortScratch.end());
+
+    m_Pairs.reserve(m_SortScratch.size());
+    for (const uint64_t pairKey : m_SortScratch)
+    {
+        const uint32_t i = static_cast<uint32_t>(pairKey >> 32);
+        const uint32_t j = static_cast<uint32_t>(pairKey & 0xFFFFFFFFu);
+        m_Pairs.push_back({ colliders[i], colliders[j] });
+    }
+}
+
+float SweepAndPruneBroadPhase::AxisMin(const AABB& box, int axis)
+{
+    return axis == 0 ? box.Min.x : axis == 1 ? box.Min.y : box.Min.z;
+}
+
+float SweepAndPruneBroadPhase::AxisMax(const AABB& box, int axis)
+{
+    return axis == 0 ? box.Max.x : axis == 1 ? box.Max.y : box.Max.z;
+}
+
+uint64_t SweepAndPruneBroadPhase::MakePairKey(uint32_t a, uint32_t b)
+{
+    const uint32_t lo = std::min(a, b);
+    const uint32_t hi = std::max(a, b);
+    return (static_cast<uint64_t>(lo) << 32) | hi;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "IBroadPhase.h"
+
+// Incremental sort and sweep. The min/max endpoints of every collider stay sorted on
+// all three axes between steps; each step only refreshes their values and repairs the
+// order with insertion sort, which is close to O(n) when bodies barely move. Every swap
+// of a min past a max is exactly one overlap starting or ending on that axis, so the
+// overlap set is kept up to date from those swaps instead of being rebuilt.
+class SweepAndPruneBroadPhase final : public IBroadPhase
+{
+public:
+    void Update(const std::vector<ICollider*>& colliders) override;
+    void Remove(ICollider* collider) override;
+    void Clear() override;
+    BroadPhaseType GetType() const override;
+    const char* GetName() const override;
+
+    //~ Overlaps that started / ended during the last Update. Removed pairs may point
+    //~ at colliders that left the world, use them as keys only.
+    const std::vector<ColliderPair>& GetAddedPairs() const { return m_AddedPairs; }
+    const std::vector<ColliderPair>& GetRemovedPairs() const { return m_RemovedPairs; }
+
+    size_t GetSwapCount() const { return m_SwapCount; }
+    bool WasRebuilt() const { return m_Rebuilt; }
+
+private:
+    struct Proxy
+    {
+        ICollider* Collider{ nullptr };
+        AABB Box{};
+        uint32_t ListIndex{ 0 };
+        uint64_t LastSeen{ 0 };
+        bool Alive{ false };
+    };
+
+    struct Endpoint
+    {
+        float Value;
+        uint32_t Data; // proxy id << 1 | is max
+
+        uint32_t ProxyId() const { return Data >> 1; }
+        bool IsMax() const { return (Data & 1u) != 0; }
+    };
+
+    uint32_t CreateProxy(ICollider* collider);
+    void RemoveStaleProxies();
+    void RefreshEndpoints();
+    void InsertionSort(int axis);
+    void RebuildFromScratch();
+
+    void AddPair(uint32_t a, uint32_t b);
+    void RemovePair(uint32_t a, uint32_t b);
+    void BuildPairList(const std::vector<ICollider*>& colliders);
+
+    static float AxisMin(const AABB& box, int axis);
+    static float AxisMax(const AABB& box, int axis);
+    static uint64_t MakePairKey(uint32_t a, uint32_t b);
+
+private:
+    std::vector<Proxy> m_Proxies;
+    std::vector<uint32_t> m_FreeProxies;
+    std::unordered_map<ICollider*, uint32_t> m_ProxyLookup;
+    std::vector<Endpoint> m_Endpoints[3];
+
+    std::unordered_set<uint64_t> m_Overlaps;
+    std::vector<ColliderPair> m_AddedPairs;
+    std::vector<ColliderPair> m_RemovedPairs;
+
+    std::vector<uint64_t> m_SortScratch;
+    uint64_t m_Frame{ 0 };
+    size_t m_NewProxies{ 0 };
+    size_t m_SwapCount{ 0 };
+    bool m_Rebuilt{ false };
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock free hand off of whole frames from one producer thread to one consumer thread.
+// The producer always owns a back buffer and the consumer a front buffer; Publish and
+// Acquire only swap indices with the middle one, so neither side ever waits and the
+// consumer keeps reading the same frame until it asks for a newer one.
+// Other threads may read the consumer's frame by pinning it. A fourth buffer lets Acquire
+// move on while a pinned frame is still being read: that frame is retired until its last
+// reader unpins it, and Acquire skips a swap (keeps its frame) rather than wait for it.
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    //~ Producer: the buffer to fill, it still holds an older frame
+    T& GetWriteBuffer() { return m_Buffers[m_Back]; }
+
+    //~ Producer: hands the filled buffer over, a frame the consumer never picked up is recycled
+    void Publish()
+    {
+        m_Published = m_Back;
+        m_Back = m_Middle.exchange(m_Back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    //~ Producer: the frame handed over by the last Publish. It sits in the middle or front slot
+    //~ and is never the write buffer, so the producer may read it while filling the next one.
+    const T& GetLastPublished() const { return m_Buffers[m_Published]; }
+
+    //~ Consumer: swaps in the newest published frame, false when there was nothing new or the
+    //~ frame retired by the last swap is still pinned
+    bool Acquire()
+    {
+        if (!(m_Middle.load(std::memory_order_relaxed) & FRESH_BIT)) return false;
+
+        if (m_Retired != NO_BUFFER)
+        {
+            if (m_Readers[m_Retired].load(std::memory_order_acquire) != 0) return false;
+            m_Spare = m_Retired;
+            m_Retired = NO_BUFFER;
+        }
+
+        const uint8_t previous = m_Front.load(std::memory_order_relaxed);
+        m_Front.store(m_Middle.exchange(m_Spare, std::memory_order_acq_rel) & INDEX_MASK, std::memory_order_seq_cst);
+
+        // A reader that pinned the previous frame before the store above is counted by now
+        if (m_Readers[previous].load(std::memory_order_seq_cst) == 0)
+        {
+            m_Spare = previous;
+        }
+        else
+        {
+            m_Spare = NO_BUFFER;
+            m_Retired = previous;
+        }
+        return true;
+    }
+
+    //~ Consumer: the frame picked by the last Acquire
+    const T& GetReadBuffer() const { return m_Buffers[m_Front.load(std::memory_order_relaxed)]; }
+
+    //~ Any thread: keeps the consumer's current frame from being reused until Unpin(slot).
+    //~ Only retries when an Acquire swapped the frame at that very moment.
+    uint8_t Pin() const
+    {
+        while (true)
+        {
+            const uint8_t slot = m_Front.load(std::memory_order_seq_cst);
+            m_Readers[slot].fetch_add(1, std::memory_order_seq_cst);
+            if (m_Front.load(std::memory_order_seq_cst) == slot) return slot;
+            m_Readers[slot].fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void Unpin(uint8_t slot) const { m_Readers[slot].fetch_sub(1, std::memory_order_release); }
+
+    //~ Any thread, between Pin and Unpin
+    const T& GetPinned(uint8_t slot) const { return m_Buffers[slot]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH_BIT = 0x4;
+    static constexpr uint8_t NO_BUFFER = 0xFF;
+
+    T m_Buffers[4]{};
+
+    // Each side's index on its own cache line
+    alignas(64) uint8_t m_Back{ 0 };
+    uint8_t m_Published{ 1 };
+    alignas(64) std::atomic<uint8_t> m_Middle{ 1 };
+    alignas(64) std::atomic<uint8_t> m_Front{ 2 };
+    uint8_t m_Spare{ 3 };
+    uint8_t m_Retired{ NO_BUFFER };
+    alignas(64) mutable std::atomic<uint32_t> m_Readers[4]{};
+};
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    void SetAffinity(std::thread& thread, uint64_t mask)
+    {
+        if (mask == 0) return;
+
+#ifdef _WIN32
+        SetThreadAffinityMask(static_cast<HANDLE>(thread.native_handle()), static_cast<DWORD_PTR>(mask));
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int core = 0; core < 64; ++core)
+        {
+            if (mask & (1ull << core)) CPU_SET(core, &set);
+        }
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+    }
+}
+
+WorkerPool::WorkerPool(int threadCount, uint64_t affinityMask)
+{
+    Configure(threadCount, affinityMask);
+}
+
+WorkerPool::~WorkerPool()
+{
+    Stop();
+}
+
+void WorkerPool::Configure(int threadCount, uint64_t affinityMask)
+{
+    threadCount = std::clamp(threadCount, 1, 64);
+    // Compared with what was asked for last, a single thread pool has no workers to look at
+    if (threadCount == m_ThreadCount && affinityMask == m_AffinityMask) return;
+
+    Stop();
+    m_ThreadCount = threadCount;
+    m_AffinityMask = affinityMask;
+    Start();
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    if (count == 0) return;
+
+    // Not worth waking anyone
+    if (m_Threads.empty() || count == 1)
+    {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Task = &task;
+        m_TaskCount = count;
+        m_NextIndex.store(0, std::memory_order_relaxed);
+        m_BusyWorkers = static_cast<int>(m_Threads.size());
+        ++m_Generation;
+    }
+    m_WorkReady.notify_all();
+
+    RunTasks();
+
+    // === Join, every worker has to check in before the step may continue ===
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WorkDone.wait(lock, [this]() { return m_BusyWorkers == 0; });
+    m_Task = nullptr;
+}
+
+int WorkerPool::GetHardwareThreadCount()
+{
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void WorkerPool::Start()
+{
+    m_Stopping = false;
+    m_Threads.reserve(m_ThreadCount - 1);
+    for (int i = 1; i < m_ThreadCount; ++i)
+    {
+        // Handed over here, a worker that reads it late would sleep through the first job
+        m_Threads.emplace_back(&WorkerPool::WorkerLoop, this, m_Generation);
+        SetAffinity(m_Threads.back(), m_AffinityMask);
+    }
+}
+
+void WorkerPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_WorkReady.notify_all();
+
+    for (std::thread& thread : m_Threads)
+    {
+        if (thread.joinable()) thread.join();
+    }
+    m_Threads.clear();
+}
+
+void WorkerPool::WorkerLoop(uint64_t seenGeneration)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkReady.wait(lock, [&]() { return m_Stopping || m_Generation != seenGeneration; });
+            if (m_Stopping) return;
+            seenGeneration = m_Generation;
+        }
+
+        RunTasks();
+
+        bool lastOut;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            lastOut = --m_BusyWorkers == 0;
+        }
+        if (lastOut) m_WorkDone.notify_one();
+    }
+}
+
+void WorkerPool::RunTasks()
+{
+    const std::function<void(size_t)>& task = *m_Task;
+    const size_t count = m_TaskCount;
+
+    for (size_t index = m_NextIndex.fetch_add(1, std::memory_order_relaxed); index < count;
+        index = m_NextIndex.fetch_add(1, std::memory_order_relaxed))
+    {
+        task(index);
+    }
+}
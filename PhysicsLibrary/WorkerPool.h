@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork/join work inside one physics step. ParallelFor hands
+// out indices one at a time to the workers and the calling thread, and only returns once
+// every index has finished, so a step never overlaps the next one. Which thread runs an
+// index is not deterministic; callers keep results deterministic by having every index
+// write only to state no other index touches.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(int threadCount = 1, uint64_t affinityMask = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //~ Joins the current workers and starts threadCount - 1 new ones, the caller is the last thread.
+    //~ Bit i of affinityMask allows logical core i for the workers, 0 leaves it to the OS.
+    void Configure(int threadCount, uint64_t affinityMask);
+
+    int GetThreadCount() const { return m_ThreadCount; }
+    uint64_t GetAffinityMask() const { return m_AffinityMask; }
+
+    //~ Runs task(index) once for every index in [0, count) and waits for all of them
+    void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+    static int GetHardwareThreadCount();
+
+private:
+    void Start();
+    void Stop();
+    void WorkerLoop(uint64_t seenGeneration);
+    void RunTasks();
+
+private:
+    std::vector<std::thread> m_Threads;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::condition_variable m_WorkDone;
+
+    const std::function<void(size_t)>* m_Task{ nullptr };
+    size_t m_TaskCount{ 0 };
+    std::atomic<size_t> m_NextIndex{ 0 };
+    uint64_t m_Generation{ 0 };
+    int m_BusyWorkers{ 0 };
+    bool m_Stopping{ false };
+
+    int m_ThreadCount{ 1 };
+    uint64_t m_AffinityMask{ 0 };
+};
@@ -1,192 +1,1912 @@
 #include "pch.h"
-#include "Quaternion.h"
-#include <Windows.h>
 #include "RigidBody.h"
+#include "BatchNarrowPhase.h"
+#include "BodyStore.h"
 #include "Contact.h"
-#include "ContactResolver.h"
+#include "Drag.h"
 #include "ForceRegistry.h"
 #include "Gravity.h"
-#include "Drag.h"
-#include "PhysicsManager.h"
+#include "ICollider.h"
 #include "SphereCollider.h"
-#include "PlaneCollider.h"
-#include "BoxCollider.h"
+#include "CubeCollider.h"
 #include "CapsuleCollider.h"
+#include "ConvexHullCollider.h"
+#include "ContinuousCollision.h"
+#include "ConvexNarrowPhase.h"
+#include "BruteForceBroadPhase.h"
+#include "CollisionResolver.h"
+#include "DynamicTreeBroadPhase.h"
+#include "IslandManager.h"
+#include "PhysicsQuery.h"
+#include "PhysicsSnapshot.h"
+#include "PhysicsWorld.h"
+#include "ReplayLog.h"
+#include "ReplayPlayer.h"
+#include "SpatialHashBroadPhase.h"
+#include "SweepAndPruneBroadPhase.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
-void simulateManualCollisionTest()
+//~ Headless benchmarks for the physics library. Every scene is generated from a fixed seed
+//~ so numbers are comparable between runs and between machines.
+
+namespace
 {
-    std::cout << "=== Manual Contact Resolution ===\n";
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct BenchScene
+    {
+        std::vector<std::unique_ptr<RigidBody>> Bodies;
+        std::vector<std::unique_ptr<ICollider>> Owned;
+        std::vector<ICollider*> Colliders;
+    };
+
+    //~ Half spheres, half cubes, spread so the average density stays the same for every count
+    void BuildScene(BenchScene& scene, int count, unsigned seed)
+    {
+        constexpr float objectsPerUnitVolume = 0.05f;
+        const float side = std::cbrt(static_cast<float>(count) / objectsPerUnitVolume);
 
-    RigidBody bodyA;
-    bodyA.SetPosition(DirectX::XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f));
-    bodyA.SetVelocity(DirectX::XMVectorSet(5.0f, 0.0f, 0.0f, 0.0f));
-    bodyA.SetMass(1.0f);
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(-side * 0.5f, side * 0.5f);
+        std::uniform_real_distribution<float> size(0.5f, 1.5f);
+        std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
 
-    RigidBody bodyB;
-    bodyB.SetPosition(DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f));
-    bodyB.SetVelocity(DirectX::XMVectorSet(-5.0f, 0.0f, 0.0f, 0.0f));
-    bodyB.SetMass(1.0f);
+        scene.Bodies.reserve(count);
+        scene.Owned.reserve(count);
+        scene.Colliders.reserve(count);
 
-    Contact contact;
-    contact.Body[0] = &bodyA;
-    contact.Body[1] = &bodyB;
-    contact.ContactNormal = DirectX::XMFLOAT3(-1.0f, 0.0f, 0.0f);
-    contact.ContactPoint = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-    contact.Penetration = 0.2f;
-    contact.Restitution = 0.9f;
-    contact.Friction = 0.0f;
+        for (int i = 0; i < count; ++i)
+        {
+            auto body = std::make_unique<RigidBody>();
+            body->SetMass(1.0f);
+            body->SetPosition(DirectX::XMVectorSet(position(rng), position(rng), position(rng), 0.0f));
+
+            std::unique_ptr<ICollider> collider;
+            if (i % 2 == 0)
+            {
+                auto sphere = std::make_unique<SphereCollider>(body.get());
+                sphere->SetRadius(size(rng) * 0.5f);
+                collider = std::move(sphere);
+            }
+            else
+            {
+                DirectX::XMFLOAT4 q;
+                DirectX::XMStoreFloat4(&q, DirectX::XMQuaternionRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)));
+                body->SetOrientation(Quaternion(q.w, q.x, q.y, q.z));
+                auto cube = std::make_unique<CubeCollider>(body.get());
+                cube->SetScale(DirectX::XMVectorSet(size(rng), size(rng), size(rng), 0.0f));
+                collider = std::move(cube);
+            }
+            collider->Update(0.0f);
 
-    ContactResolver resolver(1);
-    float dt = 1.0f / 60.0f;
+            scene.Colliders.push_back(collider.get());
+            scene.Owned.push_back(std::move(collider));
+            scene.Bodies.push_back(std::move(body));
+        }
+    }
 
-    for (int i = 0; i < 10; ++i) // Simulate 10 frames
+    struct NarrowResult
     {
-        std::cout << "[Frame " << i << "]\n";
+        double Milliseconds{ 0.0 };
+        size_t Contacts{ 0 };
+    };
 
-        // Integrate motion (optional, depending on your physics setup)
-        bodyA.Integrate(dt, IntegrationType::Euler);
-        bodyB.Integrate(dt, IntegrationType::Euler);
+    NarrowResult RunNarrowPhase(const std::vector<ColliderPair>& pairs)
+    {
+        NarrowResult result;
+        const auto start = Clock::now();
+        for (const ColliderPair& pair : pairs)
+        {
+            Contact contact;
+            if (pair.A->CheckCollision(pair.B, contact)) ++result.Contacts;
+        }
+        result.Milliseconds = ElapsedMs(start);
+        return result;
+    }
 
-        // Resolve collision
-        resolver.ResolveContacts(&contact, 1, dt);
+    //~ The old PhysicsManager loop: CheckCollision on every pair. Past the sample limit only
+    //~ the first rows are timed and the total is extrapolated from the pairs covered.
+    double RunLegacyAllPairs(const std::vector<ICollider*>& colliders, bool& estimated)
+    {
+        constexpr uint64_t sampleLimit = 20'000'000;
 
-        DirectX::XMVECTOR posA = bodyA.GetPosition();
-        DirectX::XMVECTOR velA = bodyA.GetVelocity();
-        DirectX::XMVECTOR posB = bodyB.GetPosition();
-        DirectX::XMVECTOR velB = bodyB.GetVelocity();
+        const uint64_t n = colliders.size();
+        const uint64_t totalPairs = n * (n - 1) / 2;
+        estimated = totalPairs > sampleLimit;
 
-        std::cout << "  A Pos: " << DirectX::XMVectorGetX(posA)
-            << " Vel: " << DirectX::XMVectorGetX(velA) << "\n";
-        std::cout << "  B Pos: " << DirectX::XMVectorGetX(posB)
-            << " Vel: " << DirectX::XMVectorGetX(velB) << "\n\n";
+        uint64_t visited = 0;
+        size_t contacts = 0;
+        const auto start = Clock::now();
+        for (size_t i = 0; i < colliders.size() && visited < sampleLimit; ++i)
+        {
+            for (size_t j = i + 1; j < colliders.size(); ++j)
+            {
+                Contact contact;
+                if (colliders[i]->CheckCollision(colliders[j], contact)) ++contacts;
+            }
+            visited += colliders.size() - i - 1;
+        }
+        const double ms = ElapsedMs(start);
 
-        Sleep(500); // Sleep 0.5 seconds
+        (void)contacts;
+        return estimated ? ms * static_cast<double>(totalPairs) / static_cast<double>(visited) : ms;
     }
-}
 
-void simulateDragAndGravity()
-{
-    std::cout << "=== Particle Gravity + Drag ===\n";
+    //~ False when a broadphase finds a different number of pairs than Brute Force
+    bool BenchmarkBroadPhase()
+    {
+        std::cout << "=== Broad Phase Benchmark ===\n";
+        std::printf("%8s | %-16s | %10s | %10s | %12s | %10s\n",
+            "bodies", "method", "broad ms", "narrow ms", "pairs", "contacts");
+
+        bool matched = true;
+        const int counts[] = { 1000, 10000, 50000 };
+        for (const int count : counts)
+        {
+            BenchScene scene;
+            BuildScene(scene, count, 1337u);
+
+            bool estimated = false;
+            const double legacyMs = RunLegacyAllPairs(scene.Colliders, estimated);
+            std::printf("%8d | %-16s | %10s | %10.2f%s | %12llu | %10s\n",
+                count, "All Pairs", "-", legacyMs, estimated ? " (est.)" : "",
+                static_cast<unsigned long long>(static_cast<uint64_t>(count) * (count - 1) / 2), "-");
 
-    RigidBody body;
-    body.SetMass(1.0f);
-    body.Position = DirectX::XMVectorSet(0.0f, 10.0f, 0.0f, 0.0f);
-    body.Velocity = DirectX::XMVectorSet(10.0f, 0.0f, 0.0f, 0.0f);
-    body.Acceleration = DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f);
-    body.SetDamping(0.99f);
+            BruteForceBroadPhase bruteForce;
+            SpatialHashBroadPhase spatialHash;
+            SweepAndPruneBroadPhase sweepAndPrune;
+            DynamicTreeBroadPhase dynamicTree;
+            IBroadPhase* broadPhases[] = { &bruteForce, &spatialHash, &sweepAndPrune, &dynamicTree };
 
-    Gravity gravity(DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f));
-    Drag drag(0.1f, 0.01f);
+            size_t referencePairs = 0;
+            for (IBroadPhase* broadPhase : broadPhases)
+            {
+                // Warm-up pass so the timed pass sees reused buffers, as it would in the step loop
+                broadPhase->Update(scene.Colliders);
 
-    ForceRegistry registry;
-    registry.Add(&body, &gravity);
-    registry.Add(&body, &drag);
+                const auto start = Clock::now();
+                broadPhase->Update(scene.Colliders);
+                const double broadMs = ElapsedMs(start);
 
-    float duration = 0.001f;
+                const NarrowResult narrow = RunNarrowPhase(broadPhase->GetPairs());
+                std::printf("%8d | %-16s | %10.2f | %10.2f | %12zu | %10zu\n",
+                    count, broadPhase->GetName(), broadMs, narrow.Milliseconds,
+                    broadPhase->GetPairs().size(), narrow.Contacts);
 
-    for (int i = 0; i < 60; ++i) 
+                if (broadPhase == &bruteForce) referencePairs = broadPhase->GetPairs().size();
+                else if (broadPhase->GetPairs().size() != referencePairs)
+                {
+                    std::cout << "  !! " << broadPhase->GetName() << " pair count differs from Brute Force\n";
+                    matched = false;
+                }
+            }
+        }
+        std::cout << "\n";
+        return matched;
+    }
+
+    //~ Bodies drift a little every frame, the case incremental broadphases are built for
+    void BenchmarkCoherentFrames()
     {
-        if (i > 0)
+        constexpr int count = 10000;
+        constexpr int frames = 60;
+        constexpr float dt = 1.0f / 60.0f;
+
+        std::cout << "=== Coherent Frames Benchmark (" << count << " bodies, " << frames << " frames) ===\n";
+
+        BenchScene scene;
+        BuildScene(scene, count, 7u);
+
+        std::mt19937 rng(99u);
+        std::uniform_real_distribution<float> speed(-2.0f, 2.0f);
+        std::vector<DirectX::XMVECTOR> velocities(count);
+        for (auto& v : velocities) v = DirectX::XMVectorSet(speed(rng), speed(rng), speed(rng), 0.0f);
+
+        SpatialHashBroadPhase spatialHash;
+        SweepAndPruneBroadPhase sweepAndPrune;
+        DynamicTreeBroadPhase dynamicTree;
+        IBroadPhase* broadPhases[] = { &spatialHash, &sweepAndPrune, &dynamicTree };
+        constexpr int broadPhaseCount = 3;
+        double totalMs[broadPhaseCount] = {};
+        size_t changes = 0;
+        int mismatches = 0;
+
+        for (int frame = 0; frame < frames; ++frame)
         {
-            registry.UpdateForces(duration);
-            body.Integrate(duration, IntegrationType::Euler);
+            for (int i = 0; i < count; ++i)
+            {
+                RigidBody* body = scene.Bodies[i].get();
+                body->SetPosition(DirectX::XMVectorAdd(body->GetPosition(), DirectX::XMVectorScale(velocities[i], dt)));
+                scene.Colliders[i]->Update(dt);
+            }
+
+            for (int b = 0; b < broadPhaseCount; ++b)
+            {
+                const auto start = Clock::now();
+                broadPhases[b]->Update(scene.Colliders);
+                if (frame > 0) totalMs[b] += ElapsedMs(start);
+            }
+
+            changes += sweepAndPrune.GetAddedPairs().size() + sweepAndPrune.GetRemovedPairs().size();
+            if (spatialHash.GetPairs().size() != sweepAndPrune.GetPairs().size() ||
+                spatialHash.GetPairs().size() != dynamicTree.GetPairs().size()) ++mismatches;
         }
 
-        DirectX::XMVECTOR pos = body.Position;
-        DirectX::XMVECTOR vel = body.Velocity;
+        for (int b = 0; b < broadPhaseCount; ++b)
+        {
+            std::printf("%-16s %8.3f ms / frame\n", broadPhases[b]->GetName(), totalMs[b] / (frames - 1));
+        }
+        std::printf("Pair changes reported incrementally: %zu, frames with differing pair sets: %d\n\n", changes, mismatches);
+    }
 
-        std::cout << "[t=" << duration * static_cast<float>(i) << " seconds] "
-            << "Pos: (" << DirectX::XMVectorGetX(pos) << ", "
-            << DirectX::XMVectorGetY(pos) << ", "
-            << DirectX::XMVectorGetZ(pos) << ") "
-            << "Vel: (" << DirectX::XMVectorGetX(vel) << ", "
-            << DirectX::XMVectorGetY(vel) << ", "
-            << DirectX::XMVectorGetZ(vel) << ")\n";
+    //~ Every manifold point of the pair, as PhysicsManager feeds them to the solver
+    void AppendContacts(ICollider* a, ICollider* b, std::vector<Contact>& contacts)
+    {
+        ContactManifold manifold;
+        if (a->GenerateManifold(b, manifold))
+        {
+            contacts.insert(contacts.end(), manifold.Points, manifold.Points + manifold.PointCount);
+        }
+    }
+
+    //~ Columns of unit cubes on a grid, each standing on its own static floor tile. Staggered
+    //~ columns shift and turn every cube a little against the one below it.
+    void BuildStackColumns(BenchScene& scene, int columns, int height, bool staggered = false)
+    {
+        const int columnsPerRow = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(columns))));
+        const float offset = static_cast<float>(columnsPerRow - 1) * 1.5f;
+
+        for (int c = 0; c < columns; ++c)
+        {
+            const float x = static_cast<float>(c % columnsPerRow) * 3.0f - offset;
+            const float z = static_cast<float>(c / columnsPerRow) * 3.0f - offset;
 
-        Sleep(1);
+            auto tileBody = std::make_unique<RigidBody>();
+            tileBody->SetPosition(DirectX::XMVectorSet(x, -0.5f, z, 0.0f));
+            auto tile = std::make_unique<CubeCollider>(tileBody.get());
+            tile->SetScale(DirectX::XMVectorSet(2.0f, 1.0f, 2.0f, 0.0f));
+            tile->SetColliderState(ColliderState::Static);
+            tile->Update(0.0f);
+            scene.Colliders.push_back(tile.get());
+            scene.Owned.push_back(std::move(tile));
+            scene.Bodies.push_back(std::move(tileBody));
+
+            for (int h = 0; h < height; ++h)
+            {
+                auto body = std::make_unique<RigidBody>();
+                body->SetMass(1.0f);
+                body->SetPosition(DirectX::XMVectorSet(x, 0.5f + static_cast<float>(h) * 1.01f, z, 0.0f));
+                if (staggered)
+                {
+                    const float yaw = 0.2f * static_cast<float>(h);
+                    body->SetPosition(DirectX::XMVectorSet(x + (h % 2 ? 0.15f : -0.1f),
+                        0.5f + static_cast<float>(h) * 1.01f, z + (h % 3 ? 0.1f : -0.05f), 0.0f));
+                    body->SetOrientation(Quaternion(std::cos(yaw * 0.5f), 0.0f, std::sin(yaw * 0.5f), 0.0f));
+                }
+
+                auto cube = std::make_unique<CubeCollider>(body.get());
+                cube->SetScale(DirectX::XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f));
+                cube->Update(0.0f);
+                scene.Colliders.push_back(cube.get());
+                scene.Owned.push_back(std::move(cube));
+                scene.Bodies.push_back(std::move(body));
+            }
+        }
     }
 
-    std::cout << "\n";
-}
+    void BenchmarkStackSettling()
+    {
+        constexpr int columns = 16;
+        constexpr int height = 5;
+        constexpr int maxSteps = 900;
+        constexpr int restStepsRequired = 30;
+        constexpr float restSpeed = 0.05f;
+        constexpr float dt = 1.0f / 60.0f;
+        const DirectX::XMVECTOR gravity = DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f);
 
-void simulatePhysicsManagerScene() {
-    std::cout << "=== Physics Manager Test ===\n";
+        std::cout << "=== Stack Settling (" << columns << " columns x " << height << " cubes) ===\n";
+        std::printf("%-22s | %-7s | %-8s | %8s | %13s | %10s | %12s\n",
+            "solver", "columns", "contacts", "steps", "solve ms/step", "top drop", "warm started");
 
-    RigidBody* a = new RigidBody();
-    a->SetPosition(DirectX::XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f));
-    a->SetVelocity(DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f));
-    a->SetMass(1.0f);
+        //~ Steps until every body has stayed below the rest speed for a while. The deepest
+        //~ point rows feed the solver one contact per pair, as before box manifolds.
+        struct SolverConfig
+        {
+            const char* Name;
+            bool WarmStart;
+            bool Staggered;
+            bool Manifold;
+            SolverSettings Settings;
+        };
+        const SolverConfig configs[] = {
+            { "cold, 1 / 1 iters", false, false, true, { 1, 1 } },
+            { "warm, 1 / 1 iters", true, false, true, { 1, 1 } },
+            { "cold, 8 / 3 iters", false, false, true, { 8, 3 } },
+            { "warm, 8 / 3 iters", true, false, true, { 8, 3 } },
+            { "warm, 8 / 3 iters", true, true, true, { 8, 3 } },
+            { "warm, 8 / 3 iters", true, true, false, { 8, 3 } },
+        };
+
+        for (const SolverConfig& config : configs)
+        {
+            BenchScene scene;
+            BuildStackColumns(scene, columns, height, config.Staggered);
+            const float topStart = DirectX::XMVectorGetY(scene.Bodies.back()->GetPosition());
+
+            DynamicTreeBroadPhase broadPhase;
+            ContactCache cache;
+            std::vector<Contact> contacts;
+
+            int restSteps = 0;
+            int step = 0;
+            double solveMs = 0.0;
+            size_t warmStarted = 0;
+            for (; step < maxSteps && restSteps < restStepsRequired; ++step)
+            {
+                for (size_t i = 0; i < scene.Bodies.size(); ++i)
+                {
+                    if (scene.Colliders[i]->GetColliderState() == ColliderState::Static) continue;
 
-    RigidBody* b = new RigidBody();
-    b->SetPosition(DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f));
-    b->SetVelocity(DirectX::XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f));
-    b->SetMass(1.0f);
+                    RigidBody* body = scene.Bodies[i].get();
+                    body->AddForce(DirectX::XMVectorScale(gravity, body->GetMass()));
+                    body->Integrate(dt, IntegrationType::SemiImplicitEuler);
+                    scene.Colliders[i]->Update(dt);
+                }
 
-    SphereCollider* sphereA = new SphereCollider(a, 1.0f);
-    SphereCollider* sphereB = new SphereCollider(b, 1.0f);
+                broadPhase.Update(scene.Colliders);
+                contacts.clear();
+                for (const ColliderPair& pair : broadPhase.GetPairs())
+                {
+                    if (config.Manifold)
+                    {
+                        AppendContacts(pair.A, pair.B, contacts);
+                        continue;
+                    }
 
-    PhysicsManager& physicsManager = PhysicsManager::Get();
-    physicsManager.AddRigidBody(a, sphereA);
-    physicsManager.AddRigidBody(b, sphereB);
+                    Contact contact;
+                    if (pair.A->CheckCollision(pair.B, contact)) contacts.push_back(contact);
+                }
 
-    for (int i = 0; i < 60; ++i) {
-        physicsManager.Update(1.0f / 60.0f);
-        DirectX::XMVECTOR posA = a->GetPosition();
-        DirectX::XMVECTOR posB = b->GetPosition();
-        std::cout << "[t=" << i * 1.0f / 60 << "] A: "
-            << DirectX::XMVectorGetX(posA) << ", B: "
-            << DirectX::XMVectorGetX(posB) << "\n";
+                if (!config.WarmStart) cache.Clear();
+                cache.BeginStep();
+                const auto start = Clock::now();
+                CollisionResolver::ResolveContacts(contacts, cache, config.Settings);
+                solveMs += ElapsedMs(start);
+                cache.EndStep();
+                warmStarted += cache.GetHitCount();
+
+                float maxSpeed = 0.0f;
+                for (size_t i = 0; i < scene.Bodies.size(); ++i)
+                {
+                    if (scene.Colliders[i]->GetColliderState() == ColliderState::Static) continue;
+
+                    RigidBody* body = scene.Bodies[i].get();
+                    const float speed = DirectX::XMVectorGetX(DirectX::XMVector3Length(body->GetVelocity())) +
+                        DirectX::XMVectorGetX(DirectX::XMVector3Length(body->GetAngularVelocity())) * 0.5f;
+                    maxSpeed = std::max(maxSpeed, speed);
+                }
+                restSteps = maxSpeed < restSpeed ? restSteps + 1 : 0;
+            }
+
+            const float topEnd = DirectX::XMVectorGetY(scene.Bodies.back()->GetPosition());
+            std::printf("%-22s | %-7s | %-8s | %8s | %13.4f | %10.3f | %12zu\n",
+                config.Name, config.Staggered ? "stagger" : "aligned", config.Manifold ? "manifold" : "deepest",
+                restSteps >= restStepsRequired ? std::to_string(step).c_str() : "no rest",
+                solveMs / step, topStart - topEnd, warmStarted);
+        }
+        std::cout << "\n";
     }
 
-    std::cout << "\n";
+    //~ Full steps (integrate, broad, narrow, islands, solve) over a large scene of settled
+    //~ piles. Once their islands sleep the piles should drop out of almost every stage.
+    void BenchmarkSleepingPiles()
+    {
+        constexpr int columns = 2000;
+        constexpr int height = 5;
+        constexpr int settleSteps = 150;
+        constexpr int measuredSteps = 60;
+        constexpr float dt = 1.0f / 60.0f;
+        const DirectX::XMVECTOR gravity = DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f);
+
+        std::cout << "=== Sleeping Piles (" << columns * height << " cubes, step " << settleSteps
+            << " to " << settleSteps + measuredSteps << ") ===\n";
+        std::printf("%-10s | %10s | %10s | %8s | %9s | %13s\n",
+            "sleeping", "step ms", "contacts", "islands", "asleep", "after poke ms");
 
-    physicsManager.Clear();
-    delete a; delete b;
-    delete sphereA; delete sphereB;
-}
+        for (const bool sleeping : { false, true })
+        {
+            BenchScene scene;
+            BuildStackColumns(scene, columns, height);
 
-void simulateBoxAndPlaneCollision()
-{
-    std::cout << "=== Box vs Plane ===\n";
+            SleepSettings sleepSettings;
+            sleepSettings.Enabled = sleeping;
+
+            DynamicTreeBroadPhase broadPhase;
+            ContactCache cache;
+            IslandManager islands;
+            std::vector<Contact> contacts;
+
+            auto step = [&]()
+                {
+                    for (size_t i = 0; i < scene.Bodies.size(); ++i)
+                    {
+                        RigidBody* body = scene.Bodies[i].get();
+                        if (scene.Colliders[i]->GetColliderState() == ColliderState::Static || !body->IsAwake()) continue;
+
+                        body->AddForce(DirectX::XMVectorScale(gravity, body->GetMass()));
+                        body->Integrate(dt, IntegrationType::SemiImplicitEuler);
+                        scene.Colliders[i]->Update(dt);
+                    }
+
+                    broadPhase.Update(scene.Colliders);
+                    cache.BeginStep();
+                    contacts.clear();
+                    for (const ColliderPair& pair : broadPhase.GetPairs())
+                    {
+                        if (!IslandManager::IsAwakeDynamic(pair.A) && !IslandManager::IsAwakeDynamic(pair.B))
+                        {
+                            cache.KeepAlive(pair.A, pair.B);
+                            continue;
+                        }
+
+                        AppendContacts(pair.A, pair.B, contacts);
+                    }
+
+                    islands.WakeTouchedIslands(scene.Colliders, contacts);
+                    islands.Build(scene.Colliders, contacts);
+                    CollisionResolver::ResolveContacts(contacts, cache, SolverSettings{});
+                    cache.EndStep();
+                    islands.UpdateSleep(dt, sleepSettings);
+                };
+
+            for (int i = 0; i < settleSteps; ++i) step();
+
+            const auto start = Clock::now();
+            for (int i = 0; i < measuredSteps; ++i) step();
+            const double stepMs = ElapsedMs(start) / measuredSteps;
+
+            size_t asleep = 0;
+            for (const auto& body : scene.Bodies)
+            {
+                if (!body->IsAwake()) ++asleep;
+            }
+            const size_t measuredContacts = contacts.size();
+            const size_t measuredIslands = islands.GetIslandCount();
+
+            // Knock one column's top cube, only that pile should wake
+            RigidBody* top = scene.Bodies[height].get();
+            top->SetVelocity(DirectX::XMVectorSet(0.5f, 0.0f, 0.0f, 0.0f));
+            const auto pokeStart = Clock::now();
+            for (int i = 0; i < 10; ++i) step();
+            const double pokeMs = ElapsedMs(pokeStart) / 10.0;
+
+            std::printf("%-10s | %10.3f | %10zu | %8zu | %9zu | %13.3f\n",
+                sleeping ? "on" : "off", stepMs, measuredContacts, measuredIslands, asleep, pokeMs);
+        }
+        std::cout << "\n";
+    }
+
+    //~ FNV-1a over the raw bits of every body position, equal hashes mean bit identical runs
+    uint64_t HashPositions(const BenchScene& scene)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto& body : scene.Bodies)
+        {
+            DirectX::XMFLOAT3 position;
+            DirectX::XMStoreFloat3(&position, body->GetPosition());
+
+            unsigned char bytes[sizeof(position)];
+            std::memcpy(bytes, &position, sizeof(position));
+            for (const unsigned char byte : bytes)
+            {
+                hash = (hash ^ byte) * 1099511628211ull;
+            }
+        }
+        return hash;
+    }
+
+    //~ Island solve time per step against worker count on many independent piles, plus a
+    //~ position hash to show the join gives the same result whatever the thread count
+    void BenchmarkParallelIslands()
+    {
+        constexpr int columns = 2000;
+        constexpr int height = 5;
+        constexpr int steps = 120;
+        constexpr float dt = 1.0f / 60.0f;
+        const DirectX::XMVECTOR gravity = DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f);
+
+        const int hardwareThreads = WorkerPool::GetHardwareThreadCount();
+        std::cout << "=== Parallel Island Solve (" << columns << " piles, " << steps << " steps, "
+            << hardwareThreads << " hardware threads) ===\n";
+        std::printf("%-8s | %13s | %8s | %16s\n", "threads", "solve ms/step", "speed-up", "position hash");
+
+        std::vector<int> threadCounts{ 1, 2 };
+        for (int count = 4; count <= hardwareThreads; count *= 2) threadCounts.push_back(count);
+
+        double serialMs = 0.0;
+        for (const int threadCount : threadCounts)
+        {
+            BenchScene scene;
+            BuildStackColumns(scene, columns, height);
+
+            SleepSettings sleepSettings;
+            sleepSettings.Enabled = false;
+
+            DynamicTreeBroadPhase broadPhase;
+            ContactCache cache;
+            IslandManager islands;
+            WorkerPool pool(threadCount);
+            const SolverSettings solverSettings{};
+            std::vector<Contact> contacts;
+
+            double solveMs = 0.0;
+            for (int step = 0; step < steps; ++step)
+            {
+                for (size_t i = 0; i < scene.Bodies.size(); ++i)
+                {
+                    if (scene.Colliders[i]->GetColliderState() == ColliderState::Static) continue;
+
+                    RigidBody* body = scene.Bodies[i].get();
+                    body->AddForce(DirectX::XMVectorScale(gravity, body->GetMass()));
+                    body->Integrate(dt, IntegrationType::SemiImplicitEuler);
+                    scene.Colliders[i]->Update(dt);
+                }
+
+                broadPhase.Update(scene.Colliders);
+                cache.BeginStep();
+                contacts.clear();
+                for (const ColliderPair& pair : broadPhase.GetPairs())
+                {
+                    AppendContacts(pair.A, pair.B, contacts);
+                }
+                islands.Build(scene.Colliders, contacts);
+
+                const auto start = Clock::now();
+                CollisionResolver::FetchWarmStart(contacts, cache);
+                const std::vector<uint32_t>& order = islands.GetSolveOrder();
+                pool.ParallelFor(order.size(), [&](size_t i)
+                    {
+                        CollisionResolver::SolveContacts(contacts, islands.GetIslandContacts(order[i]), solverSettings);
+                    });
+                CollisionResolver::StoreWarmStart(contacts, cache);
+                solveMs += ElapsedMs(start);
+
+                cache.EndStep();
+                islands.UpdateSleep(dt, sleepSettings);
+            }
+
+            solveMs /= steps;
+            if (threadCount == 1) serialMs = solveMs;
+            std::printf("%-8d | %13.3f | %7.2fx | %016llx\n", threadCount, solveMs, serialMs / solveMs,
+                static_cast<unsigned long long>(HashPositions(scene)));
+        }
+        std::cout << "\n";
+    }
+
+    //~ One block of slightly overlapping cubes, so every cube touches its neighbours and the
+    //~ whole block is a single island
+    void BuildPackedBlock(BenchScene& scene, int side, int height)
+    {
+        constexpr float spacing = 0.98f;
+        const float offset = static_cast<float>(side - 1) * spacing * 0.5f;
+
+        for (int x = 0; x < side; ++x)
+        {
+            for (int z = 0; z < side; ++z)
+            {
+                const float px = static_cast<float>(x) * spacing - offset;
+                const float pz = static_cast<float>(z) * spacing - offset;
+
+                auto tileBody = std::make_unique<RigidBody>();
+                tileBody->SetPosition(DirectX::XMVectorSet(px, -0.5f, pz, 0.0f));
+                auto tile = std::make_unique<CubeCollider>(tileBody.get());
+                tile->SetScale(DirectX::XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f));
+                tile->SetColliderState(ColliderState::Static);
+                tile->Update(0.0f);
+                scene.Colliders.push_back(tile.get());
+                scene.Owned.push_back(std::move(tile));
+                scene.Bodies.push_back(std::move(tileBody));
+
+                for (int h = 0; h < height; ++h)
+                {
+                    auto body = std::make_unique<RigidBody>();
+                    body->SetMass(1.0f);
+                    body->SetPosition(DirectX::XMVectorSet(px, 0.49f + static_cast<float>(h) * spacing, pz, 0.0f));
+
+                    auto cube = std::make_unique<CubeCollider>(body.get());
+                    cube->SetScale(DirectX::XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f));
+                    cube->Update(0.0f);
+                    scene.Colliders.push_back(cube.get());
+                    scene.Owned.push_back(std::move(cube));
+                    scene.Bodies.push_back(std::move(body));
+                }
+            }
+        }
+    }
+
+    //~ A single giant island: the island-per-task path is one task, the coloured solver
+    //~ spreads it over the pool. Hashes of the coloured rows must match each other.
+    void BenchmarkGraphColoring()
+    {
+        constexpr int side = 16;
+        constexpr int height = 8;
+        constexpr int steps = 60;
+        constexpr float dt = 1.0f / 60.0f;
+        const DirectX::XMVECTOR gravity = DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f);
+
+        const int hardwareThreads = WorkerPool::GetHardwareThreadCount();
+        std::cout << "=== Graph Coloured Solve (" << side * side * height << " cubes in one island, "
+            << hardwareThreads << " hardware threads) ===\n";
+        std::printf("%-14s | %8s | %13s | %8s | %7s | %8s | %-24s | %16s\n",
+            "solver", "contacts", "solve ms/step", "speed-up", "colours", "overflow", "largest batches", "position hash");
+
+        struct Run
+        {
+            bool Colored;
+            int Threads;
+        };
+        std::vector<Run> runs{ { false, 1 }, { true, 1 }, { true, 2 } };
+        for (int count = 4; count <= hardwareThreads; count *= 2) runs.push_back({ true, count });
+
+        double serialMs = 0.0;
+        for (const Run& run : runs)
+        {
+            BenchScene scene;
+            BuildPackedBlock(scene, side, height);
+
+            DynamicTreeBroadPhase broadPhase;
+            ContactCache cache;
+            IslandManager islands;
+            WorkerPool pool(run.Threads);
+            const SolverSettings solverSettings{};
+            ContactColoringStats coloringStats;
+            ContactColoringStats smallIslandStats;
+            std::vector<Contact> contacts;
+
+            double solveMs = 0.0;
+            for (int step = 0; step < steps; ++step)
+            {
+                for (size_t i = 0; i < scene.Bodies.size(); ++i)
+                {
+                    if (scene.Colliders[i]->GetColliderState() == ColliderState::Static) continue;
+
+                    RigidBody* body = scene.Bodies[i].get();
+                    body->AddForce(DirectX::XMVectorScale(gravity, body->GetMass()));
+                    body->Integrate(dt, IntegrationType::SemiImplicitEuler);
+                    scene.Colliders[i]->Update(dt);
+                }
+
+                broadPhase.Update(scene.Colliders);
+                cache.BeginStep();
+                contacts.clear();
+                for (const ColliderPair& pair : broadPhase.GetPairs())
+                {
+                    AppendContacts(pair.A, pair.B, contacts);
+                }
+                islands.Build(scene.Colliders, contacts);
+
+                const auto start = Clock::now();
+                CollisionResolver::FetchWarmStart(contacts, cache);
+                for (const uint32_t island : islands.GetSolveOrder())
+                {
+                    if (run.Colored)
+                    {
+                        CollisionResolver::SolveContactsColored(contacts, islands.GetIslandContacts(island), solverSettings,
+                            pool, island == islands.GetSolveOrder().front() ? coloringStats : smallIslandStats);
+                    }
+                    else
+                    {
+                        CollisionResolver::SolveContacts(contacts, islands.GetIslandContacts(island), solverSettings);
+                    }
+                }
+                CollisionResolver::StoreWarmStart(contacts, cache);
+                solveMs += ElapsedMs(start);
+                cache.EndStep();
+            }
+
+            solveMs /= steps;
+            if (!run.Colored) serialMs = solveMs;
+
+            std::string batches;
+            for (size_t i = 0; i < coloringStats.BatchSizes.size() && i < 4; ++i)
+            {
+                batches += std::to_string(coloringStats.BatchSizes[i]) + " ";
+            }
+            const std::string name = run.Colored ? "coloured x" + std::to_string(run.Threads) : "serial";
+            std::printf("%-14s | %8zu | %13.3f | %7.2fx | %7d | %8d | %-24s | %016llx\n",
+                name.c_str(), contacts.size(), solveMs, serialMs / solveMs, coloringStats.ColorCount,
+                coloringStats.OverflowCount, batches.c_str(), static_cast<unsigned long long>(HashPositions(scene)));
+        }
+        std::cout << "\n";
+    }
+
+    //~ Free bodies with random velocities and spin, all sharing the body store
+    void BuildFreeBodies(BenchScene& scene, int count, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> speed(-5.0f, 5.0f);
+
+        scene.Bodies.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            auto body = std::make_unique<RigidBody>();
+            body->SetMass(1.0f);
+            body->SetPosition(DirectX::XMVectorSet(position(rng), position(rng), position(rng), 0.0f));
+            body->SetVelocity(DirectX::XMVectorSet(speed(rng), speed(rng), speed(rng), 0.0f));
+            body->SetAngularVelocity(DirectX::XMVectorSet(speed(rng), speed(rng), speed(rng), 0.0f));
+            body->ComputeInverseInertiaTensorBox(1.0f, 1.0f, 1.0f);
+            scene.Bodies.push_back(std::move(body));
+        }
+    }
+
+    //~ Largest distance between matching bodies of two scenes built from the same seed
+    float MaxPositionDrift(const BenchScene& a, const BenchScene& b)
+    {
+        float drift = 0.0f;
+        for (size_t i = 0; i < a.Bodies.size() && i < b.Bodies.size(); ++i)
+        {
+            const DirectX::XMVECTOR delta = DirectX::XMVectorSubtract(a.Bodies[i]->GetPosition(), b.Bodies[i]->GetPosition());
+            drift = (std::max)(drift, DirectX::XMVectorGetX(DirectX::XMVector3Length(delta)));
+        }
+        return drift;
+    }
+
+    //~ Integration cost per step, the scalar RigidBody::Integrate per body against the batched
+    //~ SIMD loop over the body store. Rounding differs, so the drift column reports how far
+    //~ apart the two runs end up instead of a hash.
+    void BenchmarkIntegration()
+    {
+        constexpr int count = 100000;
+        constexpr int steps = 60;
+        constexpr float dt = 1.0f / 60.0f;
+        const DirectX::XMVECTOR gravity = DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f);
+
+        std::cout << "=== Integration (" << count << " bodies, " << steps << " steps, "
+            << BodyStore::GetBatchWidth() << " bodies per batch) ===\n";
+        std::printf("%-19s | %9s | %10s | %8s | %s\n", "integrator", "scalar ms", "batched ms", "speed-up", "max drift");
+
+        const std::pair<IntegrationType, const char*> types[] = {
+            { IntegrationType::Euler, "Euler" },
+            { IntegrationType::SemiImplicitEuler, "Semi-Implicit Euler" },
+            { IntegrationType::Verlet, "Verlet" },
+        };
+
+        for (const auto& [type, name] : types)
+        {
+            BenchScene scalar;
+            BenchScene batched;
+            BuildFreeBodies(scalar, count, 11);
+            BuildFreeBodies(batched, count, 11);
+            for (const auto& body : batched.Bodies) body->SetSimulated(true);
+
+            double scalarMs = 0.0;
+            double batchedMs = 0.0;
+            for (int step = 0; step < steps; ++step)
+            {
+                for (const auto& body : scalar.Bodies) body->AddForce(gravity);
+                auto start = Clock::now();
+                for (const auto& body : scalar.Bodies) body->Integrate(dt, type);
+                scalarMs += ElapsedMs(start);
+
+                for (const auto& body : batched.Bodies) body->AddForce(gravity);
+                start = Clock::now();
+                BodyStore::Get().Integrate(dt, type);
+                batchedMs += ElapsedMs(start);
+            }
+
+            scalarMs /= steps;
+            batchedMs /= steps;
+            std::printf("%-19s | %9.3f | %10.3f | %7.2fx | %g\n", name, scalarMs, batchedMs, scalarMs / batchedMs,
+                MaxPositionDrift(scalar, batched));
+        }
+        std::cout << "\n";
+    }
+
+    //~ Force accumulators of every body in the scene, one vector per body
+    std::vector<DirectX::XMFLOAT3> GatherForces(const BenchScene& scene)
+    {
+        std::vector<DirectX::XMFLOAT3> forces(scene.Colliders.size());
+        for (size_t i = 0; i < scene.Colliders.size(); ++i)
+        {
+            const BodyHandle handle = scene.Colliders[i]->GetRigidBody()->GetHandle();
+            DirectX::XMStoreFloat3(&forces[i], BodyStore::Get().GetChunk(handle)->Force.Load(BodyStore::GetLane(handle)));
+        }
+        return forces;
+    }
+
+    //~ Gravity and drag on every body, one virtual call per registration against the registry
+    //~ handing each generator its whole span at once
+    void BenchmarkForceRegistry()
+    {
+        constexpr int count = 100000;
+        constexpr int steps = 60;
+        constexpr float dt = 1.0f / 60.0f;
+
+        BenchScene scene;
+        BuildScene(scene, count, 5);
+        for (const auto& body : scene.Bodies) body->SetVelocity(DirectX::XMVectorSet(1.0f, -2.0f, 0.5f, 0.0f));
+
+        Gravity gravity(DirectX::XMVectorSet(0.0f, -9.81f, 0.0f, 0.0f));
+        gravity.SetGravity(true);
+        Drag drag(0.1f, 0.01f);
+
+        ForceRegistry registry;
+        for (ICollider* collider : scene.Colliders)
+        {
+            registry.Add(collider, &gravity);
+            registry.Add(collider, &drag);
+        }
+
+        double perCallMs = 0.0;
+        double batchedMs = 0.0;
+        std::vector<DirectX::XMFLOAT3> perCallForces;
+        std::vector<DirectX::XMFLOAT3> batchedForces;
+        for (int step = 0; step < steps; ++step)
+        {
+            for (const auto& body : scene.Bodies) body->ClearAccumulators();
+            auto start = Clock::now();
+            for (ICollider* collider : scene.Colliders)
+            {
+                gravity.UpdateForce(collider, dt);
+                drag.UpdateForce(collider, dt);
+            }
+            perCallMs += ElapsedMs(start);
+            if (step == 0) perCallForces = GatherForces(scene);
+
+            for (const auto& body : scene.Bodies) body->ClearAccumulators();
+            start = Clock::now();
+            registry.UpdateForces(dt);
+            batchedMs += ElapsedMs(start);
+            if (step == 0) batchedForces = GatherForces(scene);
+        }
+
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < perCallForces.size(); ++i)
+        {
+            const DirectX::XMVECTOR delta = DirectX::XMVectorSubtract(
+                DirectX::XMLoadFloat3(&perCallForces[i]), DirectX::XMLoadFloat3(&batchedForces[i]));
+            maxDifference = (std::max)(maxDifference, DirectX::XMVectorGetX(DirectX::XMVector3Length(delta)));
+        }
 
-    RigidBody* boxBody = new RigidBody();
-    boxBody->SetPosition(DirectX::XMVectorSet(10.f, 0.0f, 0.0f, 0.0f));
-    boxBody->SetVelocity(DirectX::XMVectorSet(-4.0f, 0.0f, 0.0f, 0.0f));
-    boxBody->SetMass(1.0f);
+        std::cout << "=== Force Registry (" << count << " bodies, gravity + drag, " << steps << " steps) ===\n";
+        std::printf("%13s | %10s | %8s | %s\n", "per call ms", "batched ms", "speed-up", "max force difference");
+        std::printf("%13.3f | %10.3f | %7.2fx | %g\n\n", perCallMs / steps, batchedMs / steps, perCallMs / batchedMs,
+            maxDifference);
+    }
+
+    //~ Collider of the given kind on body: 's'phere, 'b'ox, 'c'apsule or 'h'ull (a box given as vertices)
+    std::unique_ptr<ICollider> MakeShape(char kind, RigidBody* body, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> size(0.5f, 1.5f);
+        switch (kind)
+        {
+        case 's':
+        {
+            auto sphere = std::make_unique<SphereCollider>(body);
+            sphere->SetRadius(size(rng) * 0.5f);
+            return sphere;
+        }
+        case 'c':
+        {
+            auto capsule = std::make_unique<CapsuleCollider>(body);
+            capsule->SetRadius(size(rng) * 0.3f);
+            capsule->SetHeight(size(rng) * 1.5f);
+            return capsule;
+        }
+        case 'h':
+        {
+            auto hull = std::make_unique<ConvexHullCollider>(body);
+            hull->SetScale(DirectX::XMVectorSet(size(rng), size(rng), size(rng), 0.0f));
+            return hull;
+        }
+        default:
+        {
+            auto cube = std::make_unique<CubeCollider>(body);
+            cube->SetScale(DirectX::XMVectorSet(size(rng), size(rng), size(rng), 0.0f));
+            return cube;
+        }
+        }
+    }
+
+    //~ Specialised CheckCollision paths against the generic GJK / EPA one on the same random
+    //~ pairs. The capsule-capsule test uses a shorter segment than ConvexNarrowPhase (which
+    //~ follows the sphere and box tests), and the dispatch runs sphere-box and capsule-box pairs
+    //~ swapped, so depth and normal axis differences are reported rather than asserted.
+    void BenchmarkConvexNarrowPhase()
+    {
+        constexpr int count = 20000;
+        constexpr int repeats = 10;
+
+        std::cout << "=== Convex Narrowphase (" << count << " pairs x " << repeats << ", specialised vs GJK/EPA) ===\n";
+        std::printf("%-16s | %6s | %14s | %9s | %8s | %9s | %9s | %s\n",
+            "pair", "hits", "specialised ms", "GJK ms", "ratio", "disagree", "max depth", "max axis error");
+
+        // The hull row runs the GJK side on a vertex hull with the box's exact pose and scale
+        const std::pair<const char*, const char*> kinds[] = {
+            { "ss", "sphere-sphere" }, { "sb", "sphere-box" }, { "bb", "box-box" }, { "sc", "sphere-capsule" },
+            { "cb", "capsule-box" }, { "cc", "capsule-capsule" }, { "hb", "hull-box" },
+        };
+
+        for (const auto& [kind, name] : kinds)
+        {
+            std::mt19937 rng(17);
+            std::uniform_real_distribution<float> offset(-1.2f, 1.2f);
+            std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+
+            BenchScene scene;
+            std::vector<ICollider*> specialised;
+            std::vector<ICollider*> generic;
+            for (int i = 0; i < count; ++i)
+            {
+                for (int side = 0; side < 2; ++side)
+                {
+                    auto body = std::make_unique<RigidBody>();
+                    body->SetMass(1.0f);
+                    body->SetPosition(side == 0 ? DirectX::XMVectorZero()
+                        : DirectX::XMVectorSet(offset(rng), offset(rng), offset(rng), 0.0f));
+                    DirectX::XMFLOAT4 q;
+                    DirectX::XMStoreFloat4(&q, DirectX::XMQuaternionRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)));
+                    body->SetOrientation(Quaternion(q.w, q.x, q.y, q.z));
+
+                    // Same seed state for both shapes of the hull row, so they come out the same size
+                    const char shape = kind[side] == 'h' ? 'b' : kind[side];
+                    std::mt19937 shapeRng = rng;
+                    std::unique_ptr<ICollider> collider = MakeShape(shape, body.get(), rng);
+                    collider->Update(0.0f);
+                    specialised.push_back(collider.get());
+                    generic.push_back(collider.get());
 
-    RigidBody* boxBody_2 = new RigidBody();
-    boxBody_2->SetMass(1.0f);
-    boxBody_2->SetPosition({ -10.0f, 0.0f, 0.0f });
-    boxBody_2->SetVelocity({ 4.0f, 0.0f, 0.0f });
+                    if (kind[side] == 'h')
+                    {
+                        std::unique_ptr<ICollider> hull = MakeShape('h', body.get(), shapeRng);
+                        hull->Update(0.0f);
+                        generic.back() = hull.get();
+                        scene.Owned.push_back(std::move(hull));
+                    }
 
-    BoxCollider* box = new BoxCollider(boxBody, { 0.5f, 0.5f, 0.5f });
-    BoxCollider* box_2 = new BoxCollider(boxBody, { 0.5f, 0.5f, 0.5f });
+                    scene.Owned.push_back(std::move(collider));
+                    scene.Bodies.push_back(std::move(body));
+                }
+            }
 
-    PhysicsManager& manager = PhysicsManager::Get();
-    manager.AddRigidBody(boxBody, box);
-    manager.AddRigidBody(boxBody_2, box_2);
+            std::vector<Contact> specialisedContacts(count);
+            std::vector<Contact> genericContacts(count);
+            std::vector<char> specialisedHits(count);
+            std::vector<char> genericHits(count);
 
-    float duration = 0.001f;
-    int i = 0;
-    while (true)
+            auto start = Clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    specialisedHits[i] = specialised[2 * i]->CheckCollision(specialised[2 * i + 1], specialisedContacts[i]);
+                }
+            }
+            const double specialisedMs = ElapsedMs(start) / repeats;
+
+            start = Clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    ICollider* a = generic[2 * i];
+                    ICollider* b = generic[2 * i + 1];
+                    genericHits[i] = a->BoundsOverlap(b) && ConvexNarrowPhase::Collide(a, b, genericContacts[i]);
+                }
+            }
+            const double genericMs = ElapsedMs(start) / repeats;
+
+            int hits = 0;
+            int disagreements = 0;
+            float maxDepthError = 0.0f;
+            float maxAxisError = 0.0f;
+            for (int i = 0; i < count; ++i)
+            {
+                hits += specialisedHits[i];
+                if (specialisedHits[i] != genericHits[i])
+                {
+                    ++disagreements;
+                    continue;
+                }
+                if (!specialisedHits[i]) continue;
+
+                const Contact& s = specialisedContacts[i];
+                const Contact& g = genericContacts[i];
+                maxDepthError = (std::max)(maxDepthError, std::abs(s.PenetrationDepth - g.PenetrationDepth));
+                const float alignment = std::abs(DirectX::XMVectorGetX(DirectX::XMVector3Dot(
+                    DirectX::XMLoadFloat3(&s.ContactNormal), DirectX::XMLoadFloat3(&g.ContactNormal))));
+                maxAxisError = (std::max)(maxAxisError, 1.0f - alignment);
+            }
+
+            std::printf("%-16s | %6d | %14.3f | %9.3f | %7.2fx | %9d | %9.4f | %g\n",
+                name, hits, specialisedMs, genericMs, genericMs / specialisedMs, disagreements, maxDepthError, maxAxisError);
+        }
+        std::cout << "\n";
+    }
+
+    //~ The separating axis test CubeCollider::CheckCollisionWith ran before FindAxisOverlap:
+    //~ every axis built, normalized and both boxes projected onto it one by one
+    bool LegacyAxisOverlap(const CubeCollider& boxA, const CubeCollider& boxB, CubeCollider::AxisOverlap& out)
     {
-        if (i > 0)
+        using namespace DirectX;
+
+        struct Box
+        {
+            XMVECTOR Center;
+            XMVECTOR Axes[3];
+            float Half[3];
+        };
+        const auto project = [](const Box& box, const XMVECTOR& axis)
+        {
+            return std::abs(XMVectorGetX(XMVector3Dot(box.Axes[0], axis))) * box.Half[0] +
+                std::abs(XMVectorGetX(XMVector3Dot(box.Axes[1], axis))) * box.Half[1] +
+                std::abs(XMVectorGetX(XMVector3Dot(box.Axes[2], axis))) * box.Half[2];
+        };
+
+        Box boxes[2];
+        const CubeCollider* colliders[2] = { &boxA, &boxB };
+        for (int b = 0; b < 2; ++b)
         {
-            manager.Update(duration);
+            const XMMATRIX rotation = colliders[b]->GetRigidBody()->GetOrientation().ToRotationMatrix();
+            XMFLOAT3 half;
+            XMStoreFloat3(&half, XMVectorAbs(colliders[b]->GetHalfExtents()));
+
+            boxes[b].Center = colliders[b]->GetRigidBody()->GetPosition();
+            boxes[b].Axes[0] = XMVector3Normalize(rotation.r[0]);
+            boxes[b].Axes[1] = XMVector3Normalize(rotation.r[1]);
+            boxes[b].Axes[2] = XMVector3Normalize(rotation.r[2]);
+            boxes[b].Half[0] = half.x;
+            boxes[b].Half[1] = half.y;
+            boxes[b].Half[2] = half.z;
+        }
+        const XMVECTOR toCenter = XMVectorSubtract(boxes[1].Center, boxes[0].Center);
+
+        for (int box = 0; box < 2; ++box)
+        {
+            out.FaceOverlap[box] = FLT_MAX;
+            for (int i = 0; i < 3; ++i)
+            {
+                const XMVECTOR axis = boxes[box].Axes[i];
+                const float overlap = boxes[box].Half[i] + project(boxes[1 - box], axis)
+                    - std::abs(XMVectorGetX(XMVector3Dot(toCenter, axis)));
+                if (overlap < 0.0f) return false;
+
+                if (overlap < out.FaceOverlap[box])
+                {
+                    out.FaceOverlap[box] = overlap;
+                    out.FaceAxis[box] = i;
+                }
+            }
+        }
+
+        out.EdgeOverlap = FLT_MAX;
+        out.EdgeA = -1;
+        out.EdgeB = -1;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                XMVECTOR axis = XMVector3Cross(boxes[0].Axes[i], boxes[1].Axes[j]);
+                if (XMVectorGetX(XMVector3LengthSq(axis)) < 1e-6f) continue;
+                axis = XMVector3Normalize(axis);
+
+                const float overlap = project(boxes[0], axis) + project(boxes[1], axis)
+                    - std::abs(XMVectorGetX(XMVector3Dot(toCenter, axis)));
+                if (overlap < 0.0f) return false;
+
+                if (overlap < out.EdgeOverlap)
+                {
+                    out.EdgeOverlap = overlap;
+                    out.EdgeA = i;
+                    out.EdgeB = j;
+                }
+            }
         }
+        return true;
+    }
+
+    //~ Box pairs through the old one axis at a time SAT and through FindAxisOverlap, once with
+    //~ random poses and once stacked with small tilts, where most edge pairs are close to
+    //~ parallel. The full manifold (CheckCollision) is timed alongside for scale. Axis choices
+    //~ only count as different when the overlaps they picked differ as well, near ties may go
+    //~ either way by rounding.
+    void BenchmarkBoxSeparatingAxes()
+    {
+        constexpr int count = 50000;
+        constexpr int repeats = 20;
+
+        std::cout << "=== Box SAT (" << count << " pairs x " << repeats << ", one axis at a time vs 15 at once) ===\n";
+        std::printf("%-8s | %6s | %9s | %9s | %8s | %11s | %9s | %8s | %s\n",
+            "poses", "hits", "legacy ms", "SAT ms", "speed-up", "manifold ms", "disagree", "axes", "max overlap error");
+
+        for (const bool stacked : { false, true })
+        {
+            std::mt19937 rng(23);
+            std::uniform_real_distribution<float> offset(-1.2f, 1.2f);
+            std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+            std::uniform_real_distribution<float> tilt(-0.02f, 0.02f);
+            std::uniform_real_distribution<float> height(0.6f, 1.3f);
+
+            BenchScene scene;
+            std::vector<CubeCollider*> boxes;
+            for (int i = 0; i < count; ++i)
+            {
+                const float yaw = angle(rng);
+                for (int side = 0; side < 2; ++side)
+                {
+                    auto body = std::make_unique<RigidBody>();
+                    body->SetMass(1.0f);
+                    DirectX::XMFLOAT4 q;
+                    if (stacked)
+                    {
+                        body->SetPosition(side == 0 ? DirectX::XMVectorZero()
+                            : DirectX::XMVectorSet(tilt(rng) * 10.0f, height(rng), tilt(rng) * 10.0f, 0.0f));
+                        DirectX::XMStoreFloat4(&q, DirectX::XMQuaternionRotationRollPitchYaw(tilt(rng), yaw + tilt(rng), tilt(rng)));
+                    }
+                    else
+                    {
+                        body->SetPosition(side == 0 ? DirectX::XMVectorZero()
+                            : DirectX::XMVectorSet(offset(rng), offset(rng), offset(rng), 0.0f));
+                        DirectX::XMStoreFloat4(&q, DirectX::XMQuaternionRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)));
+                    }
+                    body->SetOrientation(Quaternion(q.w, q.x, q.y, q.z));
+
+                    auto cube = std::make_unique<CubeCollider>(body.get());
+                    cube->SetScale(stacked ? DirectX::XMVectorSet(1.0f, 0.8f, 1.0f, 0.0f)
+                        : DirectX::XMVectorSet(height(rng), height(rng), height(rng), 0.0f));
+                    cube->Update(0.0f);
+                    boxes.push_back(cube.get());
+                    scene.Owned.push_back(std::move(cube));
+                    scene.Bodies.push_back(std::move(body));
+                }
+            }
+
+            std::vector<CubeCollider::AxisOverlap> legacy(count);
+            std::vector<CubeCollider::AxisOverlap> simd(count);
+            std::vector<char> legacyHits(count);
+            std::vector<char> simdHits(count);
+
+            auto start = Clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    legacyHits[i] = LegacyAxisOverlap(*boxes[2 * i], *boxes[2 * i + 1], legacy[i]);
+                }
+            }
+            const double legacyMs = ElapsedMs(start) / repeats;
+
+            start = Clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    simdHits[i] = boxes[2 * i]->FindAxisOverlap(*boxes[2 * i + 1], simd[i]);
+                }
+            }
+            const double simdMs = ElapsedMs(start) / repeats;
+
+            start = Clock::now();
+            size_t manifolds = 0;
+            for (int r = 0; r < repeats; ++r)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    ContactManifold manifold;
+                    if (boxes[2 * i]->CheckCollisionWith(*boxes[2 * i + 1], manifold)) ++manifolds;
+                }
+            }
+            const double manifoldMs = ElapsedMs(start) / repeats;
+
+            constexpr float tie = 1e-4f;
+            int hits = 0;
+            int disagreements = 0;
+            int axisChanges = 0;
+            float maxOverlapError = 0.0f;
+            for (int i = 0; i < count; ++i)
+            {
+                hits += legacyHits[i];
+                if (legacyHits[i] != simdHits[i])
+                {
+                    ++disagreements;
+                    continue;
+                }
+                if (!legacyHits[i]) continue;
+
+                const CubeCollider::AxisOverlap& l = legacy[i];
+                const CubeCollider::AxisOverlap& s = simd[i];
+                for (int box = 0; box < 2; ++box)
+                {
+                    maxOverlapError = (std::max)(maxOverlapError, std::abs(l.FaceOverlap[box] - s.FaceOverlap[box]));
+                    if (l.FaceAxis[box] != s.FaceAxis[box] && std::abs(l.FaceOverlap[box] - s.FaceOverlap[box]) > tie) ++axisChanges;
+                }
+                if ((l.EdgeA < 0) != (s.EdgeA < 0))
+                {
+                    ++axisChanges;
+                    continue;
+                }
+                if (l.EdgeA < 0) continue;
+                maxOverlapError = (std::max)(maxOverlapError, std::abs(l.EdgeOverlap - s.EdgeOverlap));
+                if ((l.EdgeA != s.EdgeA || l.EdgeB != s.EdgeB) && std::abs(l.EdgeOverlap - s.EdgeOverlap) > tie) ++axisChanges;
+            }
+
+            (void)manifolds;
+            std::printf("%-8s | %6d | %9.3f | %9.3f | %7.2fx | %11.3f | %9d | %8d | %g\n",
+                stacked ? "stacked" : "random", hits, legacyMs, simdMs, legacyMs / simdMs, manifoldMs,
+                disagreements, axisChanges, maxOverlapError);
+        }
+        std::cout << "\n";
+    }
+
+    //~ Spheres of radius 0.2 - 0.4 packed two per unit volume, every n-th body replaced by other:
+    //~ 'c' a capsule, 'b' a box of about the same size
+    void BuildParticleScene(BenchScene& scene, int count, char other, int every)
+    {
+        constexpr float objectsPerUnitVolume = 2.0f;
+        const float side = std::cbrt(static_cast<float>(count) / objectsPerUnitVolume);
+
+        std::mt19937 rng(31);
+        std::uniform_real_distribution<float> position(-side * 0.5f, side * 0.5f);
+        std::uniform_real_distribution<float> radius(0.2f, 0.4f);
+        std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto body = std::make_unique<RigidBody>();
+            body->SetMass(1.0f);
+            body->SetPosition(DirectX::XMVectorSet(position(rng), position(rng), position(rng), 0.0f));
+            DirectX::XMFLOAT4 q;
+            DirectX::XMStoreFloat4(&q, DirectX::XMQuaternionRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)));
+            body->SetOrientation(Quaternion(q.w, q.x, q.y, q.z));
+
+            const char shape = i % every == 0 ? other : 's';
+            std::unique_ptr<ICollider> collider;
+            if (shape == 'b')
+            {
+                auto cube = std::make_unique<CubeCollider>(body.get());
+                const float size = radius(rng) * 2.0f;
+                cube->SetScale(DirectX::XMVectorSet(size, size, size, 0.0f));
+                collider = std::move(cube);
+            }
+            else if (shape == 'c')
+            {
+                auto capsule = std::make_unique<CapsuleCollider>(body.get());
+                capsule->SetRadius(radius(rng) * 0.6f);
+                capsule->SetHeight(radius(rng) * 2.0f);
+                collider = std::move(capsule);
+            }
+            else
+            {
+                auto sphere = std::make_unique<SphereCollider>(body.get());
+                sphere->SetRadius(radius(rng));
+                collider = std::move(sphere);
+            }
+            collider->Update(0.0f);
+            scene.Colliders.push_back(collider.get());
+            scene.Owned.push_back(std::move(collider));
+            scene.Bodies.push_back(std::move(body));
+        }
+    }
+
+    //~ Dense particle clouds through the old narrowphase loop (GenerateManifold per candidate
+    //~ pair) and through BatchNarrowPhase, on the same broadphase pairs. The last row keeps
+    //~ half of the bodies boxes, which only go through the per pair path, to show what the
+    //~ grouping costs when little can be batched. Contacts are matched pair by pair.
+    void BenchmarkBatchNarrowPhase()
+    {
+        constexpr int count = 20000;
+        constexpr int repeats = 20;
+
+        std::cout << "=== Batch Narrowphase (" << count << " bodies x " << repeats << ", "
+            << BatchNarrowPhase::GetLaneCount() << " lanes) ===\n";
+        std::printf("%-18s | %7s | %7s | %8s | %10s | %10s | %8s | %9s | %s\n",
+            "scene", "pairs", "batched", "contacts", "per pair ms", "batch ms", "speed-up", "mismatch", "max error");
+
+        // Every n-th body is of the other shape
+        struct Mix
+        {
+            const char* Name;
+            char Other;
+            int Every;
+        };
+        const Mix mixes[] = { { "spheres", 's', 1 }, { "spheres, capsules", 'c', 5 }, { "spheres, boxes", 'b', 2 } };
+        for (const Mix& mix : mixes)
+        {
+            BenchScene scene;
+            BuildParticleScene(scene, count, mix.Other, mix.Every);
+
+            DynamicTreeBroadPhase broadPhase;
+            broadPhase.Update(scene.Colliders);
+            const std::vector<ColliderPair>& pairs = broadPhase.GetPairs();
+
+            std::vector<Contact> perPair;
+            auto start = Clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                perPair.clear();
+                for (const ColliderPair& pair : pairs)
+                {
+                    ContactManifold manifold;
+                    if (pair.A->GenerateManifold(pair.B, manifold))
+                    {
+                        perPair.insert(perPair.end(), manifold.Points, manifold.Points + manifold.PointCount);
+                    }
+                }
+            }
+            const double perPairMs = ElapsedMs(start) / repeats;
+
+            BatchNarrowPhase narrowPhase;
+            std::vector<Contact> batched;
+            start = Clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                batched.clear();
+                narrowPhase.Begin();
+                for (const ColliderPair& pair : pairs) narrowPhase.AddPair(pair.A, pair.B);
+                narrowPhase.Run(batched);
+            }
+            const double batchMs = ElapsedMs(start) / repeats;
+
+            // First contact and point count of every touching pair of the per pair loop
+            std::map<std::pair<ICollider*, ICollider*>, std::pair<size_t, int>> expected;
+            for (size_t i = 0; i < perPair.size(); ++i)
+            {
+                auto [it, added] = expected.try_emplace({ perPair[i].Colliders[0], perPair[i].Colliders[1] }, i, 0);
+                ++it->second.second;
+            }
+
+            // Points of a manifold come out in the same order on both paths
+            std::map<std::pair<ICollider*, ICollider*>, int> matched;
+            int mismatches = static_cast<int>(perPair.size() != batched.size());
+            float maxError = 0.0f;
+            for (size_t i = 0; i < batched.size(); ++i)
+            {
+                const std::pair<ICollider*, ICollider*> key{ batched[i].Colliders[0], batched[i].Colliders[1] };
+                const auto it = expected.find(key);
+                const int point = matched[key]++;
+                if (it == expected.end() || point >= it->second.second)
+                {
+                    ++mismatches;
+                    continue;
+                }
+
+                const Contact& a = perPair[it->second.first + point];
+                const Contact& b = batched[i];
+                const auto error = [](const DirectX::XMFLOAT3& x, const DirectX::XMFLOAT3& y)
+                {
+                    return (std::max)({ std::abs(x.x - y.x), std::abs(x.y - y.y), std::abs(x.z - y.z) });
+                };
+                maxError = (std::max)({ maxError, std::abs(a.PenetrationDepth - b.PenetrationDepth),
+                    error(a.ContactNormal, b.ContactNormal), error(a.ContactPoint, b.ContactPoint) });
+            }
+
+            std::printf("%-18s | %7zu | %7zu | %8zu | %10.3f | %10.3f | %7.2fx | %9d | %g\n",
+                mix.Name, pairs.size(), narrowPhase.GetBatchedPairCount(), batched.size(),
+                perPairMs, batchMs, perPairMs / batchMs, mismatches, maxError);
+        }
+        std::cout << "\n";
+    }
+
+    //~ BatchNarrowPhase on 1 - 8 threads over the same pairs. Every thread count has to give
+    //~ the contacts of the single threaded run in the same order, field by field; the buffer
+    //~ line shows whether the output vector had to grow after the first step.
+    void BenchmarkParallelNarrowPhase()
+    {
+        constexpr int count = 40000;
+        constexpr int repeats = 20;
 
-        DirectX::XMVECTOR pos = boxBody->GetPosition();
-        std::cout << "[t=" << i * duration << "] Box Y: "
-            << DirectX::XMVectorGetX(pos) << "\n";
+        std::cout << "=== Parallel Narrowphase (" << count << " bodies x " << repeats
+            << ", half spheres half boxes, hardware threads " << WorkerPool::GetHardwareThreadCount() << ") ===\n";
+        std::printf("%7s | %10s | %8s | %8s | %s\n", "threads", "ms", "speed-up", "contacts", "order");
 
-        Sleep(1);
-        i++;
+        BenchScene scene;
+        BuildParticleScene(scene, count, 'b', 2);
+        DynamicTreeBroadPhase broadPhase;
+        broadPhase.Update(scene.Colliders);
+        const std::vector<ColliderPair>& pairs = broadPhase.GetPairs();
+
+        const auto sameContact = [](const Contact& a, const Contact& b)
+        {
+            return a.Colliders[0] == b.Colliders[0] && a.Colliders[1] == b.Colliders[1] &&
+                a.PenetrationDepth == b.PenetrationDepth &&
+                a.ContactPoint.x == b.ContactPoint.x && a.ContactPoint.y == b.ContactPoint.y && a.ContactPoint.z == b.ContactPoint.z &&
+                a.ContactNormal.x == b.ContactNormal.x && a.ContactNormal.y == b.ContactNormal.y && a.ContactNormal.z == b.ContactNormal.z;
+        };
+
+        std::vector<Contact> reference;
+        double singleMs = 0.0;
+        size_t regrowths = 0;
+        for (const int threads : { 1, 2, 4, 8 })
+        {
+            if (threads > 1 && threads > WorkerPool::GetHardwareThreadCount())
+            {
+                std::printf("%7d | %10s | %8s | %8s | skipped, not enough hardware threads\n", threads, "-", "-", "-");
+                continue;
+            }
+
+            WorkerPool pool(threads);
+            BatchNarrowPhase narrowPhase;
+            std::vector<Contact> contacts;
+            size_t capacity = 0;
+
+            const auto start = Clock::now();
+            for (int r = 0; r < repeats; ++r)
+            {
+                contacts.clear();
+                narrowPhase.Begin();
+                for (const ColliderPair& pair : pairs) narrowPhase.AddPair(pair.A, pair.B);
+                narrowPhase.Run(contacts, &pool);
+
+                if (r > 0 && contacts.capacity() != capacity) ++regrowths;
+                capacity = contacts.capacity();
+            }
+            const double ms = ElapsedMs(start) / repeats;
+            if (threads == 1)
+            {
+                singleMs = ms;
+                reference = contacts;
+            }
+
+            bool same = contacts.size() == reference.size();
+            for (size_t i = 0; same && i < contacts.size(); ++i) same = sameContact(contacts[i], reference[i]);
+
+            std::printf("%7d | %10.3f | %7.2fx | %8zu | %s\n",
+                threads, ms, singleMs / ms, contacts.size(), same ? "identical" : "DIFFERENT");
+        }
+        std::printf("buffer regrown after the first step: %zu times\n\n", regrowths);
+    }
+
+    //~ Small spheres and capsules fired at a thin static wall at up to 80 m/s, with the discrete
+    //~ pipeline alone and with the opted in bodies swept. Counts the bodies that ended up on the
+    //~ far side of the wall.
+    void BenchmarkContinuousCollision()
+    {
+        constexpr int rows = 10;
+        constexpr int steps = 60;
+        constexpr float dt = 1.0f / 60.0f;
+        constexpr float wallHalfThickness = 0.05f;
+
+        std::cout << "=== Continuous Collision (" << rows * rows << " bodies, r = 0.3, vs a "
+            << 2.0f * wallHalfThickness << " m wall) ===\n";
+        std::printf("%-10s | %9s | %6s | %7s | %10s\n", "mode", "tunnelled", "swept", "impacts", "ms/step");
+
+        for (const bool continuous : { false, true })
+        {
+            BenchScene scene;
+
+            auto wallBody = std::make_unique<RigidBody>();
+            wallBody->SetPosition(DirectX::XMVectorZero());
+            auto wall = std::make_unique<CubeCollider>(wallBody.get());
+            wall->SetScale(DirectX::XMVectorSet(2.0f * wallHalfThickness, 40.0f, 40.0f, 0.0f));
+            wall->SetColliderState(ColliderState::Static);
+            wall->Update(0.0f);
+            scene.Colliders.push_back(wall.get());
+            scene.Owned.push_back(std::move(wall));
+            scene.Bodies.push_back(std::move(wallBody));
+
+            for (int i = 0; i < rows * rows; ++i)
+            {
+                const float speed = 10.0f + 70.0f * static_cast<float>(i) / static_cast<float>(rows * rows - 1);
+                auto body = std::make_unique<RigidBody>();
+                body->SetMass(1.0f);
+                body->SetPosition(DirectX::XMVectorSet(-4.0f, static_cast<float>(i / rows) * 1.5f - 7.0f,
+                    static_cast<float>(i % rows) * 1.5f - 7.0f, 0.0f));
+                body->SetVelocity(DirectX::XMVectorSet(speed, 0.0f, 0.0f, 0.0f));
+                body->SetLinearDamping(1.0f);
+                body->SetContinuous(continuous);
+
+                std::unique_ptr<ICollider> collider;
+                if (i % 2 == 0)
+                {
+                    auto sphere = std::make_unique<SphereCollider>(body.get());
+                    sphere->SetRadius(0.3f);
+                    collider = std::move(sphere);
+                }
+                else
+                {
+                    auto capsule = std::make_unique<CapsuleCollider>(body.get());
+                    capsule->SetRadius(0.3f);
+                    capsule->SetHeight(1.0f);
+                    collider = std::move(capsule);
+                }
+                collider->Update(0.0f);
+                scene.Colliders.push_back(collider.get());
+                scene.Owned.push_back(std::move(collider));
+                scene.Bodies.push_back(std::move(body));
+            }
+
+            ContinuousCollision sweeps;
+            DynamicTreeBroadPhase broadPhase;
+            ContactCache cache;
+            std::vector<Contact> contacts;
+            size_t swept = 0;
+            size_t impacts = 0;
+
+            const auto start = Clock::now();
+            for (int step = 0; step < steps; ++step)
+            {
+                sweeps.BeginStep(scene.Colliders);
+                for (size_t i = 0; i < scene.Bodies.size(); ++i)
+                {
+                    if (scene.Colliders[i]->GetColliderState() == ColliderState::Static) continue;
+                    scene.Bodies[i]->Integrate(dt, IntegrationType::SemiImplicitEuler);
+                }
+                sweeps.Resolve();
+                swept += sweeps.GetSweptCount();
+                impacts += sweeps.GetImpactCount();
+                for (ICollider* collider : scene.Colliders) collider->Update(dt);
+
+                broadPhase.Update(scene.Colliders);
+                contacts.clear();
+                for (const ColliderPair& pair : broadPhase.GetPairs()) AppendContacts(pair.A, pair.B, contacts);
+
+                cache.BeginStep();
+                CollisionResolver::ResolveContacts(contacts, cache, SolverSettings{ 8, 3 });
+                cache.EndStep();
+            }
+            const double ms = ElapsedMs(start);
+
+            int tunnelled = 0;
+            for (size_t i = 1; i < scene.Bodies.size(); ++i)
+            {
+                if (DirectX::XMVectorGetX(scene.Bodies[i]->GetPosition()) > 0.0f) ++tunnelled;
+            }
+            std::printf("%-10s | %9d | %6zu | %7zu | %10.4f\n",
+                continuous ? "swept" : "discrete", tunnelled, swept, impacts, ms / steps);
+        }
+        std::cout << "\n";
+    }
+
+    //~ Line of sight fans (four rays per agent, a quarter of them sphere casts) against a mixed
+    //~ scene, answered from a snapshot. A sample is checked against a brute force sweep of a
+    //~ query sphere with ConvexNarrowPhase::TimeOfImpact. That sphere is never smaller than
+    //~ SphereCollider allows and the sweep stops within its tolerance of the surface, so it
+    //~ also hits what a cast only grazes; a disagreement counts as grazing when the same cast
+    //~ a little wider does reach the reference's body. Queries see hulls as the box around
+    //~ their vertices, hits on that box short of the hull itself are counted apart.
+    void BenchmarkSceneQueries()
+    {
+        constexpr int count = 8000;
+        constexpr int agents = 4096;
+        constexpr int raysPerAgent = DynamicAABBTree::RayPacket::WIDTH;
+        constexpr int checked = 512;
+        constexpr int repeats = 5;
+        constexpr float range = 40.0f;
+        const float side = std::cbrt(static_cast<float>(count) / 0.05f);
+
+        std::cout << "=== Scene Queries (" << count << " bodies, " << agents * raysPerAgent << " casts) ===\n";
+
+        BenchScene scene;
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> position(-side * 0.5f, side * 0.5f);
+        for (int i = 0; i < count; ++i)
+        {
+            auto body = std::make_unique<RigidBody>();
+            body->SetMass(1.0f);
+            body->SetPosition(DirectX::XMVectorSet(position(rng), position(rng), position(rng), 0.0f));
+            Quaternion orientation(0.9f, 0.2f * (i % 3), 0.3f, 0.1f * (i % 5));
+            orientation.Normalize();
+            body->SetOrientation(orientation);
+
+            std::unique_ptr<ICollider> collider = MakeShape("sbch"[i % 4], body.get(), rng);
+            collider->Update(0.0f);
+            scene.Colliders.push_back(collider.get());
+            scene.Owned.push_back(std::move(collider));
+            scene.Bodies.push_back(std::move(body));
+        }
+
+        PhysicsSnapshot empty;
+        PhysicsSnapshot snapshot;
+        auto start = Clock::now();
+        snapshot.Capture(scene.Colliders, empty, 1, 0.0f);
+        const double firstCaptureMs = ElapsedMs(start);
+        start = Clock::now();
+        snapshot.Capture(scene.Colliders, snapshot, 2, 0.0f);
+        const double captureMs = ElapsedMs(start);
+        std::printf("capture: first %.3f ms, then %.3f ms per frame (tree height %d)\n",
+            firstCaptureMs, captureMs, snapshot.GetQueryTree().GetHeight());
+
+        // Agents stand in free space and look around with a narrow fan
+        std::vector<CastQuery> queries;
+        std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+        std::uniform_real_distribution<float> spread(-0.05f, 0.05f);
+        std::vector<BodyHandle> touching;
+        while (queries.size() < static_cast<size_t>(agents * raysPerAgent))
+        {
+            const DirectX::XMFLOAT3 origin{ position(rng), position(rng), position(rng) };
+            touching.clear();
+            if (PhysicsQuery::OverlapSphere(snapshot, origin, 0.3f, touching) > 0) continue;
+
+            const float yaw = angle(rng);
+            const float pitch = angle(rng) * 0.25f;
+            const float radius = (queries.size() / raysPerAgent) % 4 == 0 ? 0.25f : 0.0f;
+            for (int r = 0; r < raysPerAgent; ++r)
+            {
+                const float y = yaw + spread(rng);
+                const float p = pitch + spread(rng);
+                CastQuery query;
+                query.Origin = origin;
+                query.Direction = { std::cos(p) * std::cos(y), std::sin(p), std::cos(p) * std::sin(y) };
+                query.MaxDistance = range;
+                query.Radius = radius;
+                queries.push_back(query);
+            }
+        }
+        std::vector<CastQuery> shuffled = queries;
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+        std::vector<QueryHit> hits(queries.size());
+        std::vector<QueryHit> batchHits(queries.size());
+
+        std::printf("%-28s | %9s | %8s | %s\n", "mode", "ms", "speed-up", "hits");
+        auto report = [&](const char* name, double ms, double baseline, const std::vector<QueryHit>& result)
+            {
+                size_t found = 0;
+                for (const QueryHit& hit : result) found += hit.IsHit();
+                std::printf("%-28s | %9.3f | %7.2fx | %zu\n", name, ms, baseline / ms, found);
+            };
+
+        start = Clock::now();
+        for (int r = 0; r < repeats; ++r)
+        {
+            for (size_t i = 0; i < queries.size(); ++i) PhysicsQuery::Cast(snapshot, queries[i], hits[i]);
+        }
+        const double singleMs = ElapsedMs(start) / repeats;
+        report("one cast per packet", singleMs, singleMs, hits);
+
+        start = Clock::now();
+        for (int r = 0; r < repeats; ++r) PhysicsQuery::CastBatch(snapshot, shuffled, batchHits);
+        report("batch, shuffled packets", ElapsedMs(start) / repeats, singleMs, batchHits);
+
+        start = Clock::now();
+        for (int r = 0; r < repeats; ++r) PhysicsQuery::CastBatch(snapshot, queries, batchHits);
+        report("batch, fan packets", ElapsedMs(start) / repeats, singleMs, batchHits);
+
+        int mismatches = 0;
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            if (hits[i].Body != batchHits[i].Body || hits[i].Distance != batchHits[i].Distance) ++mismatches;
+        }
+
+        for (const int threads : { 2, 4, 8 })
+        {
+            if (threads > WorkerPool::GetHardwareThreadCount()) break;
+
+            WorkerPool pool(threads);
+            std::vector<QueryHit> pooledHits(queries.size());
+            start = Clock::now();
+            for (int r = 0; r < repeats; ++r) PhysicsQuery::CastBatch(snapshot, queries, pooledHits, &pool);
+            const std::string name = "batch, fan packets, " + std::to_string(threads) + " thr";
+            report(name.c_str(), ElapsedMs(start) / repeats, singleMs, pooledHits);
+
+            for (size_t i = 0; i < queries.size(); ++i)
+            {
+                if (pooledHits[i].Body != batchHits[i].Body) ++mismatches;
+            }
+        }
+        std::printf("batched vs single mismatches: %d\n", mismatches);
+
+        // Brute force reference on a sample, a query sphere swept against every body it can reach
+        RigidBody probeBody;
+        SphereCollider probe(&probeBody);
+        constexpr float grazing = 0.02f;
+        int agree = 0;
+        int grazed = 0;
+        int hullBoxes = 0;
+        float maxDistanceError = 0.0f;
+        for (int i = 0; i < checked; ++i)
+        {
+            const CastQuery& query = queries[(i * 37) % queries.size()];
+            const QueryHit& hit = hits[(i * 37) % queries.size()];
+
+            const DirectX::XMVECTOR from = DirectX::XMLoadFloat3(&query.Origin);
+            const DirectX::XMVECTOR to = DirectX::XMVectorAdd(from,
+                DirectX::XMVectorScale(DirectX::XMLoadFloat3(&query.Direction), query.MaxDistance));
+            probe.SetRadius(query.Radius);
+            probeBody.SetPosition(to);
+
+            AABB swept;
+            DirectX::XMStoreFloat3(&swept.Min, DirectX::XMVectorMin(from, to));
+            DirectX::XMStoreFloat3(&swept.Max, DirectX::XMVectorMax(from, to));
+            swept.Expand(probe.GetSupportMargin());
+
+            float best = 2.0f;
+            BodyHandle bestBody = BodyStore::INVALID_HANDLE;
+            for (ICollider* collider : scene.Colliders)
+            {
+                if (!swept.Overlaps(collider->GetWorldAABB())) continue;
+
+                float time;
+                DirectX::XMFLOAT3 normal;
+                if (ConvexNarrowPhase::TimeOfImpact(&probe, from, to, collider, time, normal) && time < best)
+                {
+                    best = time;
+                    bestBody = collider->GetRigidBody()->GetHandle();
+                }
+            }
+
+            if (bestBody == hit.Body)
+            {
+                ++agree;
+                if (hit.IsHit()) maxDistanceError = (std::max)(maxDistanceError, std::abs(best * query.MaxDistance - hit.Distance));
+                continue;
+            }
+
+            CastQuery wider = query;
+            wider.Radius += grazing;
+            QueryHit widerHit;
+            PhysicsQuery::Cast(snapshot, wider, widerHit);
+            if (widerHit.Body == bestBody || (!hit.IsHit() && !widerHit.IsHit())) ++grazed;
+            else if (hit.IsHit() && snapshot.GetEntry(hit.Body).Shape.Type == ColliderType::ConvexHull) ++hullBoxes;
+        }
+        std::printf("reference: %d / %d agree, %d grazing, %d on hull boxes, %d wrong, max distance error %.4f\n\n",
+            agree, checked, grazed, hullBoxes, checked - agree - grazed - hullBoxes, maxDistanceError);
+    }
+
+    //~ Records a run through PhysicsWorld with bodies dropped in and taken out mid run and the
+    //~ broadphase switched halfway, round trips the log through a file and plays it back on
+    //~ every thread count, checking the state hash of each step against the recording.
+    //~ False when the log did not survive the file or any replay diverged.
+    bool BenchmarkDeterministicReplay()
+    {
+        constexpr int columns = 64;
+        constexpr int height = 6;
+        constexpr int steps = 300;
+        constexpr int waveEvery = 30;
+        constexpr int waveSize = 40;
+        constexpr float dt = 1.0f / 60.0f;
+        constexpr uint64_t seed = 0x5EED;
+
+        const int hardwareThreads = WorkerPool::GetHardwareThreadCount();
+        std::cout << "=== Deterministic Replay (" << columns << " piles, waves of " << waveSize << " every "
+            << waveEvery << " steps, " << steps << " steps) ===\n";
+
+        ReplayLog log;
+        uint64_t recordedHash = 0;
+        double recordMs = 0.0;
+        {
+            BenchScene scene;
+            BuildStackColumns(scene, columns, height, true);
+            BenchScene rain;
+            BuildScene(rain, waveSize * (steps / waveEvery), 91);
+
+            PhysicsWorld world;
+            world.GetGravity()->SetGravity(true);
+            log.Begin(seed);
+            for (ICollider* collider : scene.Colliders)
+            {
+                world.AddCollider(collider);
+                log.RecordAdd(collider);
+            }
+
+            ReplayLog::StepInput input;
+            input.DeltaTime = dt;
+            input.Settings.BroadPhase = BroadPhaseType::DynamicTree;
+            input.Settings.ThreadCount = hardwareThreads;
+            input.GravityOn = true;
+
+            size_t nextDrop = 0;
+            for (int step = 0; step < steps; ++step)
+            {
+                if (step % waveEvery == 0)
+                {
+                    // Every wave lands above the piles, the one before it mostly leaves again
+                    for (int i = 0; i < waveSize && nextDrop < rain.Colliders.size(); ++i, ++nextDrop)
+                    {
+                        ICollider* drop = rain.Colliders[nextDrop];
+                        DirectX::XMVECTOR position = drop->GetRigidBody()->GetPosition();
+                        position = DirectX::XMVectorAdd(DirectX::XMVectorScale(position, 0.5f),
+                            DirectX::XMVectorSet(0.0f, 20.0f, 0.0f, 0.0f));
+                        drop->GetRigidBody()->SetPosition(position);
+                        drop->Update(0.0f);
+                        world.AddCollider(drop);
+                        log.RecordAdd(drop);
+                    }
+                    if (nextDrop >= 2 * waveSize)
+                    {
+                        const size_t previousWave = nextDrop - 2 * waveSize;
+                        for (size_t i = previousWave; i < previousWave + waveSize; i += 3)
+                        {
+                            world.RemoveCollider(rain.Colliders[i]);
+                            log.RecordRemove(rain.Colliders[i]);
+                        }
+                    }
+
+                    // And an editor style edit, one pile's bottom box gets kicked sideways
+                    // (each pile is its tile then its boxes)
+                    const int pile = (step / waveEvery * 7) % columns;
+                    ICollider* kicked = scene.Colliders[pile * (height + 1) + 1];
+                    const BodyEdit kick = BodyEdit::Vector(BodyField::Velocity, { 2.0f, 0.0f, 0.0f });
+                    world.EditCollider(kicked, kick);
+                    log.RecordEdit(kicked, kick);
+                }
+                if (step == steps / 2) input.Settings.BroadPhase = BroadPhaseType::SweepAndPrune;
+
+                const auto start = Clock::now();
+                world.Step(input.DeltaTime, input.Settings);
+                recordMs += ElapsedMs(start);
+                log.RecordStep(input, world.ComputeStateHash());
+            }
+            recordedHash = world.ComputeStateHash();
+        }
+
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "physics_replay.bin";
+        ReplayLog loaded;
+        const bool saved = log.Save(path.string());
+        const bool reloaded = saved && loaded.Load(path.string());
+        std::error_code removeError;
+        std::filesystem::remove(path, removeError);
+
+        std::printf("recorded: %zu bodies, %zu steps, %zu distinct inputs, %.3f ms/step, final hash %016llx, file round trip %s\n",
+            log.GetBodies().size(), log.GetSteps().size(), log.GetInputs().size(), recordMs / steps,
+            static_cast<unsigned long long>(recordedHash), reloaded ? "ok" : "FAILED");
+        if (!reloaded)
+        {
+            std::cout << "\n";
+            return false;
+        }
+
+        std::printf("%-8s | %12s | %15s | %16s\n", "threads", "replay ms/step", "matching steps", "final hash");
+        std::vector<int> threadCounts{ 1, 2 };
+        for (int count = 4; count <= hardwareThreads; count *= 2) threadCounts.push_back(count);
+
+        bool allMatched = true;
+        for (const int threadCount : threadCounts)
+        {
+            ReplayPlayer player(loaded);
+            player.SetThreadCount(threadCount);
+
+            const auto start = Clock::now();
+            const bool matched = player.Run();
+            const double replayMs = ElapsedMs(start) / static_cast<double>((std::max)(player.GetStepIndex(), size_t{ 1 }));
+
+            std::printf("%-8d | %14.3f | %6zu / %-6zu | %016llx%s\n", threadCount, replayMs,
+                matched ? player.GetStepCount() : player.GetFirstMismatch(), player.GetStepCount(),
+                static_cast<unsigned long long>(player.GetLastStateHash()), matched ? "" : "  MISMATCH");
+            allMatched = allMatched && matched;
+        }
+        std::cout << "\n";
+        return allMatched;
     }
 }
 
 int main()
 {
-    simulateBoxAndPlaneCollision();
-    return 0;
+    // Timings are only reported, a wrong result fails the run
+    bool passed = BenchmarkBroadPhase();
+    BenchmarkCoherentFrames();
+    BenchmarkStackSettling();
+    BenchmarkSleepingPiles();
+    BenchmarkParallelIslands();
+    BenchmarkGraphColoring();
+    BenchmarkIntegration();
+    BenchmarkForceRegistry();
+    BenchmarkConvexNarrowPhase();
+    BenchmarkBoxSeparatingAxes();
+    BenchmarkBatchNarrowPhase();
+    BenchmarkParallelNarrowPhase();
+    BenchmarkContinuousCollision();
+    BenchmarkSceneQueries();
+    passed = BenchmarkDeterministicReplay() && passed;
+    return passed ? 0 : 1;
 }
@@ -149,6 +149,9 @@ bool Application::Run()
 		m_InputHandler->HandleInput();
 		HandleEvents();
 
+		//~ Everything below reads this one physics frame
+		m_PhysicsManager->AcquireSnapshot();
+
 		if (m_WindowSystem->ProcessMethod())
 		{
 			SetEvent(m_GlobalEvent.GlobalEndEvent);
@@ -35,24 +35,57 @@ void ModelCubeUI::RenderOnScreen()
     if (!m_RigidBody || !m_Collider) return;
 
     // === Pull RigidBody State ===
-    DirectX::XMStoreFloat3(&m_Pos, m_RigidBody->GetPosition());
-    DirectX::XMStoreFloat3(&m_Vel, m_RigidBody->GetVelocity());
-    DirectX::XMStoreFloat3(&m_Acc, m_RigidBody->GetAcceleration());
-    DirectX::XMStoreFloat3(&m_AngVel, m_RigidBody->GetAngularVelocity());
-
-	Quaternion q = m_RigidBody->GetOrientation();
-    m_Orientation[0] = q.GetI();
-    m_Orientation[1] = q.GetJ();
-    m_Orientation[2] = q.GetK();
-    m_Orientation[3] = q.GetR();
-
-    m_Mass = m_RigidBody->GetMass();
-    m_Damping = m_RigidBody->GetDamping();
-    m_Elasticity = m_RigidBody->GetElasticity();
-    m_Restitution = m_RigidBody->GetRestitution();
-    m_Friction = m_RigidBody->GetFriction();
-
-    DirectX::XMStoreFloat3(&m_Scale, m_Collider->GetScale());
+    // The frame the physics published, not the body it may be writing right now. Edits are
+    // queued for the next step boundary and show up here once the physics applied them.
+    bool isResting = false;
+    int stateIndex = 0;
+    if (const BodySnapshot* state = m_Cube->GetBodySnapshot())
+    {
+        m_Pos = state->Position;
+        m_Vel = state->Velocity;
+        m_Acc = state->Acceleration;
+        m_AngVel = state->AngularVelocity;
+        m_Orientation[0] = state->Orientation.x;
+        m_Orientation[1] = state->Orientation.y;
+        m_Orientation[2] = state->Orientation.z;
+        m_Orientation[3] = state->Orientation.w;
+
+        m_Mass = state->Mass;
+        m_Damping = state->LinearDamping;
+        m_AngularDamping = state->AngularDamping;
+        m_Elasticity = state->Elasticity;
+        m_Restitution = state->Restitution;
+        m_Friction = state->Friction;
+        m_Platform = state->Platform;
+        m_Scale = state->Scale;
+        isResting = state->Resting;
+        stateIndex = static_cast<int>(state->State);
+    }
+    else
+    {
+        // Not stepped yet
+        DirectX::XMStoreFloat3(&m_Pos, m_RigidBody->GetPosition());
+        DirectX::XMStoreFloat3(&m_Vel, m_RigidBody->GetVelocity());
+        DirectX::XMStoreFloat3(&m_Acc, m_RigidBody->GetAcceleration());
+        DirectX::XMStoreFloat3(&m_AngVel, m_RigidBody->GetAngularVelocity());
+
+        Quaternion q = m_RigidBody->GetOrientation();
+        m_Orientation[0] = q.GetI();
+        m_Orientation[1] = q.GetJ();
+        m_Orientation[2] = q.GetK();
+        m_Orientation[3] = q.GetR();
+
+        m_Mass = m_RigidBody->GetMass();
+        m_Damping = m_RigidBody->GetDamping();
+        m_AngularDamping = m_RigidBody->GetAngularDamping();
+        m_Elasticity = m_RigidBody->GetElasticity();
+        m_Restitution = m_RigidBody->GetRestitution();
+        m_Friction = m_RigidBody->GetFriction();
+        m_Platform = m_RigidBody->IsPlatform();
+        DirectX::XMStoreFloat3(&m_Scale, m_Collider->GetScale());
+        isResting = m_RigidBody->GetRestingState();
+        stateIndex = static_cast<int>(m_Collider->GetColliderState());
+    }
 
     ImGui::Text("Object Identity");
     ImGui::Separator();
@@ -69,47 +102,46 @@ void ModelCubeUI::RenderOnScreen()
     ImGui::Separator();
 
     if (ImGui::DragFloat3("Position", &m_Pos.x, 0.1f))
-        m_RigidBody->SetPosition(DirectX::XMLoadFloat3(&m_Pos));
+        m_Cube->EditBody(BodyEdit::Vector(BodyField::Position, m_Pos));
 
     if (ImGui::DragFloat3("Velocity", &m_Vel.x, 0.1f))
-        m_RigidBody->SetVelocity(DirectX::XMLoadFloat3(&m_Vel));
+        m_Cube->EditBody(BodyEdit::Vector(BodyField::Velocity, m_Vel));
 
     if (ImGui::DragFloat3("Acceleration", &m_Acc.x, 0.1f))
-        m_RigidBody->SetAcceleration(DirectX::XMLoadFloat3(&m_Acc));
+        m_Cube->EditBody(BodyEdit::Vector(BodyField::Acceleration, m_Acc));
 
     if (ImGui::DragFloat3("Angular Velocity", &m_AngVel.x, 0.1f))
-        m_RigidBody->SetAngularVelocity(DirectX::XMLoadFloat3(&m_AngVel));
+        m_Cube->EditBody(BodyEdit::Vector(BodyField::AngularVelocity, m_AngVel));
 
     if (ImGui::DragFloat4("Orientation (I, J, K, R)", m_Orientation, 0.01f))
     {
         Quaternion newQ(m_Orientation[3], m_Orientation[0], m_Orientation[1], m_Orientation[2]);
-        m_RigidBody->SetOrientation(newQ);
+        m_Cube->EditBody(BodyEdit::Rotation(newQ));
     }
 
     if (ImGui::DragFloat("Mass", &m_Mass, 0.1f, 0.001f, 1000.0f))
-        m_RigidBody->SetMass(m_Mass);
+        m_Cube->EditBody(BodyEdit::Scalar(BodyField::Mass, m_Mass));
 
     if (ImGui::DragFloat("Damping", &m_Damping, 0.01f, 0.0f, 1.0f))
-        m_RigidBody->SetDamping(m_Damping);
+        m_Cube->EditBody(BodyEdit::Scalar(BodyField::LinearDamping, m_Damping));
 
     if (ImGui::DragFloat("Angular Damping", &m_AngularDamping, 0.01f, 0.0f, 1.0f))
-        m_RigidBody->SetAngularDamping(m_AngularDamping);
+        m_Cube->EditBody(BodyEdit::Scalar(BodyField::AngularDamping, m_AngularDamping));
 
     if (ImGui::DragFloat("Elasticity", &m_Elasticity, 0.01f, 0.0f, 1.0f))
-        m_RigidBody->SetElasticity(m_Elasticity);
+        m_Cube->EditBody(BodyEdit::Scalar(BodyField::Elasticity, m_Elasticity));
 
     if (ImGui::DragFloat("Restitution", &m_Restitution, 0.01f, 0.0f, 1.0f))
-        m_RigidBody->SetRestitution(m_Restitution);
+        m_Cube->EditBody(BodyEdit::Scalar(BodyField::Restitution, m_Restitution));
 
     if (ImGui::DragFloat("Friction", &m_Friction, 0.01f, 0.0f, 5.0f))
-        m_RigidBody->SetFriction(m_Friction);
+        m_Cube->EditBody(BodyEdit::Scalar(BodyField::Friction, m_Friction));
 
     if (ImGui::Checkbox("Platform", &m_Platform))
     {
-        m_RigidBody->SetAsPlatform(m_Platform);
+        m_Cube->EditBody(BodyEdit::Flag(BodyField::Platform, m_Platform));
     }
 
-    bool isResting = m_RigidBody->GetRestingState();
     ImGui::TextColored(isResting ? ImVec4(0, 1, 0, 1) :
         ImVec4(1, 0, 0, 1),
         "Resting State: %s", isResting ? "Yes" : "No");
@@ -120,14 +152,12 @@ void ModelCubeUI::RenderOnScreen()
     ImGui::Separator();
 
     if (ImGui::DragFloat3("Scale", &m_Scale.x, 0.1f))
-        m_Collider->SetScale(DirectX::XMLoadFloat3(&m_Scale));
+        m_Cube->EditBody(BodyEdit::Vector(BodyField::Scale, m_Scale));
 
     static const char* stateLabels[] = { "Dynamic", "Static", "Resting" };
-    int currentStateIndex = static_cast<int>(m_Collider->GetColliderState());
-
-    if (ImGui::Combo("Collider State", &currentStateIndex, stateLabels, IM_ARRAYSIZE(stateLabels)))
+    if (ImGui::Combo("Collider State", &stateIndex, stateLabels, IM_ARRAYSIZE(stateLabels)))
     {
-        m_Collider->SetColliderState(static_cast<ColliderState>(currentStateIndex));
+        m_Cube->EditBody(BodyEdit::State(static_cast<ColliderState>(stateIndex)));
     }
 }
 
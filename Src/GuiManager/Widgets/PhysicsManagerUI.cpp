@@ -1,6 +1,8 @@
 #include "PhysicsManagerUI.h"
 #include "imgui.h"
 
+#include <string>
+
 
 PhysicsManagerUI::PhysicsManagerUI(PhysicsManager* physicsManager)
 	: m_PhysicsManager(physicsManager)
@@ -43,9 +45,29 @@ void PhysicsManagerUI::RenderOnScreen()
 		m_PhysicsManager->SetTargetDeltaTime(simDelta);
 	}
 
+	// === Sub Stepping ===
+	int maxSubSteps = m_PhysicsManager->GetMaxSubSteps();
+	if (ImGui::SliderInt("Max Sub Steps", &maxSubSteps, 1, 16))
+	{
+		m_PhysicsManager->SetMaxSubSteps(maxSubSteps);
+	}
+
 	// === Actual Simulation Stats ===
 	ImGui::Text("Actual Simulation Hz: %.1f", m_PhysicsManager->GetActualSimulationHz());
 	ImGui::Text("Actual Step Time: %.2f ms", m_PhysicsManager->GetActualSimulationFrameTime() * 1000.0f);
+	ImGui::Text("Dropped Time: %.2f s", m_PhysicsManager->GetDroppedSimulationTime());
+	ImGui::Text("Interpolation Alpha: %.2f", m_PhysicsManager->GetInterpolationAlpha());
+
+	// === Frame Pacing ===
+	static const char* pacingModes[] = { "Power Saving", "Balanced", "Low Latency" };
+	int pacingIndex = static_cast<int>(m_PhysicsManager->GetPacingMode());
+
+	if (ImGui::Combo("Pacing", &pacingIndex, pacingModes, IM_ARRAYSIZE(pacingModes)))
+	{
+		m_PhysicsManager->SetPacingMode(static_cast<PacingMode>(pacingIndex));
+	}
+	ImGui::Text("Wake Jitter: %.3f ms (max %.3f ms)", m_PhysicsManager->GetAverageWakeJitter(),
+		m_PhysicsManager->GetMaxWakeJitter());
 
 	ImGui::Separator();
 
@@ -58,6 +80,98 @@ void PhysicsManagerUI::RenderOnScreen()
 		m_PhysicsManager->SetIntegration(static_cast<IntegrationType>(currentIndex));
 	}
 
+	// === Broad Phase Selection ===
+	static const char* broadPhaseModes[] = { "Brute Force", "Spatial Hash", "Sweep And Prune", "Dynamic AABB Tree" };
+	int broadPhaseIndex = static_cast<int>(m_PhysicsManager->GetSelectedBroadPhase());
+
+	if (ImGui::Combo("Broad Phase", &broadPhaseIndex, broadPhaseModes, IM_ARRAYSIZE(broadPhaseModes)))
+	{
+		m_PhysicsManager->SetBroadPhase(static_cast<BroadPhaseType>(broadPhaseIndex));
+	}
+
+	ImGui::Text("Candidate Pairs: %d", m_PhysicsManager->GetCandidatePairCount());
+	ImGui::Text("Batched Pairs: %d (%u lanes)", m_PhysicsManager->GetBatchedPairCount(), BatchNarrowPhase::GetLaneCount());
+	ImGui::Text("Contacts: %d", m_PhysicsManager->GetContactCount());
+	ImGui::Text("Warm Started Contacts: %d", m_PhysicsManager->GetWarmStartedContactCount());
+
+	// === Contact Solver Iterations ===
+	int velocityIterations = m_PhysicsManager->GetVelocityIterations();
+	if (ImGui::SliderInt("Velocity Iterations", &velocityIterations, 1, 30))
+	{
+		m_PhysicsManager->SetVelocityIterations(velocityIterations);
+	}
+
+	int positionIterations = m_PhysicsManager->GetPositionIterations();
+	if (ImGui::SliderInt("Position Iterations", &positionIterations, 0, 10))
+	{
+		m_PhysicsManager->SetPositionIterations(positionIterations);
+	}
+
+	// === Islands & Sleeping ===
+	ImGui::Text("Islands: %d (largest %d)", m_PhysicsManager->GetIslandCount(), m_PhysicsManager->GetLargestIslandSize());
+	ImGui::Text("Sleeping Bodies: %d", m_PhysicsManager->GetSleepingBodyCount());
+
+	bool sleepingEnabled = m_PhysicsManager->IsSleepingEnabled();
+	if (ImGui::Checkbox("Allow Sleeping", &sleepingEnabled))
+	{
+		m_PhysicsManager->SetSleepingEnabled(sleepingEnabled);
+	}
+
+	float timeToSleep = m_PhysicsManager->GetTimeToSleep();
+	if (ImGui::SliderFloat("Time To Sleep (s)", &timeToSleep, 0.1f, 5.0f))
+	{
+		m_PhysicsManager->SetTimeToSleep(timeToSleep);
+	}
+
+	// === Continuous Collision ===
+	bool continuousEnabled = m_PhysicsManager->IsContinuousCollisionEnabled();
+	if (ImGui::Checkbox("Continuous Collision", &continuousEnabled))
+	{
+		m_PhysicsManager->SetContinuousCollisionEnabled(continuousEnabled);
+	}
+	ImGui::Text("Swept Bodies: %d (impacts %d)", m_PhysicsManager->GetSweptBodyCount(), m_PhysicsManager->GetSweptImpactCount());
+
+	// === Narrowphase and Island Solver Workers ===
+	ImGui::Text("Narrow Phase: %.3f ms", m_PhysicsManager->GetNarrowPhaseTime());
+	ImGui::Text("Island Solve: %.3f ms", m_PhysicsManager->GetIslandSolveTime());
+
+	int solverThreads = m_PhysicsManager->GetSolverThreadCount();
+	if (ImGui::SliderInt("Solver Threads", &solverThreads, 1, WorkerPool::GetHardwareThreadCount()))
+	{
+		m_PhysicsManager->SetSolverThreadCount(solverThreads);
+	}
+
+	uint64_t affinityMask = m_PhysicsManager->GetSolverAffinityMask();
+	if (ImGui::InputScalar("Worker Affinity (hex)", ImGuiDataType_U64, &affinityMask, nullptr, nullptr, "%llX",
+		ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue))
+	{
+		m_PhysicsManager->SetSolverAffinityMask(affinityMask);
+	}
+
+	const int colorCount = m_PhysicsManager->GetColorCount();
+	if (colorCount > 0)
+	{
+		ImGui::Text("Largest Island Colours: %d (overflow %d)", colorCount, m_PhysicsManager->GetColorOverflowCount());
+
+		std::string batches = "Batch Sizes:";
+		for (const int size : m_PhysicsManager->GetColorBatchSizes())
+		{
+			batches += " " + std::to_string(size);
+		}
+		ImGui::TextWrapped("%s", batches.c_str());
+	}
+	else
+	{
+		ImGui::Text("Largest Island Colours: - (solved serially)");
+	}
+
+	// === Scene Queries ===
+	int queryThreads = m_PhysicsManager->GetQueryThreadCount();
+	if (ImGui::SliderInt("Query Threads", &queryThreads, 1, WorkerPool::GetHardwareThreadCount()))
+	{
+		m_PhysicsManager->SetQueryThreadCount(queryThreads);
+	}
+
 	// === Gravity Toggle ===
 	bool gravityOn = m_PhysicsManager->GetGravity()->IsGravityOn();
 	if (ImGui::Checkbox("Enable Gravity", &gravityOn))
@@ -90,6 +204,33 @@ void PhysicsManagerUI::RenderOnScreen()
 
 	ImGui::Separator();
 
+	// === Deterministic Replay ===
+	if (m_PhysicsManager->IsDeterministic())
+	{
+		ImGui::Text("Deterministic Seed: %llu", static_cast<unsigned long long>(m_PhysicsManager->GetDeterministicSeed()));
+		ImGui::Text("Recorded Steps: %llu", static_cast<unsigned long long>(m_PhysicsManager->GetRecordedStepCount()));
+		ImGui::Text("State Hash: %016llX", static_cast<unsigned long long>(m_PhysicsManager->GetLastStateHash()));
+
+		ImGui::InputText("Replay Path", m_ReplayPath, sizeof(m_ReplayPath));
+		if (ImGui::Button("Save Replay"))
+		{
+			m_PhysicsManager->SaveReplay(m_ReplayPath);
+		}
+	}
+	else
+	{
+		ImGui::InputScalar("Seed", ImGuiDataType_U64, &m_ReplaySeed);
+		//~ Recording has to start from an empty world, every body in it gets logged
+		ImGui::BeginDisabled(totalCount > 0);
+		if (ImGui::Button("Enable Deterministic Mode"))
+		{
+			m_PhysicsManager->EnableDeterministicMode(m_ReplaySeed);
+		}
+		ImGui::EndDisabled();
+	}
+
+	ImGui::Separator();
+
 	// === Simulation Pause/Resume ===
 	bool isPaused = m_PhysicsManager->IsSimulationPause();
 	if (ImGui::Checkbox("Pause Simulation", &isPaused))
@@ -14,5 +14,7 @@ public:
 private:
 	PhysicsManager* m_PhysicsManager{ nullptr };
 	bool m_PopupPhysicsSettings{ true };
+	uint64_t m_ReplaySeed{ 1 };
+	char m_ReplayPath[256]{ "replay.bin" };
 };
 
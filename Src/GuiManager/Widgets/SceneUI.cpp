@@ -125,6 +125,7 @@ void SceneUI::DisplaySpawnerPop()
         ImGui::Checkbox("Cube", &p.spawnCube);
         ImGui::Checkbox("Sphere", &p.spawnSphere);
         ImGui::Checkbox("Capsule", &p.spawnCapsule);
+        ImGui::Checkbox("Continuous Collision", &p.continuous);
         ImGui::DragFloat("Delta Spawn Time (s)", &p.deltaSpawnTime, 0.01f, 0.0f, 10.0f);
 
         ImGui::Separator();
@@ -196,6 +197,7 @@ void SceneUI::DisplayCreateObjectPopup()
         // === Spawn Time and Static flag ===
         ImGui::DragFloat("Spawn Delay (s)", &m_Payload.SpawnTime, 0.01f, 0.0f, 10.0f);
         ImGui::Checkbox("Is Static?", &m_Payload.Static);
+        ImGui::Checkbox("Continuous Collision?", &m_Payload.Continuous);
         ImGui::Checkbox("Need Ui Control?", &m_Payload.UiControlNeeded);
 
         ImGui::Separator();
@@ -5,6 +5,7 @@
 #include "CollisionResolver.h" 
 #include "RenderManager/Model/IModel.h"
 #include "Utils/Logger.h"
+#include "Utils/Randomizer.h"
 
 #include <ranges>
 #include "Contact.h"
@@ -12,8 +13,6 @@
 
 PhysicsManager::PhysicsManager()
 {
-    DirectX::XMVECTOR grav{ 0.f, -9.81f, 0.f };
-    m_Gravity = std::make_unique<Gravity>(grav);
 }
 
 bool PhysicsManager::Shutdown()
@@ -25,6 +24,11 @@ bool PhysicsManager::Run()
 {
     ISystem::Run();
 
+    // Time spent building the scene is not owed to the simulation
+    m_Timer.Reset();
+    m_StepTimer.Reset();
+    m_FramePacer.SetInterruptEvent(mGlobalEvent.GlobalEndEvent);
+
     while (true)
     {
         if (mGlobalEvent.GlobalEndEvent)
@@ -38,69 +42,146 @@ bool PhysicsManager::Run()
         }
         if (m_Pause)
         {
+            ApplyIdleCommands();
             m_Timer.Tick();
-            Sleep(1);
+            m_FramePacer.WaitFor(m_TargetDeltaTime);
             continue;
         }
-        const float targetStep = 1.0f / static_cast<float>(m_TargetSimulationHz);
-        if (m_Timer.HasElapsed(targetStep))
+        // === Fixed step accumulator ===
+        const float fixedStep = m_TargetDeltaTime;
+        const int maxSubSteps = m_MaxSubSteps.load();
+        m_Accumulator += m_Timer.Tick();
+
+        // A hitch would otherwise ask for more steps than fit in the next frame, which makes that
+        // frame slow too. Beyond maxSubSteps the simulation falls behind real time instead.
+        const float maxBacklog = fixedStep * static_cast<float>(maxSubSteps);
+        if (m_Accumulator > maxBacklog)
         {
-            m_ActualSimulationFrameTime = m_Timer.Tick();
-            m_ActualSimulationHz = 1.0f / m_ActualSimulationFrameTime;
+            m_DroppedSimulationTime = m_DroppedSimulationTime.load() + (m_Accumulator - maxBacklog);
+            m_Accumulator = maxBacklog;
+        }
 
-            // Use actual frame time for variable step
-            Update(m_ActualSimulationFrameTime, m_SelectedIntegration);
+        if (m_Accumulator >= fixedStep)
+        {
+            int steps = 0;
+            while (m_Accumulator >= fixedStep && steps < maxSubSteps)
+            {
+                // Locked per step, so FlushCommands on another thread waits for one step at most
+                AcquireSRWLockExclusive(&m_StepLock);
+                ApplyCommands();
+                m_Accumulator -= fixedStep;
+                Update(fixedStep);
+                ReleaseSRWLockExclusive(&m_StepLock);
+                ++steps;
+            }
 
-            m_Timer.Reset();
+            m_ActualSimulationFrameTime = m_StepTimer.Tick() / static_cast<float>(steps);
+            m_ActualSimulationHz = 1.0f / m_ActualSimulationFrameTime;
         }
         else
         {
-            if (!m_WaitCleaning)
-            {
-                UseCache();
-            }
-            else Sleep(1);
+            ApplyIdleCommands();
         }
+
+        // === Pace ===
+        // Sleep until the accumulator holds the next step instead of polling the timer
+        m_FramePacer.WaitFor(fixedStep - m_Accumulator - m_Timer.Delta());
     }
     return true;
 }
 
 bool PhysicsManager::Build(SweetLoader& sweetLoader)
 {
+    const std::string threadsKey = "SolverThreads";
+    const std::string affinityKey = "SolverAffinityMask";
+    const std::string queryThreadsKey = "QueryThreads";
+    const std::string deterministicSeedKey = "DeterministicSeed";
+
+    //~ Loading / Saving solver threads, by default half the machine
+    if (sweetLoader.Contains(threadsKey))
+    {
+        SetSolverThreadCount(std::stoi(sweetLoader[threadsKey].GetValue()));
+    }
+    else
+    {
+        SetSolverThreadCount(std::clamp(WorkerPool::GetHardwareThreadCount() / 2, 1, 8));
+        sweetLoader.GetOrCreate(threadsKey) = std::to_string(GetSolverThreadCount());
+    }
+
+    //~ Loading / Saving worker affinity, 0 lets the OS place them
+    if (sweetLoader.Contains(affinityKey))
+    {
+        SetSolverAffinityMask(std::stoull(sweetLoader[affinityKey].GetValue(), nullptr, 0));
+    }
+    else
+    {
+        sweetLoader.GetOrCreate(affinityKey) = std::to_string(GetSolverAffinityMask());
+    }
+
+    //~ Loading / Saving query workers for CastBatch, they only wake up while a batch runs
+    if (sweetLoader.Contains(queryThreadsKey))
+    {
+        SetQueryThreadCount(std::stoi(sweetLoader[queryThreadsKey].GetValue()));
+    }
+    else
+    {
+        SetQueryThreadCount(std::clamp(WorkerPool::GetHardwareThreadCount() / 2, 1, 8));
+        sweetLoader.GetOrCreate(queryThreadsKey) = std::to_string(GetQueryThreadCount());
+    }
+
+    //~ A seed turns deterministic mode on from the first step, without one runs stay random
+    if (sweetLoader.Contains(deterministicSeedKey))
+    {
+        EnableDeterministicMode(std::stoull(sweetLoader[deterministicSeedKey].GetValue(), nullptr, 0));
+    }
 	return true;
 }
 
 bool PhysicsManager::AddModel(ICollider* model)
 {
-    m_CacheRequest.push(model);
-    return false;
+    if (!model) return false;
+
+    PushCommand(CommandType::Add, model);
+    return true;
+}
+
+bool PhysicsManager::RemoveModel(ICollider* model)
+{
+    if (!model) return false;
+
+    PushCommand(CommandType::Remove, model);
+    FlushCommands();
+    return true;
 }
 
 bool PhysicsManager::Clear()
 {
-    m_WaitCleaning = true;
-    m_ForceRegister.Clear();
+    PushCommand(CommandType::Clear, nullptr);
+    FlushCommands();
+    return true;
+}
 
-    ICollider* collider;
-    while (m_PhysicsEntity.try_pop(collider)) { /* drop all */ }
+bool PhysicsManager::EditBody(ICollider* model, const BodyEdit& edit)
+{
+    if (!model) return false;
 
-    m_WaitCleaning = false;
+    PushCommand(CommandType::Edit, model, edit);
     return true;
 }
 
 int PhysicsManager::GetCubeCounts()
 {
-    return m_ObjectInfo[1];
+    return m_ObjectCounts[1].load();
 }
 
 int PhysicsManager::GetSphereCounts()
 {
-    return m_ObjectInfo[0];
+    return m_ObjectCounts[0].load();
 }
 
 int PhysicsManager::GetCapsuleCounts()
 {
-    return m_ObjectInfo[2];
+    return m_ObjectCounts[2].load();
 }
 
 int PhysicsManager::GetTotalCounts()
@@ -110,8 +191,7 @@ int PhysicsManager::GetTotalCounts()
 
 Gravity* PhysicsManager::GetGravity() const
 {
-    if (m_Gravity) return m_Gravity.get();
-    return nullptr;
+    return m_World.GetGravity();
 }
 
 void PhysicsManager::SetTargetDeltaTime(float time)
@@ -146,6 +226,41 @@ float PhysicsManager::GetActualSimulationHz() const
     return m_ActualSimulationHz;
 }
 
+int PhysicsManager::GetMaxSubSteps() const
+{
+    return m_MaxSubSteps.load();
+}
+
+void PhysicsManager::SetMaxSubSteps(int count)
+{
+    m_MaxSubSteps = std::clamp(count, 1, 16);
+}
+
+float PhysicsManager::GetDroppedSimulationTime() const
+{
+    return m_DroppedSimulationTime.load();
+}
+
+PacingMode PhysicsManager::GetPacingMode() const
+{
+    return m_FramePacer.GetMode();
+}
+
+void PhysicsManager::SetPacingMode(PacingMode mode)
+{
+    m_FramePacer.SetMode(mode);
+}
+
+float PhysicsManager::GetAverageWakeJitter() const
+{
+    return m_FramePacer.GetAverageJitter();
+}
+
+float PhysicsManager::GetMaxWakeJitter() const
+{
+    return m_FramePacer.GetMaxJitter();
+}
+
 IntegrationType PhysicsManager::GetSelectedIntegration() const
 {
     return m_SelectedIntegration;
@@ -156,6 +271,294 @@ void PhysicsManager::SetIntegration(IntegrationType type)
     m_SelectedIntegration = type;
 }
 
+BroadPhaseType PhysicsManager::GetSelectedBroadPhase() const
+{
+    return m_RequestedBroadPhase.load();
+}
+
+void PhysicsManager::SetBroadPhase(BroadPhaseType type)
+{
+    //~ Swapped on the physics thread at the start of the next step
+    m_RequestedBroadPhase.store(type);
+}
+
+int PhysicsManager::GetCandidatePairCount() const
+{
+    return m_CandidatePairCount.load();
+}
+
+int PhysicsManager::GetBatchedPairCount() const
+{
+    return m_BatchedPairCount.load();
+}
+
+int PhysicsManager::GetContactCount() const
+{
+    return m_ContactCount.load();
+}
+
+int PhysicsManager::GetWarmStartedContactCount() const
+{
+    return m_WarmStartedContactCount.load();
+}
+
+int PhysicsManager::GetVelocityIterations() const
+{
+    return m_VelocityIterations.load();
+}
+
+void PhysicsManager::SetVelocityIterations(int iterations)
+{
+    m_VelocityIterations.store(std::clamp(iterations, 1, 50));
+}
+
+int PhysicsManager::GetPositionIterations() const
+{
+    return m_PositionIterations.load();
+}
+
+void PhysicsManager::SetPositionIterations(int iterations)
+{
+    m_PositionIterations.store(std::clamp(iterations, 0, 20));
+}
+
+bool PhysicsManager::IsSleepingEnabled() const
+{
+    return m_SleepingEnabled.load();
+}
+
+void PhysicsManager::SetSleepingEnabled(bool flag)
+{
+    m_SleepingEnabled.store(flag);
+}
+
+float PhysicsManager::GetTimeToSleep() const
+{
+    return m_TimeToSleep.load();
+}
+
+void PhysicsManager::SetTimeToSleep(float seconds)
+{
+    m_TimeToSleep.store(std::clamp(seconds, 0.1f, 10.0f));
+}
+
+int PhysicsManager::GetIslandCount() const
+{
+    return m_IslandCount.load();
+}
+
+int PhysicsManager::GetLargestIslandSize() const
+{
+    return m_LargestIslandSize.load();
+}
+
+int PhysicsManager::GetSleepingBodyCount() const
+{
+    return m_SleepingBodyCount.load();
+}
+
+bool PhysicsManager::IsContinuousCollisionEnabled() const
+{
+    return m_ContinuousCollisionEnabled.load();
+}
+
+void PhysicsManager::SetContinuousCollisionEnabled(bool flag)
+{
+    m_ContinuousCollisionEnabled.store(flag);
+}
+
+int PhysicsManager::GetSweptBodyCount() const
+{
+    return m_SweptBodyCount.load();
+}
+
+int PhysicsManager::GetSweptImpactCount() const
+{
+    return m_SweptImpactCount.load();
+}
+
+int PhysicsManager::GetSolverThreadCount() const
+{
+    return m_SolverThreadCount.load();
+}
+
+void PhysicsManager::SetSolverThreadCount(int count)
+{
+    m_SolverThreadCount.store(std::clamp(count, 1, WorkerPool::GetHardwareThreadCount()));
+}
+
+uint64_t PhysicsManager::GetSolverAffinityMask() const
+{
+    return m_SolverAffinityMask.load();
+}
+
+void PhysicsManager::SetSolverAffinityMask(uint64_t mask)
+{
+    m_SolverAffinityMask.store(mask);
+}
+
+float PhysicsManager::GetIslandSolveTime() const
+{
+    return m_IslandSolveTime.load();
+}
+
+float PhysicsManager::GetNarrowPhaseTime() const
+{
+    return m_NarrowPhaseTime.load();
+}
+
+int PhysicsManager::GetColorCount() const
+{
+    AcquireSRWLockShared(&m_Lock);
+    const int count = m_ColoringStats.ColorCount;
+    ReleaseSRWLockShared(&m_Lock);
+    return count;
+}
+
+int PhysicsManager::GetColorOverflowCount() const
+{
+    AcquireSRWLockShared(&m_Lock);
+    const int count = m_ColoringStats.OverflowCount;
+    ReleaseSRWLockShared(&m_Lock);
+    return count;
+}
+
+std::vector<int> PhysicsManager::GetColorBatchSizes() const
+{
+    AcquireSRWLockShared(&m_Lock);
+    std::vector<int> sizes = m_ColoringStats.BatchSizes;
+    ReleaseSRWLockShared(&m_Lock);
+    return sizes;
+}
+
+const PhysicsSnapshot& PhysicsManager::AcquireSnapshot()
+{
+    // Never waits, a frame still pinned by a query only delays the swap to a later call
+    m_Snapshots.Acquire();
+    // Sampled once so every model of the frame is drawn at the same point between the two poses
+    m_InterpolationAlpha = m_Snapshots.GetReadBuffer().GetInterpolationAlpha();
+    return m_Snapshots.GetReadBuffer();
+}
+
+const PhysicsSnapshot& PhysicsManager::GetSnapshot() const
+{
+    return m_Snapshots.GetReadBuffer();
+}
+
+bool PhysicsManager::RayCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float maxDistance,
+    QueryHit& outHit) const
+{
+    return SphereCast(origin, direction, 0.0f, maxDistance, outHit);
+}
+
+bool PhysicsManager::SphereCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float radius,
+    float maxDistance, QueryHit& outHit) const
+{
+    CastQuery query;
+    query.Origin = origin;
+    query.Direction = direction;
+    query.MaxDistance = maxDistance;
+    query.Radius = radius;
+
+    const uint8_t frame = m_Snapshots.Pin();
+    const bool hit = PhysicsQuery::Cast(m_Snapshots.GetPinned(frame), query, outHit);
+    m_Snapshots.Unpin(frame);
+    return hit;
+}
+
+void PhysicsManager::CastBatch(std::span<const CastQuery> queries, std::span<QueryHit> outHits)
+{
+    // One batch owns the query workers at a time, single casts never wait for it
+    AcquireSRWLockExclusive(&m_QueryPoolLock);
+    m_QueryPool.Configure(m_QueryThreadCount.load(), 0);
+
+    const uint8_t frame = m_Snapshots.Pin();
+    PhysicsQuery::CastBatch(m_Snapshots.GetPinned(frame), queries, outHits, &m_QueryPool);
+    m_Snapshots.Unpin(frame);
+
+    ReleaseSRWLockExclusive(&m_QueryPoolLock);
+}
+
+size_t PhysicsManager::OverlapSphere(const DirectX::XMFLOAT3& center, float radius, std::vector<BodyHandle>& outBodies) const
+{
+    const uint8_t frame = m_Snapshots.Pin();
+    const size_t count = PhysicsQuery::OverlapSphere(m_Snapshots.GetPinned(frame), center, radius, outBodies);
+    m_Snapshots.Unpin(frame);
+    return count;
+}
+
+int PhysicsManager::GetQueryThreadCount() const
+{
+    return m_QueryThreadCount.load();
+}
+
+void PhysicsManager::SetQueryThreadCount(int count)
+{
+    m_QueryThreadCount.store(std::clamp(count, 1, WorkerPool::GetHardwareThreadCount()));
+}
+
+bool PhysicsManager::EnableDeterministicMode(uint64_t seed)
+{
+    AcquireSRWLockExclusive(&m_StepLock);
+    ApplyCommands();
+
+    // A run can only be replayed from an empty world, nothing carries over from before it
+    const bool empty = m_World.GetColliders().empty();
+    if (empty)
+    {
+        m_World.Clear();
+        m_ReplayLog.Begin(seed);
+        m_DeterministicSeed = seed;
+        m_RecordedStepCount = 0;
+        m_LastStateHash = 0;
+        Randomizer::SetSessionSeed(seed);
+        m_Deterministic = true;
+    }
+    ReleaseSRWLockExclusive(&m_StepLock);
+
+    if (empty) LOG_INFO("[PhysicsManager] Deterministic mode, seed " + std::to_string(seed));
+    else LOG_WARNING("[PhysicsManager] Deterministic mode needs an empty simulation, not enabled");
+    return empty;
+}
+
+bool PhysicsManager::IsDeterministic() const
+{
+    return m_Deterministic.load();
+}
+
+uint64_t PhysicsManager::GetDeterministicSeed() const
+{
+    return m_DeterministicSeed;
+}
+
+uint64_t PhysicsManager::GetRecordedStepCount() const
+{
+    return m_RecordedStepCount.load();
+}
+
+uint64_t PhysicsManager::GetLastStateHash() const
+{
+    return m_LastStateHash.load();
+}
+
+bool PhysicsManager::SaveReplay(const std::string& path)
+{
+    if (!m_Deterministic.load()) return false;
+
+    AcquireSRWLockExclusive(&m_StepLock);
+    const bool saved = m_ReplayLog.Save(path);
+    ReleaseSRWLockExclusive(&m_StepLock);
+
+    if (saved) LOG_INFO("[PhysicsManager] Replay saved to " + path);
+    else LOG_ERROR("[PhysicsManager] Could not write replay " + path);
+    return saved;
+}
+
+float PhysicsManager::GetInterpolationAlpha() const
+{
+    return m_InterpolationAlpha;
+}
+
 int PhysicsManager::GetColliderKey(const ICollider* collider)
 {
     if (collider->GetColliderType() == ColliderType::Capsule)
@@ -175,85 +578,184 @@ int PhysicsManager::GetColliderKey(const ICollider* collider)
 
 void PhysicsManager::IncreaseCount(int colliderKey)
 {
-    m_ObjectInfo[colliderKey]++;
+    // Hulls have no key, they are not counted per type
+    if (colliderKey < 0) return;
+    m_ObjectCounts[colliderKey].fetch_add(1);
 }
 
 void PhysicsManager::DecreaseCount(int colliderKey)
 {
-    m_ObjectInfo[colliderKey]--;
+    if (colliderKey < 0) return;
+    m_ObjectCounts[colliderKey].fetch_sub(1);
 }
 
-void PhysicsManager::Update(float dt, IntegrationType type)
+void PhysicsManager::Update(float dt)
 {
-    m_TotalTime += dt;
+    const WorldSettings settings = MakeWorldSettings();
 
-    // === Integrate bodies ===
-    std::vector<ICollider*> colliders;
+    // Read before the step, so the log holds the gravity the step ran with
+    ReplayLog::StepInput input;
+    input.DeltaTime = dt;
+    input.Settings = settings;
+    input.GravityOn = m_World.GetGravity()->IsGravityOn();
+    input.GravityReversed = m_World.GetGravity()->IsReversed();
 
-    // Save off colliders for collision
+    m_World.Step(dt, settings);
+    PublishStats();
 
-    ICollider* collider = nullptr;
-    while (m_PhysicsEntity.try_pop(collider))
+    const char* broadPhaseName = m_World.GetBroadPhaseName();
+    if (m_BroadPhaseName != broadPhaseName)
     {
-        if (!collider) continue;
+        m_BroadPhaseName = broadPhaseName;
+        LOG_INFO(std::string("[PhysicsManager] Broad phase set to ") + m_BroadPhaseName);
+    }
 
-        collider->Update(dt);
+    // === Record ===
+    if (m_Deterministic.load())
+    {
+        const uint64_t stateHash = m_World.ComputeStateHash();
+        m_ReplayLog.RecordStep(input, stateHash);
+        m_LastStateHash = stateHash;
+        m_RecordedStepCount = m_ReplayLog.GetSteps().size();
+    }
 
-        RigidBody* body = collider->GetRigidBody();
-        if (!body) continue;
+    PublishSnapshot(dt);
+}
 
-        body->Integrate(dt, type);
-        colliders.push_back(collider);
-    }
+void PhysicsManager::PublishSnapshot(float stepTime)
+{
+    PhysicsSnapshot& snapshot = m_Snapshots.GetWriteBuffer();
+    snapshot.Capture(m_World.GetColliders(), m_Snapshots.GetLastPublished(), m_World.GetStepCount(), m_World.GetTotalTime());
+    snapshot.SetInterpolation(stepTime, m_Accumulator);
+    m_Snapshots.Publish();
+    m_EditsPending = false;
+}
 
-    m_ForceRegister.UpdateForces(dt);
+void PhysicsManager::RepublishSnapshot()
+{
+    // Same step and timing as the frame it replaces, only the edited bodies move
+    const PhysicsSnapshot& last = m_Snapshots.GetLastPublished();
+    PhysicsSnapshot& snapshot = m_Snapshots.GetWriteBuffer();
+    snapshot.Capture(m_World.GetColliders(), last, m_World.GetStepCount(), m_World.GetTotalTime());
+    snapshot.SetInterpolation(last);
+    m_Snapshots.Publish();
+    m_EditsPending = false;
+}
 
-    // === Collision Detection ===
-    std::vector<Contact> contacts;
-    for (size_t i = 0; i < colliders.size(); ++i)
-    {
-        for (size_t j = i + 1; j < colliders.size(); ++j)
-        {
-            ICollider* colliderA = colliders[i];
-            ICollider* colliderB = colliders[j];
+void PhysicsManager::PushCommand(CommandType type, ICollider* collider, const BodyEdit& edit)
+{
+    AcquireSRWLockExclusive(&m_CommandLock);
+    m_PendingCommands.push_back({ type, collider, edit });
+    ReleaseSRWLockExclusive(&m_CommandLock);
+}
 
-            if (!colliderA || !colliderB) continue;
+void PhysicsManager::FlushCommands()
+{
+    AcquireSRWLockExclusive(&m_StepLock);
+    ApplyCommands();
+    ReleaseSRWLockExclusive(&m_StepLock);
+}
 
-            Contact contact;
-            if (colliderA->CheckCollision(colliderB, contact))
-            {
-                colliderA->RegisterCollision(colliderB);
-                colliderB->RegisterCollision(colliderA);
-                contacts.push_back(contact);
-            }
-        }
-    }
+void PhysicsManager::ApplyIdleCommands()
+{
+    AcquireSRWLockExclusive(&m_StepLock);
+    ApplyCommands();
+    // No step may come for a while (paused), the UI would keep showing the pose before the edit
+    if (m_EditsPending) RepublishSnapshot();
+    ReleaseSRWLockExclusive(&m_StepLock);
+}
 
-    // === Contact Resolution ===
-    CollisionResolver::ResolveContacts(contacts, dt, m_TotalTime);
+void PhysicsManager::ApplyCommands()
+{
+    AcquireSRWLockExclusive(&m_CommandLock);
+    m_ApplyingCommands.swap(m_PendingCommands);
+    ReleaseSRWLockExclusive(&m_CommandLock);
 
-    // re-queue
-    for (ICollider* collider : colliders)
+    for (const PhysicsCommand& command : m_ApplyingCommands)
     {
-        m_PhysicsEntity.push(collider);
+        switch (command.Type)
+        {
+        case CommandType::Add:
+            AddCollider(command.Collider);
+            break;
+        case CommandType::Remove:
+            RemoveCollider(command.Collider);
+            break;
+        case CommandType::Clear:
+            ClearColliders();
+            break;
+        case CommandType::Edit:
+            EditCollider(command.Collider, command.Edit);
+            break;
+        }
     }
+    m_ApplyingCommands.clear();
+}
+
+void PhysicsManager::AddCollider(ICollider* collider)
+{
+    if (!m_World.AddCollider(collider)) return;
 
+    IncreaseCount(GetColliderKey(collider));
+    if (m_Deterministic.load()) m_ReplayLog.RecordAdd(collider);
 }
 
-void PhysicsManager::UseCache()
+void PhysicsManager::RemoveCollider(ICollider* collider)
 {
-    ICollider* collider = nullptr;
-    if (!m_CacheRequest.try_pop(collider) || !collider || collider == reinterpret_cast<ICollider*>(-1))
-        return;
+    if (!m_World.RemoveCollider(collider)) return;
 
-    switch (collider->GetColliderType())
-    {
-    case ColliderType::Capsule: m_ObjectInfo[2]++; break;
-    case ColliderType::Cube:    m_ObjectInfo[1]++; break;
-    case ColliderType::Sphere:  m_ObjectInfo[0]++; break;
-    default: break;
-    }
+    DecreaseCount(GetColliderKey(collider));
+    if (m_Deterministic.load()) m_ReplayLog.RecordRemove(collider);
+}
+
+void PhysicsManager::ClearColliders()
+{
+    m_World.Clear();
+    for (std::atomic<int>& count : m_ObjectCounts) count = 0;
+    PublishStats();
+    if (m_Deterministic.load()) m_ReplayLog.RecordClear();
+}
+
+void PhysicsManager::EditCollider(ICollider* collider, const BodyEdit& edit)
+{
+    if (!m_World.EditCollider(collider, edit)) return;
 
-    m_ForceRegister.Add(collider, m_Gravity.get());
-    m_PhysicsEntity.push(collider);
+    m_EditsPending = true;
+
+    if (m_Deterministic.load()) m_ReplayLog.RecordEdit(collider, edit);
+}
+
+WorldSettings PhysicsManager::MakeWorldSettings() const
+{
+    WorldSettings settings;
+    settings.Integration = m_SelectedIntegration;
+    settings.BroadPhase = m_RequestedBroadPhase.load();
+    settings.Solver.VelocityIterations = m_VelocityIterations.load();
+    settings.Solver.PositionIterations = m_PositionIterations.load();
+    settings.Sleep.Enabled = m_SleepingEnabled.load();
+    settings.Sleep.TimeToSleep = m_TimeToSleep.load();
+    settings.ContinuousCollision = m_ContinuousCollisionEnabled.load();
+    settings.ThreadCount = m_SolverThreadCount.load();
+    settings.AffinityMask = m_SolverAffinityMask.load();
+    return settings;
+}
+
+void PhysicsManager::PublishStats()
+{
+    const WorldStepStats& stats = m_World.GetStats();
+    m_CandidatePairCount = stats.CandidatePairCount;
+    m_BatchedPairCount = stats.BatchedPairCount;
+    m_ContactCount = stats.ContactCount;
+    m_WarmStartedContactCount = stats.WarmStartedContactCount;
+    m_IslandCount = stats.IslandCount;
+    m_LargestIslandSize = stats.LargestIslandSize;
+    m_SleepingBodyCount = stats.SleepingBodyCount;
+    m_SweptBodyCount = stats.SweptBodyCount;
+    m_SweptImpactCount = stats.SweptImpactCount;
+    m_NarrowPhaseTime = stats.NarrowPhaseTime;
+    m_IslandSolveTime = stats.IslandSolveTime;
+
+    AcquireSRWLockExclusive(&m_Lock);
+    m_ColoringStats = stats.Coloring;
+    ReleaseSRWLockExclusive(&m_Lock);
 }
@@ -1,12 +1,20 @@
 #pragma once
-#include "ForceRegistry.h"
-#include "Gravity.h"
+#include "BodyEdit.h"
 #include "ICollider.h"
+#include "PhysicsQuery.h"
+#include "PhysicsSnapshot.h"
+#include "PhysicsWorld.h"
+#include "ReplayLog.h"
+#include "TripleBuffer.h"
+#include "WorkerPool.h"
 #include "SystemManager/Interface/ISystem.h"
 #include "IntegrationType.h"
+#include "Utils/FramePacer.h"
 #include "Utils/LocalTimer.h"
 
-#include <concurrent_queue.h>
+#include <array>
+#include <span>
+#include <string>
 
 class IModel;
 
@@ -25,8 +33,14 @@ public:
 	bool Run() override;
 	bool Build(SweetLoader& sweetLoader) override;
 
+	//~ Any thread. The collider joins at the next step boundary.
 	bool AddModel(ICollider* model);
+	//~ Any thread. Returns once the collider is out of the simulation, so it may be destroyed.
+	bool RemoveModel(ICollider* model);
+	//~ Any thread. Drops every collider, returns once they are out of the simulation.
 	bool Clear();
+	//~ Any thread. Applied at the next step boundary, if the collider is in the simulation by then.
+	bool EditBody(ICollider* model, const BodyEdit& edit);
 
 	int GetCubeCounts();
 	int GetSphereCounts();
@@ -42,6 +56,18 @@ public:
 	float GetActualSimulationFrameTime() const;
 	float GetActualSimulationHz() const;
 
+	//~ Steps are always GetTargetDeltaTime() long, a slow frame is caught up with at most this
+	//~ many steps and whatever is left beyond that is dropped
+	int GetMaxSubSteps() const;
+	void SetMaxSubSteps(int count);
+	float GetDroppedSimulationTime() const;
+
+	//~ How the physics thread waits between steps, and how late it wakes up (ms)
+	PacingMode GetPacingMode() const;
+	void SetPacingMode(PacingMode mode);
+	float GetAverageWakeJitter() const;
+	float GetMaxWakeJitter() const;
+
 	void PauseSimulation() { m_Pause = true; }
 	void ResumeSimulation() { m_Pause = false; }
 	bool IsSimulationPause() const { return m_Pause; }
@@ -49,22 +75,135 @@ public:
 	IntegrationType GetSelectedIntegration() const;
 	void SetIntegration(IntegrationType type);
 
+	BroadPhaseType GetSelectedBroadPhase() const;
+	void SetBroadPhase(BroadPhaseType type);
+	int GetCandidatePairCount() const;
+	int GetBatchedPairCount() const;
+	int GetContactCount() const;
+	int GetWarmStartedContactCount() const;
+
+	int GetVelocityIterations() const;
+	void SetVelocityIterations(int iterations);
+	int GetPositionIterations() const;
+	void SetPositionIterations(int iterations);
+
+	bool IsSleepingEnabled() const;
+	void SetSleepingEnabled(bool flag);
+	float GetTimeToSleep() const;
+	void SetTimeToSleep(float seconds);
+	int GetIslandCount() const;
+	int GetLargestIslandSize() const;
+	int GetSleepingBodyCount() const;
+
+	//~ Swept collision for bodies created with RigidBody::SetContinuous
+	bool IsContinuousCollisionEnabled() const;
+	void SetContinuousCollisionEnabled(bool flag);
+	int GetSweptBodyCount() const;
+	int GetSweptImpactCount() const;
+
+	//~ The narrowphase and the islands run on a worker pool, the physics thread itself counts as one thread
+	int GetSolverThreadCount() const;
+	void SetSolverThreadCount(int count);
+	uint64_t GetSolverAffinityMask() const;
+	void SetSolverAffinityMask(uint64_t mask);
+	float GetIslandSolveTime() const;
+	float GetNarrowPhaseTime() const;
+
+	//~ Graph colouring of the largest island, when it was big enough to be coloured this step
+	int GetColorCount() const;
+	int GetColorOverflowCount() const;
+	std::vector<int> GetColorBatchSizes() const;
+
+	//~ Frame published at the end of every step. AcquireSnapshot is called once per frame by
+	//~ the main loop, render, GUI and scenario then all read that same frame without locking.
+	const PhysicsSnapshot& AcquireSnapshot();
+	const PhysicsSnapshot& GetSnapshot() const;
+	//~ Blend factor between the previous and current pose of the acquired frame
+	float GetInterpolationAlpha() const;
+
+	// === Scene Queries ===
+	//~ Any thread. Each query pins the acquired frame while it runs, so it sees one consistent
+	//~ frame and AcquireSnapshot never waits for it.
+	bool RayCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float maxDistance, QueryHit& outHit) const;
+	bool SphereCast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float radius,
+		float maxDistance, QueryHit& outHit) const;
+	//~ Many casts at once on the query workers, outHits[i] answers queries[i]
+	void CastBatch(std::span<const CastQuery> queries, std::span<QueryHit> outHits);
+	size_t OverlapSphere(const DirectX::XMFLOAT3& center, float radius, std::vector<BodyHandle>& outBodies) const;
+
+	int GetQueryThreadCount() const;
+	void SetQueryThreadCount(int count);
+
+	// === Deterministic Mode ===
+	//~ Seeds every random stream from seed and records each step (its commands, settings and
+	//~ state hash) to a replay log that ReplayPlayer plays back headless. Only starts while
+	//~ the simulation is empty, false otherwise. Steps are the usual fixed steps, only which
+	//~ step a command lands on depends on timing, and the log records that.
+	bool EnableDeterministicMode(uint64_t seed);
+	bool IsDeterministic() const;
+	uint64_t GetDeterministicSeed() const;
+	uint64_t GetRecordedStepCount() const;
+	uint64_t GetLastStateHash() const;
+	//~ Any thread. Writes what was recorded so far, waits for the step in flight.
+	bool SaveReplay(const std::string& path);
+
 	static int GetColliderKey(const ICollider* collider);
 
 private:
 	void IncreaseCount(int colliderKey);
 	void DecreaseCount(int colliderKey);
 
-	void Update(float dt, IntegrationType type = IntegrationType::SemiImplicitEuler);
+	void Update(float dt);
 
-	void UseCache();
+	// === Commands ===
+	enum class CommandType : uint8_t
+	{
+		Add,
+		Remove,
+		Clear,
+		Edit,
+	};
+
+	struct PhysicsCommand
+	{
+		CommandType Type;
+		ICollider* Collider;
+		BodyEdit Edit{}; // Edit only
+	};
+
+	void PushCommand(CommandType type, ICollider* collider, const BodyEdit& edit = {});
+	//~ Applies every queued command now, blocking until the physics thread is between steps
+	void FlushCommands();
+	//~ Physics thread, while no step is due: applies the queued commands and republishes the
+	//~ frame when they edited a body, edits flushed from other threads included
+	void ApplyIdleCommands();
+	//~ Caller holds m_StepLock
+	void ApplyCommands();
+	void AddCollider(ICollider* collider);
+	void RemoveCollider(ICollider* collider);
+	void ClearColliders();
+	void EditCollider(ICollider* collider, const BodyEdit& edit);
+	//~ The UI's settings as the world takes them
+	WorldSettings MakeWorldSettings() const;
+	//~ Copies the counters of the last step into what the UI reads
+	void PublishStats();
+	//~ Physics thread, after a step: captures the world for the other threads, the pending
+	//~ time comes from m_Accumulator which only this thread touches
+	void PublishSnapshot(float stepTime);
+	//~ Publishes the last step again with the edits applied since, keeping its interpolation
+	void RepublishSnapshot();
 
 private:
-	ForceRegistry m_ForceRegister{};
-	std::unique_ptr<Gravity>  m_Gravity{ nullptr };
+	//~ Physics thread only (or whoever holds m_StepLock)
+	PhysicsWorld m_World{};
 	LocalTimer m_Timer{};
-	float m_TotalTime{ 0.0f };
-	std::unordered_map<int, int> m_ObjectInfo{};
+	LocalTimer m_StepTimer{};
+	FramePacer m_FramePacer{};
+	float m_Accumulator{ 0.0f };
+	std::atomic<int> m_MaxSubSteps{ 4 };
+	std::atomic<float> m_DroppedSimulationTime{ 0.0f };
+	//~ Colliders per GetColliderKey, written on the physics thread and read by the UI
+	std::array<std::atomic<int>, 3> m_ObjectCounts{};
 	mutable SRWLOCK m_Lock{ SRWLOCK_INIT };
 	int m_TargetSimulationHz{ 60 };
 	float m_TargetDeltaTime{ 1.f / 60.f };
@@ -72,8 +211,47 @@ private:
 	float m_ActualSimulationHz{ 0.0f };
 	bool m_Pause{ false };
 	IntegrationType m_SelectedIntegration{ IntegrationType::SemiImplicitEuler };
-	Concurrency::concurrent_queue<ICollider*> m_PhysicsEntity;
-	Concurrency::concurrent_queue<ICollider*> m_CacheRequest;
+	std::atomic<BroadPhaseType> m_RequestedBroadPhase{ BroadPhaseType::SpatialHash };
+	std::string m_BroadPhaseName{};
+	std::atomic<int> m_CandidatePairCount{ 0 };
+	std::atomic<int> m_BatchedPairCount{ 0 };
+	std::atomic<int> m_ContactCount{ 0 };
+	std::atomic<int> m_WarmStartedContactCount{ 0 };
+	std::atomic<int> m_VelocityIterations{ 8 };
+	std::atomic<int> m_PositionIterations{ 3 };
+	std::atomic<bool> m_SleepingEnabled{ true };
+	std::atomic<float> m_TimeToSleep{ 0.5f };
+	std::atomic<int> m_IslandCount{ 0 };
+	std::atomic<int> m_LargestIslandSize{ 0 };
+	std::atomic<int> m_SleepingBodyCount{ 0 };
+	std::atomic<bool> m_ContinuousCollisionEnabled{ true };
+	std::atomic<int> m_SweptBodyCount{ 0 };
+	std::atomic<int> m_SweptImpactCount{ 0 };
+	std::atomic<int> m_SolverThreadCount{ 1 };
+	std::atomic<uint64_t> m_SolverAffinityMask{ 0 };
+	std::atomic<float> m_IslandSolveTime{ 0.0f };
+	std::atomic<float> m_NarrowPhaseTime{ 0.0f };
+	ContactColoringStats m_ColoringStats{};
+	TripleBuffer<PhysicsSnapshot> m_Snapshots{};
+	WorkerPool m_QueryPool{};
+	SRWLOCK m_QueryPoolLock{ SRWLOCK_INIT };
+	std::atomic<int> m_QueryThreadCount{ 1 };
+	float m_InterpolationAlpha{ 1.0f };
+	//~ Edits applied since the last published frame, under m_StepLock
+	bool m_EditsPending{ false };
+
+	//~ Written under m_StepLock
+	std::atomic<bool> m_Deterministic{ false };
+	uint64_t m_DeterministicSeed{ 0 };
+	ReplayLog m_ReplayLog{};
+	std::atomic<uint64_t> m_RecordedStepCount{ 0 };
+	std::atomic<uint64_t> m_LastStateHash{ 0 };
+
+	//~ Commands from any thread, swapped out and applied at the next step boundary
+	SRWLOCK m_CommandLock{ SRWLOCK_INIT };
+	std::vector<PhysicsCommand> m_PendingCommands;
+	std::vector<PhysicsCommand> m_ApplyingCommands;
 
-	bool m_WaitCleaning{ false };
+	//~ Held by the physics thread while it steps, taken by FlushCommands to wait for a boundary
+	SRWLOCK m_StepLock{ SRWLOCK_INIT };
 };
@@ -9,6 +9,7 @@
 #include "CubeCollider.h"
 #include "SphereCollider.h"
 #include "RenderManager/ShaderCache.h"
+#include "RenderManager/Render/Render3DQueue.h"
 
 
 IModel::IModel(const MODEL_INIT_DESC* desc)
@@ -86,11 +87,12 @@ void IModel::UpdateVertexCB(ID3D11DeviceContext* context, MODEL_VERTEX_CB* cb)
 		throw std::invalid_argument("Invalid input to UpdateVertexCB.");
 
 	ICollider* collider = GetCollider();
-	DirectX::XMVECTOR velocity = collider->GetRigidBody()->GetVelocity();
+	const BodySnapshot* state = GetBodySnapshot();
 	float deltaTime = m_Timer.Tick();
 
-	cb->Velocity = velocity;
-	cb->AngularVelocity = collider->GetRigidBody()->GetAngularVelocity();
+	// Not simulated yet, nothing else writes the body
+	cb->Velocity = state ? DirectX::XMLoadFloat3(&state->Velocity) : m_RigidBody.GetVelocity();
+	cb->AngularVelocity = state ? DirectX::XMLoadFloat3(&state->AngularVelocity) : m_RigidBody.GetAngularVelocity();
 	cb->IsStatic = collider->GetColliderState() == ColliderState::Static;
 	cb->DeltaTime = deltaTime;
 
@@ -120,11 +122,11 @@ void IModel::UpdatePixelCB(ID3D11DeviceContext* context, MODEL_PIXEL_CB* cb)
 		throw std::invalid_argument("Invalid input to UpdatePixelCB.");
 
 	ICollider* collider = GetCollider();
-	DirectX::XMVECTOR velocity = collider->GetRigidBody()->GetVelocity();
+	const BodySnapshot* state = GetBodySnapshot();
 	float deltaTime = m_Timer.Tick();
 
-	cb->Velocity = velocity;
-	cb->AngularVelocity = collider->GetRigidBody()->GetAngularVelocity();
+	cb->Velocity = state ? DirectX::XMLoadFloat3(&state->Velocity) : m_RigidBody.GetVelocity();
+	cb->AngularVelocity = state ? DirectX::XMLoadFloat3(&state->AngularVelocity) : m_RigidBody.GetAngularVelocity();
 	cb->IsStatic = collider->GetColliderState() == ColliderState::Static;
 	cb->DeltaTime = deltaTime;
 
@@ -159,6 +161,17 @@ RigidBody* IModel::GetRigidBody()
 	return &m_RigidBody;
 }
 
+const BodySnapshot* IModel::GetBodySnapshot()
+{
+	const PhysicsSnapshot* snapshot = Render3DQueue::GetPhysicsSnapshot();
+	return snapshot ? snapshot->Find(&m_RigidBody) : nullptr;
+}
+
+void IModel::EditBody(const BodyEdit& edit)
+{
+	Render3DQueue::EditBody(GetCollider(), edit);
+}
+
 void IModel::SetPayload(const CREATE_PAYLOAD& payload)
 {
 	// Set position
@@ -182,6 +195,7 @@ void IModel::SetPayload(const CREATE_PAYLOAD& payload)
 
 	ColliderState state = payload.Static ? ColliderState::Static : ColliderState::Dynamic;
 	GetCollider()->SetColliderState(state);
+	m_RigidBody.SetContinuous(payload.Continuous);
 
 	SetUiControlNeeded(payload.UiControlNeeded);
 
@@ -211,20 +225,30 @@ SweetLoader IModel::SaveSweetModelData()
 
 	// Position, Velocity, Acceleration, Angular Velocity
 	DirectX::XMFLOAT3 pos, vel, acc, angVel;
+	Quaternion orientation = m_RigidBody.GetOrientation();
 	DirectX::XMStoreFloat3(&pos, m_RigidBody.GetPosition());
 	DirectX::XMStoreFloat3(&vel, m_RigidBody.GetVelocity());
 	DirectX::XMStoreFloat3(&acc, m_RigidBody.GetAcceleration());
 	DirectX::XMStoreFloat3(&angVel, m_RigidBody.GetAngularVelocity());
 
+	// Pose and velocities from one physics frame so a running scene saves consistently
+	if (const BodySnapshot* state = GetBodySnapshot())
+	{
+		pos = state->Position;
+		vel = state->Velocity;
+		angVel = state->AngularVelocity;
+		orientation = Quaternion(state->Orientation.w, state->Orientation.x, state->Orientation.y, state->Orientation.z);
+	}
+
 	root.GetOrCreate("Name") = GetName();
 	root.GetOrCreate("Position").GetOrCreate("x") = std::to_string(pos.x);
 	root.GetOrCreate("Position").GetOrCreate("y") = std::to_string(pos.y);
 	root.GetOrCreate("Position").GetOrCreate("z") = std::to_string(pos.z);
 
-	root.GetOrCreate("Orientation").GetOrCreate("r") = std::to_string(m_RigidBody.GetOrientation().GetR());
-	root.GetOrCreate("Orientation").GetOrCreate("i") = std::to_string(m_RigidBody.GetOrientation().GetI());
-	root.GetOrCreate("Orientation").GetOrCreate("j") = std::to_string(m_RigidBody.GetOrientation().GetJ());
-	root.GetOrCreate("Orientation").GetOrCreate("k") = std::to_string(m_RigidBody.GetOrientation().GetK());
+	root.GetOrCreate("Orientation").GetOrCreate("r") = std::to_string(orientation.GetR());
+	root.GetOrCreate("Orientation").GetOrCreate("i") = std::to_string(orientation.GetI());
+	root.GetOrCreate("Orientation").GetOrCreate("j") = std::to_string(orientation.GetJ());
+	root.GetOrCreate("Orientation").GetOrCreate("k") = std::to_string(orientation.GetK());
 
 	root.GetOrCreate("Velocity").GetOrCreate("x") = std::to_string(vel.x);
 	root.GetOrCreate("Velocity").GetOrCreate("y") = std::to_string(vel.y);
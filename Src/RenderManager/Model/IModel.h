@@ -1,8 +1,10 @@
 #pragma once
 #include <atomic>
 
+#include "BodyEdit.h"
 #include "Core/DefineDefault.h"
 #include "ICollider.h"
+#include "PhysicsSnapshot.h"
 
 #include <d3d11.h>
 #include <memory>
@@ -41,6 +43,7 @@ typedef struct CREATE_PAYLOAD
 	float SpawnTime{ 0.01f };
 	bool Static{ false };
 	bool UiControlNeeded{ false };
+	bool Continuous{ false }; // swept against static geometry, for small fast bodies
 
 	float Radius{ 1.0f };
 	float Height{ 1.0f };
@@ -76,6 +79,10 @@ public:
 	bool IsBuilt() const { return m_Built; }
 
 	RigidBody* GetRigidBody();
+	//~ This body in the current physics frame, nullptr until the physics has stepped it once
+	const BodySnapshot* GetBodySnapshot();
+	//~ Changes the body from the UI, the physics applies it between two steps
+	void EditBody(const BodyEdit& edit);
 	virtual ICollider* GetCollider() const = 0;
 
 	void SetWidget(std::unique_ptr<IWidget> widget)
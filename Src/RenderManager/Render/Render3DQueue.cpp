@@ -36,13 +36,7 @@ bool Render3DQueue::RemoveModel(const IModel* model)
 {
 	if (m_ModelsToRender.empty()) return false;
 
-	bool status = false;
-	if (m_ModelsToRender.contains(model->GetModelId()))
-	{
-		m_ModelsToRender.erase(model->GetModelId());
-		status = true;
-	}
-	return status;
+	return RemoveModel(model->GetModelId());
 }
 
 bool Render3DQueue::RemoveModel(uint64_t modelId)
@@ -51,9 +45,12 @@ bool Render3DQueue::RemoveModel(uint64_t modelId)
 
 	bool status = false;
 
-	if (m_ModelsToRender.contains(modelId))
+	auto it = m_ModelsToRender.find(modelId);
+	if (it != m_ModelsToRender.end())
 	{
-		m_ModelsToRender.erase(modelId);
+		// Waits for the physics step to end, the caller is about to destroy the model
+		if (m_PhysicsManager) m_PhysicsManager->RemoveModel(it->second->GetCollider());
+		m_ModelsToRender.erase(it);
 		status = true;
 	}
 	return status;
@@ -72,12 +69,17 @@ bool Render3DQueue::UpdateVertexConstantBuffer(ID3D11DeviceContext* context)
 	cb.WorldMatrix = DirectX::XMMatrixIdentity();
 	cb.Transformation = DirectX::XMMatrixIdentity();
 
+	// Physics steps at its own fixed rate, draw between its last two frames
+	const float alpha = m_PhysicsManager ? m_PhysicsManager->GetInterpolationAlpha() : 1.0f;
+
 	static int times = 0;
 	for (auto& model : m_ModelsToRender | std::views::values)
 	{
 		if (!model->IsBuilt()) continue;
 
-		cb.Transformation = model->GetCollider()->GetTransformationMatrix();
+		const BodySnapshot* state = model->GetBodySnapshot();
+		cb.Transformation = state ? state->Interpolate(alpha)
+			: model->GetCollider()->GetTransformationMatrix();
 		model->UpdateVertexCB(context, &cb);
 	}
 	return true;
@@ -113,6 +115,20 @@ void Render3DQueue::RenderAll(ID3D11DeviceContext* context)
 	}
 }
 
+const PhysicsSnapshot* Render3DQueue::GetPhysicsSnapshot()
+{
+	if (!m_PhysicsManager) return nullptr;
+	return &m_PhysicsManager->GetSnapshot();
+}
+
+void Render3DQueue::EditBody(ICollider* collider, const BodyEdit& edit)
+{
+	if (!collider) return;
+
+	if (m_PhysicsManager) m_PhysicsManager->EditBody(collider, edit);
+	else edit.Apply(collider);
+}
+
 void Render3DQueue::CleanPhysicsManager()
 {
 	if (m_PhysicsManager) m_PhysicsManager->Clear();
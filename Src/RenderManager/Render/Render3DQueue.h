@@ -19,6 +19,10 @@ public:
 	static bool UpdatePixelConstantBuffer(ID3D11DeviceContext* context);
 	static void RenderAll(ID3D11DeviceContext* context);
 	static void CleanPhysicsManager();
+	//~ Frame last acquired by the main loop, nullptr without a physics manager
+	static const PhysicsSnapshot* GetPhysicsSnapshot();
+	//~ Through the physics manager's command buffer, straight to the collider without one
+	static void EditBody(ICollider* collider, const BodyEdit& edit);
 	static void Clean();
 
 private:
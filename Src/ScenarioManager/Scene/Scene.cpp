@@ -190,6 +190,7 @@ CREATE_PAYLOAD Scene::GeneratePayloadFromSceneSettings(SPAWN_OBJECT type, const
 	payload.Friction = m_Randomizer.Float(settings.minFriction, settings.maxFriction);
 	payload.AngularDamping = m_Randomizer.Float(settings.minAngularDamping, settings.maxAngularDamping);
 	payload.LinearDamping = m_Randomizer.Float(settings.minLinearDamping, settings.maxLinearDamping);
+	payload.Continuous = settings.continuous;
 
 	payload.Radius = m_Randomizer.Float(settings.minRadius, settings.maxRadius);
 	payload.Height = m_Randomizer.Float(settings.minHeight, settings.maxHeight);
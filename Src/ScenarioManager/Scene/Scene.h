@@ -70,6 +70,9 @@ typedef struct CREATE_SCENE_PAYLOAD
     float minDepth = 0.3f;
     float maxDepth = 4.0f;
 
+    // Sweep the spawned bodies against static geometry so small fast ones do not tunnel
+    bool continuous = false;
+
 } CREATE_SCENE_PAYLOAD;
 
 enum class State : uint8_t
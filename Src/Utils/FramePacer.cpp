@@ -0,0 +1,125 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+FramePacer::FramePacer()
+{
+    m_Timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    m_HighResolution = m_Timer != nullptr;
+
+    // Older systems only have the regular timer, which fires on the ~15.6 ms scheduler tick
+    if (!m_Timer)
+    {
+        m_Timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+}
+
+FramePacer::~FramePacer()
+{
+    if (m_Timer) CloseHandle(m_Timer);
+}
+
+void FramePacer::SetMode(PacingMode mode)
+{
+    m_Mode = mode;
+    ResetJitter();
+}
+
+PacingMode FramePacer::GetMode() const
+{
+    return m_Mode.load();
+}
+
+void FramePacer::SetInterruptEvent(HANDLE event)
+{
+    m_Interrupt = event;
+}
+
+bool FramePacer::WaitUntil(Clock::time_point deadline)
+{
+    using namespace std::chrono;
+
+    Clock::time_point now = Clock::now();
+    if (now >= deadline) return true;
+
+    const Clock::time_point sleepUntil = deadline - GetSpinMargin(m_Mode.load());
+    if (m_Timer && sleepUntil > now)
+    {
+        // Relative due time, negative and in 100 ns units
+        using Ticks = duration<long long, std::ratio<1, 10000000>>;
+        LARGE_INTEGER dueTime{};
+        dueTime.QuadPart = -(std::max)(1LL, duration_cast<Ticks>(sleepUntil - now).count());
+
+        if (SetWaitableTimer(m_Timer, &dueTime, 0, nullptr, nullptr, FALSE))
+        {
+            const HANDLE handles[2] = { m_Timer, m_Interrupt };
+            const DWORD count = m_Interrupt ? 2 : 1;
+
+            if (WaitForMultipleObjects(count, handles, FALSE, INFINITE) == WAIT_OBJECT_0 + 1)
+            {
+                CancelWaitableTimer(m_Timer);
+                return false;
+            }
+        }
+    }
+
+    while ((now = Clock::now()) < deadline)
+    {
+        YieldProcessor();
+    }
+
+    RecordJitter(now - deadline);
+    return true;
+}
+
+bool FramePacer::WaitFor(float seconds)
+{
+    return WaitUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(seconds)));
+}
+
+float FramePacer::GetAverageJitter() const
+{
+    return m_AverageJitter.load();
+}
+
+float FramePacer::GetMaxJitter() const
+{
+    return m_MaxJitter.load();
+}
+
+void FramePacer::ResetJitter()
+{
+    m_AverageJitter = 0.0f;
+    m_MaxJitter = 0.0f;
+}
+
+FramePacer::Clock::duration FramePacer::GetSpinMargin(PacingMode mode) const
+{
+    using namespace std::chrono;
+
+    // The regular timer can wake a scheduler tick late. Spinning a whole tick to cover that
+    // would burn most of a 60 Hz frame, so without the high resolution timer the margin stays
+    // within a couple of milliseconds and such a wake up is simply late.
+    switch (mode)
+    {
+    case PacingMode::PowerSaving: return Clock::duration::zero();
+    case PacingMode::Balanced:
+        return m_HighResolution ? duration_cast<Clock::duration>(microseconds(500)) : milliseconds(1);
+    case PacingMode::LowLatency:
+        return milliseconds(2);
+    }
+    return Clock::duration::zero();
+}
+
+void FramePacer::RecordJitter(Clock::duration lateness)
+{
+    const float milliseconds = std::chrono::duration<float, std::milli>(lateness).count();
+
+    // Only the pacing thread writes, the atomics are there for the UI reading them
+    m_AverageJitter = m_AverageJitter.load() * 0.95f + milliseconds * 0.05f;
+    m_MaxJitter = (std::max)(m_MaxJitter.load(), milliseconds);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+#include <chrono>
+
+enum class PacingMode : int
+{
+    PowerSaving = 0, // sleep on the timer right up to the deadline, never spin
+    Balanced,        // sleep, then spin the last half millisecond
+    LowLatency,      // sleep, then spin the last two milliseconds
+};
+
+// Blocks a loop until its next deadline without burning a core. Sleeps on a high resolution
+// waitable timer until shortly before the deadline, then spins on the clock for the rest;
+// how much is spun is the power / latency trade off picked with the mode.
+// Lateness of every wake up is recorded so the pacing quality can be shown in the UI.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer();
+    ~FramePacer();
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    void SetMode(PacingMode mode);
+    PacingMode GetMode() const;
+
+    //~ An event that cuts a wait short, e.g. the global shutdown event
+    void SetInterruptEvent(HANDLE event);
+
+    //~ False when the interrupt event fired before the deadline
+    bool WaitUntil(Clock::time_point deadline);
+    bool WaitFor(float seconds);
+
+    //~ Wake up lateness in milliseconds, a moving average and the worst one since the last reset
+    float GetAverageJitter() const;
+    float GetMaxJitter() const;
+    void ResetJitter();
+
+    //~ False on systems without high resolution waitable timers (before Windows 10 1803). Those
+    //~ sleep on the regular timer, so a wake up can be up to a scheduler tick late.
+    bool IsHighResolution() const { return m_HighResolution; }
+
+private:
+    Clock::duration GetSpinMargin(PacingMode mode) const;
+    void RecordJitter(Clock::duration lateness);
+
+private:
+    HANDLE m_Timer{ nullptr };
+    HANDLE m_Interrupt{ nullptr };
+    bool m_HighResolution{ false };
+    std::atomic<PacingMode> m_Mode{ PacingMode::Balanced };
+    std::atomic<float> m_AverageJitter{ 0.0f };
+    std::atomic<float> m_MaxJitter{ 0.0f };
+};
@@ -1,32 +1,44 @@
 #include "Randomizer.h"
 
+std::atomic<uint32_t> Randomizer::s_Session{ 0 };
+std::atomic<uint64_t> Randomizer::s_SessionSeed{ 0 };
 
-Randomizer::Randomizer()
-	: m_Engine(std::random_device{}())
-{}
+Randomizer::Randomizer(uint64_t stream)
+	: m_Stream(stream)
+{
+	Reseed();
+}
+
+void Randomizer::Reseed()
+{
+	// Session before seed, SetSessionSeed stores them the other way round
+	m_Session = s_Session.load();
+	const uint64_t seed = m_Session != 0 ? s_SessionSeed.load() : RandomStream::MakeSeed();
+	m_Engine.Seed(seed, m_Stream);
+}
 
 float Randomizer::Float(float min, float max)
 {
+    SyncSession();
     FixRange(min, max);
     if (min == max) return min;
 
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(m_Engine);
+    return m_Engine.Range(min, max);
 }
 
 int Randomizer::Int(int min, int max)
 {
+    SyncSession();
     FixRange(min, max);
     if (min == max) return min;
 
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(m_Engine);
+    return m_Engine.Range(min, max);
 }
 
 bool Randomizer::Bool()
 {
-    std::bernoulli_distribution dist(0.5);
-    return dist(m_Engine);
+    SyncSession();
+    return (m_Engine.NextUInt() & 1u) != 0;
 }
 
 DirectX::XMFLOAT3 Randomizer::Vec3(const DirectX::XMFLOAT3& min, const DirectX::XMFLOAT3& max)
@@ -37,3 +49,14 @@ DirectX::XMFLOAT3 Randomizer::Vec3(const DirectX::XMFLOAT3& min, const DirectX::
            Float(min.z, max.z)
     };
 }
+
+void Randomizer::SetSessionSeed(uint64_t seed)
+{
+	s_SessionSeed = seed;
+	s_Session.fetch_add(1);
+}
+
+void Randomizer::SyncSession()
+{
+    if (m_Session != s_Session.load(std::memory_order_relaxed)) Reseed();
+}
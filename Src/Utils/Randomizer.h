@@ -1,14 +1,24 @@
 #pragma once
 
-#include <random>
+#include <atomic>
+#include <cstdint>
+#include <utility>
 #include <DirectXMath.h>
 
+#include "RandomStream.h"
+
 
 class Randomizer
 {
 public:
-    Randomizer();
-    // Float between [min, max]
+    // Stream picks the sequence within a seed, users on their own stream never shift each other
+    explicit Randomizer(uint64_t stream = 0);
+
+    // Starts over from the session seed when one is set, from the OS otherwise. Happens on
+    // its own at the next draw after the session seed changes.
+    void Reseed();
+
+    // Float between [min, max)
     float Float(float min, float max);
 
     // Int between [min, max]
@@ -18,8 +28,20 @@ public:
     // Random vector between two XMFLOAT3 ranges
     DirectX::XMFLOAT3 Vec3(const DirectX::XMFLOAT3& min, const DirectX::XMFLOAT3& max);
 
+    // Every Randomizer restarts from this seed before its next draw, for runs that have to be reproduced
+    static void SetSessionSeed(uint64_t seed);
+
 private:
-    std::mt19937 m_Engine;
+    void SyncSession();
+
+private:
+    RandomStream m_Engine;
+    uint64_t m_Stream;
+    uint32_t m_Session{ 0 };
+
+    //~ Bumped by every SetSessionSeed, 0 while there is no session seed
+    static std::atomic<uint32_t> s_Session;
+    static std::atomic<uint64_t> s_SessionSeed;
 
     // Helper to ensure min <= max
     template<typename T>